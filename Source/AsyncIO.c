@@ -0,0 +1,665 @@
+#define VZKR_IMPLEMENTATION
+#include "AsyncIO.h"
+
+// Internal Declarations ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_ASYNC_IO_DEFAULT_QUEUE_DEPTH 256
+#define VZKR_INTERNAL_ASYNC_IO_DEFAULT_WORKERS     4
+
+#if PNSLR_LINUX
+    // mirrors the kernel's 'struct statx', which is a stable ABI; declared here since the
+    // libc and kernel headers don't agree on who provides it. The kernel writes all of it,
+    // so it has to be the full size, not just the fields read back out.
+    typedef struct VZKR_Internal_StatxBuffer
+    {
+        u32 mask;
+        u32 blockSize;
+        u64 attributes;
+        u32 numLinks;
+        u32 uid;
+        u32 gid;
+        u16 mode;
+        u16 spare0;
+        u64 inode;
+        u64 size;
+        u8 rest[208];
+    } VZKR_Internal_StatxBuffer;
+
+    static_assert(sizeof(VZKR_Internal_StatxBuffer) == 256, "must match the kernel's 'struct statx'");
+
+    #define VZKR_INTERNAL_STATX_SIZE 0x200u
+#endif
+
+typedef struct VZKR_Internal_AsyncIoSlot
+{
+    VZKR_AsyncIoRequest request;
+    VZKR_AsyncIoCompletion completion;
+    i32 nextFree; // also links the parked ones
+    cstring pathBuffer;
+    #if PNSLR_LINUX
+        VZKR_Internal_StatxBuffer statBuffer;
+    #endif
+} VZKR_Internal_AsyncIoSlot;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_Internal_AsyncIoSlot);
+
+typedef struct VZKR_Internal_AsyncIo
+{
+    PNSLR_Allocator allocator;
+    i32 capacity;
+    i32 firstFree;
+    i32 numInFlight;
+    b8 native;
+    PNSLR_ArraySlice(VZKR_Internal_AsyncIoSlot) slots;
+
+    // completions without a callback that a poll had no room for, so they don't hold up
+    // the ones behind them; the next poll with room returns them first
+    i32 parkedHead;
+    i32 parkedTail;
+    i32 numParked;
+
+    // thread-pool backend, both queues hold slot indices
+    VZKR_ProfiledMutex mutex;
+    PNSLR_ConditionVariable workAvailable;
+    PNSLR_ConditionVariable workCompleted;
+    PNSLR_ArraySlice(i32) pendingQueue;
+    i32 pendingHead;
+    i32 pendingCount;
+    PNSLR_ArraySlice(i32) completedQueue;
+    i32 completedHead;
+    i32 completedCount;
+    b8 shuttingDown;
+    PNSLR_ArraySlice(VZKR_Thread) workers;
+
+    #if PNSLR_LINUX
+        int ringFd;
+        i32 numUnsubmitted;
+        rawptr sqRing;
+        i64 sqRingSize;
+        rawptr cqRing;
+        i64 cqRingSize;
+        struct io_uring_sqe* sqes;
+        i64 sqesSize;
+        u32* sqHead;
+        u32* sqTail;
+        u32 sqMask;
+        u32* sqArray;
+        u32* cqHead;
+        u32* cqTail;
+        u32 cqMask;
+        struct io_uring_cqe* cqes;
+    #endif
+} VZKR_Internal_AsyncIo;
+
+// Thread-Pool Backend ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/** Performs a request synchronously, on a worker thread. */
+static void VZKR_Internal_AsyncIoExecuteBlocking(VZKR_Internal_AsyncIoSlot* slot)
+{
+    VZKR_AsyncIoRequest* req = &slot->request;
+    VZKR_AsyncIoCompletion* cmp = &slot->completion;
+
+    switch (req->op)
+    {
+        case VZKR_AsyncIoOp_Read:
+        case VZKR_AsyncIoOp_Write:
+        {
+            i64 res = VZKR_Internal_FileTransferAt(req->file, req->buffer.data, req->buffer.count, req->offset, req->op == VZKR_AsyncIoOp_Write);
+            cmp->success = (res >= 0);
+            cmp->result  = (res >= 0) ? res : 0;
+            break;
+        }
+        case VZKR_AsyncIoOp_OpenToRead:
+            cmp->file    = PNSLR_OpenFileToRead(req->path, false);
+            cmp->success = (cmp->file.handle != nil);
+            break;
+        case VZKR_AsyncIoOp_OpenToWrite:
+            cmp->file    = PNSLR_OpenFileToWrite(req->path, req->append, false);
+            cmp->success = (cmp->file.handle != nil);
+            break;
+        case VZKR_AsyncIoOp_Close:
+            PNSLR_CloseFileHandle(req->file);
+            cmp->success = true;
+            break;
+        case VZKR_AsyncIoOp_Stat:
+            cmp->success = PNSLR_PathExists(req->path, PNSLR_PathExistsCheckType_File);
+            cmp->result  = cmp->success ? PNSLR_GetFileSize(req->path) : 0;
+            break;
+        default:
+            cmp->success = false;
+            break;
+    }
+}
+
+static void VZKR_Internal_AsyncIoWorker(rawptr arg)
+{
+    VZKR_Internal_AsyncIo* io = (VZKR_Internal_AsyncIo*) arg;
+    VZKR_LockProfiledMutex(&io->mutex);
+    while (true)
+    {
+        while (io->pendingCount == 0 && !io->shuttingDown) { VZKR_WaitProfiledConditionVariable(&io->workAvailable, &io->mutex); }
+        if (io->pendingCount == 0) break; // shutting down, with nothing left to do
+
+        i32 idx = io->pendingQueue.data[io->pendingHead];
+        io->pendingHead = (io->pendingHead + 1) % io->capacity;
+        io->pendingCount--;
+        VZKR_UnlockProfiledMutex(&io->mutex);
+
+        VZKR_Internal_AsyncIoExecuteBlocking(&io->slots.data[idx]);
+
+        VZKR_LockProfiledMutex(&io->mutex);
+        io->completedQueue.data[(io->completedHead + io->completedCount) % io->capacity] = idx;
+        io->completedCount++;
+        PNSLR_SignalConditionVariable(&io->workCompleted);
+    }
+    VZKR_UnlockProfiledMutex(&io->mutex);
+}
+
+static b8 VZKR_Internal_AsyncIoStartWorkers(VZKR_Internal_AsyncIo* io, i32 numWorkers)
+{
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    io->workers = PNSLR_MakeSlice(VZKR_Thread, numWorkers, true, io->allocator, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None) return false;
+
+    VZKR_ThreadOptions threadOptions = {.name = PNSLR_StringLiteral("VzkrAsyncIo")};
+    for (i32 i = 0; i < numWorkers; i++)
+    {
+        io->workers.data[i] = VZKR_CreateThread(VZKR_Internal_AsyncIoWorker, io, threadOptions, io->allocator);
+        if (!io->workers.data[i].handle) { io->workers.count = i; return false; }
+    }
+
+    return true;
+}
+
+static void VZKR_Internal_AsyncIoStopWorkers(VZKR_Internal_AsyncIo* io)
+{
+    VZKR_LockProfiledMutex(&io->mutex);
+    io->shuttingDown = true;
+    PNSLR_BroadcastConditionVariable(&io->workAvailable);
+    VZKR_UnlockProfiledMutex(&io->mutex);
+
+    for (i64 i = 0; i < io->workers.count; i++) { VZKR_JoinThread(&io->workers.data[i]); }
+
+    PNSLR_FreeSlice(&io->workers, io->allocator, PNSLR_GET_LOC(), nil);
+}
+
+// io_uring Backend ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#if PNSLR_LINUX
+
+static b8 VZKR_Internal_AsyncIoSetupRing(VZKR_Internal_AsyncIo* io)
+{
+    struct io_uring_params params;
+    PNSLR_MemSet(&params, 0, (i32) sizeof(params));
+
+    int fd = (int) syscall(__NR_io_uring_setup, (unsigned) io->capacity, &params);
+    if (fd < 0) return false;
+
+    // opening/closing/stat-ing through the ring needs 5.6+, which is also when this feature showed up
+    if (!(params.features & IORING_FEAT_RW_CUR_POS)) { close(fd); return false; }
+
+    io->ringFd     = fd;
+    io->sqRingSize = (i64) (params.sq_off.array + params.sq_entries * sizeof(u32));
+    io->cqRingSize = (i64) (params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe));
+    io->sqesSize   = (i64) (params.sq_entries * sizeof(struct io_uring_sqe));
+
+    b8 singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap && io->cqRingSize > io->sqRingSize) io->sqRingSize = io->cqRingSize;
+
+    io->sqRing = mmap(nil, (size_t) io->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (io->sqRing == MAP_FAILED) { io->sqRing = nil; return false; }
+
+    if (singleMmap)
+    {
+        io->cqRing     = io->sqRing;
+        io->cqRingSize = 0;
+    }
+    else
+    {
+        io->cqRing = mmap(nil, (size_t) io->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (io->cqRing == MAP_FAILED) { io->cqRing = nil; return false; }
+    }
+
+    io->sqes = (struct io_uring_sqe*) mmap(nil, (size_t) io->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if ((rawptr) io->sqes == MAP_FAILED) { io->sqes = nil; return false; }
+
+    u8* sq = (u8*) io->sqRing;
+    u8* cq = (u8*) io->cqRing;
+    io->sqHead  = (u32*) (sq + params.sq_off.head);
+    io->sqTail  = (u32*) (sq + params.sq_off.tail);
+    io->sqMask  = *(u32*) (sq + params.sq_off.ring_mask);
+    io->sqArray = (u32*) (sq + params.sq_off.array);
+    io->cqHead  = (u32*) (cq + params.cq_off.head);
+    io->cqTail  = (u32*) (cq + params.cq_off.tail);
+    io->cqMask  = *(u32*) (cq + params.cq_off.ring_mask);
+    io->cqes    = (struct io_uring_cqe*) (cq + params.cq_off.cqes);
+    return true;
+}
+
+static void VZKR_Internal_AsyncIoTeardownRing(VZKR_Internal_AsyncIo* io)
+{
+    if (io->sqes) munmap(io->sqes, (size_t) io->sqesSize);
+    if (io->cqRing && io->cqRing != io->sqRing) munmap(io->cqRing, (size_t) io->cqRingSize);
+    if (io->sqRing) munmap(io->sqRing, (size_t) io->sqRingSize);
+    if (io->ringFd >= 0) close(io->ringFd);
+
+    io->sqes   = nil;
+    io->cqRing = nil;
+    io->sqRing = nil;
+    io->ringFd = -1;
+}
+
+/** Fills in the next submission queue entry for a slot. The tail is published by the caller. */
+static b8 VZKR_Internal_AsyncIoPrepareSqe(VZKR_Internal_AsyncIo* io, i32 slotIdx, u32 tail)
+{
+    VZKR_Internal_AsyncIoSlot* slot = &io->slots.data[slotIdx];
+    VZKR_AsyncIoRequest* req = &slot->request;
+
+    u32 idx = tail & io->sqMask;
+    struct io_uring_sqe* sqe = &io->sqes[idx];
+    PNSLR_MemSet(sqe, 0, (i32) sizeof(*sqe));
+    sqe->user_data = (u64) slotIdx;
+
+    i64 count = req->buffer.count;
+    if (count > VZKR_INTERNAL_FILE_MAX_TRANSFER) count = VZKR_INTERNAL_FILE_MAX_TRANSFER;
+
+    switch (req->op)
+    {
+        case VZKR_AsyncIoOp_Read:
+        case VZKR_AsyncIoOp_Write:
+            sqe->opcode = (req->op == VZKR_AsyncIoOp_Read) ? IORING_OP_READ : IORING_OP_WRITE;
+            sqe->fd     = VZKR_Internal_FileDescriptor(req->file);
+            sqe->addr   = (u64) req->buffer.data;
+            sqe->len    = (u32) count;
+            sqe->off    = (u64) req->offset;
+            break;
+        case VZKR_AsyncIoOp_OpenToRead:
+        case VZKR_AsyncIoOp_OpenToWrite:
+        {
+            slot->pathBuffer = VZKR_Internal_CopyPathToCString(req->path, io->allocator);
+            if (!slot->pathBuffer) return false;
+
+            b8 toWrite = (req->op == VZKR_AsyncIoOp_OpenToWrite);
+            sqe->opcode     = IORING_OP_OPENAT;
+            sqe->fd         = AT_FDCWD;
+            sqe->addr       = (u64) slot->pathBuffer;
+            sqe->len        = toWrite ? 0644 : 0;
+            sqe->open_flags = O_CLOEXEC | (toWrite ? (O_WRONLY | O_CREAT | (req->append ? O_APPEND : O_TRUNC)) : O_RDONLY);
+            break;
+        }
+        case VZKR_AsyncIoOp_Close:
+            sqe->opcode = IORING_OP_CLOSE;
+            sqe->fd     = VZKR_Internal_FileDescriptor(req->file);
+            break;
+        case VZKR_AsyncIoOp_Stat:
+            slot->pathBuffer = VZKR_Internal_CopyPathToCString(req->path, io->allocator);
+            if (!slot->pathBuffer) return false;
+
+            sqe->opcode = IORING_OP_STATX;
+            sqe->fd     = AT_FDCWD;
+            sqe->addr   = (u64) slot->pathBuffer;
+            sqe->len    = VZKR_INTERNAL_STATX_SIZE;
+            sqe->off    = (u64) &slot->statBuffer;
+            break;
+        default:
+            return false;
+    }
+
+    io->sqArray[idx] = idx;
+    return true;
+}
+
+/** Hands everything that's been queued in the ring over to the kernel. */
+static void VZKR_Internal_AsyncIoFlushRing(VZKR_Internal_AsyncIo* io)
+{
+    while (io->numUnsubmitted > 0)
+    {
+        long res = syscall(__NR_io_uring_enter, io->ringFd, (unsigned) io->numUnsubmitted, 0u, 0u, nil, 0);
+        if (res < 0)
+        {
+            // busy/interrupted, the entries stay in the ring and get retried on the next poll
+            break;
+        }
+
+        io->numUnsubmitted -= (i32) res;
+        if (res == 0) break;
+    }
+}
+
+static void VZKR_Internal_AsyncIoFillFromCqe(VZKR_Internal_AsyncIoSlot* slot, i32 res)
+{
+    VZKR_AsyncIoCompletion* cmp = &slot->completion;
+    cmp->success = (res >= 0);
+
+    switch (slot->request.op)
+    {
+        case VZKR_AsyncIoOp_Read:
+        case VZKR_AsyncIoOp_Write:
+            cmp->result = (res >= 0) ? (i64) res : 0;
+            break;
+        case VZKR_AsyncIoOp_OpenToRead:
+        case VZKR_AsyncIoOp_OpenToWrite:
+            cmp->file = (res >= 0) ? VZKR_Internal_FileFromDescriptor(res) : (PNSLR_File) {0};
+            break;
+        case VZKR_AsyncIoOp_Stat:
+            cmp->result = (res >= 0) ? (i64) slot->statBuffer.size : 0;
+            break;
+        default:
+            break;
+    }
+}
+
+#endif
+
+// Async I/O Declaration ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+static void VZKR_Internal_AsyncIoFree(VZKR_Internal_AsyncIo* io)
+{
+    PNSLR_Allocator allocator = io->allocator;
+
+    if (io->workers.data) VZKR_Internal_AsyncIoStopWorkers(io);
+
+    #if PNSLR_LINUX
+        VZKR_Internal_AsyncIoTeardownRing(io);
+    #endif
+
+    for (i64 i = 0; i < io->slots.count; i++)
+    {
+        if (io->slots.data[i].pathBuffer) PNSLR_Free(allocator, (rawptr) io->slots.data[i].pathBuffer, PNSLR_GET_LOC(), nil);
+    }
+
+    PNSLR_DestroyConditionVariable(&io->workCompleted);
+    PNSLR_DestroyConditionVariable(&io->workAvailable);
+    VZKR_DestroyProfiledMutex(&io->mutex);
+    PNSLR_FreeSlice(&io->completedQueue, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&io->pendingQueue, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&io->slots, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_Free(allocator, io, PNSLR_GET_LOC(), nil);
+}
+
+VZKR_AsyncIo VZKR_CreateAsyncIo(VZKR_AsyncIoCreationOptions options)
+{
+    i32 capacity   = options.queueDepth > 0 ? options.queueDepth : VZKR_INTERNAL_ASYNC_IO_DEFAULT_QUEUE_DEPTH;
+    i32 numWorkers = options.numWorkerThreads > 0 ? options.numWorkerThreads : VZKR_INTERNAL_ASYNC_IO_DEFAULT_WORKERS;
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_AsyncIo* io = (VZKR_Internal_AsyncIo*) PNSLR_Allocate(options.allocator, true, (i32) sizeof(VZKR_Internal_AsyncIo), (i32) alignof(VZKR_Internal_AsyncIo), PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !io) return (VZKR_AsyncIo) {0};
+
+    io->allocator      = options.allocator;
+    io->capacity       = capacity;
+    io->mutex          = VZKR_CreateProfiledMutex(PNSLR_GET_LOC());
+    io->workAvailable  = PNSLR_CreateConditionVariable();
+    io->workCompleted  = PNSLR_CreateConditionVariable();
+    io->slots          = PNSLR_MakeSlice(VZKR_Internal_AsyncIoSlot, capacity, true, io->allocator, PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) io->pendingQueue   = PNSLR_MakeSlice(i32, capacity, false, io->allocator, PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) io->completedQueue = PNSLR_MakeSlice(i32, capacity, false, io->allocator, PNSLR_GET_LOC(), &err);
+    #if PNSLR_LINUX
+        io->ringFd = -1;
+    #endif
+
+    if (err != PNSLR_AllocatorError_None)
+    {
+        VZKR_Internal_AsyncIoFree(io);
+        return (VZKR_AsyncIo) {0};
+    }
+
+    for (i32 i = 0; i < capacity; i++) { io->slots.data[i].nextFree = (i + 1 < capacity) ? (i + 1) : -1; }
+    io->firstFree = 0;
+    io->parkedHead = -1;
+    io->parkedTail = -1;
+
+    #if PNSLR_LINUX
+        if (!options.forceThreadPool)
+        {
+            io->native = VZKR_Internal_AsyncIoSetupRing(io);
+            if (!io->native) VZKR_Internal_AsyncIoTeardownRing(io);
+        }
+    #endif
+
+    if (!io->native && !VZKR_Internal_AsyncIoStartWorkers(io, numWorkers))
+    {
+        VZKR_Internal_AsyncIoFree(io);
+        return (VZKR_AsyncIo) {0};
+    }
+
+    return (VZKR_AsyncIo) {.handle = io};
+}
+
+void VZKR_DestroyAsyncIo(VZKR_AsyncIo* io)
+{
+    if (!io || !io->handle) return;
+    VZKR_Internal_AsyncIo* internal = (VZKR_Internal_AsyncIo*) io->handle;
+
+    // the kernel/workers might still be touching the slots, so everything has to land first
+    VZKR_AsyncIoCompletion discard[16];
+    PNSLR_ArraySlice(VZKR_AsyncIoCompletion) discardSlice = {.data = discard, .count = 16};
+    while (internal->numInFlight > 0)
+    {
+        for (i64 i = 0; i < internal->slots.count; i++) { internal->slots.data[i].request.callback = nil; }
+        VZKR_WaitAsyncIo(*io, -1);
+        VZKR_PollAsyncIo(*io, discardSlice);
+    }
+
+    VZKR_Internal_AsyncIoFree(internal);
+    *io = (VZKR_AsyncIo) {0};
+}
+
+b8 VZKR_IsAsyncIoNative(VZKR_AsyncIo io)
+{
+    VZKR_Internal_AsyncIo* internal = (VZKR_Internal_AsyncIo*) io.handle;
+    return internal ? internal->native : false;
+}
+
+// Async I/O Submission ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+b8 VZKR_SubmitAsyncIo(VZKR_AsyncIo io, PNSLR_ArraySlice(VZKR_AsyncIoRequest) requests)
+{
+    VZKR_Internal_AsyncIo* internal = (VZKR_Internal_AsyncIo*) io.handle;
+    if (!internal) return false;
+    if (requests.count == 0) return true;
+    if (requests.count > (i64) (internal->capacity - internal->numInFlight)) return false;
+
+    #if PNSLR_LINUX
+        if (internal->native)
+        {
+            u32 tail = *internal->sqTail;
+            i32 numPrepared = 0;
+            b8 success = true;
+            for (i64 i = 0; i < requests.count; i++)
+            {
+                i32 idx = internal->firstFree;
+                VZKR_Internal_AsyncIoSlot* slot = &internal->slots.data[idx];
+                slot->request    = requests.data[i];
+                slot->completion = (VZKR_AsyncIoCompletion) {.userData = requests.data[i].userData, .op = requests.data[i].op};
+                slot->pathBuffer = nil;
+
+                if (!VZKR_Internal_AsyncIoPrepareSqe(internal, idx, tail + (u32) numPrepared)) { success = false; break; }
+
+                internal->firstFree = slot->nextFree;
+                numPrepared++;
+            }
+
+            if (!success)
+            {
+                // nothing was published yet, so the already-prepared slots just go back
+                for (i32 i = numPrepared - 1; i >= 0; i--)
+                {
+                    i32 idx = (i32) internal->sqes[(tail + (u32) i) & internal->sqMask].user_data;
+                    VZKR_Internal_AsyncIoSlot* slot = &internal->slots.data[idx];
+                    if (slot->pathBuffer) { PNSLR_Free(internal->allocator, (rawptr) slot->pathBuffer, PNSLR_GET_LOC(), nil); slot->pathBuffer = nil; }
+                    slot->nextFree      = internal->firstFree;
+                    internal->firstFree = idx;
+                }
+
+                return false;
+            }
+
+            VZKR_AtomicStoreU32(internal->sqTail, tail + (u32) numPrepared, VZKR_MemoryOrder_Release);
+            internal->numInFlight    += numPrepared;
+            internal->numUnsubmitted += numPrepared;
+            VZKR_Internal_AsyncIoFlushRing(internal);
+            return true;
+        }
+    #endif
+
+    VZKR_LockProfiledMutex(&internal->mutex);
+    for (i64 i = 0; i < requests.count; i++)
+    {
+        i32 idx = internal->firstFree;
+        VZKR_Internal_AsyncIoSlot* slot = &internal->slots.data[idx];
+        internal->firstFree = slot->nextFree;
+
+        slot->request    = requests.data[i];
+        slot->completion = (VZKR_AsyncIoCompletion) {.userData = requests.data[i].userData, .op = requests.data[i].op};
+
+        internal->pendingQueue.data[(internal->pendingHead + internal->pendingCount) % internal->capacity] = idx;
+        internal->pendingCount++;
+    }
+
+    internal->numInFlight += (i32) requests.count;
+    if (requests.count == 1) PNSLR_SignalConditionVariable(&internal->workAvailable);
+    else                     PNSLR_BroadcastConditionVariable(&internal->workAvailable);
+    VZKR_UnlockProfiledMutex(&internal->mutex);
+    return true;
+}
+
+i32 VZKR_GetNumAsyncIoInFlight(VZKR_AsyncIo io)
+{
+    VZKR_Internal_AsyncIo* internal = (VZKR_Internal_AsyncIo*) io.handle;
+    return internal ? internal->numInFlight : 0;
+}
+
+// Async I/O Completion ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Hands a finished slot's completion over to its callback or the output, and frees it.
+ * If it has no callback and the output's full, it's parked instead.
+ */
+static void VZKR_Internal_AsyncIoDeliver(
+    VZKR_Internal_AsyncIo* io,
+    i32 idx,
+    PNSLR_ArraySlice(VZKR_AsyncIoCompletion) output,
+    i32* numWritten
+)
+{
+    VZKR_Internal_AsyncIoSlot* slot = &io->slots.data[idx];
+    VZKR_AsyncIoCompletion completion = slot->completion;
+    VZKR_AsyncIoCallback callback = slot->request.callback;
+
+    if (!callback && *numWritten >= output.count)
+    {
+        slot->nextFree = -1;
+        if (io->parkedTail >= 0) io->slots.data[io->parkedTail].nextFree = idx;
+        else                     io->parkedHead = idx;
+        io->parkedTail = idx;
+        io->numParked++;
+        return;
+    }
+
+    if (slot->pathBuffer) { PNSLR_Free(io->allocator, (rawptr) slot->pathBuffer, PNSLR_GET_LOC(), nil); slot->pathBuffer = nil; }
+    slot->request  = (VZKR_AsyncIoRequest) {0};
+    slot->nextFree = io->firstFree;
+    io->firstFree  = idx;
+    io->numInFlight--;
+
+    // the slot's already free, so the callback can submit more work
+    if (callback) callback(completion.userData, completion);
+    else          output.data[(*numWritten)++] = completion;
+}
+
+i32 VZKR_PollAsyncIo(VZKR_AsyncIo io, PNSLR_ArraySlice(VZKR_AsyncIoCompletion) output)
+{
+    VZKR_Internal_AsyncIo* internal = (VZKR_Internal_AsyncIo*) io.handle;
+    if (!internal) return 0;
+
+    i32 numWritten = 0;
+    while (internal->numParked > 0 && numWritten < output.count)
+    {
+        i32 idx = internal->parkedHead;
+        internal->parkedHead = internal->slots.data[idx].nextFree;
+        if (internal->parkedHead < 0) internal->parkedTail = -1;
+        internal->numParked--;
+
+        VZKR_Internal_AsyncIoDeliver(internal, idx, output, &numWritten);
+    }
+
+    #if PNSLR_LINUX
+        if (internal->native)
+        {
+            VZKR_Internal_AsyncIoFlushRing(internal);
+
+            u32 head = *internal->cqHead;
+            while (head != VZKR_AtomicLoadU32(internal->cqTail, VZKR_MemoryOrder_Acquire))
+            {
+                struct io_uring_cqe* cqe = &internal->cqes[head & internal->cqMask];
+                i32 idx = (i32) cqe->user_data;
+                VZKR_Internal_AsyncIoFillFromCqe(&internal->slots.data[idx], cqe->res);
+                head++;
+                VZKR_AtomicStoreU32(internal->cqHead, head, VZKR_MemoryOrder_Release);
+
+                VZKR_Internal_AsyncIoDeliver(internal, idx, output, &numWritten);
+            }
+
+            return numWritten;
+        }
+    #endif
+
+    while (true)
+    {
+        VZKR_LockProfiledMutex(&internal->mutex);
+        if (internal->completedCount == 0) { VZKR_UnlockProfiledMutex(&internal->mutex); break; }
+
+        i32 idx = internal->completedQueue.data[internal->completedHead];
+
+        internal->completedHead = (internal->completedHead + 1) % internal->capacity;
+        internal->completedCount--;
+        VZKR_UnlockProfiledMutex(&internal->mutex);
+
+        VZKR_Internal_AsyncIoDeliver(internal, idx, output, &numWritten);
+    }
+
+    return numWritten;
+}
+
+b8 VZKR_WaitAsyncIo(VZKR_AsyncIo io, i32 timeoutNs)
+{
+    VZKR_Internal_AsyncIo* internal = (VZKR_Internal_AsyncIo*) io.handle;
+    if (!internal) return false;
+
+    // parked ones don't count, so waiting on the ones behind them isn't cut short
+    if (internal->numInFlight == internal->numParked) return internal->numParked > 0;
+
+    #if PNSLR_LINUX
+        if (internal->native)
+        {
+            VZKR_Internal_AsyncIoFlushRing(internal);
+            if (*internal->cqHead != VZKR_AtomicLoadU32(internal->cqTail, VZKR_MemoryOrder_Acquire)) return true;
+
+            // the ring's fd becomes readable once there are completions
+            struct pollfd pfd = {.fd = internal->ringFd, .events = POLLIN};
+            int timeoutMs = (timeoutNs < 0) ? -1 : (int) (((i64) timeoutNs + 999999) / 1000000);
+            int res;
+            do { res = poll(&pfd, 1, timeoutMs); } while (res < 0 && errno == EINTR);
+
+            return *internal->cqHead != VZKR_AtomicLoadU32(internal->cqTail, VZKR_MemoryOrder_Acquire);
+        }
+    #endif
+
+    VZKR_LockProfiledMutex(&internal->mutex);
+    if (internal->completedCount == 0)
+    {
+        if (timeoutNs < 0)
+        {
+            while (internal->completedCount == 0) { VZKR_WaitProfiledConditionVariable(&internal->workCompleted, &internal->mutex); }
+        }
+        else
+        {
+            VZKR_WaitProfiledConditionVariableTimeout(&internal->workCompleted, &internal->mutex, timeoutNs);
+        }
+    }
+
+    b8 ready = (internal->completedCount > 0);
+    VZKR_UnlockProfiledMutex(&internal->mutex);
+    return ready;
+}
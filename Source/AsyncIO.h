@@ -0,0 +1,174 @@
+#ifndef VZKR_ASYNC_IO_H // =========================================================
+#define VZKR_ASYNC_IO_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Async I/O Declaration ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A cross-platform opaque handle to an async I/O engine.
+ * Uses io_uring on Linux where available, and a pool of worker threads otherwise.
+ *
+ * Submitting, polling and waiting must all happen on the same thread (typically the
+ * one running the frame loop); the I/O itself never blocks that thread.
+ */
+typedef struct VZKR_AsyncIo
+{
+    rawptr handle;
+} VZKR_AsyncIo;
+
+/**
+ * The kind of operation an async I/O request performs.
+ */
+typedef u8 VZKR_AsyncIoOp /* use as value */;
+#define VZKR_AsyncIoOp_Read ((VZKR_AsyncIoOp) 0)
+#define VZKR_AsyncIoOp_Write ((VZKR_AsyncIoOp) 1)
+#define VZKR_AsyncIoOp_OpenToRead ((VZKR_AsyncIoOp) 2)
+#define VZKR_AsyncIoOp_OpenToWrite ((VZKR_AsyncIoOp) 3)
+#define VZKR_AsyncIoOp_Close ((VZKR_AsyncIoOp) 4)
+#define VZKR_AsyncIoOp_Stat ((VZKR_AsyncIoOp) 5)
+
+/**
+ * The result of a finished async I/O request.
+ * 'result' is the number of bytes transferred for reads/writes, and the size of the
+ * file for stats. 'file' is the opened file for opens.
+ */
+typedef struct VZKR_AsyncIoCompletion
+{
+    rawptr userData;
+    VZKR_AsyncIoOp op;
+    b8 success;
+    i64 result;
+    PNSLR_File file;
+} VZKR_AsyncIoCompletion;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_AsyncIoCompletion);
+
+/**
+ * The signature of the delegate that's called when a request finishes.
+ * Always called on the thread that polls the engine.
+ */
+typedef void (*VZKR_AsyncIoCallback)(
+    rawptr userData,
+    VZKR_AsyncIoCompletion completion
+);
+
+/**
+ * A single async I/O request.
+ *
+ * Reads and writes use 'file', 'buffer' and the absolute 'offset' in the file, and leave
+ * the file's cursor alone (as `VZKR_ReadFromFileAt` does, with the same caveat on Windows).
+ * They transfer at most 2GB, and reads can be short at the end of the file. Opens and
+ * stats use 'path', closes use 'file'. Opening to write creates the file if needed, and
+ * truncates it unless 'append' is set.
+ *
+ * The buffer (and the path, for the thread-pool backend) must stay alive until the
+ * request completes.
+ *
+ * If 'callback' is set, it's called with the completion, otherwise the completion
+ * is returned by `VZKR_PollAsyncIo`.
+ */
+typedef struct VZKR_AsyncIoRequest
+{
+    VZKR_AsyncIoOp op;
+    b8 append;
+    PNSLR_File file;
+    PNSLR_ArraySlice(u8) buffer;
+    i64 offset;
+    PNSLR_Path path;
+    rawptr userData;
+    VZKR_AsyncIoCallback callback;
+} VZKR_AsyncIoRequest;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_AsyncIoRequest);
+
+/**
+ * Options for creating an async I/O engine.
+ * 'queueDepth' is the maximum number of requests in flight at once (defaults to 256).
+ * 'numWorkerThreads' is only used by the thread-pool backend (defaults to 4).
+ * 'forceThreadPool' skips io_uring even where it's available.
+ */
+typedef struct VZKR_AsyncIoCreationOptions
+{
+    PNSLR_Allocator allocator;
+    i32 queueDepth;
+    i32 numWorkerThreads;
+    b8 forceThreadPool;
+} VZKR_AsyncIoCreationOptions;
+
+/**
+ * Creates an async I/O engine.
+ * If creation failed, the returned handle will be zeroed.
+ */
+VZKR_AsyncIo VZKR_CreateAsyncIo(
+    VZKR_AsyncIoCreationOptions options
+);
+
+/**
+ * Destroys an async I/O engine. Waits for every request in flight to finish first,
+ * dropping their completions without calling their callbacks.
+ */
+void VZKR_DestroyAsyncIo(
+    VZKR_AsyncIo* io
+);
+
+/**
+ * Checks whether the engine uses the OS' native async I/O (io_uring), rather than
+ * the thread-pool backend.
+ */
+b8 VZKR_IsAsyncIoNative(
+    VZKR_AsyncIo io
+);
+
+// Async I/O Submission ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Submits a batch of requests at once (a single syscall with io_uring).
+ * Submits nothing if there isn't enough room in the queue for the whole batch.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_SubmitAsyncIo(
+    VZKR_AsyncIo io,
+    PNSLR_ArraySlice(VZKR_AsyncIoRequest) requests
+);
+
+/**
+ * Gets the number of requests that were submitted but haven't been polled yet.
+ */
+i32 VZKR_GetNumAsyncIoInFlight(
+    VZKR_AsyncIo io
+);
+
+// Async I/O Completion ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Collects finished requests without blocking. Requests with a callback have it called,
+ * the rest are written to 'output' until it's full; anything left is kept back for the
+ * next poll (which returns those first), without holding up the callbacks behind it.
+ * Returns the number of completions written to 'output'.
+ */
+i32 VZKR_PollAsyncIo(
+    VZKR_AsyncIo io,
+    PNSLR_ArraySlice(VZKR_AsyncIoCompletion) output
+);
+
+/**
+ * Blocks until at least one request has finished, or the timeout expires.
+ * A negative timeout waits indefinitely. Completions kept back by an earlier poll are only
+ * waited for if nothing else is in flight (in which case it returns immediately), so poll
+ * until the output isn't filled to get them without waiting.
+ * Returns true if there's something to poll, false on timeout or if nothing's in flight.
+ */
+b8 VZKR_WaitAsyncIo(
+    VZKR_AsyncIo io,
+    i32 timeoutNs
+);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_ASYNC_IO_H ==========================================================
@@ -0,0 +1,520 @@
+#define VZKR_IMPLEMENTATION
+#include "Atomics.h"
+
+// Atomic Operations ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// these are small enough that the unity build inlines them wherever the order is a
+// constant, which then also folds the switch between orders away
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    // every interlocked operation is a full barrier already, so only plain loads and
+    // stores need any help
+
+    #define VZKR_INTERNAL_DEFINE_ATOMIC_INTEGER(suffix, ty, interlockedTy, interlockedSuffix) \
+        ty VZKR_AtomicLoad##suffix(ty* value, VZKR_MemoryOrder order) \
+        { \
+            ty result = *(volatile ty*) value; \
+            if (order != VZKR_MemoryOrder_Relaxed && order != VZKR_MemoryOrder_Release) MemoryBarrier(); \
+            return result; \
+        } \
+        void VZKR_AtomicStore##suffix(ty* value, ty newValue, VZKR_MemoryOrder order) \
+        { \
+            if (order != VZKR_MemoryOrder_Relaxed && order != VZKR_MemoryOrder_Acquire) MemoryBarrier(); \
+            *(volatile ty*) value = newValue; \
+            if (order == VZKR_MemoryOrder_SequentiallyConsistent) MemoryBarrier(); \
+        } \
+        ty VZKR_AtomicExchange##suffix(ty* value, ty newValue, VZKR_MemoryOrder order) \
+        { \
+            (void) order; return (ty) InterlockedExchange##interlockedSuffix((volatile interlockedTy*) value, (interlockedTy) newValue); \
+        } \
+        b8 VZKR_AtomicCompareExchange##suffix(ty* value, ty* expected, ty desired, VZKR_MemoryOrder order) \
+        { \
+            (void) order; \
+            ty previous = (ty) InterlockedCompareExchange##interlockedSuffix((volatile interlockedTy*) value, (interlockedTy) desired, (interlockedTy) *expected); \
+            if (previous == *expected) return true; \
+            *expected = previous; \
+            return false; \
+        } \
+        ty VZKR_AtomicFetchAdd##suffix(ty* value, ty delta, VZKR_MemoryOrder order) \
+        { \
+            (void) order; return (ty) InterlockedExchangeAdd##interlockedSuffix((volatile interlockedTy*) value, (interlockedTy) delta); \
+        } \
+        ty VZKR_AtomicFetchSub##suffix(ty* value, ty delta, VZKR_MemoryOrder order) \
+        { \
+            (void) order; return (ty) InterlockedExchangeAdd##interlockedSuffix((volatile interlockedTy*) value, (interlockedTy) (0 - delta)); \
+        } \
+        ty VZKR_AtomicFetchAnd##suffix(ty* value, ty bits, VZKR_MemoryOrder order) \
+        { \
+            (void) order; return (ty) InterlockedAnd##interlockedSuffix((volatile interlockedTy*) value, (interlockedTy) bits); \
+        } \
+        ty VZKR_AtomicFetchOr##suffix(ty* value, ty bits, VZKR_MemoryOrder order) \
+        { \
+            (void) order; return (ty) InterlockedOr##interlockedSuffix((volatile interlockedTy*) value, (interlockedTy) bits); \
+        }
+
+    VZKR_INTERNAL_DEFINE_ATOMIC_INTEGER(I32, i32, LONG, )
+    VZKR_INTERNAL_DEFINE_ATOMIC_INTEGER(U32, u32, LONG, )
+    VZKR_INTERNAL_DEFINE_ATOMIC_INTEGER(I64, i64, LONG64, 64)
+    VZKR_INTERNAL_DEFINE_ATOMIC_INTEGER(U64, u64, LONG64, 64)
+
+    rawptr VZKR_AtomicLoadPtr(rawptr* value, VZKR_MemoryOrder order)
+    {
+        rawptr result = *(rawptr volatile*) value;
+        if (order != VZKR_MemoryOrder_Relaxed && order != VZKR_MemoryOrder_Release) MemoryBarrier();
+        return result;
+    }
+
+    void VZKR_AtomicStorePtr(rawptr* value, rawptr newValue, VZKR_MemoryOrder order)
+    {
+        if (order != VZKR_MemoryOrder_Relaxed && order != VZKR_MemoryOrder_Acquire) MemoryBarrier();
+        *(rawptr volatile*) value = newValue;
+        if (order == VZKR_MemoryOrder_SequentiallyConsistent) MemoryBarrier();
+    }
+
+    rawptr VZKR_AtomicExchangePtr(rawptr* value, rawptr newValue, VZKR_MemoryOrder order)
+    {
+        (void) order; return InterlockedExchangePointer((PVOID volatile*) value, newValue);
+    }
+
+    b8 VZKR_AtomicCompareExchangePtr(rawptr* value, rawptr* expected, rawptr desired, VZKR_MemoryOrder order)
+    {
+        (void) order;
+        rawptr previous = InterlockedCompareExchangePointer((PVOID volatile*) value, desired, *expected);
+        if (previous == *expected) return true;
+        *expected = previous;
+        return false;
+    }
+
+    void VZKR_AtomicFence(VZKR_MemoryOrder order)
+    {
+        if (order != VZKR_MemoryOrder_Relaxed) MemoryBarrier();
+    }
+#else
+    static i32 VZKR_Internal_LoadOrder(VZKR_MemoryOrder order)
+    {
+        switch (order)
+        {
+            case VZKR_MemoryOrder_Relaxed:        return __ATOMIC_RELAXED;
+            case VZKR_MemoryOrder_Acquire:        return __ATOMIC_ACQUIRE;
+            case VZKR_MemoryOrder_Release:        return __ATOMIC_RELAXED;
+            case VZKR_MemoryOrder_AcquireRelease: return __ATOMIC_ACQUIRE;
+            default:                              return __ATOMIC_SEQ_CST;
+        }
+    }
+
+    static i32 VZKR_Internal_StoreOrder(VZKR_MemoryOrder order)
+    {
+        switch (order)
+        {
+            case VZKR_MemoryOrder_Relaxed:        return __ATOMIC_RELAXED;
+            case VZKR_MemoryOrder_Acquire:        return __ATOMIC_RELAXED;
+            case VZKR_MemoryOrder_Release:        return __ATOMIC_RELEASE;
+            case VZKR_MemoryOrder_AcquireRelease: return __ATOMIC_RELEASE;
+            default:                              return __ATOMIC_SEQ_CST;
+        }
+    }
+
+    static i32 VZKR_Internal_ReadModifyWriteOrder(VZKR_MemoryOrder order)
+    {
+        switch (order)
+        {
+            case VZKR_MemoryOrder_Relaxed:        return __ATOMIC_RELAXED;
+            case VZKR_MemoryOrder_Acquire:        return __ATOMIC_ACQUIRE;
+            case VZKR_MemoryOrder_Release:        return __ATOMIC_RELEASE;
+            case VZKR_MemoryOrder_AcquireRelease: return __ATOMIC_ACQ_REL;
+            default:                              return __ATOMIC_SEQ_CST;
+        }
+    }
+
+    #define VZKR_INTERNAL_DEFINE_ATOMIC_INTEGER(suffix, ty) \
+        ty VZKR_AtomicLoad##suffix(ty* value, VZKR_MemoryOrder order) \
+        { \
+            return __atomic_load_n(value, VZKR_Internal_LoadOrder(order)); \
+        } \
+        void VZKR_AtomicStore##suffix(ty* value, ty newValue, VZKR_MemoryOrder order) \
+        { \
+            __atomic_store_n(value, newValue, VZKR_Internal_StoreOrder(order)); \
+        } \
+        ty VZKR_AtomicExchange##suffix(ty* value, ty newValue, VZKR_MemoryOrder order) \
+        { \
+            return __atomic_exchange_n(value, newValue, VZKR_Internal_ReadModifyWriteOrder(order)); \
+        } \
+        b8 VZKR_AtomicCompareExchange##suffix(ty* value, ty* expected, ty desired, VZKR_MemoryOrder order) \
+        { \
+            return __atomic_compare_exchange_n(value, expected, desired, false, VZKR_Internal_ReadModifyWriteOrder(order), VZKR_Internal_LoadOrder(order)); \
+        } \
+        ty VZKR_AtomicFetchAdd##suffix(ty* value, ty delta, VZKR_MemoryOrder order) \
+        { \
+            return __atomic_fetch_add(value, delta, VZKR_Internal_ReadModifyWriteOrder(order)); \
+        } \
+        ty VZKR_AtomicFetchSub##suffix(ty* value, ty delta, VZKR_MemoryOrder order) \
+        { \
+            return __atomic_fetch_sub(value, delta, VZKR_Internal_ReadModifyWriteOrder(order)); \
+        } \
+        ty VZKR_AtomicFetchAnd##suffix(ty* value, ty bits, VZKR_MemoryOrder order) \
+        { \
+            return __atomic_fetch_and(value, bits, VZKR_Internal_ReadModifyWriteOrder(order)); \
+        } \
+        ty VZKR_AtomicFetchOr##suffix(ty* value, ty bits, VZKR_MemoryOrder order) \
+        { \
+            return __atomic_fetch_or(value, bits, VZKR_Internal_ReadModifyWriteOrder(order)); \
+        }
+
+    VZKR_INTERNAL_DEFINE_ATOMIC_INTEGER(I32, i32)
+    VZKR_INTERNAL_DEFINE_ATOMIC_INTEGER(U32, u32)
+    VZKR_INTERNAL_DEFINE_ATOMIC_INTEGER(I64, i64)
+    VZKR_INTERNAL_DEFINE_ATOMIC_INTEGER(U64, u64)
+
+    rawptr VZKR_AtomicLoadPtr(rawptr* value, VZKR_MemoryOrder order)
+    {
+        return __atomic_load_n(value, VZKR_Internal_LoadOrder(order));
+    }
+
+    void VZKR_AtomicStorePtr(rawptr* value, rawptr newValue, VZKR_MemoryOrder order)
+    {
+        __atomic_store_n(value, newValue, VZKR_Internal_StoreOrder(order));
+    }
+
+    rawptr VZKR_AtomicExchangePtr(rawptr* value, rawptr newValue, VZKR_MemoryOrder order)
+    {
+        return __atomic_exchange_n(value, newValue, VZKR_Internal_ReadModifyWriteOrder(order));
+    }
+
+    b8 VZKR_AtomicCompareExchangePtr(rawptr* value, rawptr* expected, rawptr desired, VZKR_MemoryOrder order)
+    {
+        return __atomic_compare_exchange_n(value, expected, desired, false, VZKR_Internal_ReadModifyWriteOrder(order), VZKR_Internal_LoadOrder(order));
+    }
+
+    void VZKR_AtomicFence(VZKR_MemoryOrder order)
+    {
+        __atomic_thread_fence(VZKR_Internal_ReadModifyWriteOrder(order));
+    }
+#endif
+
+#undef VZKR_INTERNAL_DEFINE_ATOMIC_INTEGER
+
+void VZKR_CpuRelax(void)
+{
+    #if PNSLR_X64
+        _mm_pause();
+    #elif PNSLR_ARM64 && defined(_MSC_VER) && !defined(__clang__)
+        __yield();
+    #elif PNSLR_ARM64
+        __asm__ __volatile__("yield");
+    #endif
+}
+
+// Epoch-Based Reclamation ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_EPOCH_DEFAULT_PARTICIPANTS 64
+#define VZKR_INTERNAL_EPOCH_RETIRES_PER_RECLAIM  64
+
+typedef struct VZKR_Internal_RetiredPointer
+{
+    rawptr pointer;
+    VZKR_EpochReclaimProcedure procedure; // nil if it's just to be freed
+    rawptr userData;
+    PNSLR_Allocator allocator;
+    u64 epoch;
+} VZKR_Internal_RetiredPointer;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_Internal_RetiredPointer);
+
+/**
+ * 'state' is the epoch it last entered, shifted up one, with the lowest bit set while it's
+ * inside it. The first cache line is what everyone else reads; the rest is the owner's.
+ */
+typedef struct VZKR_Internal_EpochParticipant
+{
+    u64 state;
+    u64 inUse;
+    VZKR_CACHE_LINE_PADDING(sharedPadding, 16);
+    struct VZKR_Internal_EpochDomain* domain;
+    i32 nesting;
+    i32 retiresSinceReclaim;
+    PNSLR_ArraySlice(VZKR_Internal_RetiredPointer) retired; // all of its capacity
+    i64 numRetired;
+    VZKR_CACHE_LINE_PADDING(ownerPadding, 40);
+} VZKR_Internal_EpochParticipant;
+
+/** What participants leave behind is kept under the lock, until it's safe to reclaim. */
+typedef struct VZKR_Internal_EpochDomain
+{
+    u64 epoch;
+    VZKR_CACHE_LINE_PADDING(epochPadding, 8);
+    PNSLR_Allocator allocator;
+    VZKR_Internal_EpochParticipant* participants;
+    i32 numParticipants;
+    VZKR_ProfiledMutex orphansMutex;
+    PNSLR_ArraySlice(VZKR_Internal_RetiredPointer) orphans;
+    i64 numOrphans;
+} VZKR_Internal_EpochDomain;
+
+/** Returns false if the list couldn't grow, in which case nothing was added. */
+static b8 VZKR_Internal_AppendRetired(PNSLR_ArraySlice(VZKR_Internal_RetiredPointer)* list, i64* count, VZKR_Internal_RetiredPointer retired, PNSLR_Allocator allocator)
+{
+    if (*count == list->count)
+    {
+        PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+        PNSLR_ResizeSlice(VZKR_Internal_RetiredPointer, list, list->count ? list->count * 2 : 64, false, allocator, PNSLR_GET_LOC(), &err);
+        if (err != PNSLR_AllocatorError_None) return false;
+    }
+
+    list->data[(*count)++] = retired;
+    return true;
+}
+
+/** Reclaims everything retired two or more epochs ago (or all of it), keeping the rest. */
+static void VZKR_Internal_ReclaimRetired(VZKR_Internal_RetiredPointer* retired, i64* count, u64 epoch, b8 everything)
+{
+    i64 numKept = 0;
+    for (i64 i = 0; i < *count; i++)
+    {
+        if (!everything && retired[i].epoch + 2 > epoch) { retired[numKept++] = retired[i]; continue; }
+
+        if (retired[i].procedure) retired[i].procedure(retired[i].pointer, retired[i].userData);
+        else                      PNSLR_Free(retired[i].allocator, retired[i].pointer, PNSLR_GET_LOC(), nil);
+    }
+
+    *count = numKept;
+}
+
+/** Moves the global epoch on if every participant inside an epoch is in the current one. */
+static u64 VZKR_Internal_TryAdvanceEpoch(VZKR_Internal_EpochDomain* domain)
+{
+    u64 epoch = VZKR_AtomicLoadU64(&domain->epoch, VZKR_MemoryOrder_SequentiallyConsistent);
+    for (i32 i = 0; i < domain->numParticipants; i++)
+    {
+        VZKR_Internal_EpochParticipant* participant = &domain->participants[i];
+        if (!VZKR_AtomicLoadU64(&participant->inUse, VZKR_MemoryOrder_Acquire)) continue;
+
+        u64 state = VZKR_AtomicLoadU64(&participant->state, VZKR_MemoryOrder_SequentiallyConsistent);
+        if ((state & 1) && (state >> 1) != epoch) return epoch;
+    }
+
+    // losing the race just means someone else moved it on
+    VZKR_AtomicCompareExchangeU64(&domain->epoch, &epoch, epoch + 1, VZKR_MemoryOrder_SequentiallyConsistent);
+    return VZKR_AtomicLoadU64(&domain->epoch, VZKR_MemoryOrder_SequentiallyConsistent);
+}
+
+VZKR_EpochDomain VZKR_CreateEpochDomain(i32 maxParticipants, PNSLR_Allocator allocator)
+{
+    if (maxParticipants <= 0) maxParticipants = VZKR_INTERNAL_EPOCH_DEFAULT_PARTICIPANTS;
+    if ((i64) maxParticipants * (i64) sizeof(VZKR_Internal_EpochParticipant) > 0x7FFFFFFF) return (VZKR_EpochDomain) {0};
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_EpochDomain* domain = (VZKR_Internal_EpochDomain*) PNSLR_Allocate(allocator, true, (i32) sizeof(VZKR_Internal_EpochDomain), VZKR_CACHE_LINE_SIZE, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !domain) return (VZKR_EpochDomain) {0};
+
+    domain->participants = (VZKR_Internal_EpochParticipant*) PNSLR_Allocate(allocator, true, maxParticipants * (i32) sizeof(VZKR_Internal_EpochParticipant), VZKR_CACHE_LINE_SIZE, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !domain->participants)
+    {
+        PNSLR_Free(allocator, domain, PNSLR_GET_LOC(), nil);
+        return (VZKR_EpochDomain) {0};
+    }
+
+    domain->allocator       = allocator;
+    domain->numParticipants = maxParticipants;
+    domain->orphansMutex    = VZKR_CreateProfiledMutex(PNSLR_GET_LOC());
+    for (i32 i = 0; i < maxParticipants; i++) domain->participants[i].domain = domain;
+
+    return (VZKR_EpochDomain) {.handle = (rawptr) domain};
+}
+
+void VZKR_DestroyEpochDomain(VZKR_EpochDomain* domain)
+{
+    if (!domain || !domain->handle) return;
+    VZKR_Internal_EpochDomain* internal = (VZKR_Internal_EpochDomain*) domain->handle;
+
+    for (i32 i = 0; i < internal->numParticipants; i++)
+    {
+        VZKR_Internal_EpochParticipant* participant = &internal->participants[i];
+        VZKR_Internal_ReclaimRetired(participant->retired.data, &participant->numRetired, 0, true);
+        PNSLR_FreeSlice(&participant->retired, internal->allocator, PNSLR_GET_LOC(), nil);
+    }
+
+    VZKR_Internal_ReclaimRetired(internal->orphans.data, &internal->numOrphans, 0, true);
+    PNSLR_FreeSlice(&internal->orphans, internal->allocator, PNSLR_GET_LOC(), nil);
+
+    VZKR_DestroyProfiledMutex(&internal->orphansMutex);
+    PNSLR_Free(internal->allocator, internal->participants, PNSLR_GET_LOC(), nil);
+    PNSLR_Free(internal->allocator, internal, PNSLR_GET_LOC(), nil);
+    *domain = (VZKR_EpochDomain) {0};
+}
+
+VZKR_EpochParticipant VZKR_JoinEpochDomain(VZKR_EpochDomain domain)
+{
+    if (!domain.handle) return (VZKR_EpochParticipant) {0};
+    VZKR_Internal_EpochDomain* internal = (VZKR_Internal_EpochDomain*) domain.handle;
+
+    for (i32 i = 0; i < internal->numParticipants; i++)
+    {
+        VZKR_Internal_EpochParticipant* participant = &internal->participants[i];
+
+        u64 expected = 0;
+        if (VZKR_AtomicCompareExchangeU64(&participant->inUse, &expected, 1, VZKR_MemoryOrder_SequentiallyConsistent))
+        {
+            return (VZKR_EpochParticipant) {.handle = (rawptr) participant};
+        }
+    }
+
+    return (VZKR_EpochParticipant) {0};
+}
+
+void VZKR_LeaveEpochDomain(VZKR_EpochParticipant* participant)
+{
+    if (!participant || !participant->handle) return;
+    VZKR_Internal_EpochParticipant* internal = (VZKR_Internal_EpochParticipant*) participant->handle;
+    VZKR_Internal_EpochDomain*      domain   = internal->domain;
+
+    internal->nesting = 0;
+    VZKR_AtomicStoreU64(&internal->state, 0, VZKR_MemoryOrder_Release);
+    VZKR_ReclaimEpochs(*participant);
+
+    if (internal->numRetired > 0)
+    {
+        VZKR_LockProfiledMutex(&domain->orphansMutex);
+
+        i64 numOrphans = domain->numOrphans, numKept = 0;
+        for (i64 i = 0; i < internal->numRetired; i++)
+        {
+            VZKR_Internal_RetiredPointer retired = internal->retired.data[i];
+            if (!VZKR_Internal_AppendRetired(&domain->orphans, &numOrphans, retired, domain->allocator)) internal->retired.data[numKept++] = retired;
+        }
+
+        VZKR_AtomicStoreI64(&domain->numOrphans, numOrphans, VZKR_MemoryOrder_Relaxed);
+        VZKR_UnlockProfiledMutex(&domain->orphansMutex);
+        internal->numRetired = numKept;
+    }
+
+    // whatever there was no room to hand over gets waited out instead; this participant
+    // is outside any epoch by now, so it doesn't hold the others up
+    while (internal->numRetired > 0)
+    {
+        VZKR_YieldThread();
+        u64 epoch = VZKR_Internal_TryAdvanceEpoch(domain);
+        VZKR_Internal_ReclaimRetired(internal->retired.data, &internal->numRetired, epoch, false);
+    }
+
+    PNSLR_FreeSlice(&internal->retired, domain->allocator, PNSLR_GET_LOC(), nil);
+    internal->retired             = (PNSLR_ArraySlice(VZKR_Internal_RetiredPointer)) {0};
+    internal->numRetired          = 0;
+    internal->retiresSinceReclaim = 0;
+    VZKR_AtomicStoreU64(&internal->inUse, 0, VZKR_MemoryOrder_Release);
+    *participant = (VZKR_EpochParticipant) {0};
+}
+
+void VZKR_EnterEpoch(VZKR_EpochParticipant participant)
+{
+    if (!participant.handle) return;
+    VZKR_Internal_EpochParticipant* internal = (VZKR_Internal_EpochParticipant*) participant.handle;
+
+    if (internal->nesting++ > 0) return;
+
+    // the fence keeps every read of the shared structure after the epoch is published,
+    // so anything unlinked before then can't be seen
+    u64 epoch = VZKR_AtomicLoadU64(&internal->domain->epoch, VZKR_MemoryOrder_Relaxed);
+    VZKR_AtomicStoreU64(&internal->state, (epoch << 1) | 1, VZKR_MemoryOrder_Relaxed);
+    VZKR_AtomicFence(VZKR_MemoryOrder_SequentiallyConsistent);
+}
+
+void VZKR_ExitEpoch(VZKR_EpochParticipant participant)
+{
+    if (!participant.handle) return;
+    VZKR_Internal_EpochParticipant* internal = (VZKR_Internal_EpochParticipant*) participant.handle;
+
+    if (internal->nesting <= 0 || --internal->nesting > 0) return;
+
+    u64 state = VZKR_AtomicLoadU64(&internal->state, VZKR_MemoryOrder_Relaxed);
+    VZKR_AtomicStoreU64(&internal->state, state & ~(u64) 1, VZKR_MemoryOrder_Release);
+}
+
+static b8 VZKR_Internal_Retire(VZKR_EpochParticipant participant, VZKR_Internal_RetiredPointer retired)
+{
+    VZKR_Internal_EpochParticipant* internal = (VZKR_Internal_EpochParticipant*) participant.handle;
+
+    // the fence keeps the epoch from being read before the caller's unlinking
+    VZKR_AtomicFence(VZKR_MemoryOrder_SequentiallyConsistent);
+    retired.epoch = VZKR_AtomicLoadU64(&internal->domain->epoch, VZKR_MemoryOrder_Relaxed);
+
+    if (!VZKR_Internal_AppendRetired(&internal->retired, &internal->numRetired, retired, internal->domain->allocator)) return false;
+
+    if (++internal->retiresSinceReclaim >= VZKR_INTERNAL_EPOCH_RETIRES_PER_RECLAIM) VZKR_ReclaimEpochs(participant);
+    return true;
+}
+
+b8 VZKR_RetireInEpoch(
+    VZKR_EpochParticipant participant,
+    rawptr pointer,
+    VZKR_EpochReclaimProcedure procedure,
+    rawptr userData
+)
+{
+    if (!participant.handle || !procedure) return false;
+
+    return VZKR_Internal_Retire(participant, (VZKR_Internal_RetiredPointer) {.pointer = pointer, .procedure = procedure, .userData = userData});
+}
+
+b8 VZKR_RetireAllocationInEpoch(
+    VZKR_EpochParticipant participant,
+    rawptr pointer,
+    PNSLR_Allocator allocator
+)
+{
+    if (!participant.handle) return false;
+    if (!pointer) return true;
+
+    return VZKR_Internal_Retire(participant, (VZKR_Internal_RetiredPointer) {.pointer = pointer, .allocator = allocator});
+}
+
+void VZKR_ReclaimEpochs(VZKR_EpochParticipant participant)
+{
+    if (!participant.handle) return;
+    VZKR_Internal_EpochParticipant* internal = (VZKR_Internal_EpochParticipant*) participant.handle;
+    VZKR_Internal_EpochDomain*      domain   = internal->domain;
+
+    internal->retiresSinceReclaim = 0;
+    u64 epoch = VZKR_Internal_TryAdvanceEpoch(domain);
+    VZKR_Internal_ReclaimRetired(internal->retired.data, &internal->numRetired, epoch, false);
+
+    if (VZKR_AtomicLoadI64(&domain->numOrphans, VZKR_MemoryOrder_Relaxed) > 0 && VZKR_TryLockProfiledMutex(&domain->orphansMutex))
+    {
+        i64 numOrphans = domain->numOrphans;
+        VZKR_Internal_ReclaimRetired(domain->orphans.data, &numOrphans, epoch, false);
+        VZKR_AtomicStoreI64(&domain->numOrphans, numOrphans, VZKR_MemoryOrder_Relaxed);
+        VZKR_UnlockProfiledMutex(&domain->orphansMutex);
+    }
+}
+
+// Published Pointers ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+rawptr VZKR_ReadPublishedPointer(VZKR_PublishedPointer* published)
+{
+    if (!published) return nil;
+
+    return VZKR_AtomicLoadPtr(&published->pointer, VZKR_MemoryOrder_Acquire);
+}
+
+b8 VZKR_PublishPointer(
+    VZKR_EpochParticipant participant,
+    VZKR_PublishedPointer* published,
+    rawptr pointer,
+    PNSLR_Allocator allocator
+)
+{
+    if (!participant.handle || !published) return false;
+    VZKR_Internal_EpochParticipant* internal = (VZKR_Internal_EpochParticipant*) participant.handle;
+
+    // make room to retire the old one first, so it can't fail once it's been swapped out
+    if (internal->numRetired == internal->retired.count)
+    {
+        PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+        PNSLR_ResizeSlice(VZKR_Internal_RetiredPointer, &internal->retired, internal->retired.count ? internal->retired.count * 2 : 64, false, internal->domain->allocator, PNSLR_GET_LOC(), &err);
+        if (err != PNSLR_AllocatorError_None) return false;
+    }
+
+    // release, so whatever was written into the new one is there for readers that get it;
+    // acquire, so the old one is done being written to by whoever published it
+    rawptr previous = VZKR_AtomicExchangePtr(&published->pointer, pointer, VZKR_MemoryOrder_AcquireRelease);
+    return VZKR_RetireAllocationInEpoch(participant, previous, allocator);
+}
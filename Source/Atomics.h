@@ -0,0 +1,566 @@
+#ifndef VZKR_ATOMICS_H // ==========================================================
+#define VZKR_ATOMICS_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Memory Orders ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * How an atomic operation orders the memory accesses around it, as in C11.
+ * Relaxed ones only make the operation itself atomic. An acquire load keeps later
+ * accesses after it, and a release store keeps earlier ones before it, so a release store
+ * seen by an acquire load publishes everything written before it. Sequentially consistent
+ * operations also agree on a single order among themselves.
+ *
+ * Loads treat release as relaxed and acquire-release as acquire; stores treat acquire as
+ * relaxed and acquire-release as release.
+ */
+typedef u8 VZKR_MemoryOrder /* use as value */;
+#define VZKR_MemoryOrder_Relaxed ((VZKR_MemoryOrder) 0)
+#define VZKR_MemoryOrder_Acquire ((VZKR_MemoryOrder) 1)
+#define VZKR_MemoryOrder_Release ((VZKR_MemoryOrder) 2)
+#define VZKR_MemoryOrder_AcquireRelease ((VZKR_MemoryOrder) 3)
+#define VZKR_MemoryOrder_SequentiallyConsistent ((VZKR_MemoryOrder) 4)
+
+// Atomic i32 ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Atomically loads a value. Every atomic operation needs the value to be naturally aligned.
+ */
+i32 VZKR_AtomicLoadI32(
+    i32* value,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically stores a value.
+ */
+void VZKR_AtomicStoreI32(
+    i32* value,
+    i32 newValue,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically replaces a value, returning the previous one.
+ */
+i32 VZKR_AtomicExchangeI32(
+    i32* value,
+    i32 newValue,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically replaces a value with 'desired' if it's still 'expected'.
+ * Returns true if it was replaced; otherwise stores the current value in 'expected'.
+ * Failing only orders like a load would (so release becomes relaxed).
+ */
+b8 VZKR_AtomicCompareExchangeI32(
+    i32* value,
+    i32* expected,
+    i32 desired,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically adds to a value (wrapping around), returning the previous one.
+ */
+i32 VZKR_AtomicFetchAddI32(
+    i32* value,
+    i32 delta,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically subtracts from a value (wrapping around), returning the previous one.
+ */
+i32 VZKR_AtomicFetchSubI32(
+    i32* value,
+    i32 delta,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically ANDs bits into a value, returning the previous one.
+ */
+i32 VZKR_AtomicFetchAndI32(
+    i32* value,
+    i32 bits,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically ORs bits into a value, returning the previous one.
+ */
+i32 VZKR_AtomicFetchOrI32(
+    i32* value,
+    i32 bits,
+    VZKR_MemoryOrder order
+);
+
+// Atomic u32 ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Atomically loads a value.
+ */
+u32 VZKR_AtomicLoadU32(
+    u32* value,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically stores a value.
+ */
+void VZKR_AtomicStoreU32(
+    u32* value,
+    u32 newValue,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically replaces a value, returning the previous one.
+ */
+u32 VZKR_AtomicExchangeU32(
+    u32* value,
+    u32 newValue,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically replaces a value with 'desired' if it's still 'expected'.
+ * Returns true if it was replaced; otherwise stores the current value in 'expected'.
+ */
+b8 VZKR_AtomicCompareExchangeU32(
+    u32* value,
+    u32* expected,
+    u32 desired,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically adds to a value (wrapping around), returning the previous one.
+ */
+u32 VZKR_AtomicFetchAddU32(
+    u32* value,
+    u32 delta,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically subtracts from a value (wrapping around), returning the previous one.
+ */
+u32 VZKR_AtomicFetchSubU32(
+    u32* value,
+    u32 delta,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically ANDs bits into a value, returning the previous one.
+ */
+u32 VZKR_AtomicFetchAndU32(
+    u32* value,
+    u32 bits,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically ORs bits into a value, returning the previous one.
+ */
+u32 VZKR_AtomicFetchOrU32(
+    u32* value,
+    u32 bits,
+    VZKR_MemoryOrder order
+);
+
+// Atomic i64 ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Atomically loads a value.
+ */
+i64 VZKR_AtomicLoadI64(
+    i64* value,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically stores a value.
+ */
+void VZKR_AtomicStoreI64(
+    i64* value,
+    i64 newValue,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically replaces a value, returning the previous one.
+ */
+i64 VZKR_AtomicExchangeI64(
+    i64* value,
+    i64 newValue,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically replaces a value with 'desired' if it's still 'expected'.
+ * Returns true if it was replaced; otherwise stores the current value in 'expected'.
+ */
+b8 VZKR_AtomicCompareExchangeI64(
+    i64* value,
+    i64* expected,
+    i64 desired,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically adds to a value (wrapping around), returning the previous one.
+ */
+i64 VZKR_AtomicFetchAddI64(
+    i64* value,
+    i64 delta,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically subtracts from a value (wrapping around), returning the previous one.
+ */
+i64 VZKR_AtomicFetchSubI64(
+    i64* value,
+    i64 delta,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically ANDs bits into a value, returning the previous one.
+ */
+i64 VZKR_AtomicFetchAndI64(
+    i64* value,
+    i64 bits,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically ORs bits into a value, returning the previous one.
+ */
+i64 VZKR_AtomicFetchOrI64(
+    i64* value,
+    i64 bits,
+    VZKR_MemoryOrder order
+);
+
+// Atomic u64 ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Atomically loads a value.
+ */
+u64 VZKR_AtomicLoadU64(
+    u64* value,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically stores a value.
+ */
+void VZKR_AtomicStoreU64(
+    u64* value,
+    u64 newValue,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically replaces a value, returning the previous one.
+ */
+u64 VZKR_AtomicExchangeU64(
+    u64* value,
+    u64 newValue,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically replaces a value with 'desired' if it's still 'expected'.
+ * Returns true if it was replaced; otherwise stores the current value in 'expected'.
+ */
+b8 VZKR_AtomicCompareExchangeU64(
+    u64* value,
+    u64* expected,
+    u64 desired,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically adds to a value (wrapping around), returning the previous one.
+ */
+u64 VZKR_AtomicFetchAddU64(
+    u64* value,
+    u64 delta,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically subtracts from a value (wrapping around), returning the previous one.
+ */
+u64 VZKR_AtomicFetchSubU64(
+    u64* value,
+    u64 delta,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically ANDs bits into a value, returning the previous one.
+ */
+u64 VZKR_AtomicFetchAndU64(
+    u64* value,
+    u64 bits,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically ORs bits into a value, returning the previous one.
+ */
+u64 VZKR_AtomicFetchOrU64(
+    u64* value,
+    u64 bits,
+    VZKR_MemoryOrder order
+);
+
+// Atomic Pointers ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Atomically loads a pointer.
+ */
+rawptr VZKR_AtomicLoadPtr(
+    rawptr* value,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically stores a pointer.
+ */
+void VZKR_AtomicStorePtr(
+    rawptr* value,
+    rawptr newValue,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically replaces a pointer, returning the previous one.
+ */
+rawptr VZKR_AtomicExchangePtr(
+    rawptr* value,
+    rawptr newValue,
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Atomically replaces a pointer with 'desired' if it's still 'expected'.
+ * Returns true if it was replaced; otherwise stores the current pointer in 'expected'.
+ */
+b8 VZKR_AtomicCompareExchangePtr(
+    rawptr* value,
+    rawptr* expected,
+    rawptr desired,
+    VZKR_MemoryOrder order
+);
+
+// Fences ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Orders the memory accesses around it without touching anything, like an atomic
+ * operation with the same order that everything else can synchronise with.
+ */
+void VZKR_AtomicFence(
+    VZKR_MemoryOrder order
+);
+
+/**
+ * Tells the core the calling thread is spin-waiting, so it can ease off for a moment
+ * (and let another hardware thread on the same core run).
+ */
+void VZKR_CpuRelax(void);
+
+// Cache Lines ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * The size of a cache line (or, on Apple's chips, of the pair the prefetcher brings in
+ * together), to keep data written by different threads apart.
+ */
+#if PNSLR_ARM64 && (PNSLR_OSX || PNSLR_IOS)
+    #define VZKR_CACHE_LINE_SIZE 128
+#else
+    #define VZKR_CACHE_LINE_SIZE 64
+#endif
+
+/**
+ * Declares an array of padding, so a struct's fields that take up 'usedBytes' of a cache
+ * line fill the rest of it. Allocate the struct aligned to the cache line size.
+ */
+#define VZKR_CACHE_LINE_PADDING(name, usedBytes) u8 name[VZKR_CACHE_LINE_SIZE - (usedBytes)]
+
+// Epoch-Based Reclamation ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A cross-platform opaque handle to an epoch domain, which lets readers walk a shared
+ * structure (like a dataset table, or a resource cache) without taking any locks, while
+ * writers swap parts of it out from under them.
+ *
+ * Readers do their reading inside an epoch. Writers unlink what they replace, and retire
+ * it instead of freeing it; it's only reclaimed once every reader that might still see it
+ * has left the epoch it was in. The global epoch moves on once every reader inside an
+ * epoch has caught up with it, so anything retired is reclaimed two epochs later.
+ *
+ * A reader that stays in an epoch for a long time holds back reclaiming everything.
+ */
+typedef struct VZKR_EpochDomain
+{
+    rawptr handle;
+} VZKR_EpochDomain;
+
+/**
+ * A cross-platform opaque handle to a thread's place in an epoch domain.
+ * Only the thread that joined may use it.
+ */
+typedef struct VZKR_EpochParticipant
+{
+    rawptr handle;
+} VZKR_EpochParticipant;
+
+/**
+ * The signature of the procedure that reclaims something retired.
+ */
+typedef void (*VZKR_EpochReclaimProcedure)(
+    rawptr pointer,
+    rawptr userData
+);
+
+/**
+ * Creates an epoch domain that up to 'maxParticipants' threads (64 if not positive) can
+ * take part in at once.
+ * The allocator must be thread-safe, since every participant keeps its retired pointers
+ * in it.
+ * If creating failed, the returned handle will be zeroed.
+ */
+VZKR_EpochDomain VZKR_CreateEpochDomain(
+    i32 maxParticipants,
+    PNSLR_Allocator allocator
+);
+
+/**
+ * Reclaims everything still retired, and frees an epoch domain.
+ * Every participant must have left it already.
+ */
+void VZKR_DestroyEpochDomain(
+    VZKR_EpochDomain* domain
+);
+
+/**
+ * Makes the calling thread a participant in an epoch domain.
+ * If the domain is full, the returned handle will be zeroed.
+ */
+VZKR_EpochParticipant VZKR_JoinEpochDomain(
+    VZKR_EpochDomain domain
+);
+
+/**
+ * Stops the calling thread from participating in an epoch domain. Whatever it retired
+ * that can't be reclaimed yet is handed over to the domain.
+ */
+void VZKR_LeaveEpochDomain(
+    VZKR_EpochParticipant* participant
+);
+
+/**
+ * Enters the current epoch, before reading the shared structure. Can be nested, in
+ * which case only the outermost one counts.
+ */
+void VZKR_EnterEpoch(
+    VZKR_EpochParticipant participant
+);
+
+/**
+ * Leaves the epoch entered last, once done with everything read from the shared structure.
+ */
+void VZKR_ExitEpoch(
+    VZKR_EpochParticipant participant
+);
+
+/**
+ * Retires something that's been unlinked from the shared structure, to be reclaimed with
+ * a procedure once no reader can still see it. Can be called inside an epoch, or outside.
+ * Every so often, this also tries to reclaim what was retired earlier.
+ * Returns true on success, false if there was no memory to keep track of it (in which
+ * case it's left to the caller).
+ */
+b8 VZKR_RetireInEpoch(
+    VZKR_EpochParticipant participant,
+    rawptr pointer,
+    VZKR_EpochReclaimProcedure procedure,
+    rawptr userData
+);
+
+/**
+ * Tries to move the global epoch on, and reclaims whatever the calling thread retired
+ * that's now safe to, including what was left behind by participants that left.
+ */
+void VZKR_ReclaimEpochs(
+    VZKR_EpochParticipant participant
+);
+
+/**
+ * Retires an allocation that's been unlinked from the shared structure, to be freed with
+ * an allocator (which must be thread-safe) once no reader can still see it.
+ * Returns true on success, false if there was no memory to keep track of it (in which
+ * case it's left to the caller).
+ */
+b8 VZKR_RetireAllocationInEpoch(
+    VZKR_EpochParticipant participant,
+    rawptr pointer,
+    PNSLR_Allocator allocator
+);
+
+// Published Pointers ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A pointer to an immutable snapshot of some read-mostly state (like a colour map, or a
+ * dataset's descriptor), which writers replace wholesale instead of changing in place.
+ * Zero-initialise it to create it.
+ *
+ * Readers enter an epoch, read the pointer, and use what it points to until they exit the
+ * epoch, without writing to anything shared. Writers build a new snapshot, publish it, and
+ * the old one gets freed once the last reader that might have it is done.
+ */
+typedef struct VZKR_PublishedPointer
+{
+    rawptr pointer;
+} VZKR_PublishedPointer;
+
+/**
+ * Reads a published pointer. Must be called inside an epoch, and what it points to must
+ * not be used (or changed) after exiting it.
+ */
+rawptr VZKR_ReadPublishedPointer(
+    VZKR_PublishedPointer* published
+);
+
+/**
+ * Replaces a published pointer, retiring the previous one (if any) to be freed with an
+ * allocator, which must be thread-safe and the one it was allocated with. Publish nil to
+ * retire the last one before getting rid of the published pointer.
+ * Writers that build the new snapshot from the current one must take turns themselves.
+ * Returns true on success, false if there was no memory to keep track of the previous
+ * one, in which case nothing was replaced.
+ */
+b8 VZKR_PublishPointer(
+    VZKR_EpochParticipant participant,
+    VZKR_PublishedPointer* published,
+    rawptr pointer,
+    PNSLR_Allocator allocator
+);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_ATOMICS_H ===========================================================
@@ -0,0 +1,180 @@
+#define VZKR_IMPLEMENTATION
+#include "Clock.h"
+
+// Monotonic Clock ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_NANOSECONDS_PER_SECOND 1000000000LL
+
+i64 VZKR_GetMonotonicTime(void)
+{
+    #if PNSLR_WINDOWS
+        LARGE_INTEGER counter, frequency;
+        QueryPerformanceCounter(&counter);
+        QueryPerformanceFrequency(&frequency);
+        return (counter.QuadPart / frequency.QuadPart) * VZKR_INTERNAL_NANOSECONDS_PER_SECOND
+            + (counter.QuadPart % frequency.QuadPart) * VZKR_INTERNAL_NANOSECONDS_PER_SECOND / frequency.QuadPart;
+    #elif PNSLR_UNIX
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (i64) now.tv_sec * VZKR_INTERNAL_NANOSECONDS_PER_SECOND + (i64) now.tv_nsec;
+    #else
+        return PNSLR_NanosecondsSinceUnixEpoch();
+    #endif
+}
+
+f64 VZKR_NanosecondsToSeconds(i64 nanoseconds)
+{
+    return (f64) nanoseconds / (f64) VZKR_INTERNAL_NANOSECONDS_PER_SECOND;
+}
+
+i64 VZKR_SecondsToNanoseconds(f64 seconds)
+{
+    return (i64) (seconds * (f64) VZKR_INTERNAL_NANOSECONDS_PER_SECOND);
+}
+
+// Timestamp Counter ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_TIMESTAMP_CALIBRATION_NS 2000000
+
+#if PNSLR_X64 || (PNSLR_ARM64 && !(defined(_MSC_VER) && !defined(__clang__)))
+    #define VZKR_INTERNAL_TIMESTAMP_COUNTER 1
+#else
+    #define VZKR_INTERNAL_TIMESTAMP_COUNTER 0
+#endif
+
+static i64 VZKR_Internal_TimestampFrequency = 0;
+
+u64 VZKR_ReadTimestamp(void)
+{
+    #if VZKR_INTERNAL_TIMESTAMP_COUNTER && PNSLR_X64
+        #if defined(_MSC_VER) && !defined(__clang__)
+            return __rdtsc();
+        #else
+            return __builtin_ia32_rdtsc();
+        #endif
+    #elif VZKR_INTERNAL_TIMESTAMP_COUNTER && PNSLR_ARM64
+        u64 value;
+        __asm__ volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+    #else
+        return (u64) VZKR_GetMonotonicTime();
+    #endif
+}
+
+i64 VZKR_GetTimestampFrequency(void)
+{
+    i64 frequency = VZKR_AtomicLoadI64(&VZKR_Internal_TimestampFrequency, VZKR_MemoryOrder_Relaxed);
+    if (frequency > 0) return frequency;
+
+    #if VZKR_INTERNAL_TIMESTAMP_COUNTER && PNSLR_X64
+        // the TSC runs at a fixed rate, but nothing reliably reports it, so count its
+        // ticks over a short span of the monotonic clock (reading the two back to back,
+        // in opposite orders at either end, to keep the gaps between them out of it)
+        u64 startTicks = VZKR_ReadTimestamp();
+        i64 startTime  = VZKR_GetMonotonicTime();
+        i64 endTime    = startTime;
+        while (endTime - startTime < VZKR_INTERNAL_TIMESTAMP_CALIBRATION_NS) endTime = VZKR_GetMonotonicTime();
+        u64 endTicks   = VZKR_ReadTimestamp();
+
+        frequency = (i64) ((endTicks - startTicks) * (u64) VZKR_INTERNAL_NANOSECONDS_PER_SECOND / (u64) (endTime - startTime));
+    #elif VZKR_INTERNAL_TIMESTAMP_COUNTER && PNSLR_ARM64
+        u64 value;
+        __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(value));
+        frequency = (i64) value;
+    #endif
+
+    if (frequency <= 0) frequency = VZKR_INTERNAL_NANOSECONDS_PER_SECOND;
+
+    // racing threads can only end up with (nearly) the same value
+    VZKR_AtomicStoreI64(&VZKR_Internal_TimestampFrequency, frequency, VZKR_MemoryOrder_Relaxed);
+    return frequency;
+}
+
+i64 VZKR_TimestampToNanoseconds(u64 ticks)
+{
+    u64 frequency = (u64) VZKR_GetTimestampFrequency();
+    return (i64) ((ticks / frequency) * VZKR_INTERNAL_NANOSECONDS_PER_SECOND + (ticks % frequency) * VZKR_INTERNAL_NANOSECONDS_PER_SECOND / frequency);
+}
+
+u64 VZKR_NanosecondsToTimestamp(i64 nanoseconds)
+{
+    if (nanoseconds <= 0) return 0;
+
+    u64 frequency = (u64) VZKR_GetTimestampFrequency();
+    return ((u64) nanoseconds / VZKR_INTERNAL_NANOSECONDS_PER_SECOND) * frequency + ((u64) nanoseconds % VZKR_INTERNAL_NANOSECONDS_PER_SECOND) * frequency / VZKR_INTERNAL_NANOSECONDS_PER_SECOND;
+}
+
+// Sleeping ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#if PNSLR_WINDOWS
+    #ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+        #define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+    #endif
+
+    #define VZKR_INTERNAL_SLEEP_MIN_MARGIN_NS 500000
+#else
+    #define VZKR_INTERNAL_SLEEP_MIN_MARGIN_NS 50000
+#endif
+
+#define VZKR_INTERNAL_SLEEP_MAX_MARGIN_NS 20000000 // more than a whole default timer period on Windows
+#define VZKR_INTERNAL_SLEEP_YIELD_NS      50000    // below this, spin without giving up the core
+
+/** How late the OS has been waking sleeping threads up, and so how much of a wait to spin through. */
+static i64 VZKR_Internal_SleepMargin = VZKR_INTERNAL_SLEEP_MIN_MARGIN_NS * 2;
+
+void VZKR_SleepThread(i64 durationNs)
+{
+    if (durationNs <= 0) return;
+
+    #if PNSLR_WINDOWS
+        // a high-resolution timer (Windows 10 1803 onwards) wakes up well within a
+        // millisecond; Sleep can take a whole timer interrupt period (15.6ms by default)
+        HANDLE timer = CreateWaitableTimerExW(nil, nil, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (timer)
+        {
+            LARGE_INTEGER dueTime;
+            dueTime.QuadPart = -((durationNs + 99) / 100); // relative, in 100ns units
+            if (SetWaitableTimer(timer, &dueTime, 0, nil, nil, FALSE)) WaitForSingleObject(timer, INFINITE);
+            CloseHandle(timer);
+        }
+        else
+        {
+            i64 milliseconds = durationNs / 1000000 + (durationNs % 1000000 != 0); // rounded up, without overflowing
+            Sleep(milliseconds < (i64) INFINITE ? (DWORD) milliseconds : INFINITE - 1);
+        }
+    #elif PNSLR_UNIX
+        struct timespec remaining = {.tv_sec = (time_t) (durationNs / VZKR_INTERNAL_NANOSECONDS_PER_SECOND), .tv_nsec = (long) (durationNs % VZKR_INTERNAL_NANOSECONDS_PER_SECOND)};
+        while (nanosleep(&remaining, &remaining) != 0 && errno == EINTR) { }
+    #endif
+}
+
+void VZKR_SleepThreadUntil(i64 monotonicTimeNs)
+{
+    for (;;)
+    {
+        i64 now       = VZKR_GetMonotonicTime();
+        i64 remaining = monotonicTimeNs - now;
+        if (remaining <= 0) return;
+
+        i64 margin = VZKR_AtomicLoadI64(&VZKR_Internal_SleepMargin, VZKR_MemoryOrder_Relaxed);
+        if (remaining > margin)
+        {
+            VZKR_SleepThread(remaining - margin);
+
+            // jump straight up to any new worst, then drift slowly back down
+            i64 late = VZKR_GetMonotonicTime() - now - (remaining - margin);
+            margin   = late > margin ? late : margin - margin / 16;
+            if (margin < VZKR_INTERNAL_SLEEP_MIN_MARGIN_NS) margin = VZKR_INTERNAL_SLEEP_MIN_MARGIN_NS;
+            if (margin > VZKR_INTERNAL_SLEEP_MAX_MARGIN_NS) margin = VZKR_INTERNAL_SLEEP_MAX_MARGIN_NS;
+            VZKR_AtomicStoreI64(&VZKR_Internal_SleepMargin, margin, VZKR_MemoryOrder_Relaxed);
+        }
+        else if (remaining > VZKR_INTERNAL_SLEEP_YIELD_NS)
+        {
+            VZKR_YieldThread();
+        }
+        else
+        {
+            VZKR_CpuRelax();
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef VZKR_CLOCK_H // ============================================================
+#define VZKR_CLOCK_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Monotonic Clock ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Gets the time in nanoseconds since an arbitrary point (usually boot), from a clock that
+ * never goes backwards or jumps when the system time gets changed, unlike
+ * 'PNSLR_NanosecondsSinceUnixEpoch'. Use it for measuring durations and deadlines.
+ */
+i64 VZKR_GetMonotonicTime(void);
+
+/**
+ * Converts nanoseconds to seconds.
+ */
+f64 VZKR_NanosecondsToSeconds(
+    i64 nanoseconds
+);
+
+/**
+ * Converts seconds to nanoseconds.
+ */
+i64 VZKR_SecondsToNanoseconds(
+    f64 seconds
+);
+
+// Timestamp Counter ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Reads the CPU's timestamp counter (TSC on x64, CNTVCT on ARM64) directly: a handful of
+ * cycles, rather than a call into the OS, so cheap enough to timestamp very short spans
+ * of code. Only differences between timestamps mean anything, and only once converted
+ * with the frequency below; comparing ones read on different cores assumes they're in
+ * sync (as they are on anything recent). Falls back to the monotonic clock elsewhere.
+ */
+u64 VZKR_ReadTimestamp(void);
+
+/**
+ * Gets the number of timestamp ticks per second. On x64, this is measured against the
+ * monotonic clock the first time it's needed (which takes a couple of milliseconds).
+ */
+i64 VZKR_GetTimestampFrequency(void);
+
+/**
+ * Converts a number of timestamp ticks (a difference between two timestamps) to
+ * nanoseconds.
+ */
+i64 VZKR_TimestampToNanoseconds(
+    u64 ticks
+);
+
+/**
+ * Converts nanoseconds to a number of timestamp ticks.
+ */
+u64 VZKR_NanosecondsToTimestamp(
+    i64 nanoseconds
+);
+
+// Sleeping ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Puts the calling thread to sleep for at least a duration. How much longer it can take
+ * depends on the OS's scheduler (up to a millisecond or more on Windows).
+ */
+void VZKR_SleepThread(
+    i64 durationNs
+);
+
+/**
+ * Blocks the calling thread until a time of the monotonic clock, sleeping for as much of
+ * the wait as the OS has lately been waking threads up on time for, then spinning (and
+ * yielding) for the rest, so it can be used for pacing frames.
+ */
+void VZKR_SleepThreadUntil(
+    i64 monotonicTimeNs
+);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_CLOCK_H =============================================================
@@ -0,0 +1,1860 @@
+#define VZKR_IMPLEMENTATION
+#include "Compression.h"
+
+// Internal Helpers ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+static u32 VZKR_Internal_LoadU32(const u8* ptr)
+{
+    u32 value;
+    PNSLR_MemCopy(&value, (rawptr) ptr, 4);
+    return value;
+}
+
+static u64 VZKR_Internal_LoadU64(const u8* ptr)
+{
+    u64 value;
+    PNSLR_MemCopy(&value, (rawptr) ptr, 8);
+    return value;
+}
+
+static void VZKR_Internal_StoreU64(u8* ptr, u64 value)
+{
+    PNSLR_MemCopy(ptr, &value, 8);
+}
+
+/** Little-endian, regardless of the platform's byte order. */
+static u32 VZKR_Internal_ReadLE32(const u8* ptr)
+{
+    return (u32) ptr[0] | ((u32) ptr[1] << 8) | ((u32) ptr[2] << 16) | ((u32) ptr[3] << 24);
+}
+
+static void VZKR_Internal_WriteLE32(u8* ptr, u32 value)
+{
+    ptr[0] = (u8) value;
+    ptr[1] = (u8) (value >> 8);
+    ptr[2] = (u8) (value >> 16);
+    ptr[3] = (u8) (value >> 24);
+}
+
+static i32 VZKR_Internal_CompressionLowestBit(u64 mask)
+{
+    #if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long idx; _BitScanForward64(&idx, mask); return (i32) idx;
+    #else
+        return __builtin_ctzll(mask);
+    #endif
+}
+
+static u32 VZKR_Internal_RotateLeft32(u32 value, i32 count)
+{
+    return (value << count) | (value >> (32 - count));
+}
+
+/** xxHash32, which the LZ4 frame format uses for its checksums. */
+static u32 VZKR_Internal_XxHash32(const u8* data, i64 size, u32 seed)
+{
+    const u32 prime1 = 2654435761u, prime2 = 2246822519u, prime3 = 3266489917u, prime4 = 668265263u, prime5 = 374761393u;
+    const u8* end = data + size;
+    u32 hash;
+
+    if (size >= 16)
+    {
+        u32 v1 = seed + prime1 + prime2, v2 = seed + prime2, v3 = seed, v4 = seed - prime1;
+        for (; end - data >= 16; data += 16)
+        {
+            v1 = VZKR_Internal_RotateLeft32(v1 + VZKR_Internal_ReadLE32(data +  0) * prime2, 13) * prime1;
+            v2 = VZKR_Internal_RotateLeft32(v2 + VZKR_Internal_ReadLE32(data +  4) * prime2, 13) * prime1;
+            v3 = VZKR_Internal_RotateLeft32(v3 + VZKR_Internal_ReadLE32(data +  8) * prime2, 13) * prime1;
+            v4 = VZKR_Internal_RotateLeft32(v4 + VZKR_Internal_ReadLE32(data + 12) * prime2, 13) * prime1;
+        }
+
+        hash = VZKR_Internal_RotateLeft32(v1, 1) + VZKR_Internal_RotateLeft32(v2, 7) + VZKR_Internal_RotateLeft32(v3, 12) + VZKR_Internal_RotateLeft32(v4, 18);
+    }
+    else
+    {
+        hash = seed + prime5;
+    }
+
+    hash += (u32) size;
+    for (; end - data >= 4; data += 4) { hash = VZKR_Internal_RotateLeft32(hash + VZKR_Internal_ReadLE32(data) * prime3, 17) * prime4; }
+    for (; data < end; data++)         { hash = VZKR_Internal_RotateLeft32(hash + (*data) * prime5, 11) * prime1; }
+
+    hash ^= hash >> 15;
+    hash *= prime2;
+    hash ^= hash >> 13;
+    hash *= prime3;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+/** Reads until 'count' bytes are in, or the stream ends. Returns the number read, -1 on failure. */
+static i64 VZKR_Internal_ReadFully(PNSLR_Stream stream, u8* dst, i64 count)
+{
+    i64 done = 0;
+    while (done < count)
+    {
+        i64 readSize = 0;
+        PNSLR_ArraySlice(u8) rest = {.data = dst + done, .count = count - done};
+        if (!PNSLR_ReadFromStream(stream, rest, &readSize)) return -1;
+        if (readSize == 0) break;
+        done += readSize;
+    }
+
+    return done;
+}
+
+// LZ4 Blocks ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_LZ4_HASH_LOG      12
+#define VZKR_INTERNAL_LZ4_MIN_MATCH     4
+#define VZKR_INTERNAL_LZ4_LAST_LITERALS 5  // blocks always end with at least this many literals
+#define VZKR_INTERNAL_LZ4_MF_LIMIT      12 // and the last match starts at least this far from the end
+#define VZKR_INTERNAL_LZ4_MAX_OFFSET    65535
+#define VZKR_INTERNAL_LZ4_SKIP_TRIGGER  6  // how quickly the search speeds up through incompressible data
+
+static u32 VZKR_Internal_Lz4Hash(u32 sequence)
+{
+    return (sequence * 2654435761u) >> (32 - VZKR_INTERNAL_LZ4_HASH_LOG);
+}
+
+/** Bytes needed to store a length that doesn't fit in its token nibble. */
+static i64 VZKR_Internal_Lz4ExtraLengthSize(i64 length)
+{
+    return (length >= 15) ? (length - 15) / 255 + 1 : 0;
+}
+
+static u8* VZKR_Internal_Lz4WriteExtraLength(u8* op, i64 length)
+{
+    length -= 15;
+    while (length >= 255) { *op++ = 255; length -= 255; }
+    *op++ = (u8) length;
+    return op;
+}
+
+/** Returns the compressed size, or 0 if it didn't fit. */
+static i64 VZKR_Internal_Lz4CompressBlock(const u8* src, i64 srcSize, u8* dst, i64 dstCapacity)
+{
+    u32 table[1 << VZKR_INTERNAL_LZ4_HASH_LOG];
+    PNSLR_MemSet(table, 0, (i32) sizeof(table));
+
+    const u8* ip     = src;
+    const u8* anchor = src;
+    const u8* iend   = src + srcSize;
+    u8* op           = dst;
+    u8* oend         = dst + dstCapacity;
+
+    if (srcSize > VZKR_INTERNAL_LZ4_MF_LIMIT)
+    {
+        const u8* mfLimit    = iend - VZKR_INTERNAL_LZ4_MF_LIMIT;
+        const u8* matchLimit = iend - VZKR_INTERNAL_LZ4_LAST_LITERALS;
+        u32 attempts = 1u << VZKR_INTERNAL_LZ4_SKIP_TRIGGER;
+
+        while (ip <= mfLimit)
+        {
+            u32 sequence = VZKR_Internal_LoadU32(ip);
+            u32 hash     = VZKR_Internal_Lz4Hash(sequence);
+            const u8* ref = src + table[hash];
+            table[hash] = (u32) (ip - src);
+
+            if (ref >= ip || ip - ref > VZKR_INTERNAL_LZ4_MAX_OFFSET || VZKR_Internal_LoadU32(ref) != sequence)
+            {
+                ip += attempts++ >> VZKR_INTERNAL_LZ4_SKIP_TRIGGER;
+                continue;
+            }
+
+            attempts = 1u << VZKR_INTERNAL_LZ4_SKIP_TRIGGER;
+
+            // grow the match in both directions
+            while (ip > anchor && ref > src && ip[-1] == ref[-1]) { ip--; ref--; }
+
+            const u8* matchEnd = ip + VZKR_INTERNAL_LZ4_MIN_MATCH;
+            const u8* refEnd   = ref + VZKR_INTERNAL_LZ4_MIN_MATCH;
+            while (matchEnd + 8 <= matchLimit)
+            {
+                u64 diff = VZKR_Internal_LoadU64(matchEnd) ^ VZKR_Internal_LoadU64(refEnd);
+                if (diff) { matchEnd += VZKR_Internal_CompressionLowestBit(diff) >> 3; goto MatchEndFound; }
+                matchEnd += 8;
+                refEnd   += 8;
+            }
+
+            while (matchEnd < matchLimit && *matchEnd == *refEnd) { matchEnd++; refEnd++; }
+
+        MatchEndFound:;
+            i64 literalLength = ip - anchor;
+            i64 matchLength   = matchEnd - ip - VZKR_INTERNAL_LZ4_MIN_MATCH;
+            i64 needed = 1 + VZKR_Internal_Lz4ExtraLengthSize(literalLength) + literalLength + 2 + VZKR_Internal_Lz4ExtraLengthSize(matchLength);
+            if (oend - op < needed) return 0;
+
+            u8* token = op++;
+            if (literalLength >= 15) { *token = 15 << 4; op = VZKR_Internal_Lz4WriteExtraLength(op, literalLength); }
+            else                     { *token = (u8) (literalLength << 4); }
+
+            PNSLR_MemCopy(op, (rawptr) anchor, (i32) literalLength);
+            op += literalLength;
+
+            i64 offset = ip - ref;
+            *op++ = (u8) offset;
+            *op++ = (u8) (offset >> 8);
+
+            if (matchLength >= 15) { *token |= 15; op = VZKR_Internal_Lz4WriteExtraLength(op, matchLength); }
+            else                   { *token |= (u8) matchLength; }
+
+            ip     = matchEnd;
+            anchor = ip;
+
+            // the spot just before the end of a match tends to come up again
+            if (ip <= mfLimit) table[VZKR_Internal_Lz4Hash(VZKR_Internal_LoadU32(ip - 2))] = (u32) (ip - 2 - src);
+        }
+    }
+
+    i64 literalLength = iend - anchor;
+    i64 needed = 1 + VZKR_Internal_Lz4ExtraLengthSize(literalLength) + literalLength;
+    if (oend - op < needed) return 0;
+
+    u8* token = op++;
+    if (literalLength >= 15) { *token = 15 << 4; op = VZKR_Internal_Lz4WriteExtraLength(op, literalLength); }
+    else                     { *token = (u8) (literalLength << 4); }
+
+    PNSLR_MemCopy(op, (rawptr) anchor, (i32) literalLength);
+    op += literalLength;
+    return op - dst;
+}
+
+/**
+ * Decodes a block into 'dst'. Matches can reach back as far as 'lowest', which lets
+ * linked blocks refer to the ones before them.
+ * Returns the decompressed size, or -1 if the block is malformed or doesn't fit.
+ */
+static i64 VZKR_Internal_Lz4DecompressBlock(const u8* src, i64 srcSize, u8* dst, i64 dstCapacity, const u8* lowest)
+{
+    const u8* ip   = src;
+    const u8* iend = src + srcSize;
+    u8* op         = dst;
+    u8* oend       = dst + dstCapacity;
+
+    while (ip < iend)
+    {
+        u32 token = *ip++;
+
+        i64 literalLength = token >> 4;
+        if (literalLength == 15)
+        {
+            u8 extra;
+            do
+            {
+                if (ip >= iend) return -1;
+                extra = *ip++;
+                literalLength += extra;
+            } while (extra == 255);
+        }
+
+        if (literalLength > iend - ip || literalLength > oend - op) return -1;
+
+        if (literalLength <= 16 && iend - ip >= 16 && oend - op >= 16)
+        {
+            VZKR_Internal_StoreU64(op, VZKR_Internal_LoadU64(ip));
+            VZKR_Internal_StoreU64(op + 8, VZKR_Internal_LoadU64(ip + 8));
+        }
+        else
+        {
+            PNSLR_MemCopy(op, (rawptr) ip, (i32) literalLength);
+        }
+
+        ip += literalLength;
+        op += literalLength;
+
+        // the last sequence has no match
+        if (ip == iend) break;
+        if (iend - ip < 2) return -1;
+
+        i64 offset = (i64) ip[0] | ((i64) ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op - lowest) return -1;
+
+        i64 matchLength = token & 15;
+        const u8* match = op - offset;
+
+        // most matches are short enough to copy a fixed 18 bytes without checking further
+        if (matchLength < 15 && offset >= 8 && oend - op >= 24)
+        {
+            VZKR_Internal_StoreU64(op,      VZKR_Internal_LoadU64(match));
+            VZKR_Internal_StoreU64(op + 8,  VZKR_Internal_LoadU64(match + 8));
+            VZKR_Internal_StoreU64(op + 16, VZKR_Internal_LoadU64(match + 16));
+            op += matchLength + VZKR_INTERNAL_LZ4_MIN_MATCH;
+            continue;
+        }
+
+        if (matchLength == 15)
+        {
+            u8 extra;
+            do
+            {
+                if (ip >= iend) return -1;
+                extra = *ip++;
+                matchLength += extra;
+            } while (extra == 255);
+        }
+
+        matchLength += VZKR_INTERNAL_LZ4_MIN_MATCH;
+        if (matchLength > oend - op) return -1;
+
+        // 8 bytes at a time is only safe when they don't overlap what they're writing
+        if (offset >= 8 && oend - op >= matchLength + 8)
+        {
+            for (i64 i = 0; i < matchLength; i += 8) { VZKR_Internal_StoreU64(op + i, VZKR_Internal_LoadU64(match + i)); }
+        }
+        else
+        {
+            for (i64 i = 0; i < matchLength; i++) { op[i] = match[i]; }
+        }
+
+        op += matchLength;
+    }
+
+    return op - dst;
+}
+
+i64 VZKR_GetLz4CompressedSizeBound(i64 size)
+{
+    if (size < 0) return 0;
+    return size + size / 255 + 16;
+}
+
+b8 VZKR_CompressLz4Block(
+    PNSLR_ArraySlice(u8) src,
+    PNSLR_ArraySlice(u8) dst,
+    i64* compressedSize
+)
+{
+    if (compressedSize) *compressedSize = 0;
+    if (src.count < 0 || src.count > VZKR_INTERNAL_FILE_MAX_TRANSFER) return false;
+
+    i64 size = VZKR_Internal_Lz4CompressBlock(src.data, src.count, dst.data, dst.count);
+    if (size <= 0) return false;
+
+    if (compressedSize) *compressedSize = size;
+    return true;
+}
+
+b8 VZKR_DecompressLz4Block(
+    PNSLR_ArraySlice(u8) src,
+    PNSLR_ArraySlice(u8) dst,
+    i64* decompressedSize
+)
+{
+    if (decompressedSize) *decompressedSize = 0;
+
+    i64 size = VZKR_Internal_Lz4DecompressBlock(src.data, src.count, dst.data, dst.count, dst.data);
+    if (size < 0) return false;
+
+    if (decompressedSize) *decompressedSize = size;
+    return true;
+}
+
+// LZ4 Frames ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_LZ4_FRAME_MAGIC          0x184D2204u
+#define VZKR_INTERNAL_LZ4_SKIPPABLE_MAGIC      0x184D2A50u // the low nibble can be anything
+#define VZKR_INTERNAL_LZ4_FLAG_INDEPENDENT     0x20
+#define VZKR_INTERNAL_LZ4_FLAG_BLOCK_CHECKSUM  0x10
+#define VZKR_INTERNAL_LZ4_FLAG_CONTENT_SIZE    0x08
+#define VZKR_INTERNAL_LZ4_FLAG_CONTENT_CHECKSUM 0x04
+#define VZKR_INTERNAL_LZ4_FLAG_DICTIONARY      0x01
+#define VZKR_INTERNAL_LZ4_UNCOMPRESSED_BIT     0x80000000u
+#define VZKR_INTERNAL_LZ4_MAX_HEADER_SIZE      19
+#define VZKR_INTERNAL_LZ4_HISTORY_SIZE         (64 * 1024) // how far back linked blocks can reach
+#define VZKR_INTERNAL_LZ4_DEFAULT_THREADS      4
+
+static i64 VZKR_Internal_Lz4BlockSizeFromId(u32 id)
+{
+    return (id >= 4 && id <= 7) ? (i64) 1 << (8 + 2 * id) : 0;
+}
+
+/**
+ * Parses a frame header (after the magic number), 'header' holding at least the
+ * descriptor. Returns the header size (without the magic), or -1 if it's invalid.
+ */
+static i64 VZKR_Internal_Lz4ParseFrameHeader(const u8* header, i64 available, u8* flags, i64* blockSize, i64* contentSize)
+{
+    if (available < 3) return -1;
+
+    u8 flg = header[0];
+    u8 bd  = header[1];
+    if ((flg >> 6) != 1 || (flg & VZKR_INTERNAL_LZ4_FLAG_DICTIONARY)) return -1;
+
+    i64 size = 2 + ((flg & VZKR_INTERNAL_LZ4_FLAG_CONTENT_SIZE) ? 8 : 0);
+    if (available < size + 1) return -1;
+
+    if ((u8) (VZKR_Internal_XxHash32(header, size, 0) >> 8) != header[size]) return -1;
+
+    *flags     = flg;
+    *blockSize = VZKR_Internal_Lz4BlockSizeFromId((bd >> 4) & 7);
+    *contentSize = -1;
+    if (flg & VZKR_INTERNAL_LZ4_FLAG_CONTENT_SIZE)
+    {
+        *contentSize = (i64) ((u64) VZKR_Internal_ReadLE32(header + 2) | ((u64) VZKR_Internal_ReadLE32(header + 6) << 32));
+    }
+
+    return (*blockSize > 0) ? size + 1 : -1;
+}
+
+typedef struct VZKR_Internal_Lz4FrameBlock
+{
+    const u8* data;
+    i64 size;
+    b8 uncompressed;
+    i64 capacity;
+    i64 outputOffset;
+    i64 outputSize;
+} VZKR_Internal_Lz4FrameBlock;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_Internal_Lz4FrameBlock);
+
+typedef struct VZKR_Internal_Lz4ParallelDecode
+{
+    PNSLR_ArraySlice(VZKR_Internal_Lz4FrameBlock) blocks;
+    u8* output;
+    VZKR_ProfiledMutex mutex;
+    i64 nextBlock;
+    b8 failed;
+} VZKR_Internal_Lz4ParallelDecode;
+
+static void VZKR_Internal_Lz4DecodeWorker(rawptr arg)
+{
+    VZKR_Internal_Lz4ParallelDecode* decode = (VZKR_Internal_Lz4ParallelDecode*) arg;
+    while (true)
+    {
+        VZKR_LockProfiledMutex(&decode->mutex);
+        i64 idx = (decode->failed) ? decode->blocks.count : decode->nextBlock++;
+        VZKR_UnlockProfiledMutex(&decode->mutex);
+        if (idx >= decode->blocks.count) break;
+
+        VZKR_Internal_Lz4FrameBlock* block = &decode->blocks.data[idx];
+        u8* dst = decode->output + block->outputOffset;
+        i64 size = block->size;
+        if (block->uncompressed) { if (size > block->capacity) size = -1; else PNSLR_MemCopy(dst, (rawptr) block->data, (i32) size); }
+        else size = VZKR_Internal_Lz4DecompressBlock(block->data, block->size, dst, block->capacity, dst);
+
+        block->outputSize = size;
+        if (size < 0)
+        {
+            VZKR_LockProfiledMutex(&decode->mutex);
+            decode->failed = true;
+            VZKR_UnlockProfiledMutex(&decode->mutex);
+        }
+    }
+}
+
+/**
+ * Finds every block in the frames, and where each one goes in the output.
+ * Returns false if the frames are malformed.
+ */
+static b8 VZKR_Internal_Lz4ScanFrames(PNSLR_ArraySlice(u8) src, PNSLR_Allocator allocator, PNSLR_ArraySlice(VZKR_Internal_Lz4FrameBlock)* blocks, i64* numBlocks, b8* linked)
+{
+    const u8* ip   = src.data;
+    const u8* iend = src.data + src.count;
+    i64 outputOffset = 0;
+    *numBlocks = 0;
+    *linked    = false;
+
+    while (iend - ip >= 4)
+    {
+        u32 magic = VZKR_Internal_ReadLE32(ip);
+        ip += 4;
+
+        if ((magic & 0xFFFFFFF0u) == VZKR_INTERNAL_LZ4_SKIPPABLE_MAGIC)
+        {
+            if (iend - ip < 4) return false;
+            u32 skip = VZKR_Internal_ReadLE32(ip);
+            if ((i64) skip > iend - ip - 4) return false;
+            ip += 4 + skip;
+            continue;
+        }
+
+        if (magic != VZKR_INTERNAL_LZ4_FRAME_MAGIC) return false;
+
+        u8 flags = 0;
+        i64 blockSize = 0, contentSize = -1;
+        i64 headerSize = VZKR_Internal_Lz4ParseFrameHeader(ip, iend - ip, &flags, &blockSize, &contentSize);
+        if (headerSize < 0) return false;
+        ip += headerSize;
+        if (!(flags & VZKR_INTERNAL_LZ4_FLAG_INDEPENDENT)) *linked = true;
+
+        while (true)
+        {
+            if (iend - ip < 4) return false;
+            u32 word = VZKR_Internal_ReadLE32(ip);
+            ip += 4;
+            if (word == 0) break;
+
+            i64 size = (i64) (word & ~VZKR_INTERNAL_LZ4_UNCOMPRESSED_BIT);
+            if (size > iend - ip) return false;
+
+            if (*numBlocks == blocks->count)
+            {
+                PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+                PNSLR_ResizeSlice(VZKR_Internal_Lz4FrameBlock, blocks, blocks->count ? blocks->count * 2 : 64, false, allocator, PNSLR_GET_LOC(), &err);
+                if (err != PNSLR_AllocatorError_None) return false;
+            }
+
+            blocks->data[(*numBlocks)++] = (VZKR_Internal_Lz4FrameBlock)
+            {
+                .data         = ip,
+                .size         = size,
+                .uncompressed = (word & VZKR_INTERNAL_LZ4_UNCOMPRESSED_BIT) != 0,
+                .capacity     = blockSize,
+                .outputOffset = outputOffset,
+            };
+
+            outputOffset += blockSize;
+            if (outputOffset > VZKR_INTERNAL_FILE_MAX_TRANSFER) return false;
+
+            ip += size + ((flags & VZKR_INTERNAL_LZ4_FLAG_BLOCK_CHECKSUM) ? 4 : 0);
+            if (ip > iend) return false;
+        }
+
+        if (flags & VZKR_INTERNAL_LZ4_FLAG_CONTENT_CHECKSUM)
+        {
+            if (iend - ip < 4) return false;
+            ip += 4;
+        }
+    }
+
+    return ip == iend;
+}
+
+b8 VZKR_DecompressLz4FrameParallel(
+    PNSLR_ArraySlice(u8) src,
+    i32 numThreads,
+    PNSLR_Allocator allocator,
+    PNSLR_ArraySlice(u8)* output
+)
+{
+    if (!output) return false;
+    *output = (PNSLR_ArraySlice(u8)) {0};
+
+    PNSLR_ArraySlice(VZKR_Internal_Lz4FrameBlock) blocks = {0};
+    i64 numBlocks = 0;
+    b8 linked = false;
+    b8 success = VZKR_Internal_Lz4ScanFrames(src, allocator, &blocks, &numBlocks, &linked);
+    blocks.count = success ? numBlocks : blocks.count;
+
+    // every block gets room for its maximum size, and the gaps are closed up afterwards
+    i64 capacity = (success && numBlocks > 0) ? blocks.data[numBlocks - 1].outputOffset + blocks.data[numBlocks - 1].capacity : 0;
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    PNSLR_ArraySlice(u8) buffer = {0};
+    if (success)
+    {
+        buffer = PNSLR_MakeSlice(u8, capacity > 0 ? capacity : 1, false, allocator, PNSLR_GET_LOC(), &err);
+        success = (err == PNSLR_AllocatorError_None);
+    }
+
+    i64 written = 0;
+    if (success && linked)
+    {
+        // linked blocks refer back to the ones before them, so they're decoded in order,
+        // straight after one another
+        for (i64 i = 0; success && i < numBlocks; i++)
+        {
+            VZKR_Internal_Lz4FrameBlock* block = &blocks.data[i];
+            u8* dst = buffer.data + written;
+            i64 room = capacity - written;
+            i64 size = block->size;
+            if (block->uncompressed) { if (size > room) size = -1; else PNSLR_MemCopy(dst, (rawptr) block->data, (i32) size); }
+            else size = VZKR_Internal_Lz4DecompressBlock(block->data, block->size, dst, block->capacity < room ? block->capacity : room, buffer.data);
+
+            success = (size >= 0);
+            written += success ? size : 0;
+        }
+    }
+    else if (success)
+    {
+        VZKR_Internal_Lz4ParallelDecode decode = {.blocks = blocks, .output = buffer.data, .mutex = VZKR_CreateProfiledMutex(PNSLR_GET_LOC())};
+
+        if (numThreads <= 0) numThreads = VZKR_INTERNAL_LZ4_DEFAULT_THREADS;
+        if (numThreads > numBlocks) numThreads = (i32) numBlocks;
+
+        // the calling thread decodes too
+        PNSLR_ArraySlice(VZKR_Thread) threads = PNSLR_MakeSlice(VZKR_Thread, numThreads > 1 ? numThreads - 1 : 1, true, allocator, PNSLR_GET_LOC(), &err);
+        VZKR_ThreadOptions threadOptions = {.name = PNSLR_StringLiteral("VzkrLz4")};
+        for (i32 i = 0; err == PNSLR_AllocatorError_None && i < numThreads - 1; i++)
+        {
+            threads.data[i] = VZKR_CreateThread(VZKR_Internal_Lz4DecodeWorker, &decode, threadOptions, allocator);
+            if (!threads.data[i].handle) break;
+        }
+
+        VZKR_Internal_Lz4DecodeWorker(&decode);
+
+        for (i32 i = 0; err == PNSLR_AllocatorError_None && i < numThreads - 1; i++) { VZKR_JoinThread(&threads.data[i]); }
+
+        PNSLR_FreeSlice(&threads, allocator, PNSLR_GET_LOC(), nil);
+        VZKR_DestroyProfiledMutex(&decode.mutex);
+        success = !decode.failed;
+
+        // only short blocks (usually just the last one) leave gaps
+        for (i64 i = 0; success && i < numBlocks; i++)
+        {
+            VZKR_Internal_Lz4FrameBlock* block = &blocks.data[i];
+            if (block->outputOffset != written) PNSLR_MemMove(buffer.data + written, buffer.data + block->outputOffset, (i32) block->outputSize);
+            written += block->outputSize;
+        }
+    }
+
+    PNSLR_FreeSlice(&blocks, allocator, PNSLR_GET_LOC(), nil);
+    if (!success)
+    {
+        PNSLR_FreeSlice(&buffer, allocator, PNSLR_GET_LOC(), nil);
+        return false;
+    }
+
+    output->data  = buffer.data;
+    output->count = written;
+    return true;
+}
+
+// LZ4 Streams ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_LZ4_DEFAULT_BLOCK_SIZE (1024 * 1024)
+
+b8 VZKR_CreateLz4CompressStream(
+    PNSLR_Stream inner,
+    i32 blockSize,
+    PNSLR_Allocator allocator,
+    VZKR_Lz4Stream* output
+)
+{
+    if (!output || !inner.procedure) return false;
+    *output = (VZKR_Lz4Stream) {0};
+    if (blockSize <= 0) blockSize = VZKR_INTERNAL_LZ4_DEFAULT_BLOCK_SIZE;
+
+    i64 size = 0;
+    for (u32 id = 4; id <= 7 && size < blockSize; id++) { size = VZKR_Internal_Lz4BlockSizeFromId(id); }
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    output->rawBuffer    = PNSLR_MakeSlice(u8, size, false, allocator, PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) output->packedBuffer = PNSLR_MakeSlice(u8, VZKR_GetLz4CompressedSizeBound(size), false, allocator, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None)
+    {
+        PNSLR_FreeSlice(&output->rawBuffer, allocator, PNSLR_GET_LOC(), nil);
+        PNSLR_FreeSlice(&output->packedBuffer, allocator, PNSLR_GET_LOC(), nil);
+        return false;
+    }
+
+    output->allocator   = allocator;
+    output->inner       = inner;
+    output->compressing = true;
+    output->blockSize   = size;
+    output->contentSize = -1;
+    return true;
+}
+
+b8 VZKR_CreateLz4DecompressStream(
+    PNSLR_Stream inner,
+    PNSLR_Allocator allocator,
+    VZKR_Lz4Stream* output
+)
+{
+    if (!output || !inner.procedure) return false;
+
+    // the buffers are sized once the block size is known, from the frame header
+    *output = (VZKR_Lz4Stream) {.allocator = allocator, .inner = inner, .contentSize = -1};
+    return true;
+}
+
+static b8 VZKR_Internal_Lz4WriteFrameHeader(VZKR_Lz4Stream* stream)
+{
+    u32 blockId = 4;
+    while (VZKR_Internal_Lz4BlockSizeFromId(blockId) < stream->blockSize) { blockId++; }
+
+    u8 header[7];
+    VZKR_Internal_WriteLE32(header, VZKR_INTERNAL_LZ4_FRAME_MAGIC);
+    header[4] = (1 << 6) | VZKR_INTERNAL_LZ4_FLAG_INDEPENDENT;
+    header[5] = (u8) (blockId << 4);
+    header[6] = (u8) (VZKR_Internal_XxHash32(header + 4, 2, 0) >> 8);
+
+    stream->inFrame = true;
+    return PNSLR_WriteToStream(stream->inner, (PNSLR_ArraySlice(u8)) {.data = header, .count = 7});
+}
+
+/** Compresses and writes out a single block, stored as-is if it doesn't compress. */
+static b8 VZKR_Internal_Lz4WriteBlock(VZKR_Lz4Stream* stream, const u8* data, i64 count)
+{
+    if (!stream->inFrame && !VZKR_Internal_Lz4WriteFrameHeader(stream)) return false;
+    if (count == 0) return true;
+
+    i64 packedSize = VZKR_Internal_Lz4CompressBlock(data, count, stream->packedBuffer.data + 4, count - 1);
+    u32 word = (u32) packedSize;
+    const u8* payload = stream->packedBuffer.data + 4;
+    if (packedSize <= 0)
+    {
+        word       = (u32) count | VZKR_INTERNAL_LZ4_UNCOMPRESSED_BIT;
+        packedSize = count;
+        payload    = data;
+    }
+
+    VZKR_Internal_WriteLE32(stream->packedBuffer.data, word);
+    if (payload != data) return PNSLR_WriteToStream(stream->inner, (PNSLR_ArraySlice(u8)) {.data = stream->packedBuffer.data, .count = packedSize + 4});
+
+    return PNSLR_WriteToStream(stream->inner, (PNSLR_ArraySlice(u8)) {.data = stream->packedBuffer.data, .count = 4}) &&
+           PNSLR_WriteToStream(stream->inner, (PNSLR_ArraySlice(u8)) {.data = (u8*) data, .count = packedSize});
+}
+
+static b8 VZKR_Internal_Lz4StreamWrite(VZKR_Lz4Stream* stream, PNSLR_ArraySlice(u8) src)
+{
+    i64 done = 0;
+    while (done < src.count)
+    {
+        // whole blocks are compressed straight from the source
+        if (stream->rawEnd == 0 && src.count - done >= stream->blockSize)
+        {
+            if (!VZKR_Internal_Lz4WriteBlock(stream, src.data + done, stream->blockSize)) return false;
+            done += stream->blockSize;
+            continue;
+        }
+
+        i64 count = stream->blockSize - stream->rawEnd;
+        if (count > src.count - done) count = src.count - done;
+        PNSLR_MemCopy(stream->rawBuffer.data + stream->rawEnd, src.data + done, (i32) count);
+        stream->rawEnd += count;
+        done           += count;
+
+        if (stream->rawEnd == stream->blockSize)
+        {
+            stream->rawEnd = 0;
+            if (!VZKR_Internal_Lz4WriteBlock(stream, stream->rawBuffer.data, stream->blockSize)) return false;
+        }
+    }
+
+    stream->position += src.count;
+    return true;
+}
+
+static b8 VZKR_Internal_Lz4StreamFlushBlock(VZKR_Lz4Stream* stream)
+{
+    i64 count = stream->rawEnd;
+    stream->rawEnd = 0;
+    return VZKR_Internal_Lz4WriteBlock(stream, stream->rawBuffer.data, count);
+}
+
+/** Reads the next frame's header, allocating buffers to fit. Returns false at the end, or on failure. */
+static b8 VZKR_Internal_Lz4ReadFrameHeader(VZKR_Lz4Stream* stream)
+{
+    u8 header[VZKR_INTERNAL_LZ4_MAX_HEADER_SIZE];
+    while (true)
+    {
+        i64 numRead = VZKR_Internal_ReadFully(stream->inner, header, 4);
+        if (numRead != 4) { stream->finished = true; return false; }
+
+        u32 magic = VZKR_Internal_ReadLE32(header);
+        if ((magic & 0xFFFFFFF0u) == VZKR_INTERNAL_LZ4_SKIPPABLE_MAGIC)
+        {
+            if (VZKR_Internal_ReadFully(stream->inner, header, 4) != 4) return false;
+            if (!PNSLR_SeekPositionInStream(stream->inner, (i64) VZKR_Internal_ReadLE32(header), true)) return false;
+            continue;
+        }
+
+        if (magic != VZKR_INTERNAL_LZ4_FRAME_MAGIC) return false;
+        break;
+    }
+
+    // the descriptor's size depends on its first byte
+    if (VZKR_Internal_ReadFully(stream->inner, header, 2) != 2) return false;
+    i64 descriptorSize = 3 + ((header[0] & VZKR_INTERNAL_LZ4_FLAG_CONTENT_SIZE) ? 8 : 0);
+    if (VZKR_Internal_ReadFully(stream->inner, header + 2, descriptorSize - 2) != descriptorSize - 2) return false;
+
+    i64 blockSize = 0, contentSize = -1;
+    if (VZKR_Internal_Lz4ParseFrameHeader(header, descriptorSize, &stream->frameFlags, &blockSize, &contentSize) < 0) return false;
+
+    // linked blocks need the end of the previous ones to be kept around
+    i64 rawSize = blockSize + VZKR_INTERNAL_LZ4_HISTORY_SIZE;
+    if (stream->rawBuffer.count < rawSize)
+    {
+        PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+        PNSLR_FreeSlice(&stream->rawBuffer, stream->allocator, PNSLR_GET_LOC(), nil);
+        PNSLR_FreeSlice(&stream->packedBuffer, stream->allocator, PNSLR_GET_LOC(), nil);
+        stream->rawBuffer    = PNSLR_MakeSlice(u8, rawSize, false, stream->allocator, PNSLR_GET_LOC(), &err);
+        if (err == PNSLR_AllocatorError_None) stream->packedBuffer = PNSLR_MakeSlice(u8, blockSize, false, stream->allocator, PNSLR_GET_LOC(), &err);
+        if (err != PNSLR_AllocatorError_None)
+        {
+            // don't leave a raw buffer behind that's big enough to skip this next time
+            PNSLR_FreeSlice(&stream->rawBuffer, stream->allocator, PNSLR_GET_LOC(), nil);
+            return false;
+        }
+    }
+
+    stream->blockSize   = blockSize;
+    stream->contentSize = contentSize;
+    stream->rawStart    = 0;
+    stream->rawEnd      = 0;
+    stream->inFrame     = true;
+    return true;
+}
+
+/** Decodes the next block. Returns the number of bytes decoded (0 at the end), -1 on failure. */
+static i64 VZKR_Internal_Lz4ReadBlock(VZKR_Lz4Stream* stream)
+{
+    while (!stream->finished)
+    {
+        if (!stream->inFrame && !VZKR_Internal_Lz4ReadFrameHeader(stream)) return stream->finished ? 0 : -1;
+
+        u8 word[4];
+        if (VZKR_Internal_ReadFully(stream->inner, word, 4) != 4) return -1;
+
+        u32 blockWord = VZKR_Internal_ReadLE32(word);
+        if (blockWord == 0)
+        {
+            // the end of this frame, there could be another one after it
+            stream->inFrame = false;
+            if ((stream->frameFlags & VZKR_INTERNAL_LZ4_FLAG_CONTENT_CHECKSUM) && VZKR_Internal_ReadFully(stream->inner, word, 4) != 4) return -1;
+            stream->rawStart = 0;
+            stream->rawEnd   = 0;
+            continue;
+        }
+
+        i64 size = (i64) (blockWord & ~VZKR_INTERNAL_LZ4_UNCOMPRESSED_BIT);
+        if (size > stream->blockSize) return -1;
+        if (VZKR_Internal_ReadFully(stream->inner, stream->packedBuffer.data, size) != size) return -1;
+        if ((stream->frameFlags & VZKR_INTERNAL_LZ4_FLAG_BLOCK_CHECKSUM) && VZKR_Internal_ReadFully(stream->inner, word, 4) != 4) return -1;
+
+        // keep the end of the previous block for linked blocks to refer back to
+        i64 history = 0;
+        if (!(stream->frameFlags & VZKR_INTERNAL_LZ4_FLAG_INDEPENDENT))
+        {
+            history = stream->rawEnd < VZKR_INTERNAL_LZ4_HISTORY_SIZE ? stream->rawEnd : VZKR_INTERNAL_LZ4_HISTORY_SIZE;
+            if (history > 0 && stream->rawEnd != history) PNSLR_MemMove(stream->rawBuffer.data, stream->rawBuffer.data + stream->rawEnd - history, (i32) history);
+        }
+
+        u8* dst = stream->rawBuffer.data + history;
+        i64 decoded = size;
+        if (blockWord & VZKR_INTERNAL_LZ4_UNCOMPRESSED_BIT) PNSLR_MemCopy(dst, stream->packedBuffer.data, (i32) size);
+        else decoded = VZKR_Internal_Lz4DecompressBlock(stream->packedBuffer.data, size, dst, stream->blockSize, stream->rawBuffer.data);
+        if (decoded < 0) return -1;
+
+        stream->rawStart = history;
+        stream->rawEnd   = history + decoded;
+        if (decoded > 0) return decoded;
+    }
+
+    return 0;
+}
+
+static b8 VZKR_Internal_Lz4StreamRead(VZKR_Lz4Stream* stream, PNSLR_ArraySlice(u8) dst, i64* readSize)
+{
+    i64 copied = 0;
+    while (copied < dst.count)
+    {
+        if (stream->rawStart == stream->rawEnd)
+        {
+            i64 decoded = VZKR_Internal_Lz4ReadBlock(stream);
+            if (decoded < 0) { if (readSize) *readSize = copied; return false; }
+            if (decoded == 0) break;
+        }
+
+        i64 count = stream->rawEnd - stream->rawStart;
+        if (count > dst.count - copied) count = dst.count - copied;
+        if (dst.data) PNSLR_MemCopy(dst.data + copied, stream->rawBuffer.data + stream->rawStart, (i32) count);
+        stream->rawStart += count;
+        copied           += count;
+    }
+
+    stream->position += copied;
+    if (readSize) *readSize = copied;
+    return true;
+}
+
+static b8 VZKR_Internal_Lz4StreamProc(
+    rawptr streamData,
+    PNSLR_StreamMode mode,
+    PNSLR_ArraySlice(u8) data,
+    i64 offset,
+    i64* extraRet
+)
+{
+    VZKR_Lz4Stream* stream = (VZKR_Lz4Stream*) streamData;
+    if (!stream || !stream->inner.procedure) return false;
+
+    switch (mode)
+    {
+        case PNSLR_StreamMode_GetSize:
+            // only known when compressing, or when the frame says so
+            if (!stream->compressing && stream->contentSize < 0) return false;
+            if (extraRet) *extraRet = stream->compressing ? stream->position : stream->contentSize;
+            return true;
+        case PNSLR_StreamMode_GetCurrentPos:
+            if (extraRet) *extraRet = stream->position;
+            return true;
+        case PNSLR_StreamMode_SeekAbsolute:
+        case PNSLR_StreamMode_SeekRelative:
+        {
+            // forward only, by decompressing and throwing it away
+            i64 skip = (mode == PNSLR_StreamMode_SeekRelative) ? offset : offset - stream->position;
+            if (stream->compressing || skip < 0) return skip == 0;
+
+            i64 skipped = 0;
+            return VZKR_Internal_Lz4StreamRead(stream, (PNSLR_ArraySlice(u8)) {.data = nil, .count = skip}, &skipped) && skipped == skip;
+        }
+        case PNSLR_StreamMode_Read:
+            return !stream->compressing && VZKR_Internal_Lz4StreamRead(stream, data, extraRet);
+        case PNSLR_StreamMode_Write:
+            return stream->compressing && VZKR_Internal_Lz4StreamWrite(stream, data);
+        case PNSLR_StreamMode_Truncate:
+            return false;
+        case PNSLR_StreamMode_Flush:
+            if (!stream->compressing) return true;
+            return VZKR_Internal_Lz4StreamFlushBlock(stream) && PNSLR_FlushStream(stream->inner);
+        case PNSLR_StreamMode_Close:
+        {
+            b8 success = true;
+            if (stream->compressing)
+            {
+                // an empty stream still becomes a valid (empty) frame
+                u8 endMark[4] = {0};
+                success = VZKR_Internal_Lz4StreamFlushBlock(stream) &&
+                          PNSLR_WriteToStream(stream->inner, (PNSLR_ArraySlice(u8)) {.data = endMark, .count = 4});
+            }
+
+            PNSLR_CloseStream(stream->inner);
+            PNSLR_FreeSlice(&stream->rawBuffer, stream->allocator, PNSLR_GET_LOC(), nil);
+            PNSLR_FreeSlice(&stream->packedBuffer, stream->allocator, PNSLR_GET_LOC(), nil);
+            *stream = (VZKR_Lz4Stream) {0};
+            return success;
+        }
+        default:
+            return false;
+    }
+}
+
+PNSLR_Stream VZKR_StreamFromLz4Stream(VZKR_Lz4Stream* stream)
+{
+    return (PNSLR_Stream) {.procedure = VZKR_Internal_Lz4StreamProc, .data = (rawptr) stream};
+}
+
+// Inflate Streams ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_INFLATE_FAST_BITS   10
+#define VZKR_INTERNAL_INFLATE_WINDOW_SIZE (32 * 1024)  // how far back matches can reach
+#define VZKR_INTERNAL_INFLATE_BUFFER_SIZE (256 * 1024) // the window, and room to decode after it
+#define VZKR_INTERNAL_INFLATE_INPUT_SIZE  (64 * 1024)
+#define VZKR_INTERNAL_INFLATE_MAX_MATCH   258
+
+#define VZKR_INTERNAL_INFLATE_PHASE_MEMBER_HEADER  0
+#define VZKR_INTERNAL_INFLATE_PHASE_BLOCK_HEADER   1
+#define VZKR_INTERNAL_INFLATE_PHASE_STORED         2
+#define VZKR_INTERNAL_INFLATE_PHASE_HUFFMAN        3
+#define VZKR_INTERNAL_INFLATE_PHASE_MEMBER_TRAILER 4
+#define VZKR_INTERNAL_INFLATE_PHASE_DONE           5
+
+/**
+ * A canonical Huffman code. Codes up to 'FAST_BITS' long are decoded with a single
+ * lookup, longer ones by comparing against the largest code of each length.
+ */
+typedef struct VZKR_Internal_Huffman
+{
+    u16 fast[1 << VZKR_INTERNAL_INFLATE_FAST_BITS]; // (length << 9) | symbol, 0 if longer
+    u16 firstCode[16];
+    i32 maxCode[17];
+    u16 firstSymbol[16];
+    u16 symbols[288];
+} VZKR_Internal_Huffman;
+
+typedef struct VZKR_Internal_Inflater
+{
+    PNSLR_Allocator allocator;
+    PNSLR_Stream inner; // no procedure when decompressing from memory
+    VZKR_InflateFormat format;
+    u8 phase;
+    b8 lastBlock;
+    b8 failed;
+
+    const u8* in;
+    const u8* inEnd;
+    PNSLR_ArraySlice(u8) inBuffer;
+    u64 bits;
+    i32 numBits;
+    i32 padBytes; // zeroes added to the bits after the input ran out
+
+    i64 storedRemaining;
+    u8* window;
+    i64 windowStart; // matches can't reach back past the start of their member
+    i64 outStart;
+    i64 outEnd;
+    i64 checksumEnd;
+    u32 checksum;
+    u32 memberSize;
+
+    VZKR_Internal_Huffman lengths;
+    VZKR_Internal_Huffman distances;
+    u32 crcTable[4][256];
+} VZKR_Internal_Inflater;
+
+static void VZKR_Internal_InitCrc32Table(u32 table[4][256])
+{
+    for (u32 i = 0; i < 256; i++)
+    {
+        u32 crc = i;
+        for (i32 j = 0; j < 8; j++) { crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1; }
+        table[0][i] = crc;
+    }
+
+    for (u32 i = 0; i < 256; i++)
+    {
+        for (i32 k = 1; k < 4; k++) { table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF]; }
+    }
+}
+
+/** CRC-32 (as used by gzip), four bytes at a time. */
+static u32 VZKR_Internal_UpdateCrc32(u32 table[4][256], u32 crc, const u8* data, i64 size)
+{
+    crc = ~crc;
+    for (; size >= 4; size -= 4, data += 4)
+    {
+        crc ^= VZKR_Internal_ReadLE32(data);
+        crc = table[3][crc & 0xFF] ^ table[2][(crc >> 8) & 0xFF] ^ table[1][(crc >> 16) & 0xFF] ^ table[0][crc >> 24];
+    }
+
+    for (; size > 0; size--) { crc = table[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8); }
+    return ~crc;
+}
+
+/** Adler-32 (as used by zlib). */
+static u32 VZKR_Internal_UpdateAdler32(u32 adler, const u8* data, i64 size)
+{
+    u32 a = adler & 0xFFFF, b = adler >> 16;
+    while (size > 0)
+    {
+        // the most bytes that can be summed before the sums could overflow
+        i64 count = size < 5552 ? size : 5552;
+        size -= count;
+        for (; count > 0; count--) { a += *data++; b += a; }
+        a %= 65521;
+        b %= 65521;
+    }
+
+    return (b << 16) | a;
+}
+
+static u32 VZKR_Internal_ReverseBits(u32 value, i32 count)
+{
+    u32 result = 0;
+    for (i32 i = 0; i < count; i++, value >>= 1) { result = (result << 1) | (value & 1); }
+    return result;
+}
+
+static b8 VZKR_Internal_BuildHuffman(VZKR_Internal_Huffman* huffman, const u8* lengths, i32 count)
+{
+    i32 counts[17] = {0}, nextCode[16];
+    PNSLR_MemSet(huffman->fast, 0, (i32) sizeof(huffman->fast));
+    for (i32 i = 0; i < count; i++) { counts[lengths[i]]++; }
+    counts[0] = 0;
+
+    i32 code = 0, symbol = 0;
+    for (i32 i = 1; i < 16; i++)
+    {
+        nextCode[i]              = code;
+        huffman->firstCode[i]    = (u16) code;
+        huffman->firstSymbol[i]  = (u16) symbol;
+        code                    += counts[i];
+        if (counts[i] && code - 1 >= (1 << i)) return false; // over-subscribed
+        huffman->maxCode[i]      = code << (16 - i);
+        code                   <<= 1;
+        symbol                  += counts[i];
+    }
+
+    huffman->maxCode[16] = 0x10000;
+
+    for (i32 i = 0; i < count; i++)
+    {
+        i32 length = lengths[i];
+        if (!length) continue;
+
+        huffman->symbols[nextCode[length] - huffman->firstCode[length] + huffman->firstSymbol[length]] = (u16) i;
+        if (length <= VZKR_INTERNAL_INFLATE_FAST_BITS)
+        {
+            for (u32 j = VZKR_Internal_ReverseBits((u32) nextCode[length], length); j < (1u << VZKR_INTERNAL_INFLATE_FAST_BITS); j += 1u << length)
+            {
+                huffman->fast[j] = (u16) ((length << 9) | i);
+            }
+        }
+
+        nextCode[length]++;
+    }
+
+    return true;
+}
+
+/** Reads more input into the buffer. Returns false once the stream ends (or fails). */
+static b8 VZKR_Internal_InflatePull(VZKR_Internal_Inflater* inf)
+{
+    if (!inf->inner.procedure) return false;
+
+    i64 readSize = 0;
+    if (!PNSLR_ReadFromStream(inf->inner, inf->inBuffer, &readSize)) { inf->failed = true; return false; }
+
+    inf->in    = inf->inBuffer.data;
+    inf->inEnd = inf->inBuffer.data + readSize;
+    return readSize > 0;
+}
+
+/** Fills the bit buffer up to at least 57 bits, padding with zeroes once the input runs out. */
+static void VZKR_Internal_InflateRefill(VZKR_Internal_Inflater* inf)
+{
+    if (inf->numBits > 56) return;
+
+    if (inf->inEnd - inf->in >= 8)
+    {
+        inf->bits    |= VZKR_Internal_LoadU64(inf->in) << inf->numBits;
+        inf->in      += (63 - inf->numBits) >> 3;
+        inf->numBits |= 56;
+        return;
+    }
+
+    // the padding always sits above the real bits, so having used any of it up
+    // means the data was cut short
+    if (inf->numBits < inf->padBytes * 8) { inf->failed = true; return; }
+
+    while (inf->numBits <= 56)
+    {
+        if (inf->in == inf->inEnd && !VZKR_Internal_InflatePull(inf))
+        {
+            inf->padBytes++;
+            inf->numBits += 8;
+            continue;
+        }
+
+        inf->bits    |= (u64) (*inf->in++) << inf->numBits;
+        inf->numBits += 8;
+    }
+}
+
+static b8 VZKR_Internal_InflateOverran(VZKR_Internal_Inflater* inf)
+{
+    return inf->failed || inf->numBits < inf->padBytes * 8;
+}
+
+static u32 VZKR_Internal_InflateGetBits(VZKR_Internal_Inflater* inf, i32 count)
+{
+    if (inf->numBits < count) VZKR_Internal_InflateRefill(inf);
+
+    u32 value = (u32) (inf->bits & ((1ull << count) - 1));
+    inf->bits    >>= count;
+    inf->numBits  -= count;
+    return value;
+}
+
+/** Returns the next symbol, or -1 if the bits don't make a valid code. Needs at least 15 bits. */
+static i32 VZKR_Internal_InflateDecodeSymbol(VZKR_Internal_Inflater* inf, VZKR_Internal_Huffman* huffman)
+{
+    u32 entry = huffman->fast[inf->bits & ((1u << VZKR_INTERNAL_INFLATE_FAST_BITS) - 1)];
+    if (entry)
+    {
+        i32 length = (i32) (entry >> 9);
+        inf->bits    >>= length;
+        inf->numBits  -= length;
+        return (i32) (entry & 511);
+    }
+
+    // codes are stored most significant bit first, the other way around from everything else
+    u32 code = VZKR_Internal_ReverseBits((u32) (inf->bits & 0xFFFF), 16);
+    i32 length = VZKR_INTERNAL_INFLATE_FAST_BITS + 1;
+    while ((i32) code >= huffman->maxCode[length]) { length++; }
+    if (length >= 16) return -1;
+
+    i32 idx = (i32) (code >> (16 - length)) - huffman->firstCode[length] + huffman->firstSymbol[length];
+    if (idx < 0 || idx >= 288) return -1;
+
+    inf->bits    >>= length;
+    inf->numBits  -= length;
+    return huffman->symbols[idx];
+}
+
+/** Reads a whole byte, once the bits are aligned to one. Returns false if the input ended. */
+static b8 VZKR_Internal_InflateGetByte(VZKR_Internal_Inflater* inf, u8* value)
+{
+    if (inf->numBits - inf->padBytes * 8 >= 8)
+    {
+        *value = (u8) inf->bits;
+        inf->bits    >>= 8;
+        inf->numBits  -= 8;
+        return true;
+    }
+
+    // the wide refills leave copies of the upcoming bytes above the real bits, which
+    // would be wrong once bytes are taken straight from the input
+    inf->bits    = 0;
+    inf->numBits = 0;
+    if (inf->in == inf->inEnd && !VZKR_Internal_InflatePull(inf)) return false;
+
+    *value = *inf->in++;
+    return true;
+}
+
+static b8 VZKR_Internal_InflateHasMoreInput(VZKR_Internal_Inflater* inf)
+{
+    return inf->numBits - inf->padBytes * 8 >= 8 || inf->in < inf->inEnd || VZKR_Internal_InflatePull(inf);
+}
+
+static b8 VZKR_Internal_InflateReadBlockHeader(VZKR_Internal_Inflater* inf)
+{
+    VZKR_Internal_InflateRefill(inf);
+    inf->lastBlock = (b8) VZKR_Internal_InflateGetBits(inf, 1);
+    u32 type = VZKR_Internal_InflateGetBits(inf, 2);
+
+    if (type == 0)
+    {
+        // stored blocks start at the next byte, with their length and its complement
+        VZKR_Internal_InflateGetBits(inf, inf->numBits & 7);
+        u8 header[4];
+        for (i32 i = 0; i < 4; i++) { if (!VZKR_Internal_InflateGetByte(inf, &header[i])) return false; }
+
+        u32 length = (u32) header[0] | ((u32) header[1] << 8);
+        if ((length ^ 0xFFFF) != ((u32) header[2] | ((u32) header[3] << 8))) return false;
+
+        inf->storedRemaining = length;
+        inf->phase           = VZKR_INTERNAL_INFLATE_PHASE_STORED;
+        return true;
+    }
+
+    u8 lengths[288 + 32];
+    if (type == 1)
+    {
+        // the fixed codes from the spec
+        for (i32 i = 0; i < 288; i++) { lengths[i] = (i < 144) ? 8 : (i < 256) ? 9 : (i < 280) ? 7 : 8; }
+        for (i32 i = 0; i < 32; i++)  { lengths[288 + i] = 5; }
+
+        if (!VZKR_Internal_BuildHuffman(&inf->lengths, lengths, 288) || !VZKR_Internal_BuildHuffman(&inf->distances, lengths + 288, 32)) return false;
+
+        inf->phase = VZKR_INTERNAL_INFLATE_PHASE_HUFFMAN;
+        return !VZKR_Internal_InflateOverran(inf);
+    }
+
+    if (type != 2) return false;
+
+    // the code lengths are themselves Huffman coded
+    static const u8 codeLengthOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    i32 numLengths    = (i32) VZKR_Internal_InflateGetBits(inf, 5) + 257;
+    i32 numDistances  = (i32) VZKR_Internal_InflateGetBits(inf, 5) + 1;
+    i32 numCodeLength = (i32) VZKR_Internal_InflateGetBits(inf, 4) + 4;
+    if (numLengths > 286 || numDistances > 30) return false;
+
+    u8 codeLengths[19] = {0};
+    for (i32 i = 0; i < numCodeLength; i++) { codeLengths[codeLengthOrder[i]] = (u8) VZKR_Internal_InflateGetBits(inf, 3); }
+    if (!VZKR_Internal_BuildHuffman(&inf->lengths, codeLengths, 19)) return false;
+
+    i32 total = numLengths + numDistances;
+    for (i32 i = 0; i < total;)
+    {
+        if (inf->numBits < 32) VZKR_Internal_InflateRefill(inf);
+        if (inf->failed) return false;
+
+        i32 symbol = VZKR_Internal_InflateDecodeSymbol(inf, &inf->lengths);
+        if (symbol < 0) return false;
+        if (symbol < 16) { lengths[i++] = (u8) symbol; continue; }
+
+        u8 value = 0;
+        i32 repeat;
+        if (symbol == 16)
+        {
+            if (i == 0) return false;
+            value  = lengths[i - 1];
+            repeat = 3 + (i32) VZKR_Internal_InflateGetBits(inf, 2);
+        }
+        else if (symbol == 17) { repeat = 3  + (i32) VZKR_Internal_InflateGetBits(inf, 3); }
+        else                   { repeat = 11 + (i32) VZKR_Internal_InflateGetBits(inf, 7); }
+
+        if (repeat > total - i) return false;
+        for (; repeat > 0; repeat--) { lengths[i++] = value; }
+    }
+
+    if (lengths[256] == 0) return false; // there'd be no way to end the block
+    if (!VZKR_Internal_BuildHuffman(&inf->lengths, lengths, numLengths) || !VZKR_Internal_BuildHuffman(&inf->distances, lengths + numLengths, numDistances)) return false;
+
+    inf->phase = VZKR_INTERNAL_INFLATE_PHASE_HUFFMAN;
+    return !VZKR_Internal_InflateOverran(inf);
+}
+
+static void VZKR_Internal_InflateEndBlock(VZKR_Internal_Inflater* inf)
+{
+    inf->phase = inf->lastBlock ? VZKR_INTERNAL_INFLATE_PHASE_MEMBER_TRAILER : VZKR_INTERNAL_INFLATE_PHASE_BLOCK_HEADER;
+}
+
+/** Decodes Huffman coded data until the block ends, or there's no more room in the window. */
+static b8 VZKR_Internal_InflateHuffman(VZKR_Internal_Inflater* inf)
+{
+    static const u16 lengthBase[29]    = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const u8  lengthExtra[29]   = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const u16 distanceBase[30]  = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static const u8  distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    u8* window = inf->window;
+    i64 out    = inf->outEnd;
+    i64 limit  = VZKR_INTERNAL_INFLATE_BUFFER_SIZE - VZKR_INTERNAL_INFLATE_MAX_MATCH;
+    b8 success = true;
+
+    while (out <= limit)
+    {
+        // a literal/length, its extra bits, a distance and its extra bits take up to 48 bits
+        if (inf->numBits < 48)
+        {
+            VZKR_Internal_InflateRefill(inf);
+            if (inf->failed) { success = false; break; }
+        }
+
+        i32 symbol = VZKR_Internal_InflateDecodeSymbol(inf, &inf->lengths);
+        if (symbol < 256)
+        {
+            if (symbol < 0) { success = false; break; }
+            window[out++] = (u8) symbol;
+            continue;
+        }
+
+        if (symbol == 256)
+        {
+            VZKR_Internal_InflateEndBlock(inf);
+            success = !VZKR_Internal_InflateOverran(inf);
+            break;
+        }
+
+        symbol -= 257;
+        if (symbol >= 29) { success = false; break; }
+
+        i64 length = lengthBase[symbol];
+        if (lengthExtra[symbol])
+        {
+            length += (i64) (inf->bits & ((1u << lengthExtra[symbol]) - 1));
+            inf->bits    >>= lengthExtra[symbol];
+            inf->numBits  -= lengthExtra[symbol];
+        }
+
+        i32 distanceSymbol = VZKR_Internal_InflateDecodeSymbol(inf, &inf->distances);
+        if (distanceSymbol < 0 || distanceSymbol >= 30) { success = false; break; }
+
+        i64 distance = distanceBase[distanceSymbol];
+        if (distanceExtra[distanceSymbol])
+        {
+            distance += (i64) (inf->bits & ((1u << distanceExtra[distanceSymbol]) - 1));
+            inf->bits    >>= distanceExtra[distanceSymbol];
+            inf->numBits  -= distanceExtra[distanceSymbol];
+        }
+
+        if (distance > out - inf->windowStart) { success = false; break; }
+
+        // the window has some slack at the end, so the copies can overshoot a little
+        u8* dst       = window + out;
+        const u8* src = dst - distance;
+        if (distance >= 8)
+        {
+            for (i64 i = 0; i < length; i += 8) { VZKR_Internal_StoreU64(dst + i, VZKR_Internal_LoadU64(src + i)); }
+        }
+        else if (distance == 1)
+        {
+            PNSLR_MemSet(dst, *src, (i32) length);
+        }
+        else
+        {
+            for (i64 i = 0; i < length; i++) { dst[i] = src[i]; }
+        }
+
+        out += length;
+    }
+
+    inf->outEnd = out;
+    return success;
+}
+
+static b8 VZKR_Internal_InflateStored(VZKR_Internal_Inflater* inf)
+{
+    i64 room = VZKR_INTERNAL_INFLATE_BUFFER_SIZE - inf->outEnd;
+    while (inf->storedRemaining > 0 && room > 0)
+    {
+        // whatever's left in the bit buffer first, then straight from the input
+        if (inf->numBits - inf->padBytes * 8 >= 8)
+        {
+            u8 value = 0;
+            VZKR_Internal_InflateGetByte(inf, &value);
+            inf->window[inf->outEnd++] = value;
+            inf->storedRemaining--;
+            room--;
+            continue;
+        }
+
+        inf->bits    = 0;
+        inf->numBits = 0;
+        if (inf->in == inf->inEnd && !VZKR_Internal_InflatePull(inf)) return false;
+
+        i64 count = inf->inEnd - inf->in;
+        if (count > inf->storedRemaining) count = inf->storedRemaining;
+        if (count > room) count = room;
+
+        PNSLR_MemCopy(inf->window + inf->outEnd, (rawptr) inf->in, (i32) count);
+        inf->in              += count;
+        inf->outEnd          += count;
+        inf->storedRemaining -= count;
+        room                 -= count;
+    }
+
+    if (inf->storedRemaining == 0) VZKR_Internal_InflateEndBlock(inf);
+    return true;
+}
+
+static void VZKR_Internal_InflateUpdateChecksum(VZKR_Internal_Inflater* inf)
+{
+    const u8* data = inf->window + inf->checksumEnd;
+    i64 size = inf->outEnd - inf->checksumEnd;
+    if (size <= 0) return;
+
+    if (inf->format == VZKR_InflateFormat_Gzip) inf->checksum = VZKR_Internal_UpdateCrc32(inf->crcTable, inf->checksum, data, size);
+    if (inf->format == VZKR_InflateFormat_Zlib) inf->checksum = VZKR_Internal_UpdateAdler32(inf->checksum, data, size);
+
+    inf->memberSize += (u32) size;
+    inf->checksumEnd = inf->outEnd;
+}
+
+static b8 VZKR_Internal_InflateReadMemberHeader(VZKR_Internal_Inflater* inf)
+{
+    VZKR_Internal_InflateRefill(inf);
+    if (inf->failed || inf->numBits - inf->padBytes * 8 < 16) return false;
+
+    if (inf->format == VZKR_InflateFormat_Auto)
+    {
+        u32 first = (u32) (inf->bits & 0xFF), second = (u32) ((inf->bits >> 8) & 0xFF);
+        if (first == 0x1F && second == 0x8B)                                 inf->format = VZKR_InflateFormat_Gzip;
+        else if ((first & 0x0F) == 8 && ((first << 8) | second) % 31 == 0)   inf->format = VZKR_InflateFormat_Zlib;
+        else                                                                 inf->format = VZKR_InflateFormat_Raw;
+    }
+
+    if (inf->format == VZKR_InflateFormat_Zlib)
+    {
+        u32 cmf = VZKR_Internal_InflateGetBits(inf, 8), flg = VZKR_Internal_InflateGetBits(inf, 8);
+        if ((cmf & 0x0F) != 8 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20)) return false; // preset dictionaries aren't supported
+    }
+    else if (inf->format == VZKR_InflateFormat_Gzip)
+    {
+        u8 header[10];
+        for (i32 i = 0; i < 10; i++) { if (!VZKR_Internal_InflateGetByte(inf, &header[i])) return false; }
+        if (header[0] != 0x1F || header[1] != 0x8B || header[2] != 8 || (header[3] & 0xE0)) return false;
+
+        u8 flags = header[3], value = 0;
+        if (flags & 0x04)
+        {
+            // extra fields
+            u8 size[2];
+            if (!VZKR_Internal_InflateGetByte(inf, &size[0]) || !VZKR_Internal_InflateGetByte(inf, &size[1])) return false;
+            for (u32 i = 0, count = (u32) size[0] | ((u32) size[1] << 8); i < count; i++) { if (!VZKR_Internal_InflateGetByte(inf, &value)) return false; }
+        }
+
+        // the file name, then the comment, both zero-terminated
+        for (u8 flag = 0x08; flag <= 0x10; flag <<= 1)
+        {
+            if (!(flags & flag)) continue;
+            do { if (!VZKR_Internal_InflateGetByte(inf, &value)) return false; } while (value != 0);
+        }
+
+        if (flags & 0x02)
+        {
+            // header checksum
+            if (!VZKR_Internal_InflateGetByte(inf, &value) || !VZKR_Internal_InflateGetByte(inf, &value)) return false;
+        }
+    }
+
+    inf->checksum    = (inf->format == VZKR_InflateFormat_Zlib) ? 1 : 0;
+    inf->memberSize  = 0;
+    inf->windowStart = inf->outEnd;
+    inf->checksumEnd = inf->outEnd;
+    inf->phase       = VZKR_INTERNAL_INFLATE_PHASE_BLOCK_HEADER;
+    return true;
+}
+
+static b8 VZKR_Internal_InflateReadMemberTrailer(VZKR_Internal_Inflater* inf)
+{
+    VZKR_Internal_InflateUpdateChecksum(inf);
+    VZKR_Internal_InflateGetBits(inf, inf->numBits & 7);
+    inf->phase = VZKR_INTERNAL_INFLATE_PHASE_DONE;
+    if (inf->format == VZKR_InflateFormat_Raw) return true;
+
+    u8 trailer[8];
+    i32 size = (inf->format == VZKR_InflateFormat_Gzip) ? 8 : 4;
+    for (i32 i = 0; i < size; i++) { if (!VZKR_Internal_InflateGetByte(inf, &trailer[i])) return false; }
+
+    if (inf->format == VZKR_InflateFormat_Zlib)
+    {
+        u32 adler = ((u32) trailer[0] << 24) | ((u32) trailer[1] << 16) | ((u32) trailer[2] << 8) | (u32) trailer[3];
+        return adler == inf->checksum;
+    }
+
+    if (VZKR_Internal_ReadLE32(trailer) != inf->checksum || VZKR_Internal_ReadLE32(trailer + 4) != inf->memberSize) return false;
+
+    // another member could follow, but anything else is ignored
+    if (VZKR_Internal_InflateHasMoreInput(inf))
+    {
+        VZKR_Internal_InflateRefill(inf);
+        if (inf->numBits - inf->padBytes * 8 >= 16 && (inf->bits & 0xFFFF) == 0x8B1F) inf->phase = VZKR_INTERNAL_INFLATE_PHASE_MEMBER_HEADER;
+    }
+
+    return !inf->failed;
+}
+
+/**
+ * Decompresses some more into the window, sliding it along first if there isn't much
+ * room left. Stops early after each member, so callers can tell where members end.
+ * Returns false on failure.
+ */
+static b8 VZKR_Internal_InflateRun(VZKR_Internal_Inflater* inf)
+{
+    if (inf->failed) return false;
+
+    if (inf->outEnd > VZKR_INTERNAL_INFLATE_BUFFER_SIZE - VZKR_INTERNAL_INFLATE_MAX_MATCH - 1)
+    {
+        VZKR_Internal_InflateUpdateChecksum(inf);
+
+        i64 shift = inf->outEnd - VZKR_INTERNAL_INFLATE_WINDOW_SIZE;
+        PNSLR_MemMove(inf->window, inf->window + shift, VZKR_INTERNAL_INFLATE_WINDOW_SIZE);
+        inf->windowStart = (inf->windowStart > shift) ? inf->windowStart - shift : 0;
+        inf->outStart   -= shift;
+        inf->outEnd     -= shift;
+        inf->checksumEnd = inf->outEnd;
+    }
+
+    i64 startEnd = inf->outEnd;
+    b8 success = true;
+    while (success && inf->outEnd == startEnd)
+    {
+        switch (inf->phase)
+        {
+            case VZKR_INTERNAL_INFLATE_PHASE_MEMBER_HEADER:  success = VZKR_Internal_InflateReadMemberHeader(inf); break;
+            case VZKR_INTERNAL_INFLATE_PHASE_BLOCK_HEADER:   success = VZKR_Internal_InflateReadBlockHeader(inf);  break;
+            case VZKR_INTERNAL_INFLATE_PHASE_STORED:         success = VZKR_Internal_InflateStored(inf);           break;
+            case VZKR_INTERNAL_INFLATE_PHASE_HUFFMAN:        success = VZKR_Internal_InflateHuffman(inf);          break;
+            case VZKR_INTERNAL_INFLATE_PHASE_MEMBER_TRAILER:
+                success = VZKR_Internal_InflateReadMemberTrailer(inf);
+                if (success) return true;
+                break;
+            default:
+                return true;
+        }
+    }
+
+    if (!success) inf->failed = true;
+    return success;
+}
+
+static VZKR_Internal_Inflater* VZKR_Internal_CreateInflater(PNSLR_Stream inner, VZKR_InflateFormat format, PNSLR_Allocator allocator)
+{
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_Inflater* inf = (VZKR_Internal_Inflater*) PNSLR_Allocate(allocator, false, (i32) sizeof(VZKR_Internal_Inflater), (i32) alignof(VZKR_Internal_Inflater), PNSLR_GET_LOC(), &err);
+    if (!inf || err != PNSLR_AllocatorError_None) return nil;
+
+    *inf = (VZKR_Internal_Inflater) {.allocator = allocator, .inner = inner, .format = format};
+    inf->window = (u8*) PNSLR_Allocate(allocator, false, VZKR_INTERNAL_INFLATE_BUFFER_SIZE + 8, 16, PNSLR_GET_LOC(), &err);
+    if (inner.procedure && err == PNSLR_AllocatorError_None) inf->inBuffer = PNSLR_MakeSlice(u8, VZKR_INTERNAL_INFLATE_INPUT_SIZE, false, allocator, PNSLR_GET_LOC(), &err);
+
+    if (!inf->window || err != PNSLR_AllocatorError_None)
+    {
+        if (inf->window) PNSLR_Free(allocator, inf->window, PNSLR_GET_LOC(), nil);
+        PNSLR_Free(allocator, inf, PNSLR_GET_LOC(), nil);
+        return nil;
+    }
+
+    VZKR_Internal_InitCrc32Table(inf->crcTable);
+    return inf;
+}
+
+static void VZKR_Internal_DestroyInflater(VZKR_Internal_Inflater* inf)
+{
+    PNSLR_Allocator allocator = inf->allocator;
+    PNSLR_FreeSlice(&inf->inBuffer, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_Free(allocator, inf->window, PNSLR_GET_LOC(), nil);
+    PNSLR_Free(allocator, inf, PNSLR_GET_LOC(), nil);
+}
+
+/** Starts over, decompressing a new stream from memory. */
+static void VZKR_Internal_ResetInflater(VZKR_Internal_Inflater* inf, const u8* data, i64 size)
+{
+    inf->phase           = VZKR_INTERNAL_INFLATE_PHASE_MEMBER_HEADER;
+    inf->failed          = false;
+    inf->in              = data;
+    inf->inEnd           = data + size;
+    inf->bits            = 0;
+    inf->numBits         = 0;
+    inf->padBytes        = 0;
+    inf->windowStart     = 0;
+    inf->outStart        = 0;
+    inf->outEnd          = 0;
+    inf->checksumEnd     = 0;
+}
+
+/** How far into the input the decompression has got, not counting what's in the bit buffer. */
+static i64 VZKR_Internal_InflateInputOffset(VZKR_Internal_Inflater* inf, const u8* data)
+{
+    return (inf->in - data) - (inf->numBits - inf->padBytes * 8) / 8;
+}
+
+b8 VZKR_CreateInflateStream(
+    PNSLR_Stream inner,
+    VZKR_InflateFormat format,
+    PNSLR_Allocator allocator,
+    VZKR_InflateStream* output
+)
+{
+    if (!output || !inner.procedure) return false;
+    *output = (VZKR_InflateStream) {0};
+
+    VZKR_Internal_Inflater* inf = VZKR_Internal_CreateInflater(inner, format, allocator);
+    if (!inf) return false;
+
+    VZKR_Internal_ResetInflater(inf, nil, 0);
+    output->allocator = allocator;
+    output->decoder   = inf;
+    return true;
+}
+
+static b8 VZKR_Internal_InflateStreamRead(VZKR_InflateStream* stream, PNSLR_ArraySlice(u8) dst, i64* readSize)
+{
+    VZKR_Internal_Inflater* inf = (VZKR_Internal_Inflater*) stream->decoder;
+
+    i64 copied = 0;
+    while (copied < dst.count)
+    {
+        if (inf->outStart == inf->outEnd)
+        {
+            if (inf->phase == VZKR_INTERNAL_INFLATE_PHASE_DONE) break;
+            if (!VZKR_Internal_InflateRun(inf)) { if (readSize) *readSize = copied; return false; }
+            continue;
+        }
+
+        i64 count = inf->outEnd - inf->outStart;
+        if (count > dst.count - copied) count = dst.count - copied;
+        if (dst.data) PNSLR_MemCopy(dst.data + copied, inf->window + inf->outStart, (i32) count);
+        inf->outStart += count;
+        copied        += count;
+    }
+
+    stream->position += copied;
+    if (readSize) *readSize = copied;
+    return true;
+}
+
+static b8 VZKR_Internal_InflateStreamProc(
+    rawptr streamData,
+    PNSLR_StreamMode mode,
+    PNSLR_ArraySlice(u8) data,
+    i64 offset,
+    i64* extraRet
+)
+{
+    VZKR_InflateStream* stream = (VZKR_InflateStream*) streamData;
+    if (!stream || !stream->decoder) return false;
+
+    switch (mode)
+    {
+        case PNSLR_StreamMode_GetCurrentPos:
+            if (extraRet) *extraRet = stream->position;
+            return true;
+        case PNSLR_StreamMode_SeekAbsolute:
+        case PNSLR_StreamMode_SeekRelative:
+        {
+            // forward only, by decompressing and throwing it away
+            i64 skip = (mode == PNSLR_StreamMode_SeekRelative) ? offset : offset - stream->position;
+            if (skip <= 0) return skip == 0;
+
+            i64 skipped = 0;
+            return VZKR_Internal_InflateStreamRead(stream, (PNSLR_ArraySlice(u8)) {.data = nil, .count = skip}, &skipped) && skipped == skip;
+        }
+        case PNSLR_StreamMode_Read:
+            return VZKR_Internal_InflateStreamRead(stream, data, extraRet);
+        case PNSLR_StreamMode_Flush:
+            return true;
+        case PNSLR_StreamMode_Close:
+        {
+            VZKR_Internal_Inflater* inf = (VZKR_Internal_Inflater*) stream->decoder;
+            PNSLR_CloseStream(inf->inner);
+            VZKR_Internal_DestroyInflater(inf);
+            *stream = (VZKR_InflateStream) {0};
+            return true;
+        }
+        default:
+            // the size isn't known until everything's decompressed, and writing isn't supported
+            return false;
+    }
+}
+
+PNSLR_Stream VZKR_StreamFromInflateStream(VZKR_InflateStream* stream)
+{
+    return (PNSLR_Stream) {.procedure = VZKR_Internal_InflateStreamProc, .data = (rawptr) stream};
+}
+
+typedef struct VZKR_Internal_GzipSegment
+{
+    PNSLR_ArraySlice(u8) src;
+    PNSLR_Allocator allocator;
+    i64 searchStart; // where this segment's share of the file begins
+    i64 searchEnd;   // and where the next one's does
+    i64 start;       // where its first member was found
+    i64 end;         // where it stopped, after the first member that ends past 'searchEnd'
+    PNSLR_ArraySlice(u8) output;
+    i64 outputSize;
+    b8 failed;
+} VZKR_Internal_GzipSegment;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_Internal_GzipSegment);
+
+/** Decompresses members from 'start' onwards, until one ends past 'searchEnd'. */
+static b8 VZKR_Internal_GzipDecodeMembers(VZKR_Internal_GzipSegment* segment, VZKR_Internal_Inflater* inf, i64 start)
+{
+    VZKR_Internal_ResetInflater(inf, segment->src.data + start, segment->src.count - start);
+    inf->format = VZKR_InflateFormat_Gzip;
+    segment->outputSize = 0;
+
+    while (true)
+    {
+        if (!VZKR_Internal_InflateRun(inf)) return false;
+
+        i64 count = inf->outEnd - inf->outStart;
+        if (segment->outputSize + count > segment->output.count)
+        {
+            i64 capacity = segment->output.count ? segment->output.count : 1024 * 1024;
+            while (capacity < segment->outputSize + count) { capacity *= 2; }
+
+            PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+            PNSLR_ResizeSlice(u8, &segment->output, capacity, false, segment->allocator, PNSLR_GET_LOC(), &err);
+            if (err != PNSLR_AllocatorError_None) return false;
+        }
+
+        PNSLR_MemCopy(segment->output.data + segment->outputSize, inf->window + inf->outStart, (i32) count);
+        segment->outputSize += count;
+        inf->outStart        = inf->outEnd;
+
+        // members finish with the phase moving on to the next one (or the end)
+        b8 memberDone = (inf->phase == VZKR_INTERNAL_INFLATE_PHASE_MEMBER_HEADER || inf->phase == VZKR_INTERNAL_INFLATE_PHASE_DONE);
+        if (!memberDone) continue;
+
+        segment->end = start + VZKR_Internal_InflateInputOffset(inf, segment->src.data + start);
+        if (inf->phase == VZKR_INTERNAL_INFLATE_PHASE_DONE || segment->end >= segment->searchEnd) return true;
+    }
+}
+
+static void VZKR_Internal_GzipSegmentWorker(rawptr arg)
+{
+    VZKR_Internal_GzipSegment* segment = (VZKR_Internal_GzipSegment*) arg;
+    VZKR_Internal_Inflater* inf = VZKR_Internal_CreateInflater((PNSLR_Stream) {0}, VZKR_InflateFormat_Gzip, segment->allocator);
+    if (!inf) { segment->failed = true; return; }
+
+    // the first segment starts at the start, the others at the first spot within their own
+    // share that looks like a member header, and decompresses as one (the checksum makes
+    // false starts unlikely); one that finds none is within the member before it
+    b8 found = false;
+    segment->start = segment->src.count;
+    segment->end   = segment->src.count;
+    for (i64 i = segment->searchStart; !found && i < segment->searchEnd && i + 10 <= segment->src.count; i++)
+    {
+        const u8* header = segment->src.data + i;
+        b8 candidate = header[0] == 0x1F && header[1] == 0x8B && header[2] == 8 && !(header[3] & 0xE0);
+        if (candidate) found = VZKR_Internal_GzipDecodeMembers(segment, inf, i);
+        if (found) segment->start = i;
+        if (segment->searchStart == 0) break;
+    }
+
+    if (segment->searchStart == 0 && !found) segment->failed = true;
+    VZKR_Internal_DestroyInflater(inf);
+}
+
+#define VZKR_INTERNAL_GZIP_MIN_SEGMENT_SIZE (1024 * 1024) // smaller files aren't worth splitting up
+
+b8 VZKR_DecompressGzipParallel(
+    PNSLR_ArraySlice(u8) src,
+    i32 numThreads,
+    PNSLR_Allocator allocator,
+    PNSLR_ArraySlice(u8)* output
+)
+{
+    if (!output) return false;
+    *output = (PNSLR_ArraySlice(u8)) {0};
+
+    if (numThreads <= 0) numThreads = VZKR_INTERNAL_LZ4_DEFAULT_THREADS;
+    if (numThreads > src.count / VZKR_INTERNAL_GZIP_MIN_SEGMENT_SIZE) numThreads = (i32) (src.count / VZKR_INTERNAL_GZIP_MIN_SEGMENT_SIZE);
+    if (numThreads < 1) numThreads = 1;
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    PNSLR_AllocatorError threadsErr = PNSLR_AllocatorError_None;
+    PNSLR_ArraySlice(VZKR_Internal_GzipSegment) segments = PNSLR_MakeSlice(VZKR_Internal_GzipSegment, numThreads, true, allocator, PNSLR_GET_LOC(), &err);
+    PNSLR_ArraySlice(VZKR_Thread) threads = PNSLR_MakeSlice(VZKR_Thread, numThreads, true, allocator, PNSLR_GET_LOC(), &threadsErr);
+    if (err != PNSLR_AllocatorError_None || threadsErr != PNSLR_AllocatorError_None)
+    {
+        PNSLR_FreeSlice(&segments, allocator, PNSLR_GET_LOC(), nil);
+        PNSLR_FreeSlice(&threads, allocator, PNSLR_GET_LOC(), nil);
+        return false;
+    }
+
+    for (i32 i = 0; i < numThreads; i++)
+    {
+        segments.data[i] = (VZKR_Internal_GzipSegment)
+        {
+            .src         = src,
+            .allocator   = allocator,
+            .searchStart = src.count * i / numThreads,
+            .searchEnd   = src.count * (i + 1) / numThreads,
+        };
+    }
+
+    // the calling thread takes the first segment
+    VZKR_ThreadOptions threadOptions = {.name = PNSLR_StringLiteral("VzkrGzip")};
+    for (i32 i = 1; i < numThreads; i++)
+    {
+        threads.data[i] = VZKR_CreateThread(VZKR_Internal_GzipSegmentWorker, &segments.data[i], threadOptions, allocator);
+        if (!threads.data[i].handle) break;
+    }
+
+    // segments whose thread couldn't start are picked up by the calling thread
+    for (i32 i = 0; i < numThreads; i++)
+    {
+        if (!threads.data[i].handle) VZKR_Internal_GzipSegmentWorker(&segments.data[i]);
+    }
+
+    for (i32 i = 1; i < numThreads; i++) { VZKR_JoinThread(&threads.data[i]); }
+
+    // each segment has to pick up exactly where the one before it stopped; if not (a false
+    // start, most likely) the whole thing is redone on a single segment
+    b8 success = !segments.data[0].failed;
+    i64 total = 0, pos = segments.data[0].end;
+    for (i32 i = 1; success && i < numThreads; i++)
+    {
+        VZKR_Internal_GzipSegment* segment = &segments.data[i];
+        if (segment->start == src.count) continue; // within the previous segment's last member
+        if (segment->failed || segment->start != pos) { success = false; break; }
+        pos = segment->end;
+    }
+
+    if (!success && numThreads > 1 && !segments.data[0].failed)
+    {
+        VZKR_Internal_GzipSegment* first = &segments.data[0];
+        first->searchEnd = src.count;
+        VZKR_Internal_GzipSegmentWorker(first);
+        success = !first->failed;
+        for (i32 i = 1; i < numThreads; i++) { segments.data[i].outputSize = 0; segments.data[i].start = src.count; }
+    }
+
+    for (i32 i = 0; success && i < numThreads; i++) { total += segments.data[i].outputSize; }
+
+    PNSLR_ArraySlice(u8) buffer = {0};
+    if (success)
+    {
+        buffer = PNSLR_MakeSlice(u8, total > 0 ? total : 1, false, allocator, PNSLR_GET_LOC(), &err);
+        success = (err == PNSLR_AllocatorError_None);
+    }
+
+    i64 written = 0;
+    for (i32 i = 0; i < numThreads; i++)
+    {
+        VZKR_Internal_GzipSegment* segment = &segments.data[i];
+        if (success && segment->outputSize > 0) PNSLR_MemCopy(buffer.data + written, segment->output.data, (i32) segment->outputSize);
+        written += segment->outputSize;
+        PNSLR_FreeSlice(&segment->output, allocator, PNSLR_GET_LOC(), nil);
+    }
+
+    PNSLR_FreeSlice(&segments, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&threads, allocator, PNSLR_GET_LOC(), nil);
+    if (!success) return false;
+
+    output->data  = buffer.data;
+    output->count = total;
+    return true;
+}
@@ -0,0 +1,188 @@
+#ifndef VZKR_COMPRESSION_H // ======================================================
+#define VZKR_COMPRESSION_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// LZ4 Blocks ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Gets the largest size that 'size' bytes can take up once compressed as an LZ4 block,
+ * for sizing the output of `VZKR_CompressLz4Block`.
+ */
+i64 VZKR_GetLz4CompressedSizeBound(
+    i64 size
+);
+
+/**
+ * Compresses data as a single LZ4 block (the raw block format, without a frame).
+ * 'dst' should be at least `VZKR_GetLz4CompressedSizeBound` bytes to be sure it fits.
+ * Returns true on success, false if it didn't fit.
+ */
+b8 VZKR_CompressLz4Block(
+    PNSLR_ArraySlice(u8) src,
+    PNSLR_ArraySlice(u8) dst,
+    i64* compressedSize
+);
+
+/**
+ * Decompresses a single LZ4 block. Safe against malformed input.
+ * Returns true on success, false if the block is malformed or doesn't fit in 'dst'.
+ */
+b8 VZKR_DecompressLz4Block(
+    PNSLR_ArraySlice(u8) src,
+    PNSLR_ArraySlice(u8) dst,
+    i64* decompressedSize
+);
+
+// LZ4 Frames ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Decompresses an entire LZ4 frame (or several back to back) that's already in memory.
+ * Frames with independent blocks (as written by `VZKR_CreateLz4CompressStream`) are
+ * decompressed on several threads at once (4 if 'numThreads' isn't positive), frames
+ * with linked blocks one block at a time.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_DecompressLz4FrameParallel(
+    PNSLR_ArraySlice(u8) src,
+    i32 numThreads,
+    PNSLR_Allocator allocator,
+    PNSLR_ArraySlice(u8)* output
+);
+
+// LZ4 Streams ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Compresses data written to it into another stream, or decompresses data read from
+ * another stream, in the standard LZ4 frame format (readable by the `lz4` tool).
+ *
+ * Compressed frames are made of independent blocks, so they can be decompressed in
+ * parallel. Decompression handles independent and linked blocks, concatenated frames,
+ * and skips over checksums without verifying them; frames using dictionaries aren't
+ * supported.
+ *
+ * Only one direction works at a time, and seeking is limited to skipping forward while
+ * decompressing. Closing the stream finishes the frame (when compressing), closes the
+ * underlying stream and frees the buffers. Not thread-safe.
+ */
+typedef struct VZKR_Lz4Stream
+{
+    PNSLR_Allocator allocator;
+    PNSLR_Stream inner;
+    b8 compressing;
+    b8 inFrame;
+    b8 finished;
+    u8 frameFlags;
+    i64 blockSize;
+    i64 contentSize;
+    PNSLR_ArraySlice(u8) rawBuffer;
+    PNSLR_ArraySlice(u8) packedBuffer;
+    i64 rawStart;
+    i64 rawEnd;
+    i64 position;
+} VZKR_Lz4Stream;
+
+/**
+ * Creates a stream that compresses everything written to it into another stream.
+ * The block size is rounded up to one LZ4 supports (64KiB, 256KiB, 1MiB or 4MiB),
+ * and defaults to 1MiB if not positive.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_CreateLz4CompressStream(
+    PNSLR_Stream inner,
+    i32 blockSize,
+    PNSLR_Allocator allocator,
+    VZKR_Lz4Stream* output
+);
+
+/**
+ * Creates a stream that decompresses another stream as it's read.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_CreateLz4DecompressStream(
+    PNSLR_Stream inner,
+    PNSLR_Allocator allocator,
+    VZKR_Lz4Stream* output
+);
+
+/**
+ * Creates a stream that compresses/decompresses through an LZ4 stream.
+ * The LZ4 stream must outlive the returned stream.
+ */
+PNSLR_Stream VZKR_StreamFromLz4Stream(
+    VZKR_Lz4Stream* stream
+);
+
+// Inflate Streams ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * The container around DEFLATE compressed data.
+ * 'Auto' detects gzip and zlib headers, and treats anything else as raw DEFLATE.
+ */
+typedef u8 VZKR_InflateFormat /* use as value */;
+#define VZKR_InflateFormat_Auto ((VZKR_InflateFormat) 0)
+#define VZKR_InflateFormat_Raw ((VZKR_InflateFormat) 1)
+#define VZKR_InflateFormat_Zlib ((VZKR_InflateFormat) 2)
+#define VZKR_InflateFormat_Gzip ((VZKR_InflateFormat) 3)
+
+/**
+ * Decompresses DEFLATE data (.gz files, zlib streams) read from another stream, as it's
+ * read, so only a small window of it is ever in memory.
+ *
+ * Gzip files with several members (as made by concatenating them, or by tools like
+ * pigz and bgzip) are decompressed one after the other; anything after the last
+ * member that isn't another member is ignored, like the `gzip` tool does. Checksums are
+ * verified at the end of each member, and reading fails if they don't match.
+ *
+ * Seeking is limited to skipping forward. Closing the stream closes the underlying
+ * stream and frees the decoder. Not thread-safe.
+ */
+typedef struct VZKR_InflateStream
+{
+    PNSLR_Allocator allocator;
+    rawptr decoder;
+    i64 position;
+} VZKR_InflateStream;
+
+/**
+ * Creates a stream that decompresses another stream as it's read.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_CreateInflateStream(
+    PNSLR_Stream inner,
+    VZKR_InflateFormat format,
+    PNSLR_Allocator allocator,
+    VZKR_InflateStream* output
+);
+
+/**
+ * Creates a stream that decompresses through an inflate stream.
+ * The inflate stream must outlive the returned stream.
+ */
+PNSLR_Stream VZKR_StreamFromInflateStream(
+    VZKR_InflateStream* stream
+);
+
+/**
+ * Decompresses a whole gzip file that's already in memory (mapped, for example).
+ * Files made of several members are split up between threads (4 if 'numThreads' isn't
+ * positive), each finding the first member after its share of the file begins and
+ * decompressing from there; files with a single member are decompressed on one thread.
+ * The allocator must be thread-safe.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_DecompressGzipParallel(
+    PNSLR_ArraySlice(u8) src,
+    i32 numThreads,
+    PNSLR_Allocator allocator,
+    PNSLR_ArraySlice(u8)* output
+);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_COMPRESSION_H =======================================================
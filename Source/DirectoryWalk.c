@@ -0,0 +1,449 @@
+#define VZKR_IMPLEMENTATION
+#include "DirectoryWalk.h"
+
+// Internal Declarations ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_DIRECTORY_SCAN_DEFAULT_THREADS 4
+#define VZKR_INTERNAL_DIRECTORY_SCAN_BATCH_SIZE      4096
+#define VZKR_INTERNAL_DIRECTORY_SCAN_ARENA_PAGE      (1024 * 1024)
+#define VZKR_INTERNAL_DIRECTORY_SCAN_DENTS_SIZE      (64 * 1024)
+
+#if PNSLR_LINUX
+    // the layout getdents64 fills in, not exposed by every libc
+    typedef struct VZKR_Internal_LinuxDirent64
+    {
+        u64 inode;
+        i64 offset;
+        u16 recordLength;
+        u8 type;
+        char name[1];
+    } VZKR_Internal_LinuxDirent64;
+#endif
+
+PNSLR_DECLARE_ARRAY_SLICE(PNSLR_Path);
+
+typedef struct VZKR_Internal_DirectoryScan
+{
+    PNSLR_Allocator allocator;
+    b8 skipDirectories;
+    VZKR_ProfiledMutex mutex;
+    PNSLR_ConditionVariable workAvailable;
+    PNSLR_ArraySlice(PNSLR_Path) pending; // used as a stack, to stay close to depth-first
+    i64 numPending;
+    i32 numBusy;
+    b8 failed;
+} VZKR_Internal_DirectoryScan;
+
+typedef struct VZKR_Internal_DirectoryScanWorker
+{
+    VZKR_Internal_DirectoryScan* scan;
+    PNSLR_Allocator arena;
+    PNSLR_ArraySlice(VZKR_DirectoryScanBatch) batches;
+    i64 numBatches;
+    i64 currentCapacity;
+    i64 numEntries;
+    PNSLR_ArraySlice(PNSLR_Path) subdirectories;
+    i64 numSubdirectories;
+    PNSLR_ArraySlice(u8) scratch;
+} VZKR_Internal_DirectoryScanWorker;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_Internal_DirectoryScanWorker);
+
+// Collecting Entries ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/** Doubles a slice's capacity if it's full. */
+#define VZKR_INTERNAL_ENSURE_ROOM(ty, slice, used, allocator, success)                                      \
+    do                                                                                                     \
+    {                                                                                                      \
+        if ((used) < (slice).count) break;                                                                 \
+        PNSLR_AllocatorError err__ = PNSLR_AllocatorError_None;                                            \
+        PNSLR_ResizeSlice(ty, &(slice), (slice).count ? (slice).count * 2 : 64, false, allocator, PNSLR_GET_LOC(), &err__); \
+        if (err__ != PNSLR_AllocatorError_None) success = false;                                            \
+    } while (0)
+
+static b8 VZKR_Internal_DirectoryScanAddEntry(
+    VZKR_Internal_DirectoryScanWorker* worker,
+    PNSLR_Path dir,
+    const char* name,
+    i64 nameLength,
+    b8 isDirectory
+)
+{
+    // skip '.' and '..'
+    if (name[0] == '.' && (nameLength == 1 || (nameLength == 2 && name[1] == '.'))) return true;
+
+    VZKR_Internal_DirectoryScan* scan = worker->scan;
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+
+    // nul-terminated, so it can be handed straight back to the OS
+    i64 length = dir.path.count + nameLength + (isDirectory ? 1 : 0);
+    u8* data = (u8*) PNSLR_Allocate(worker->arena, false, (i32) length + 1, 1, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !data) return false;
+
+    PNSLR_MemCopy(data, dir.path.data, (i32) dir.path.count);
+    PNSLR_MemCopy(data + dir.path.count, (rawptr) name, (i32) nameLength);
+    if (isDirectory) data[length - 1] = '/';
+    data[length] = '\0';
+
+    PNSLR_Path path = {.path = {.data = data, .count = length}};
+
+    if (isDirectory)
+    {
+        b8 success = true;
+        VZKR_INTERNAL_ENSURE_ROOM(PNSLR_Path, worker->subdirectories, worker->numSubdirectories, scan->allocator, success);
+        if (!success) return false;
+        worker->subdirectories.data[worker->numSubdirectories++] = path;
+        if (scan->skipDirectories) return true;
+    }
+
+    // start a new batch when the current one is full
+    VZKR_DirectoryScanBatch* batch = worker->numBatches ? &worker->batches.data[worker->numBatches - 1] : nil;
+    if (!batch || batch->entries.count == worker->currentCapacity)
+    {
+        b8 success = true;
+        VZKR_INTERNAL_ENSURE_ROOM(VZKR_DirectoryScanBatch, worker->batches, worker->numBatches, scan->allocator, success);
+        if (!success) return false;
+
+        batch = &worker->batches.data[worker->numBatches++];
+        batch->entries = PNSLR_MakeSlice(VZKR_DirectoryScanEntry, VZKR_INTERNAL_DIRECTORY_SCAN_BATCH_SIZE, false, worker->arena, PNSLR_GET_LOC(), &err);
+        if (err != PNSLR_AllocatorError_None) { worker->numBatches--; return false; }
+
+        worker->currentCapacity = batch->entries.count;
+        batch->entries.count    = 0;
+    }
+
+    batch->entries.data[batch->entries.count++] = (VZKR_DirectoryScanEntry) {.path = path, .isDirectory = isDirectory};
+    worker->numEntries++;
+    return true;
+}
+
+// Reading Directories ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Reads every entry in a single directory. Subdirectories are collected in the worker.
+ * Returns false only on allocation failures, unreadable directories are skipped.
+ */
+static b8 VZKR_Internal_DirectoryScanReadOne(VZKR_Internal_DirectoryScanWorker* worker, PNSLR_Path dir)
+{
+    #if PNSLR_LINUX
+        int fd = open((const char*) dir.path.data, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) return true;
+
+        b8 success = true;
+        while (success)
+        {
+            long numRead = syscall(SYS_getdents64, fd, worker->scratch.data, (unsigned) worker->scratch.count);
+            if (numRead < 0 && errno == EINTR) continue;
+            if (numRead <= 0) break;
+
+            for (long pos = 0; pos < numRead && success;)
+            {
+                VZKR_Internal_LinuxDirent64* ent = (VZKR_Internal_LinuxDirent64*) (worker->scratch.data + pos);
+                pos += ent->recordLength;
+
+                b8 isDirectory = (ent->type == DT_DIR);
+                if (ent->type == DT_UNKNOWN)
+                {
+                    // some filesystems don't fill the type in
+                    struct stat st;
+                    if (fstatat(fd, ent->name, &st, AT_SYMLINK_NOFOLLOW) != 0) continue;
+                    isDirectory = S_ISDIR(st.st_mode);
+                }
+
+                i64 nameLength = 0;
+                while (ent->name[nameLength]) { nameLength++; }
+                success = VZKR_Internal_DirectoryScanAddEntry(worker, dir, ent->name, nameLength, isDirectory);
+            }
+        }
+
+        close(fd);
+        return success;
+    #elif PNSLR_UNIX
+        DIR* handle = opendir((const char*) dir.path.data);
+        if (!handle) return true;
+
+        b8 success = true;
+        struct dirent* ent;
+        while (success && (ent = readdir(handle)) != nil)
+        {
+            b8 isDirectory = (ent->d_type == DT_DIR);
+            if (ent->d_type == DT_UNKNOWN)
+            {
+                struct stat st;
+                if (fstatat(dirfd(handle), ent->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) continue;
+                isDirectory = S_ISDIR(st.st_mode);
+            }
+
+            i64 nameLength = 0;
+            while (ent->d_name[nameLength]) { nameLength++; }
+            success = VZKR_Internal_DirectoryScanAddEntry(worker, dir, ent->d_name, nameLength, isDirectory);
+        }
+
+        closedir(handle);
+        return success;
+    #elif PNSLR_WINDOWS
+        // the scratch buffer holds the wide search pattern first, then the utf-8 names
+        wchar_t* pattern = (wchar_t*) worker->scratch.data;
+        i32 maxWide = (i32) (worker->scratch.count / 2 / (i64) sizeof(wchar_t));
+        i32 numWide = MultiByteToWideChar(CP_UTF8, 0, (LPCCH) dir.path.data, (i32) dir.path.count, pattern, maxWide - 2);
+        if (numWide <= 0) return true;
+        pattern[numWide]     = L'*';
+        pattern[numWide + 1] = L'\0';
+
+        WIN32_FIND_DATAW data;
+        HANDLE find = FindFirstFileExW(pattern, FindExInfoBasic, &data, FindExSearchNameMatch, nil, FIND_FIRST_EX_LARGE_FETCH);
+        if (find == INVALID_HANDLE_VALUE) return true;
+
+        char* name = (char*) (worker->scratch.data + worker->scratch.count / 2);
+        i32 maxName = (i32) (worker->scratch.count / 2);
+        b8 success = true;
+        do
+        {
+            i32 nameLength = WideCharToMultiByte(CP_UTF8, 0, data.cFileName, -1, name, maxName, nil, nil) - 1;
+            if (nameLength <= 0) continue;
+
+            // reparse points (symlinks/junctions) aren't followed, so they can't loop
+            b8 isDirectory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && !(data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT);
+            success = VZKR_Internal_DirectoryScanAddEntry(worker, dir, name, nameLength, isDirectory);
+        } while (success && FindNextFileW(find, &data));
+
+        FindClose(find);
+        return success;
+    #endif
+}
+
+static void VZKR_Internal_DirectoryScanWorkerLoop(rawptr arg)
+{
+    VZKR_Internal_DirectoryScanWorker* worker = (VZKR_Internal_DirectoryScanWorker*) arg;
+    VZKR_Internal_DirectoryScan* scan = worker->scan;
+
+    VZKR_LockProfiledMutex(&scan->mutex);
+    while (true)
+    {
+        while (scan->numPending == 0 && scan->numBusy > 0 && !scan->failed) { VZKR_WaitProfiledConditionVariable(&scan->workAvailable, &scan->mutex); }
+        if (scan->numPending == 0 || scan->failed) break;
+
+        PNSLR_Path dir = scan->pending.data[--scan->numPending];
+        scan->numBusy++;
+        VZKR_UnlockProfiledMutex(&scan->mutex);
+
+        worker->numSubdirectories = 0;
+        b8 success = VZKR_Internal_DirectoryScanReadOne(worker, dir);
+
+        // hand the subdirectories over all at once
+        VZKR_LockProfiledMutex(&scan->mutex);
+        scan->numBusy--;
+        if (!success) scan->failed = true;
+
+        i64 needed = scan->numPending + worker->numSubdirectories;
+        if (success && needed > scan->pending.count)
+        {
+            PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+            i64 newCount = scan->pending.count * 2;
+            if (newCount < needed) newCount = needed;
+            PNSLR_ResizeSlice(PNSLR_Path, &scan->pending, newCount, false, scan->allocator, PNSLR_GET_LOC(), &err);
+            if (err != PNSLR_AllocatorError_None) scan->failed = true;
+        }
+
+        if (!scan->failed)
+        {
+            for (i64 i = 0; i < worker->numSubdirectories; i++) { scan->pending.data[scan->numPending++] = worker->subdirectories.data[i]; }
+        }
+
+        if (scan->failed || worker->numSubdirectories > 1 || (scan->numPending == 0 && scan->numBusy == 0))
+        {
+            PNSLR_BroadcastConditionVariable(&scan->workAvailable);
+        }
+        else if (worker->numSubdirectories == 1)
+        {
+            PNSLR_SignalConditionVariable(&scan->workAvailable);
+        }
+    }
+
+    // let the others know that there's nothing left
+    PNSLR_BroadcastConditionVariable(&scan->workAvailable);
+    VZKR_UnlockProfiledMutex(&scan->mutex);
+}
+
+// Sorting ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+static b8 VZKR_Internal_DirectoryScanEntryLess(const VZKR_DirectoryScanEntry* a, const VZKR_DirectoryScanEntry* b)
+{
+    i64 n = a->path.path.count < b->path.path.count ? a->path.path.count : b->path.path.count;
+    for (i64 i = 0; i < n; i++)
+    {
+        u8 x = a->path.path.data[i], y = b->path.path.data[i];
+        if (x != y) return x < y;
+    }
+
+    return a->path.path.count < b->path.path.count;
+}
+
+/** Bottom-up merge sort, stable and without recursion. */
+static void VZKR_Internal_DirectoryScanSort(VZKR_DirectoryScanEntry* entries, VZKR_DirectoryScanEntry* temp, i64 count)
+{
+    VZKR_DirectoryScanEntry* src = entries;
+    VZKR_DirectoryScanEntry* dst = temp;
+    for (i64 width = 1; width < count; width *= 2)
+    {
+        for (i64 lo = 0; lo < count; lo += width * 2)
+        {
+            i64 mid = lo + width < count ? lo + width : count;
+            i64 hi  = lo + width * 2 < count ? lo + width * 2 : count;
+            i64 i = lo, j = mid, k = lo;
+            while (i < mid && j < hi) { dst[k++] = VZKR_Internal_DirectoryScanEntryLess(&src[j], &src[i]) ? src[j++] : src[i++]; }
+            while (i < mid) { dst[k++] = src[i++]; }
+            while (j < hi)  { dst[k++] = src[j++]; }
+        }
+
+        VZKR_DirectoryScanEntry* swap = src; src = dst; dst = swap;
+    }
+
+    if (src != entries)
+    {
+        for (i64 i = 0; i < count; i++) { entries[i] = src[i]; }
+    }
+}
+
+// Directory Scan Functions ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+b8 VZKR_ScanDirectory(
+    PNSLR_Path root,
+    VZKR_DirectoryScanOptions options,
+    PNSLR_Allocator allocator,
+    VZKR_DirectoryScanResult* output
+)
+{
+    if (!output) return false;
+    *output = (VZKR_DirectoryScanResult) {.allocator = allocator};
+    if (root.path.count <= 0) return false;
+
+    i32 numThreads = options.numThreads > 0 ? options.numThreads : VZKR_INTERNAL_DIRECTORY_SCAN_DEFAULT_THREADS;
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_DirectoryScan scan = {.allocator = allocator, .skipDirectories = options.skipDirectories};
+    PNSLR_ArraySlice(VZKR_Internal_DirectoryScanWorker) workers = PNSLR_MakeSlice(VZKR_Internal_DirectoryScanWorker, numThreads, true, allocator, PNSLR_GET_LOC(), &err);
+    PNSLR_ArraySlice(VZKR_Thread) threads = {0};
+    if (err == PNSLR_AllocatorError_None) threads        = PNSLR_MakeSlice(VZKR_Thread, numThreads, true, allocator, PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) output->arenas = PNSLR_MakeSlice(PNSLR_Allocator, numThreads, true, allocator, PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) scan.pending   = PNSLR_MakeSlice(PNSLR_Path, 256, false, allocator, PNSLR_GET_LOC(), &err);
+    b8 success = (err == PNSLR_AllocatorError_None);
+
+    for (i32 i = 0; success && i < numThreads; i++)
+    {
+        VZKR_Internal_DirectoryScanWorker* worker = &workers.data[i];
+        worker->scan  = &scan;
+        worker->arena = PNSLR_NewAllocator_Arena(allocator, VZKR_INTERNAL_DIRECTORY_SCAN_ARENA_PAGE, PNSLR_GET_LOC(), &err);
+        if (err != PNSLR_AllocatorError_None) { success = false; break; }
+        output->arenas.data[i] = worker->arena;
+
+        worker->scratch = PNSLR_MakeSlice(u8, VZKR_INTERNAL_DIRECTORY_SCAN_DENTS_SIZE, false, allocator, PNSLR_GET_LOC(), &err);
+        if (err != PNSLR_AllocatorError_None) { success = false; break; }
+    }
+
+    // the root gets the same nul-terminated, trailing-slash treatment as everything else
+    if (success)
+    {
+        b8 hasSlash = (root.path.data[root.path.count - 1] == '/');
+        i64 length  = root.path.count + (hasSlash ? 0 : 1);
+        u8* data    = (u8*) PNSLR_Allocate(workers.data[0].arena, false, (i32) length + 1, 1, PNSLR_GET_LOC(), &err);
+        success     = (err == PNSLR_AllocatorError_None && data);
+        if (success)
+        {
+            PNSLR_MemCopy(data, root.path.data, (i32) root.path.count);
+            data[length - 1] = '/';
+            data[length]     = '\0';
+            scan.pending.data[scan.numPending++] = (PNSLR_Path) {.path = {.data = data, .count = length}};
+        }
+    }
+
+    if (success)
+    {
+        scan.mutex         = VZKR_CreateProfiledMutex(PNSLR_GET_LOC());
+        scan.workAvailable = PNSLR_CreateConditionVariable();
+
+        // the calling thread is worker 0
+        VZKR_ThreadOptions threadOptions = {.name = PNSLR_StringLiteral("VzkrDirScan")};
+        for (i32 i = 1; i < numThreads; i++)
+        {
+            threads.data[i] = VZKR_CreateThread(VZKR_Internal_DirectoryScanWorkerLoop, &workers.data[i], threadOptions, allocator);
+            if (!threads.data[i].handle) break;
+        }
+
+        VZKR_Internal_DirectoryScanWorkerLoop(&workers.data[0]);
+
+        for (i32 i = 1; i < numThreads; i++) { VZKR_JoinThread(&threads.data[i]); }
+
+        PNSLR_DestroyConditionVariable(&scan.workAvailable);
+        VZKR_DestroyProfiledMutex(&scan.mutex);
+        success = !scan.failed;
+    }
+
+    // gather every worker's batches
+    i64 numBatches = 0;
+    for (i64 i = 0; i < workers.count; i++) { numBatches += workers.data[i].numBatches; output->numEntries += workers.data[i].numEntries; }
+
+    if (success && numBatches > 0)
+    {
+        output->batches = PNSLR_MakeSlice(VZKR_DirectoryScanBatch, numBatches, false, output->arenas.data[0], PNSLR_GET_LOC(), &err);
+        success = (err == PNSLR_AllocatorError_None);
+
+        i64 idx = 0;
+        for (i64 i = 0; success && i < workers.count; i++)
+        {
+            for (i64 j = 0; j < workers.data[i].numBatches; j++) { output->batches.data[idx++] = workers.data[i].batches.data[j]; }
+        }
+    }
+
+    if (success && options.sorted && output->numEntries > 0)
+    {
+        PNSLR_ArraySlice(VZKR_DirectoryScanEntry) all  = PNSLR_MakeSlice(VZKR_DirectoryScanEntry, output->numEntries, false, output->arenas.data[0], PNSLR_GET_LOC(), &err);
+        PNSLR_ArraySlice(VZKR_DirectoryScanEntry) temp = {0};
+        if (err == PNSLR_AllocatorError_None) temp = PNSLR_MakeSlice(VZKR_DirectoryScanEntry, output->numEntries, false, allocator, PNSLR_GET_LOC(), &err);
+        success = (err == PNSLR_AllocatorError_None);
+
+        if (success)
+        {
+            i64 idx = 0;
+            for (i64 i = 0; i < output->batches.count; i++)
+            {
+                VZKR_DirectoryScanBatch batch = output->batches.data[i];
+                for (i64 j = 0; j < batch.entries.count; j++) { all.data[idx++] = batch.entries.data[j]; }
+            }
+
+            VZKR_Internal_DirectoryScanSort(all.data, temp.data, all.count);
+            output->batches.data[0].entries = all;
+            output->batches.count = 1;
+        }
+
+        PNSLR_FreeSlice(&temp, allocator, PNSLR_GET_LOC(), nil);
+    }
+
+    // per-worker bookkeeping isn't part of the results
+    for (i64 i = 0; i < workers.count; i++)
+    {
+        PNSLR_FreeSlice(&workers.data[i].batches, allocator, PNSLR_GET_LOC(), nil);
+        PNSLR_FreeSlice(&workers.data[i].subdirectories, allocator, PNSLR_GET_LOC(), nil);
+        PNSLR_FreeSlice(&workers.data[i].scratch, allocator, PNSLR_GET_LOC(), nil);
+    }
+
+    PNSLR_FreeSlice(&scan.pending, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&threads, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&workers, allocator, PNSLR_GET_LOC(), nil);
+
+    if (!success) VZKR_FreeDirectoryScanResult(output);
+    return success;
+}
+
+void VZKR_FreeDirectoryScanResult(VZKR_DirectoryScanResult* result)
+{
+    if (!result) return;
+
+    for (i64 i = 0; i < result->arenas.count; i++)
+    {
+        if (result->arenas.data[i].procedure) PNSLR_DestroyAllocator_Arena(result->arenas.data[i], PNSLR_GET_LOC(), nil);
+    }
+
+    PNSLR_FreeSlice(&result->arenas, result->allocator, PNSLR_GET_LOC(), nil);
+    *result = (VZKR_DirectoryScanResult) {0};
+}
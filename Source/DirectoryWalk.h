@@ -0,0 +1,87 @@
+#ifndef VZKR_DIRECTORY_WALK_H // ===================================================
+#define VZKR_DIRECTORY_WALK_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Directory Scan Declaration ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A single file or directory found by a directory scan.
+ * Directory paths end with a trailing slash, as per Panshilar conventions.
+ * Symbolic links are reported as files and never followed.
+ */
+typedef struct VZKR_DirectoryScanEntry
+{
+    PNSLR_Path path;
+    b8 isDirectory;
+} VZKR_DirectoryScanEntry;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_DirectoryScanEntry);
+
+/**
+ * A batch of entries found by a single worker.
+ */
+typedef struct VZKR_DirectoryScanBatch
+{
+    PNSLR_ArraySlice(VZKR_DirectoryScanEntry) entries;
+} VZKR_DirectoryScanBatch;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_DirectoryScanBatch);
+
+/**
+ * Options for a directory scan.
+ * 'numThreads' is the total number of threads scanning, including the calling one
+ * (defaults to 4). 'sorted' merges every batch into one, sorted by path.
+ * 'skipDirectories' leaves directories out of the results (they're still recursed into).
+ */
+typedef struct VZKR_DirectoryScanOptions
+{
+    i32 numThreads;
+    b8 sorted;
+    b8 skipDirectories;
+} VZKR_DirectoryScanOptions;
+
+/**
+ * The results of a directory scan. Every path and batch lives in per-worker arenas
+ * owned by the result, and is freed along with it.
+ */
+typedef struct VZKR_DirectoryScanResult
+{
+    PNSLR_Allocator allocator;
+    PNSLR_ArraySlice(PNSLR_Allocator) arenas;
+    PNSLR_ArraySlice(VZKR_DirectoryScanBatch) batches;
+    i64 numEntries;
+} VZKR_DirectoryScanResult;
+
+// Directory Scan Functions ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Recursively scans a directory, spreading subdirectories across several threads.
+ * Entries are read from the OS in large batches, and their types come along with them,
+ * so files don't need to be stat-ed individually.
+ * The allocator must be thread-safe (like the default heap).
+ * Directories that can't be opened are skipped.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_ScanDirectory(
+    PNSLR_Path root,
+    VZKR_DirectoryScanOptions options,
+    PNSLR_Allocator allocator,
+    VZKR_DirectoryScanResult* output
+);
+
+/**
+ * Frees the results of a directory scan, including every path in it.
+ */
+void VZKR_FreeDirectoryScanResult(
+    VZKR_DirectoryScanResult* result
+);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_DIRECTORY_WALK_H ====================================================
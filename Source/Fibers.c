@@ -0,0 +1,537 @@
+#define VZKR_IMPLEMENTATION
+#include "Fibers.h"
+
+// Context Switching ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_FIBER_DEFAULT_STACK_SIZE   (64 * 1024)
+#define VZKR_INTERNAL_FIBER_MAX_STACK_SIZE       (1 << 30)
+#define VZKR_INTERNAL_FIBER_DEFAULT_POOLED_STACKS 64
+
+#if PNSLR_WINDOWS
+    #define VZKR_INTERNAL_FIBER_NATIVE 1
+#elif PNSLR_UNIX && (PNSLR_X64 || PNSLR_ARM64) && !defined(_MSC_VER)
+    #define VZKR_INTERNAL_FIBER_ASM 1
+#endif
+
+#if VZKR_INTERNAL_FIBER_ASM
+
+    /**
+     * Saves the callee-saved registers on the current stack, stores the stack pointer in
+     * 'from', then switches to the stack in 'to' and restores the registers saved on it,
+     * returning to wherever that context last called this from.
+     */
+    void VZKR_Internal_FiberSwitch(rawptr* from, rawptr to);
+
+    /** Where a new fiber's context first returns to: calls the entry with the fiber. */
+    void VZKR_Internal_FiberTrampoline(void);
+
+    #if PNSLR_OSX || PNSLR_IOS
+        #define VZKR_INTERNAL_FIBER_SYMBOL(name) \
+            ".private_extern _" #name "\n" \
+            ".globl _" #name "\n" \
+            "_" #name ":\n"
+    #else
+        #define VZKR_INTERNAL_FIBER_SYMBOL(name) \
+            ".hidden " #name "\n" \
+            ".globl " #name "\n" \
+            ".type " #name ", %function\n" \
+            #name ":\n"
+    #endif
+
+    #if PNSLR_X64
+
+        // rbp, rbx and r12-r15, plus the SSE and x87 control words (their other
+        // registers are all caller-saved); a new fiber starts with r12 holding the fiber
+        // and r13 the entry, so the trampoline doesn't need anything else
+
+        #define VZKR_INTERNAL_FIBER_FRAME_SLOTS 8
+        #define VZKR_INTERNAL_FIBER_SLOT_ARG    4 // r12
+        #define VZKR_INTERNAL_FIBER_SLOT_ENTRY  3 // r13
+        #define VZKR_INTERNAL_FIBER_SLOT_RETURN 7
+        #define VZKR_INTERNAL_FIBER_CONTROL     (0x1F80ULL | (0x037FULL << 32)) // default MXCSR, x87 CW
+
+        __asm__(
+            ".text\n"
+            ".p2align 4\n"
+            VZKR_INTERNAL_FIBER_SYMBOL(VZKR_Internal_FiberSwitch)
+            "    pushq %rbp\n"
+            "    pushq %rbx\n"
+            "    pushq %r12\n"
+            "    pushq %r13\n"
+            "    pushq %r14\n"
+            "    pushq %r15\n"
+            "    subq $8, %rsp\n"
+            "    stmxcsr (%rsp)\n"
+            "    fnstcw 4(%rsp)\n"
+            "    movq %rsp, (%rdi)\n"
+            "    movq %rsi, %rsp\n"
+            "    ldmxcsr (%rsp)\n"
+            "    fldcw 4(%rsp)\n"
+            "    addq $8, %rsp\n"
+            "    popq %r15\n"
+            "    popq %r14\n"
+            "    popq %r13\n"
+            "    popq %r12\n"
+            "    popq %rbx\n"
+            "    popq %rbp\n"
+            "    ret\n"
+            ".p2align 4\n"
+            VZKR_INTERNAL_FIBER_SYMBOL(VZKR_Internal_FiberTrampoline)
+            "    movq %r12, %rdi\n"
+            "    callq *%r13\n"
+            "    ud2\n"
+        );
+
+    #elif PNSLR_ARM64
+
+        // x19-x28, the frame pointer and link register, and the low halves of v8-v15;
+        // a new fiber starts with x19 holding the fiber and x20 the entry
+
+        #define VZKR_INTERNAL_FIBER_FRAME_SLOTS 20
+        #define VZKR_INTERNAL_FIBER_SLOT_ARG    0  // x19
+        #define VZKR_INTERNAL_FIBER_SLOT_ENTRY  1  // x20
+        #define VZKR_INTERNAL_FIBER_SLOT_RETURN 11 // x30
+
+        __asm__(
+            ".text\n"
+            ".p2align 4\n"
+            VZKR_INTERNAL_FIBER_SYMBOL(VZKR_Internal_FiberSwitch)
+            "    sub sp, sp, #160\n"
+            "    stp x19, x20, [sp, #0]\n"
+            "    stp x21, x22, [sp, #16]\n"
+            "    stp x23, x24, [sp, #32]\n"
+            "    stp x25, x26, [sp, #48]\n"
+            "    stp x27, x28, [sp, #64]\n"
+            "    stp x29, x30, [sp, #80]\n"
+            "    stp d8, d9, [sp, #96]\n"
+            "    stp d10, d11, [sp, #112]\n"
+            "    stp d12, d13, [sp, #128]\n"
+            "    stp d14, d15, [sp, #144]\n"
+            "    mov x9, sp\n"
+            "    str x9, [x0]\n"
+            "    mov sp, x1\n"
+            "    ldp x19, x20, [sp, #0]\n"
+            "    ldp x21, x22, [sp, #16]\n"
+            "    ldp x23, x24, [sp, #32]\n"
+            "    ldp x25, x26, [sp, #48]\n"
+            "    ldp x27, x28, [sp, #64]\n"
+            "    ldp x29, x30, [sp, #80]\n"
+            "    ldp d8, d9, [sp, #96]\n"
+            "    ldp d10, d11, [sp, #112]\n"
+            "    ldp d12, d13, [sp, #128]\n"
+            "    ldp d14, d15, [sp, #144]\n"
+            "    add sp, sp, #160\n"
+            "    ret\n"
+            ".p2align 4\n"
+            VZKR_INTERNAL_FIBER_SYMBOL(VZKR_Internal_FiberTrampoline)
+            "    mov x0, x19\n"
+            "    blr x20\n"
+            "    brk #0\n"
+        );
+
+    #endif
+
+    #undef VZKR_INTERNAL_FIBER_SYMBOL
+
+#endif
+
+// Fiber Scheduler ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+typedef u8 VZKR_Internal_FiberState /* use as value */;
+#define VZKR_Internal_FiberState_Ready          ((VZKR_Internal_FiberState) 0)
+#define VZKR_Internal_FiberState_WaitingForIo   ((VZKR_Internal_FiberState) 1)
+#define VZKR_Internal_FiberState_WaitingForJobs ((VZKR_Internal_FiberState) 2)
+#define VZKR_Internal_FiberState_Done           ((VZKR_Internal_FiberState) 3)
+
+/**
+ * Lives at the top of its own stack's allocation (the guard page being at the bottom).
+ * A finished fiber stays suspended at the end of its entry's loop, so a pooled one only
+ * needs a new procedure to run another one.
+ */
+typedef struct VZKR_Internal_Fiber
+{
+    rawptr context; // the saved stack pointer, or the native fiber
+    u8* memory;
+    struct VZKR_Internal_FiberScheduler* scheduler;
+    struct VZKR_Internal_Fiber* next; // in whichever list it's in
+    VZKR_FiberProcedure procedure;
+    rawptr userData;
+    VZKR_Internal_FiberState state;
+    VZKR_JobCounter* counter;
+    VZKR_AsyncIoCompletion completion;
+} VZKR_Internal_Fiber;
+
+typedef struct VZKR_Internal_FiberScheduler
+{
+    PNSLR_Allocator allocator;
+    VZKR_AsyncIo io;
+    i64 pageSize;
+    i64 stackSize;
+    i32 maxPooled;
+    i32 numPooled;
+    i32 numAlive;
+    i32 numWaitingForIo;
+    rawptr context; // the scheduler thread's own
+    b8 convertedThread;
+    VZKR_Internal_Fiber* readyHead;
+    VZKR_Internal_Fiber* readyTail;
+    VZKR_Internal_Fiber* waitingForJobs;
+    VZKR_Internal_Fiber* pool;
+} VZKR_Internal_FiberScheduler;
+
+static VZKR_INTERNAL_THREAD_LOCAL VZKR_Internal_Fiber* VZKR_Internal_CurrentFiber = nil;
+
+static void VZKR_Internal_FiberPushReady(VZKR_Internal_FiberScheduler* scheduler, VZKR_Internal_Fiber* fiber)
+{
+    fiber->state = VZKR_Internal_FiberState_Ready;
+    fiber->next  = nil;
+    if (scheduler->readyTail) scheduler->readyTail->next = fiber;
+    else                      scheduler->readyHead       = fiber;
+    scheduler->readyTail = fiber;
+}
+
+/** Switches from the calling fiber back to its scheduler. */
+static void VZKR_Internal_FiberSuspend(VZKR_Internal_Fiber* fiber)
+{
+    #if VZKR_INTERNAL_FIBER_ASM
+        VZKR_Internal_FiberSwitch(&fiber->context, fiber->scheduler->context);
+    #elif VZKR_INTERNAL_FIBER_NATIVE
+        SwitchToFiber(fiber->scheduler->context);
+    #else
+        (void) fiber;
+    #endif
+}
+
+static void VZKR_Internal_FiberMain(rawptr data)
+{
+    VZKR_Internal_Fiber* fiber = (VZKR_Internal_Fiber*) data;
+    for (;;)
+    {
+        fiber->procedure(fiber->userData);
+        fiber->state = VZKR_Internal_FiberState_Done;
+        VZKR_Internal_FiberSuspend(fiber);
+    }
+}
+
+#if VZKR_INTERNAL_FIBER_NATIVE
+    static VOID WINAPI VZKR_Internal_FiberNativeEntry(LPVOID data) { VZKR_Internal_FiberMain((rawptr) data); }
+#endif
+
+/** Switches from the scheduler's thread to a fiber, until it suspends or finishes. */
+static void VZKR_Internal_FiberResume(VZKR_Internal_FiberScheduler* scheduler, VZKR_Internal_Fiber* fiber)
+{
+    VZKR_Internal_CurrentFiber = fiber;
+
+    #if VZKR_INTERNAL_FIBER_ASM
+        VZKR_Internal_FiberSwitch(&scheduler->context, fiber->context);
+    #elif VZKR_INTERNAL_FIBER_NATIVE
+        (void) scheduler;
+        SwitchToFiber(fiber->context);
+    #else
+        (void) scheduler;
+    #endif
+
+    VZKR_Internal_CurrentFiber = nil;
+}
+
+static void VZKR_Internal_FiberFree(VZKR_Internal_FiberScheduler* scheduler, VZKR_Internal_Fiber* fiber)
+{
+    #if VZKR_INTERNAL_FIBER_NATIVE
+        DeleteFiber(fiber->context);
+        PNSLR_Free(scheduler->allocator, fiber, PNSLR_GET_LOC(), nil);
+    #else
+        mprotect(fiber->memory, (size_t) scheduler->pageSize, PROT_READ | PROT_WRITE);
+        PNSLR_Free(scheduler->allocator, fiber->memory, PNSLR_GET_LOC(), nil);
+    #endif
+}
+
+static VZKR_Internal_Fiber* VZKR_Internal_FiberCreate(VZKR_Internal_FiberScheduler* scheduler)
+{
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+
+    #if VZKR_INTERNAL_FIBER_NATIVE
+
+        VZKR_Internal_Fiber* fiber = (VZKR_Internal_Fiber*) PNSLR_Allocate(scheduler->allocator, true, (i32) sizeof(VZKR_Internal_Fiber), (i32) alignof(VZKR_Internal_Fiber), PNSLR_GET_LOC(), &err);
+        if (err != PNSLR_AllocatorError_None || !fiber) return nil;
+
+        // the OS reserves the stack (with its own guard page) and commits it as it grows
+        fiber->context = CreateFiberEx(0, (SIZE_T) scheduler->stackSize, FIBER_FLAG_FLOAT_SWITCH, VZKR_Internal_FiberNativeEntry, fiber);
+        if (!fiber->context) { PNSLR_Free(scheduler->allocator, fiber, PNSLR_GET_LOC(), nil); return nil; }
+
+    #else
+
+        // [guard page][stack, growing down][fiber]
+        i64 fiberSize = ((i64) sizeof(VZKR_Internal_Fiber) + 63) & ~63LL;
+        i64 totalSize = scheduler->pageSize + scheduler->stackSize + fiberSize;
+        u8* memory    = (u8*) PNSLR_Allocate(scheduler->allocator, false, (i32) totalSize, (i32) scheduler->pageSize, PNSLR_GET_LOC(), &err);
+        if (err != PNSLR_AllocatorError_None || !memory) return nil;
+
+        // without a guard page, overflowing the stack still works the same as before
+        mprotect(memory, (size_t) scheduler->pageSize, PROT_NONE);
+
+        VZKR_Internal_Fiber* fiber = (VZKR_Internal_Fiber*) (memory + totalSize - fiberSize);
+        *fiber = (VZKR_Internal_Fiber) {.memory = memory};
+
+        #if VZKR_INTERNAL_FIBER_ASM
+            u64* frame = (u64*) (memory + scheduler->pageSize + scheduler->stackSize) - VZKR_INTERNAL_FIBER_FRAME_SLOTS;
+            PNSLR_MemSet(frame, 0, VZKR_INTERNAL_FIBER_FRAME_SLOTS * (i32) sizeof(u64));
+            #if PNSLR_X64
+                frame[0] = VZKR_INTERNAL_FIBER_CONTROL;
+            #endif
+            frame[VZKR_INTERNAL_FIBER_SLOT_ARG]    = (u64) fiber;
+            frame[VZKR_INTERNAL_FIBER_SLOT_ENTRY]  = (u64) VZKR_Internal_FiberMain;
+            frame[VZKR_INTERNAL_FIBER_SLOT_RETURN] = (u64) VZKR_Internal_FiberTrampoline;
+            fiber->context = frame;
+        #endif
+
+    #endif
+
+    fiber->scheduler = scheduler;
+    return fiber;
+}
+
+VZKR_FiberScheduler VZKR_CreateFiberScheduler(
+    VZKR_FiberSchedulerOptions options,
+    PNSLR_Allocator allocator
+)
+{
+    #if !VZKR_INTERNAL_FIBER_ASM && !VZKR_INTERNAL_FIBER_NATIVE
+        return (VZKR_FiberScheduler) {0};
+    #endif
+
+    i64 stackSize = options.stackSize > 0 ? options.stackSize : VZKR_INTERNAL_FIBER_DEFAULT_STACK_SIZE;
+    if (stackSize > VZKR_INTERNAL_FIBER_MAX_STACK_SIZE) return (VZKR_FiberScheduler) {0};
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_FiberScheduler* scheduler = (VZKR_Internal_FiberScheduler*) PNSLR_Allocate(allocator, true, (i32) sizeof(VZKR_Internal_FiberScheduler), (i32) alignof(VZKR_Internal_FiberScheduler), PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !scheduler) return (VZKR_FiberScheduler) {0};
+
+    #if PNSLR_WINDOWS
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        scheduler->pageSize = (i64) info.dwPageSize;
+    #elif PNSLR_UNIX
+        scheduler->pageSize = (i64) sysconf(_SC_PAGESIZE);
+    #endif
+
+    scheduler->allocator = allocator;
+    scheduler->io        = options.io;
+    scheduler->stackSize = (stackSize + scheduler->pageSize - 1) & ~(scheduler->pageSize - 1);
+    scheduler->maxPooled = options.maxPooledStacks == 0 ? VZKR_INTERNAL_FIBER_DEFAULT_POOLED_STACKS : (options.maxPooledStacks < 0 ? 0 : options.maxPooledStacks);
+
+    #if VZKR_INTERNAL_FIBER_NATIVE
+        // switching needs the scheduler's thread to be a fiber itself
+        if (IsThreadAFiber())
+        {
+            scheduler->context = GetCurrentFiber();
+        }
+        else
+        {
+            scheduler->context         = ConvertThreadToFiberEx(nil, FIBER_FLAG_FLOAT_SWITCH);
+            scheduler->convertedThread = true;
+        }
+
+        if (!scheduler->context)
+        {
+            PNSLR_Free(allocator, scheduler, PNSLR_GET_LOC(), nil);
+            return (VZKR_FiberScheduler) {0};
+        }
+    #endif
+
+    return (VZKR_FiberScheduler) {.handle = (rawptr) scheduler};
+}
+
+void VZKR_DestroyFiberScheduler(VZKR_FiberScheduler* scheduler)
+{
+    if (!scheduler || !scheduler->handle) return;
+
+    VZKR_RunFibersUntilDone(*scheduler);
+
+    VZKR_Internal_FiberScheduler* internal = (VZKR_Internal_FiberScheduler*) scheduler->handle;
+    while (internal->pool)
+    {
+        VZKR_Internal_Fiber* fiber = internal->pool;
+        internal->pool = fiber->next;
+        VZKR_Internal_FiberFree(internal, fiber);
+    }
+
+    #if VZKR_INTERNAL_FIBER_NATIVE
+        if (internal->convertedThread) ConvertFiberToThread();
+    #endif
+
+    PNSLR_Free(internal->allocator, internal, PNSLR_GET_LOC(), nil);
+    *scheduler = (VZKR_FiberScheduler) {0};
+}
+
+b8 VZKR_SpawnFiber(
+    VZKR_FiberScheduler scheduler,
+    VZKR_FiberProcedure procedure,
+    rawptr userData
+)
+{
+    VZKR_Internal_FiberScheduler* internal = (VZKR_Internal_FiberScheduler*) scheduler.handle;
+    if (!internal || !procedure) return false;
+
+    VZKR_Internal_Fiber* fiber = internal->pool;
+    if (fiber)
+    {
+        internal->pool = fiber->next;
+        internal->numPooled--;
+    }
+    else
+    {
+        fiber = VZKR_Internal_FiberCreate(internal);
+        if (!fiber) return false;
+    }
+
+    fiber->procedure = procedure;
+    fiber->userData  = userData;
+    internal->numAlive++;
+    VZKR_Internal_FiberPushReady(internal, fiber);
+    return true;
+}
+
+/** Deals with a fiber that just switched back to the scheduler. */
+static void VZKR_Internal_FiberSuspended(VZKR_Internal_FiberScheduler* scheduler, VZKR_Internal_Fiber* fiber)
+{
+    switch (fiber->state)
+    {
+        case VZKR_Internal_FiberState_Ready:
+            VZKR_Internal_FiberPushReady(scheduler, fiber);
+            break;
+        case VZKR_Internal_FiberState_WaitingForJobs:
+            fiber->next = scheduler->waitingForJobs;
+            scheduler->waitingForJobs = fiber;
+            break;
+        case VZKR_Internal_FiberState_Done:
+            scheduler->numAlive--;
+            if (scheduler->numPooled < scheduler->maxPooled)
+            {
+                fiber->next = scheduler->pool;
+                scheduler->pool = fiber;
+                scheduler->numPooled++;
+            }
+            else
+            {
+                VZKR_Internal_FiberFree(scheduler, fiber);
+            }
+            break;
+        default: // waiting for I/O; its completion puts it back
+            break;
+    }
+}
+
+b8 VZKR_UpdateFiberScheduler(VZKR_FiberScheduler scheduler)
+{
+    VZKR_Internal_FiberScheduler* internal = (VZKR_Internal_FiberScheduler*) scheduler.handle;
+    if (!internal) return false;
+
+    if (internal->numWaitingForIo > 0) VZKR_PollAsyncIo(internal->io, (PNSLR_ArraySlice(VZKR_AsyncIoCompletion)) {0});
+
+    VZKR_Internal_Fiber** link = &internal->waitingForJobs;
+    while (*link)
+    {
+        VZKR_Internal_Fiber* fiber = *link;
+        if (!VZKR_AreJobsDone(fiber->counter)) { link = &fiber->next; continue; }
+
+        *link = fiber->next;
+        VZKR_Internal_FiberPushReady(internal, fiber);
+    }
+
+    // only the ones ready now; anything that yields goes after them, for the next update
+    VZKR_Internal_Fiber* last = internal->readyTail;
+    while (internal->readyHead)
+    {
+        VZKR_Internal_Fiber* fiber = internal->readyHead;
+        internal->readyHead = fiber->next;
+        if (!internal->readyHead) internal->readyTail = nil;
+
+        VZKR_Internal_FiberResume(internal, fiber);
+        VZKR_Internal_FiberSuspended(internal, fiber);
+        if (fiber == last) break;
+    }
+
+    return internal->numAlive > 0;
+}
+
+void VZKR_RunFibersUntilDone(VZKR_FiberScheduler scheduler)
+{
+    VZKR_Internal_FiberScheduler* internal = (VZKR_Internal_FiberScheduler*) scheduler.handle;
+    if (!internal) return;
+
+    while (VZKR_UpdateFiberScheduler(scheduler))
+    {
+        if (internal->readyHead) continue;
+
+        if (internal->numWaitingForIo > 0 && !internal->waitingForJobs) VZKR_WaitAsyncIo(internal->io, -1);
+        else                                                            VZKR_YieldThread();
+    }
+}
+
+// Inside Fibers ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+b8 VZKR_IsInFiber(void)
+{
+    return VZKR_Internal_CurrentFiber != nil;
+}
+
+void VZKR_YieldFiber(void)
+{
+    VZKR_Internal_Fiber* fiber = VZKR_Internal_CurrentFiber;
+    if (!fiber) return;
+
+    fiber->state = VZKR_Internal_FiberState_Ready;
+    VZKR_Internal_FiberSuspend(fiber);
+}
+
+static void VZKR_Internal_FiberIoCallback(rawptr userData, VZKR_AsyncIoCompletion completion)
+{
+    VZKR_Internal_Fiber* fiber = (VZKR_Internal_Fiber*) userData;
+    fiber->completion.op      = completion.op;
+    fiber->completion.success = completion.success;
+    fiber->completion.result  = completion.result;
+    fiber->completion.file    = completion.file;
+    fiber->scheduler->numWaitingForIo--;
+    VZKR_Internal_FiberPushReady(fiber->scheduler, fiber);
+}
+
+b8 VZKR_AwaitAsyncIo(
+    VZKR_AsyncIoRequest request,
+    VZKR_AsyncIoCompletion* completion
+)
+{
+    VZKR_Internal_Fiber* fiber = VZKR_Internal_CurrentFiber;
+    if (!fiber || !fiber->scheduler->io.handle || !completion) return false;
+
+    fiber->completion = (VZKR_AsyncIoCompletion) {.userData = request.userData};
+    request.userData  = fiber;
+    request.callback  = VZKR_Internal_FiberIoCallback;
+
+    PNSLR_ArraySlice(VZKR_AsyncIoRequest) requests = {.data = &request, .count = 1};
+    if (!VZKR_SubmitAsyncIo(fiber->scheduler->io, requests)) return false;
+
+    fiber->scheduler->numWaitingForIo++;
+    fiber->state = VZKR_Internal_FiberState_WaitingForIo;
+    VZKR_Internal_FiberSuspend(fiber);
+
+    *completion = fiber->completion;
+    return true;
+}
+
+void VZKR_AwaitJobs(VZKR_JobCounter* counter)
+{
+    if (!counter) return;
+
+    VZKR_Internal_Fiber* fiber = VZKR_Internal_CurrentFiber;
+    if (!fiber)
+    {
+        while (!VZKR_AreJobsDone(counter)) VZKR_YieldThread();
+        return;
+    }
+
+    if (VZKR_AreJobsDone(counter)) return;
+
+    fiber->counter = counter;
+    fiber->state   = VZKR_Internal_FiberState_WaitingForJobs;
+    VZKR_Internal_FiberSuspend(fiber);
+}
@@ -0,0 +1,137 @@
+#ifndef VZKR_FIBERS_H // ===========================================================
+#define VZKR_FIBERS_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fiber Scheduler ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A cross-platform opaque handle to a fiber scheduler: it runs fibers (functions with
+ * stacks of their own) on the thread that created it, letting them suspend in the middle
+ * of whatever they're doing (to wait for async I/O, or for jobs to finish) and picking
+ * them back up once they can go on, without tying up the thread or needing them to be
+ * turned into state machines.
+ *
+ * Switching between fibers is a handful of instructions of hand-written assembly on
+ * x64 and ARM64 (native fibers on Windows). Stacks have a guard page below them, and are
+ * kept around once their fiber finishes, for the next one to reuse.
+ *
+ * Spawning, updating and destroying must all happen on the thread that created the
+ * scheduler (spawning can also happen from its fibers).
+ */
+typedef struct VZKR_FiberScheduler
+{
+    rawptr handle;
+} VZKR_FiberScheduler;
+
+/**
+ * The signature of the procedure a fiber runs.
+ */
+typedef void (*VZKR_FiberProcedure)(
+    rawptr userData
+);
+
+/**
+ * Options for creating a fiber scheduler.
+ * 'stackSize' is the size of every fiber's stack, rounded up to whole pages (defaults to
+ * 64KB), not counting its guard page.
+ * 'maxPooledStacks' is the number of finished fibers' stacks kept for reuse (defaults to
+ * 64; negative keeps none).
+ * 'io' is the async I/O engine fibers can wait on, which the scheduler polls (keeping
+ * completions that don't have a callback back for whoever else polls it). Can be zeroed.
+ */
+typedef struct VZKR_FiberSchedulerOptions
+{
+    i32 stackSize;
+    i32 maxPooledStacks;
+    VZKR_AsyncIo io;
+} VZKR_FiberSchedulerOptions;
+
+/**
+ * Creates a fiber scheduler on the calling thread.
+ * If creating failed (including on platforms without fiber support), the returned
+ * handle will be zeroed.
+ */
+VZKR_FiberScheduler VZKR_CreateFiberScheduler(
+    VZKR_FiberSchedulerOptions options,
+    PNSLR_Allocator allocator
+);
+
+/**
+ * Runs every fiber that hasn't finished until it does, then frees the scheduler along
+ * with every pooled stack.
+ */
+void VZKR_DestroyFiberScheduler(
+    VZKR_FiberScheduler* scheduler
+);
+
+/**
+ * Creates a fiber that runs a procedure, starting on the next update.
+ * Returns false if allocating its stack failed.
+ */
+b8 VZKR_SpawnFiber(
+    VZKR_FiberScheduler scheduler,
+    VZKR_FiberProcedure procedure,
+    rawptr userData
+);
+
+/**
+ * Polls the async I/O engine and the job counters fibers are waiting on, then runs every
+ * fiber that's ready until it finishes or suspends again. Fibers that yield only get to
+ * run again on the next update.
+ * Can't be called from the scheduler's own fibers.
+ * Returns true if there are still fibers that haven't finished.
+ */
+b8 VZKR_UpdateFiberScheduler(
+    VZKR_FiberScheduler scheduler
+);
+
+/**
+ * Keeps updating the scheduler until every fiber has finished, sleeping on the async I/O
+ * engine whenever every fiber is waiting on it.
+ */
+void VZKR_RunFibersUntilDone(
+    VZKR_FiberScheduler scheduler
+);
+
+// Inside Fibers ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Checks whether the calling code is running on a fiber.
+ */
+b8 VZKR_IsInFiber(void);
+
+/**
+ * Suspends the calling fiber until the scheduler's next update.
+ * Does nothing if not called from a fiber.
+ */
+void VZKR_YieldFiber(void);
+
+/**
+ * Submits an async I/O request to the scheduler's engine, and suspends the calling fiber
+ * until it finishes. The request's 'callback' and 'userData' are used internally (the
+ * completion still gets 'userData' back).
+ * Returns false if not called from a fiber, the scheduler has no engine, or submitting
+ * failed; the completion is only written on success.
+ */
+b8 VZKR_AwaitAsyncIo(
+    VZKR_AsyncIoRequest request,
+    VZKR_AsyncIoCompletion* completion
+);
+
+/**
+ * Suspends the calling fiber until every job counted in a counter has finished, checking
+ * on every update. Outside a fiber, yields the thread until they have.
+ */
+void VZKR_AwaitJobs(
+    VZKR_JobCounter* counter
+);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_FIBERS_H ============================================================
@@ -0,0 +1,1042 @@
+#define VZKR_IMPLEMENTATION
+#include "FileIO.h"
+
+// Internal Helpers ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_FILE_MAX_TRANSFER 0x7FFFF000 // what linux allows per read/write
+#define VZKR_INTERNAL_FILE_MAX_IOVECS   64
+
+#if PNSLR_UNIX
+    // Panshilar stores the file descriptor directly in the handle on unix platforms
+    static int VZKR_Internal_FileDescriptor(PNSLR_File file)
+    {
+        return (int) (i64) file.handle;
+    }
+
+    static PNSLR_File VZKR_Internal_FileFromDescriptor(int fd)
+    {
+        return (PNSLR_File) {.handle = (rawptr) (i64) fd};
+    }
+#endif
+
+/** Copies in chunks, since Panshilar's memory functions take an i32 size. */
+static void VZKR_Internal_CopyBytes(u8* dst, const u8* src, i64 count)
+{
+    const i64 maxChunk = 1 << 30;
+    while (count > 0)
+    {
+        i32 chunk = (i32) (count < maxChunk ? count : maxChunk);
+        PNSLR_MemCopy(dst, (rawptr) src, chunk);
+        dst   += chunk;
+        src   += chunk;
+        count -= chunk;
+    }
+}
+
+/**
+ * Reads or writes once at an absolute offset, leaving the file's cursor where it was.
+ * Transfers at most VZKR_INTERNAL_FILE_MAX_TRANSFER bytes, and can come up short.
+ * Returns the number of bytes transferred (0 at the end of the file), or -1 on failure.
+ */
+static i64 VZKR_Internal_FileTransferAt(PNSLR_File file, u8* buffer, i64 count, i64 offset, b8 isWrite)
+{
+    if (count > VZKR_INTERNAL_FILE_MAX_TRANSFER) count = VZKR_INTERNAL_FILE_MAX_TRANSFER;
+
+    #if PNSLR_WINDOWS
+        // Panshilar's handles aren't opened for overlapped I/O, and on those, an offset in
+        // the OVERLAPPED still moves the file pointer to the end of the transfer; so it's
+        // put back afterwards
+        LARGE_INTEGER zero = {0}, cursor = {0};
+        BOOL haveCursor = SetFilePointerEx((HANDLE) file.handle, zero, &cursor, FILE_CURRENT);
+
+        OVERLAPPED ov = {0};
+        ov.Offset     = (DWORD) ((u64) offset & 0xFFFFFFFF);
+        ov.OffsetHigh = (DWORD) ((u64) offset >> 32);
+
+        DWORD transferred = 0;
+        BOOL ok = isWrite
+            ? WriteFile((HANDLE) file.handle, buffer, (DWORD) count, &transferred, &ov)
+            : ReadFile((HANDLE) file.handle, buffer, (DWORD) count, &transferred, &ov);
+        DWORD error = ok ? ERROR_SUCCESS : GetLastError();
+
+        if (haveCursor) SetFilePointerEx((HANDLE) file.handle, cursor, nil, FILE_BEGIN);
+
+        // reading at or past the end isn't an error
+        if (!ok && !isWrite && error == ERROR_HANDLE_EOF) return 0;
+        return ok ? (i64) transferred : -1;
+    #elif PNSLR_UNIX
+        int fd = VZKR_Internal_FileDescriptor(file);
+        ssize_t res;
+        do
+        {
+            res = isWrite
+                ? pwrite(fd, buffer, (size_t) count, (off_t) offset)
+                : pread(fd, buffer, (size_t) count, (off_t) offset);
+        } while (res < 0 && errno == EINTR);
+
+        return (res >= 0) ? (i64) res : -1;
+    #endif
+}
+
+/** Keeps transferring at an absolute offset until everything's done or the file ends. */
+static b8 VZKR_Internal_FileTransferAllAt(PNSLR_File file, u8* buffer, i64 count, i64 offset, b8 isWrite, i64* transferred)
+{
+    i64 done = 0;
+    while (done < count)
+    {
+        i64 res = VZKR_Internal_FileTransferAt(file, buffer + done, count - done, offset + done, isWrite);
+        if (res < 0) { *transferred = done; return false; }
+        if (res == 0) break;
+        done += res;
+    }
+
+    *transferred = done;
+    return isWrite ? (done == count) : true;
+}
+
+/** The vectored counterpart to `VZKR_Internal_FileTransferAllAt`. */
+static b8 VZKR_Internal_FileTransferAllAtVectored(PNSLR_File file, PNSLR_ArraySlice(utf8str) buffers, i64 offset, b8 isWrite, i64* transferred)
+{
+    i64 total = 0;
+
+    #if PNSLR_LINUX
+        int fd = VZKR_Internal_FileDescriptor(file);
+        i64 bufIdx = 0, bufOff = 0;
+        while (bufIdx < buffers.count)
+        {
+            struct iovec iov[VZKR_INTERNAL_FILE_MAX_IOVECS];
+            i32 numIov = 0;
+            i64 batchSize = 0;
+            for (i64 j = bufIdx; j < buffers.count && numIov < VZKR_INTERNAL_FILE_MAX_IOVECS; j++)
+            {
+                i64 skip  = (j == bufIdx) ? bufOff : 0;
+                i64 count = buffers.data[j].count - skip;
+                if (count <= 0) continue;
+                if (count > VZKR_INTERNAL_FILE_MAX_TRANSFER - batchSize) count = VZKR_INTERNAL_FILE_MAX_TRANSFER - batchSize;
+                if (count <= 0) break;
+
+                iov[numIov++] = (struct iovec) {.iov_base = buffers.data[j].data + skip, .iov_len = (size_t) count};
+                batchSize += count;
+            }
+
+            if (numIov == 0) break;
+
+            ssize_t res;
+            do
+            {
+                res = isWrite
+                    ? pwritev(fd, iov, numIov, (off_t) (offset + total))
+                    : preadv(fd, iov, numIov, (off_t) (offset + total));
+            } while (res < 0 && errno == EINTR);
+
+            if (res < 0) { *transferred = total; return false; }
+            if (res == 0) break;
+            total += res;
+
+            // move past whatever got transferred, buffers can be partially filled
+            i64 advance = (i64) res;
+            while (advance > 0 && bufIdx < buffers.count)
+            {
+                i64 remaining = buffers.data[bufIdx].count - bufOff;
+                if (advance >= remaining) { advance -= remaining; bufIdx++; bufOff = 0; }
+                else                      { bufOff += advance; advance = 0; }
+            }
+        }
+
+        *transferred = total;
+        if (!isWrite) return true;
+
+        // writes only succeed if everything made it
+        i64 expected = 0;
+        for (i64 i = 0; i < buffers.count; i++) { expected += buffers.data[i].count; }
+        return total == expected;
+    #else
+        // no positional scatter/gather on these platforms, so one buffer at a time
+        for (i64 i = 0; i < buffers.count; i++)
+        {
+            i64 done = 0;
+            b8 ok = VZKR_Internal_FileTransferAllAt(file, buffers.data[i].data, buffers.data[i].count, offset + total, isWrite, &done);
+            total += done;
+            if (!ok) { *transferred = total; return false; }
+            if (done < buffers.data[i].count) break; // end of the file
+        }
+
+        *transferred = total;
+        return true;
+    #endif
+}
+
+/** Copies a path with a nul-terminator, for the OS functions that need one. */
+static cstring VZKR_Internal_CopyPathToCString(PNSLR_Path path, PNSLR_Allocator allocator)
+{
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    cstring output = (cstring) PNSLR_Allocate(allocator, false, (i32) path.path.count + 1, 1, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !output) return nil;
+
+    if (path.path.count > 0) PNSLR_MemCopy((rawptr) output, path.path.data, (i32) path.path.count);
+    ((char*) output)[path.path.count] = '\0';
+    return output;
+}
+
+static i64 VZKR_Internal_MapAlignment(void)
+{
+    #if PNSLR_WINDOWS
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return (i64) info.dwAllocationGranularity;
+    #elif PNSLR_UNIX
+        return (i64) sysconf(_SC_PAGESIZE);
+    #endif
+}
+
+// Positional File I/O ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+b8 VZKR_ReadFromFileAt(
+    PNSLR_File handle,
+    PNSLR_ArraySlice(u8) dst,
+    i64 offset,
+    i64* readSize
+)
+{
+    i64 done = 0;
+    b8 ok = (handle.handle && offset >= 0) && VZKR_Internal_FileTransferAllAt(handle, dst.data, dst.count, offset, false, &done);
+    if (readSize) *readSize = done;
+    return ok;
+}
+
+b8 VZKR_WriteToFileAt(
+    PNSLR_File handle,
+    PNSLR_ArraySlice(u8) src,
+    i64 offset
+)
+{
+    i64 done = 0;
+    return (handle.handle && offset >= 0) && VZKR_Internal_FileTransferAllAt(handle, src.data, src.count, offset, true, &done);
+}
+
+b8 VZKR_ReadFromFileAtVectored(
+    PNSLR_File handle,
+    PNSLR_ArraySlice(utf8str) dst,
+    i64 offset,
+    i64* readSize
+)
+{
+    i64 done = 0;
+    b8 ok = (handle.handle && offset >= 0) && VZKR_Internal_FileTransferAllAtVectored(handle, dst, offset, false, &done);
+    if (readSize) *readSize = done;
+    return ok;
+}
+
+b8 VZKR_WriteToFileAtVectored(
+    PNSLR_File handle,
+    PNSLR_ArraySlice(utf8str) src,
+    i64 offset
+)
+{
+    i64 done = 0;
+    return (handle.handle && offset >= 0) && VZKR_Internal_FileTransferAllAtVectored(handle, src, offset, true, &done);
+}
+
+// File Mapping ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+b8 VZKR_MapFile(
+    PNSLR_File file,
+    VZKR_FileMapMode mode,
+    i64 offset,
+    i64 size,
+    VZKR_FileMapping* output
+)
+{
+    if (!output) return false;
+    *output = (VZKR_FileMapping) {.mode = mode};
+    if (!file.handle || offset < 0 || size < -1) return false;
+
+    i64 fileSize = PNSLR_GetSizeOfFile(file);
+    if (offset > fileSize) return false;
+    if (size == -1) size = fileSize - offset;
+    if (offset + size > fileSize) return false;
+    if (size == 0) return true;
+
+    i64 alignedOffset = offset - (offset % VZKR_Internal_MapAlignment());
+    i64 mapSize       = size + (offset - alignedOffset);
+
+    #if PNSLR_WINDOWS
+        DWORD protect = (mode == VZKR_FileMapMode_ReadWrite)   ? PAGE_READWRITE :
+                        (mode == VZKR_FileMapMode_CopyOnWrite) ? PAGE_WRITECOPY :
+                                                                 PAGE_READONLY;
+        DWORD access  = (mode == VZKR_FileMapMode_ReadWrite)   ? FILE_MAP_WRITE :
+                        (mode == VZKR_FileMapMode_CopyOnWrite) ? FILE_MAP_COPY  :
+                                                                 FILE_MAP_READ;
+
+        HANDLE section = CreateFileMappingW((HANDLE) file.handle, nil, protect, 0, 0, nil);
+        if (!section) return false;
+
+        rawptr base = MapViewOfFile(section, access, (DWORD) ((u64) alignedOffset >> 32), (DWORD) ((u64) alignedOffset & 0xFFFFFFFF), (SIZE_T) mapSize);
+        if (!base) { CloseHandle(section); return false; }
+
+        output->platformHandle = (rawptr) section;
+    #elif PNSLR_UNIX
+        int prot  = (mode == VZKR_FileMapMode_ReadOnly) ? PROT_READ : (PROT_READ | PROT_WRITE);
+        int flags = (mode == VZKR_FileMapMode_ReadWrite) ? MAP_SHARED : MAP_PRIVATE;
+
+        rawptr base = mmap(nil, (size_t) mapSize, prot, flags, VZKR_Internal_FileDescriptor(file), (off_t) alignedOffset);
+        if (base == MAP_FAILED) return false;
+    #endif
+
+    output->base       = base;
+    output->baseSize   = mapSize;
+    output->data.data  = (u8*) base + (offset - alignedOffset);
+    output->data.count = size;
+    return true;
+}
+
+void VZKR_UnmapFile(VZKR_FileMapping* mapping)
+{
+    if (!mapping) return;
+
+    if (mapping->base)
+    {
+        #if PNSLR_WINDOWS
+            UnmapViewOfFile(mapping->base);
+            CloseHandle((HANDLE) mapping->platformHandle);
+        #elif PNSLR_UNIX
+            munmap(mapping->base, (size_t) mapping->baseSize);
+        #endif
+    }
+
+    *mapping = (VZKR_FileMapping) {0};
+}
+
+b8 VZKR_AdviseFileMapping(
+    VZKR_FileMapping* mapping,
+    VZKR_FileMapHint hint,
+    i64 offset,
+    i64 size
+)
+{
+    if (!mapping || offset < 0 || size < -1 || offset > mapping->data.count) return false;
+    if (size == -1) size = mapping->data.count - offset;
+    if (offset + size > mapping->data.count) return false;
+    if (size == 0) return true;
+
+    // the range has to start on a page boundary, so extend it backwards
+    u8* start      = mapping->data.data + offset;
+    u8* alignedPtr = (u8*) mapping->base + ((start - (u8*) mapping->base) / VZKR_Internal_MapAlignment()) * VZKR_Internal_MapAlignment();
+    i64 length     = size + (start - alignedPtr);
+
+    #if PNSLR_WINDOWS
+        if (hint != VZKR_FileMapHint_WillNeed) return true; // no equivalent
+
+        WIN32_MEMORY_RANGE_ENTRY range = {.VirtualAddress = alignedPtr, .NumberOfBytes = (SIZE_T) length};
+        return PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0) ? true : false;
+    #elif PNSLR_UNIX
+        int advice = MADV_NORMAL;
+        switch (hint)
+        {
+            case VZKR_FileMapHint_Sequential: advice = MADV_SEQUENTIAL; break;
+            case VZKR_FileMapHint_Random:     advice = MADV_RANDOM;     break;
+            case VZKR_FileMapHint_WillNeed:   advice = MADV_WILLNEED;   break;
+            default:                          advice = MADV_NORMAL;     break;
+        }
+
+        return madvise(alignedPtr, (size_t) length, advice) == 0;
+    #endif
+}
+
+b8 VZKR_FlushFileMapping(VZKR_FileMapping* mapping)
+{
+    if (!mapping) return false;
+    if (!mapping->base || mapping->mode != VZKR_FileMapMode_ReadWrite) return true;
+
+    #if PNSLR_WINDOWS
+        return FlushViewOfFile(mapping->base, (SIZE_T) mapping->baseSize) ? true : false;
+    #elif PNSLR_UNIX
+        return msync(mapping->base, (size_t) mapping->baseSize, MS_SYNC) == 0;
+    #endif
+}
+
+static b8 VZKR_Internal_FileMappingStreamProc(
+    rawptr streamData,
+    PNSLR_StreamMode mode,
+    PNSLR_ArraySlice(u8) data,
+    i64 offset,
+    i64* extraRet
+)
+{
+    VZKR_FileMapping* mapping = (VZKR_FileMapping*) streamData;
+    if (!mapping) return false;
+
+    i64 total = mapping->data.count;
+    i64* pos  = &mapping->streamPosition;
+
+    switch (mode)
+    {
+        case PNSLR_StreamMode_GetSize:
+            if (extraRet) *extraRet = total;
+            return true;
+        case PNSLR_StreamMode_GetCurrentPos:
+            if (extraRet) *extraRet = *pos;
+            return true;
+        case PNSLR_StreamMode_SeekAbsolute:
+        case PNSLR_StreamMode_SeekRelative:
+        {
+            i64 newPos = (mode == PNSLR_StreamMode_SeekRelative) ? *pos + offset : offset;
+            if (newPos < 0 || newPos > total) return false;
+            *pos = newPos;
+            return true;
+        }
+        case PNSLR_StreamMode_Read:
+        {
+            i64 count = total - *pos;
+            if (count > data.count) count = data.count;
+            VZKR_Internal_CopyBytes(data.data, mapping->data.data + *pos, count);
+            *pos += count;
+            if (extraRet) *extraRet = count;
+            return true;
+        }
+        case PNSLR_StreamMode_Write:
+        {
+            if (mapping->mode == VZKR_FileMapMode_ReadOnly) return false;
+            if (data.count > total - *pos) return false;
+            VZKR_Internal_CopyBytes(mapping->data.data + *pos, data.data, data.count);
+            *pos += data.count;
+            return true;
+        }
+        case PNSLR_StreamMode_Truncate:
+            return false;
+        case PNSLR_StreamMode_Flush:
+            return VZKR_FlushFileMapping(mapping);
+        case PNSLR_StreamMode_Close:
+            VZKR_UnmapFile(mapping);
+            return true;
+        default:
+            return false;
+    }
+}
+
+PNSLR_Stream VZKR_StreamFromFileMapping(VZKR_FileMapping* mapping)
+{
+    return (PNSLR_Stream) {.procedure = VZKR_Internal_FileMappingStreamProc, .data = (rawptr) mapping};
+}
+
+// File Copying ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_FILE_COPY_BUFFER_SIZE (1024 * 1024)
+
+#if PNSLR_LINUX
+    #define VZKR_INTERNAL_FICLONE _IOW(0x94, 9, int) // from linux/fs.h, which clashes with the libc headers
+#endif
+
+#if PNSLR_WINDOWS
+    /** Converts a path for the wide Windows API functions. Free with the same allocator. */
+    static wchar_t* VZKR_Internal_WidenPath(utf8str path, PNSLR_Allocator allocator)
+    {
+        i32 numWide = MultiByteToWideChar(CP_UTF8, 0, (LPCCH) path.data, (i32) path.count, nil, 0);
+        if (numWide < 0) return nil;
+
+        PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+        wchar_t* output = (wchar_t*) PNSLR_Allocate(allocator, false, (numWide + 1) * (i32) sizeof(wchar_t), (i32) alignof(wchar_t), PNSLR_GET_LOC(), &err);
+        if (err != PNSLR_AllocatorError_None || !output) return nil;
+
+        if (numWide > 0) MultiByteToWideChar(CP_UTF8, 0, (LPCCH) path.data, (i32) path.count, output, numWide);
+        output[numWide] = L'\0';
+        return output;
+    }
+#endif
+
+/**
+ * Copies a range between two files, trying the kernel's copying first.
+ * With 'freshDst', the destination's cursor is allowed to move, which lets sendfile help
+ * out where copy_file_range can't (older kernels, or across filesystems).
+ */
+static b8 VZKR_Internal_CopyFileData(PNSLR_File src, i64 srcOffset, PNSLR_File dst, i64 dstOffset, i64 size, b8 freshDst, i64* copied)
+{
+    i64 done = 0;
+
+    #if PNSLR_LINUX
+        int in  = VZKR_Internal_FileDescriptor(src);
+        int out = VZKR_Internal_FileDescriptor(dst);
+
+        #ifdef SYS_copy_file_range
+            while (done < size)
+            {
+                loff_t inOff  = (loff_t) (srcOffset + done);
+                loff_t outOff = (loff_t) (dstOffset + done);
+                i64 chunk = size - done;
+                if (chunk > VZKR_INTERNAL_FILE_MAX_TRANSFER) chunk = VZKR_INTERNAL_FILE_MAX_TRANSFER;
+
+                long res = syscall(SYS_copy_file_range, in, &inOff, out, &outOff, (size_t) chunk, 0u);
+                if (res < 0 && errno == EINTR) continue;
+                if (res < 0) break; // unsupported here, so on to the next way
+                if (res == 0) { *copied = done; return true; }
+                done += res;
+            }
+        #endif
+
+        if (freshDst && done < size && lseek(out, (off_t) (dstOffset + done), SEEK_SET) >= 0)
+        {
+            while (done < size)
+            {
+                off_t inOff = (off_t) (srcOffset + done);
+                i64 chunk = size - done;
+                if (chunk > VZKR_INTERNAL_FILE_MAX_TRANSFER) chunk = VZKR_INTERNAL_FILE_MAX_TRANSFER;
+
+                ssize_t res = sendfile(out, in, &inOff, (size_t) chunk);
+                if (res < 0 && errno == EINTR) continue;
+                if (res < 0) break;
+                if (res == 0) { *copied = done; return true; }
+                done += res;
+            }
+        }
+    #endif
+
+    if (done == size) { *copied = done; return true; }
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    PNSLR_Allocator heap = PNSLR_GetAllocator_DefaultHeap();
+    i64 bufferSize = size - done < VZKR_INTERNAL_FILE_COPY_BUFFER_SIZE ? size - done : VZKR_INTERNAL_FILE_COPY_BUFFER_SIZE;
+    PNSLR_ArraySlice(u8) buffer = PNSLR_MakeSlice(u8, bufferSize, false, heap, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None) { *copied = done; return false; }
+
+    b8 success = true;
+    while (done < size)
+    {
+        i64 chunk = size - done < buffer.count ? size - done : buffer.count;
+        i64 numRead = VZKR_Internal_FileTransferAt(src, buffer.data, chunk, srcOffset + done, false);
+        if (numRead <= 0) { success = (numRead == 0); break; }
+
+        i64 numWritten = 0;
+        if (!VZKR_Internal_FileTransferAllAt(dst, buffer.data, numRead, dstOffset + done, true, &numWritten)) { done += numWritten; success = false; break; }
+        done += numRead;
+    }
+
+    PNSLR_FreeSlice(&buffer, heap, PNSLR_GET_LOC(), nil);
+    *copied = done;
+    return success;
+}
+
+b8 VZKR_CopyFile(
+    PNSLR_Path src,
+    PNSLR_Path dst
+)
+{
+    #if PNSLR_WINDOWS
+        // CopyFileW already copies within the kernel, and clones blocks where it can
+        PNSLR_Allocator heap = PNSLR_GetAllocator_DefaultHeap();
+        wchar_t* srcWide = VZKR_Internal_WidenPath(src.path, heap);
+        wchar_t* dstWide = VZKR_Internal_WidenPath(dst.path, heap);
+        b8 success = srcWide && dstWide && CopyFileW(srcWide, dstWide, FALSE);
+        if (srcWide) PNSLR_Free(heap, srcWide, PNSLR_GET_LOC(), nil);
+        if (dstWide) PNSLR_Free(heap, dstWide, PNSLR_GET_LOC(), nil);
+        return success;
+    #elif PNSLR_OSX || PNSLR_IOS
+        // clones on APFS, and falls back to a regular copy elsewhere
+        PNSLR_Allocator heap = PNSLR_GetAllocator_DefaultHeap();
+        cstring srcPath = VZKR_Internal_CopyPathToCString(src, heap);
+        cstring dstPath = VZKR_Internal_CopyPathToCString(dst, heap);
+        b8 success = srcPath && dstPath && copyfile(srcPath, dstPath, nil, COPYFILE_CLONE | COPYFILE_DATA | COPYFILE_STAT | COPYFILE_UNLINK) == 0;
+        if (srcPath) PNSLR_Free(heap, (rawptr) srcPath, PNSLR_GET_LOC(), nil);
+        if (dstPath) PNSLR_Free(heap, (rawptr) dstPath, PNSLR_GET_LOC(), nil);
+        return success;
+    #elif PNSLR_UNIX
+        PNSLR_File in = PNSLR_OpenFileToRead(src, false);
+        if (!in.handle) return false;
+
+        i64 size = PNSLR_GetSizeOfFile(in);
+        PNSLR_File out = PNSLR_OpenFileToWrite(dst, false, false);
+        b8 success = (size >= 0) && out.handle;
+
+        #if PNSLR_LINUX
+            // a reflink shares the data outright, on btrfs/xfs/bcachefs and the like
+            if (success && ioctl(VZKR_Internal_FileDescriptor(out), VZKR_INTERNAL_FICLONE, VZKR_Internal_FileDescriptor(in)) == 0)
+            {
+                PNSLR_CloseFileHandle(in);
+                PNSLR_CloseFileHandle(out);
+                return true;
+            }
+        #endif
+
+        i64 copied = 0;
+        success = success && VZKR_Internal_CopyFileData(in, 0, out, 0, size, true, &copied);
+
+        PNSLR_CloseFileHandle(in);
+        if (out.handle) PNSLR_CloseFileHandle(out);
+        return success;
+    #endif
+}
+
+b8 VZKR_CopyFileRange(
+    PNSLR_File src,
+    i64 srcOffset,
+    PNSLR_File dst,
+    i64 dstOffset,
+    i64 size,
+    i64* copiedSize
+)
+{
+    i64 copied = 0;
+    b8 success = src.handle && dst.handle && srcOffset >= 0 && dstOffset >= 0 && size >= 0 &&
+                 VZKR_Internal_CopyFileData(src, srcOffset, dst, dstOffset, size, false, &copied);
+    if (copiedSize) *copiedSize = copied;
+    return success;
+}
+
+// Atomic File Writes ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_ATOMIC_WRITE_ATTEMPTS 16
+
+static u32 VZKR_Internal_AtomicWriteCounter = 0; // only ever touched atomically
+
+/** Opens a brand new file for writing, failing if it already exists. */
+static PNSLR_File VZKR_Internal_CreateNewFile(PNSLR_Path path, PNSLR_Path original, PNSLR_Allocator allocator)
+{
+    #if PNSLR_WINDOWS
+        (void) original; // a new file inherits the directory's permissions instead
+
+        wchar_t* wide = VZKR_Internal_WidenPath(path.path, allocator);
+        if (!wide) return (PNSLR_File) {0};
+
+        HANDLE handle = CreateFileW(wide, GENERIC_READ | GENERIC_WRITE, 0, nil, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nil);
+        PNSLR_Free(allocator, wide, PNSLR_GET_LOC(), nil);
+        return (PNSLR_File) {.handle = (handle == INVALID_HANDLE_VALUE) ? nil : (rawptr) handle};
+    #elif PNSLR_UNIX
+        (void) allocator; // the path's already null-terminated
+
+        // keep the permissions of the file being replaced
+        mode_t mode = 0666;
+        struct stat st;
+        if (stat((const char*) original.path.data, &st) == 0) mode = st.st_mode & 07777;
+
+        int fd;
+        do { fd = open((const char*) path.path.data, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, mode); } while (fd < 0 && errno == EINTR);
+        return (fd < 0) ? (PNSLR_File) {0} : VZKR_Internal_FileFromDescriptor(fd);
+    #endif
+}
+
+static void VZKR_Internal_FreeAtomicFileWrite(VZKR_AtomicFileWrite* write)
+{
+    if (write->path.path.data)     PNSLR_Free(write->allocator, write->path.path.data, PNSLR_GET_LOC(), nil);
+    if (write->tempPath.path.data) PNSLR_Free(write->allocator, write->tempPath.path.data, PNSLR_GET_LOC(), nil);
+    *write = (VZKR_AtomicFileWrite) {0};
+}
+
+b8 VZKR_BeginAtomicFileWrite(
+    PNSLR_Path path,
+    PNSLR_Allocator allocator,
+    VZKR_AtomicFileWrite* output
+)
+{
+    if (!output) return false;
+    *output = (VZKR_AtomicFileWrite) {.allocator = allocator};
+    if (path.path.count <= 0 || path.path.data[path.path.count - 1] == '/') return false;
+
+    // both nul-terminated, so they can go straight to the OS; the temp file sits next to
+    // the original, since renames only replace atomically within the same filesystem
+    const i64 suffixLength = 1 + 16 + 4; // ".<hex>.tmp"
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    output->path.path.data     = (u8*) PNSLR_Allocate(allocator, false, (i32) path.path.count + 1, 1, PNSLR_GET_LOC(), &err);
+    output->tempPath.path.data = (u8*) PNSLR_Allocate(allocator, false, (i32) (path.path.count + suffixLength) + 1, 1, PNSLR_GET_LOC(), &err);
+    if (!output->path.path.data || !output->tempPath.path.data) { VZKR_Internal_FreeAtomicFileWrite(output); return false; }
+
+    PNSLR_MemCopy(output->path.path.data, path.path.data, (i32) path.path.count);
+    PNSLR_MemCopy(output->tempPath.path.data, path.path.data, (i32) path.path.count);
+    output->path.path.data[path.path.count] = '\0';
+    output->path.path.count                 = path.path.count;
+    output->tempPath.path.count             = path.path.count + suffixLength;
+
+    #if PNSLR_WINDOWS
+        u64 processId = (u64) GetCurrentProcessId();
+    #elif PNSLR_UNIX
+        u64 processId = (u64) getpid();
+    #endif
+
+    for (i32 attempt = 0; attempt < VZKR_INTERNAL_ATOMIC_WRITE_ATTEMPTS; attempt++)
+    {
+        // unique enough between processes and threads, and retried if not
+        u64 unique = (processId << 32) ^ (u64) VZKR_AtomicFetchAddU32(&VZKR_Internal_AtomicWriteCounter, 1, VZKR_MemoryOrder_Relaxed) ^ ((u64) (uintptr_t) output << 12);
+
+        u8* suffix = output->tempPath.path.data + path.path.count;
+        suffix[0] = '.';
+        for (i32 i = 0; i < 16; i++) { suffix[1 + i] = (u8) "0123456789abcdef"[(unique >> (60 - i * 4)) & 0xF]; }
+        PNSLR_MemCopy(suffix + 17, (rawptr) ".tmp", 5);
+
+        output->file = VZKR_Internal_CreateNewFile(output->tempPath, output->path, allocator);
+        if (output->file.handle) return true;
+    }
+
+    VZKR_Internal_FreeAtomicFileWrite(output);
+    return false;
+}
+
+b8 VZKR_CommitAtomicFileWrite(VZKR_AtomicFileWrite* write)
+{
+    if (!write || !write->file.handle) return false;
+
+    b8 success = false;
+
+    #if PNSLR_WINDOWS
+        HANDLE handle = (HANDLE) write->file.handle;
+        success = FlushFileBuffers(handle) != 0;
+        CloseHandle(handle);
+
+        wchar_t* tempWide = VZKR_Internal_WidenPath(write->tempPath.path, write->allocator);
+        wchar_t* pathWide = VZKR_Internal_WidenPath(write->path.path, write->allocator);
+        success = success && tempWide && pathWide && MoveFileExW(tempWide, pathWide, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+        if (!success && tempWide) DeleteFileW(tempWide);
+        if (tempWide) PNSLR_Free(write->allocator, tempWide, PNSLR_GET_LOC(), nil);
+        if (pathWide) PNSLR_Free(write->allocator, pathWide, PNSLR_GET_LOC(), nil);
+    #elif PNSLR_UNIX
+        int fd = VZKR_Internal_FileDescriptor(write->file);
+        #if PNSLR_OSX || PNSLR_IOS
+            // plain fsync doesn't reach the disk itself on apple platforms
+            success = (fcntl(fd, F_FULLFSYNC) == 0) || (fsync(fd) == 0);
+        #else
+            success = (fdatasync(fd) == 0);
+        #endif
+        success = (close(fd) == 0) && success;
+        success = success && rename((const char*) write->tempPath.path.data, (const char*) write->path.path.data) == 0;
+        if (!success) unlink((const char*) write->tempPath.path.data);
+
+        if (success)
+        {
+            // the rename itself only survives a crash once the directory's been synced too
+            i64 dirLength = write->path.path.count;
+            while (dirLength > 0 && write->path.path.data[dirLength - 1] != '/') { dirLength--; }
+
+            u8 saved = write->path.path.data[dirLength];
+            write->path.path.data[dirLength] = '\0';
+            int dirFd = open(dirLength > 0 ? (const char*) write->path.path.data : ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            write->path.path.data[dirLength] = saved;
+
+            if (dirFd >= 0) { fsync(dirFd); close(dirFd); }
+        }
+    #endif
+
+    VZKR_Internal_FreeAtomicFileWrite(write);
+    return success;
+}
+
+void VZKR_AbortAtomicFileWrite(VZKR_AtomicFileWrite* write)
+{
+    if (!write || !write->file.handle) return;
+
+    PNSLR_CloseFileHandle(write->file);
+    PNSLR_DeletePath(write->tempPath);
+    VZKR_Internal_FreeAtomicFileWrite(write);
+}
+
+b8 VZKR_WriteAllContentsToFileAtomically(
+    PNSLR_Path path,
+    PNSLR_ArraySlice(u8) src
+)
+{
+    VZKR_AtomicFileWrite write;
+    if (!VZKR_BeginAtomicFileWrite(path, PNSLR_GetAllocator_DefaultHeap(), &write)) return false;
+
+    i64 written = 0;
+    if (!VZKR_Internal_FileTransferAllAt(write.file, src.data, src.count, 0, true, &written))
+    {
+        VZKR_AbortAtomicFileWrite(&write);
+        return false;
+    }
+
+    return VZKR_CommitAtomicFileWrite(&write);
+}
+
+// Whole File Loading ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_FILE_LOAD_DEFAULT_THREADS    4
+#define VZKR_INTERNAL_FILE_LOAD_DEFAULT_CHUNK_SIZE (4 * 1024 * 1024)
+#define VZKR_INTERNAL_FILE_LOAD_PARALLEL_THRESHOLD (8 * 1024 * 1024) // below this, threads aren't worth it
+#define VZKR_INTERNAL_FILE_LOAD_DIRECT_ALIGNMENT   4096
+
+typedef struct VZKR_Internal_FileLoad
+{
+    PNSLR_Allocator allocator;
+    PNSLR_File file;
+    i64 size;
+    i64 chunkSize;
+    i64 numChunks;
+    b8 direct;
+    PNSLR_ArraySlice(u8) buffer; // rounded up for direct reads, which read whole blocks
+    VZKR_FileLoadProgressDelegate progress;
+    rawptr userData;
+
+    VZKR_ProfiledMutex mutex;
+    PNSLR_ConditionVariable chunkLoaded;
+    PNSLR_ArraySlice(b8) chunksDone;
+    i64 nextChunk;
+    i64 numContiguousChunks;
+    i64 loadedSize;
+    b8 failed;
+    PNSLR_ArraySlice(VZKR_Thread) threads;
+} VZKR_Internal_FileLoad;
+
+static i64 VZKR_Internal_FileLoadContiguousSize(VZKR_Internal_FileLoad* load)
+{
+    i64 size = load->numContiguousChunks * load->chunkSize;
+    return size < load->size ? size : load->size;
+}
+
+/** Reads chunks until there are none left, on however many threads. */
+static void VZKR_Internal_FileLoadWorker(rawptr arg)
+{
+    VZKR_Internal_FileLoad* load = (VZKR_Internal_FileLoad*) arg;
+    while (true)
+    {
+        VZKR_LockProfiledMutex(&load->mutex);
+        if (load->failed || load->nextChunk >= load->numChunks) { VZKR_UnlockProfiledMutex(&load->mutex); break; }
+        i64 idx = load->nextChunk++;
+        VZKR_UnlockProfiledMutex(&load->mutex);
+
+        i64 offset = idx * load->chunkSize;
+        i64 count  = load->size - offset < load->chunkSize ? load->size - offset : load->chunkSize;
+        i64 toRead = count;
+        if (load->direct) toRead = (count + VZKR_INTERNAL_FILE_LOAD_DIRECT_ALIGNMENT - 1) & ~(i64) (VZKR_INTERNAL_FILE_LOAD_DIRECT_ALIGNMENT - 1);
+
+        // a short read means the file shrank underneath us
+        i64 numRead = 0;
+        b8 success = true;
+        if (load->direct)
+        {
+            // the tail's read rounded up to a whole block, so it comes up short at the end
+            // of the file; carrying on from there would be an unaligned read, which direct
+            // I/O can fail outright instead of just returning nothing, so only full reads do
+            while (numRead < toRead)
+            {
+                i64 wanted = toRead - numRead < VZKR_INTERNAL_FILE_MAX_TRANSFER ? toRead - numRead : VZKR_INTERNAL_FILE_MAX_TRANSFER;
+                i64 res    = VZKR_Internal_FileTransferAt(load->file, load->buffer.data + offset + numRead, wanted, offset + numRead, false);
+                if (res < 0) { success = false; break; }
+
+                numRead += res;
+                if (res < wanted) break;
+            }
+        }
+        else
+        {
+            success = VZKR_Internal_FileTransferAllAt(load->file, load->buffer.data + offset, toRead, offset, false, &numRead);
+        }
+
+        success = success && numRead >= count;
+
+        VZKR_LockProfiledMutex(&load->mutex);
+        if (!success) load->failed = true;
+        else
+        {
+            load->chunksDone.data[idx] = true;
+            load->loadedSize += count;
+            while (load->numContiguousChunks < load->numChunks && load->chunksDone.data[load->numContiguousChunks]) { load->numContiguousChunks++; }
+            if (load->progress) load->progress(load->userData, load->loadedSize, load->size);
+        }
+
+        PNSLR_BroadcastConditionVariable(&load->chunkLoaded);
+        VZKR_UnlockProfiledMutex(&load->mutex);
+    }
+}
+
+/** Opens a file so that reads skip the OS' file cache. Returns a zeroed handle if that isn't possible. */
+static PNSLR_File VZKR_Internal_OpenFileDirect(PNSLR_Path path, PNSLR_Allocator allocator)
+{
+    #if PNSLR_WINDOWS
+        wchar_t* wide = VZKR_Internal_WidenPath(path.path, allocator);
+        if (!wide) return (PNSLR_File) {0};
+
+        HANDLE handle = CreateFileW(wide, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nil, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, nil);
+        PNSLR_Free(allocator, wide, PNSLR_GET_LOC(), nil);
+        return (PNSLR_File) {.handle = (handle == INVALID_HANDLE_VALUE) ? nil : (rawptr) handle};
+    #elif PNSLR_UNIX
+        cstring pathC = VZKR_Internal_CopyPathToCString(path, allocator);
+        if (!pathC) return (PNSLR_File) {0};
+
+        #if PNSLR_OSX || PNSLR_IOS
+            int fd = open(pathC, O_RDONLY | O_CLOEXEC);
+            if (fd >= 0 && fcntl(fd, F_NOCACHE, 1) != 0) { close(fd); fd = -1; }
+        #else
+            // some filesystems (like tmpfs) refuse O_DIRECT outright
+            int fd = open(pathC, O_RDONLY | O_DIRECT | O_CLOEXEC);
+        #endif
+
+        PNSLR_Free(allocator, (rawptr) pathC, PNSLR_GET_LOC(), nil);
+        return (fd < 0) ? (PNSLR_File) {0} : VZKR_Internal_FileFromDescriptor(fd);
+    #endif
+}
+
+static void VZKR_Internal_FileLoadFree(VZKR_Internal_FileLoad* load, b8 freeBuffer)
+{
+    if (load->file.handle) PNSLR_CloseFileHandle(load->file);
+    if (freeBuffer) PNSLR_FreeSlice(&load->buffer, load->allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&load->chunksDone, load->allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&load->threads, load->allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_DestroyConditionVariable(&load->chunkLoaded);
+    VZKR_DestroyProfiledMutex(&load->mutex);
+    PNSLR_Free(load->allocator, load, PNSLR_GET_LOC(), nil);
+}
+
+VZKR_FileLoad VZKR_BeginFileLoad(
+    PNSLR_Path path,
+    VZKR_FileLoadOptions options
+)
+{
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_FileLoad* load = (VZKR_Internal_FileLoad*) PNSLR_Allocate(options.allocator, true, (i32) sizeof(VZKR_Internal_FileLoad), (i32) alignof(VZKR_Internal_FileLoad), PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !load) return (VZKR_FileLoad) {0};
+
+    load->allocator   = options.allocator;
+    load->progress    = options.progress;
+    load->userData    = options.userData;
+    load->mutex       = VZKR_CreateProfiledMutex(PNSLR_GET_LOC());
+    load->chunkLoaded = PNSLR_CreateConditionVariable();
+
+    // pick a strategy based on the size
+    i64 size = PNSLR_GetFileSize(path);
+    VZKR_FileLoadStrategy strategy = options.strategy;
+    if (strategy == VZKR_FileLoadStrategy_Auto)
+    {
+        strategy = (size < VZKR_INTERNAL_FILE_LOAD_PARALLEL_THRESHOLD) ? VZKR_FileLoadStrategy_SingleRead : VZKR_FileLoadStrategy_Parallel;
+    }
+
+    if (strategy == VZKR_FileLoadStrategy_ParallelDirect)
+    {
+        load->file   = VZKR_Internal_OpenFileDirect(path, options.allocator);
+        load->direct = (load->file.handle != nil);
+    }
+
+    if (!load->file.handle) load->file = PNSLR_OpenFileToRead(path, false);
+    if (load->file.handle) load->size = PNSLR_GetSizeOfFile(load->file);
+
+    i64 alignment = load->direct ? VZKR_INTERNAL_FILE_LOAD_DIRECT_ALIGNMENT : 1;
+    i64 capacity  = (load->size + alignment - 1) & ~(alignment - 1);
+    if (!load->file.handle || load->size < 0 || capacity > VZKR_INTERNAL_FILE_MAX_TRANSFER)
+    {
+        VZKR_Internal_FileLoadFree(load, true);
+        return (VZKR_FileLoad) {0};
+    }
+
+    // direct chunks have to start on block boundaries too
+    i64 chunkSize = (options.chunkSize > 0) ? options.chunkSize : VZKR_INTERNAL_FILE_LOAD_DEFAULT_CHUNK_SIZE;
+    chunkSize = (chunkSize + alignment - 1) & ~(alignment - 1);
+    if (strategy == VZKR_FileLoadStrategy_SingleRead || chunkSize > load->size) chunkSize = load->size > 0 ? load->size : 1;
+
+    load->chunkSize = chunkSize;
+    load->numChunks = (load->size + chunkSize - 1) / chunkSize;
+
+    load->buffer.data  = (u8*) PNSLR_Allocate(options.allocator, false, (i32) capacity + 1, (i32) alignment, PNSLR_GET_LOC(), &err);
+    load->buffer.count = load->size;
+    load->chunksDone   = PNSLR_MakeSlice(b8, load->numChunks > 0 ? load->numChunks : 1, true, options.allocator, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !load->buffer.data)
+    {
+        VZKR_Internal_FileLoadFree(load, true);
+        return (VZKR_FileLoad) {0};
+    }
+
+    i32 numThreads = (options.numThreads > 0) ? options.numThreads : VZKR_INTERNAL_FILE_LOAD_DEFAULT_THREADS;
+    if (numThreads > load->numChunks) numThreads = (i32) load->numChunks;
+
+    if (strategy == VZKR_FileLoadStrategy_SingleRead)
+    {
+        // done by the time this returns
+        VZKR_Internal_FileLoadWorker(load);
+        return (VZKR_FileLoad) {.handle = load};
+    }
+
+    load->threads = PNSLR_MakeSlice(VZKR_Thread, numThreads, true, options.allocator, PNSLR_GET_LOC(), &err);
+    VZKR_ThreadOptions threadOptions = {.name = PNSLR_StringLiteral("VzkrFileLoad")};
+    i32 numStarted = 0;
+    for (i32 i = 0; err == PNSLR_AllocatorError_None && i < numThreads; i++, numStarted++)
+    {
+        load->threads.data[i] = VZKR_CreateThread(VZKR_Internal_FileLoadWorker, load, threadOptions, options.allocator);
+        if (!load->threads.data[i].handle) break;
+    }
+
+    load->threads.count = numStarted;
+
+    // the calling thread picks up the work if no threads could be started
+    if (numStarted == 0) VZKR_Internal_FileLoadWorker(load);
+    return (VZKR_FileLoad) {.handle = load};
+}
+
+i64 VZKR_GetFileLoadTotalSize(VZKR_FileLoad load)
+{
+    if (!load.handle) return -1;
+    return ((VZKR_Internal_FileLoad*) load.handle)->size;
+}
+
+PNSLR_ArraySlice(u8) VZKR_GetLoadedFileContents(VZKR_FileLoad load)
+{
+    if (!load.handle) return (PNSLR_ArraySlice(u8)) {0};
+    VZKR_Internal_FileLoad* internal = (VZKR_Internal_FileLoad*) load.handle;
+
+    VZKR_LockProfiledMutex(&internal->mutex);
+    i64 loaded = VZKR_Internal_FileLoadContiguousSize(internal);
+    VZKR_UnlockProfiledMutex(&internal->mutex);
+
+    return (PNSLR_ArraySlice(u8)) {.data = internal->buffer.data, .count = loaded};
+}
+
+b8 VZKR_WaitForFileLoad(
+    VZKR_FileLoad load,
+    i64 minSize,
+    i32 timeoutNs
+)
+{
+    if (!load.handle) return false;
+    VZKR_Internal_FileLoad* internal = (VZKR_Internal_FileLoad*) load.handle;
+    if (minSize > internal->size) minSize = internal->size;
+
+    i64 deadline = (timeoutNs >= 0) ? VZKR_GetMonotonicTime() + timeoutNs : 0;
+
+    VZKR_LockProfiledMutex(&internal->mutex);
+    while (!internal->failed && VZKR_Internal_FileLoadContiguousSize(internal) < minSize)
+    {
+        if (timeoutNs < 0) { VZKR_WaitProfiledConditionVariable(&internal->chunkLoaded, &internal->mutex); continue; }
+
+        // every chunk wakes everyone up, so keep going until the deadline
+        i64 remaining = deadline - VZKR_GetMonotonicTime();
+        if (remaining <= 0) break;
+        VZKR_WaitProfiledConditionVariableTimeout(&internal->chunkLoaded, &internal->mutex, (i32) remaining);
+    }
+
+    b8 loaded = !internal->failed && VZKR_Internal_FileLoadContiguousSize(internal) >= minSize;
+    VZKR_UnlockProfiledMutex(&internal->mutex);
+    return loaded;
+}
+
+b8 VZKR_FinishFileLoad(
+    VZKR_FileLoad* load,
+    PNSLR_ArraySlice(u8)* output
+)
+{
+    if (output) *output = (PNSLR_ArraySlice(u8)) {0};
+    if (!load || !load->handle) return false;
+    VZKR_Internal_FileLoad* internal = (VZKR_Internal_FileLoad*) load->handle;
+
+    if (!output)
+    {
+        // stops the workers from picking up anything new
+        VZKR_LockProfiledMutex(&internal->mutex);
+        internal->failed = true;
+        VZKR_UnlockProfiledMutex(&internal->mutex);
+    }
+
+    for (i64 i = 0; i < internal->threads.count; i++) { VZKR_JoinThread(&internal->threads.data[i]); }
+
+    b8 success = !internal->failed && output != nil;
+    if (success) *output = internal->buffer;
+
+    VZKR_Internal_FileLoadFree(internal, !success);
+    *load = (VZKR_FileLoad) {0};
+    return success;
+}
+
+b8 VZKR_ReadAllContentsFromFileParallel(
+    PNSLR_Path path,
+    VZKR_FileLoadOptions options,
+    PNSLR_ArraySlice(u8)* dst
+)
+{
+    if (!dst) return false;
+    *dst = (PNSLR_ArraySlice(u8)) {0};
+
+    VZKR_FileLoad load = VZKR_BeginFileLoad(path, options);
+    return VZKR_FinishFileLoad(&load, dst);
+}
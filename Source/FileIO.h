@@ -0,0 +1,349 @@
+#ifndef VZKR_FILE_IO_H // ==========================================================
+#define VZKR_FILE_IO_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Positional File I/O ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Reads data from an opened file at an absolute offset, without moving its cursor,
+ * so several threads can read different parts of the same file at once.
+ * On Windows, the transfer itself moves the cursor, and it's put back afterwards, so it's
+ * only left alone if nothing else moves it (or reads and writes at it) at the same time;
+ * the same goes for every other function here that doesn't move the cursor.
+ * Keeps reading until 'dst' is full or the file ends.
+ * Optionally stores the number of bytes read.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_ReadFromFileAt(
+    PNSLR_File handle,
+    PNSLR_ArraySlice(u8) dst,
+    i64 offset,
+    i64* readSize
+);
+
+/**
+ * Writes data to an opened file at an absolute offset, without moving its cursor.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_WriteToFileAt(
+    PNSLR_File handle,
+    PNSLR_ArraySlice(u8) src,
+    i64 offset
+);
+
+/**
+ * Reads a contiguous range of an opened file, starting at an absolute offset, into
+ * several buffers in order (scatter), without moving its cursor.
+ * Keeps reading until every buffer is full or the file ends.
+ * Optionally stores the total number of bytes read.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_ReadFromFileAtVectored(
+    PNSLR_File handle,
+    PNSLR_ArraySlice(utf8str) dst,
+    i64 offset,
+    i64* readSize
+);
+
+/**
+ * Writes several buffers, in order, as a contiguous range of an opened file starting
+ * at an absolute offset (gather), without moving its cursor.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_WriteToFileAtVectored(
+    PNSLR_File handle,
+    PNSLR_ArraySlice(utf8str) src,
+    i64 offset
+);
+
+// File Mapping ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * How a file is mapped into memory.
+ * Read-only mappings can't be written to.
+ * Copy-on-write mappings can be written to, but the changes stay private to the process.
+ * Read-write mappings write through to the file (the file must be opened for writing).
+ */
+typedef u8 VZKR_FileMapMode /* use as value */;
+#define VZKR_FileMapMode_ReadOnly ((VZKR_FileMapMode) 0)
+#define VZKR_FileMapMode_CopyOnWrite ((VZKR_FileMapMode) 1)
+#define VZKR_FileMapMode_ReadWrite ((VZKR_FileMapMode) 2)
+
+/**
+ * Hints to the OS about how a mapped range is going to be accessed.
+ * Only hints, unsupported ones are silently ignored.
+ */
+typedef u8 VZKR_FileMapHint /* use as value */;
+#define VZKR_FileMapHint_Normal ((VZKR_FileMapHint) 0)
+#define VZKR_FileMapHint_Sequential ((VZKR_FileMapHint) 1)
+#define VZKR_FileMapHint_Random ((VZKR_FileMapHint) 2)
+#define VZKR_FileMapHint_WillNeed ((VZKR_FileMapHint) 3)
+
+/**
+ * A range of a file mapped into memory.
+ * 'data' is the requested range; the OS mapping itself ('base'/'baseSize') starts at
+ * the closest page boundary before it.
+ * 'streamPosition' is the cursor used when the mapping is used as a stream.
+ */
+typedef struct VZKR_FileMapping
+{
+    PNSLR_ArraySlice(u8) data;
+    VZKR_FileMapMode mode;
+    rawptr base;
+    i64 baseSize;
+    rawptr platformHandle;
+    i64 streamPosition;
+} VZKR_FileMapping;
+
+/**
+ * Maps 'size' bytes of a file starting at 'offset' into memory.
+ * A size of -1 maps everything from the offset to the end of the file.
+ * The offset doesn't need to be page-aligned. The file can be closed once mapped.
+ * Mapping an empty range succeeds with an empty slice.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_MapFile(
+    PNSLR_File file,
+    VZKR_FileMapMode mode,
+    i64 offset,
+    i64 size,
+    VZKR_FileMapping* output
+);
+
+/**
+ * Unmaps a file mapping. Changes to read-write mappings are written back by the OS.
+ */
+void VZKR_UnmapFile(
+    VZKR_FileMapping* mapping
+);
+
+/**
+ * Hints to the OS how a range of the mapping (relative to 'data') is going to be used.
+ * A size of -1 covers everything from the offset to the end of the mapping.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_AdviseFileMapping(
+    VZKR_FileMapping* mapping,
+    VZKR_FileMapHint hint,
+    i64 offset,
+    i64 size
+);
+
+/**
+ * Writes the changes made to a read-write mapping back to the file.
+ * Does nothing for other modes.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_FlushFileMapping(
+    VZKR_FileMapping* mapping
+);
+
+/**
+ * Creates a stream over a file mapping, reading and writing at its 'streamPosition'.
+ * Writes can't go past the end of the mapping, and read-only mappings can't be written.
+ * Closing the stream unmaps the file; the mapping must outlive the stream.
+ */
+PNSLR_Stream VZKR_StreamFromFileMapping(
+    VZKR_FileMapping* mapping
+);
+
+// File Copying ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Copies a file from src to dst. If dst exists, it will be overwritten.
+ * Unlike `PNSLR_CopyFile`, lets the OS do the work wherever it can: filesystems that
+ * support reflinks share the data without copying it at all, otherwise the data is
+ * copied within the kernel, with large buffered copies as the last resort.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_CopyFile(
+    PNSLR_Path src,
+    PNSLR_Path dst
+);
+
+/**
+ * Copies a range of one opened file into another at absolute offsets, without moving
+ * either cursor. Copies within the kernel where possible.
+ * Stops early if the source ends. Optionally stores the number of bytes copied.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_CopyFileRange(
+    PNSLR_File src,
+    i64 srcOffset,
+    PNSLR_File dst,
+    i64 dstOffset,
+    i64 size,
+    i64* copiedSize
+);
+
+// Atomic File Writes ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A file being written to replace another one. Everything is written to a temporary
+ * file next to it, which only takes its place once committed, so other readers (or a
+ * crash midway) see either the old contents or the new ones, never a mix.
+ * Write to 'file' with the regular Panshilar functions, or a stream over it.
+ */
+typedef struct VZKR_AtomicFileWrite
+{
+    PNSLR_File file;
+    PNSLR_Allocator allocator;
+    PNSLR_Path path;
+    PNSLR_Path tempPath;
+} VZKR_AtomicFileWrite;
+
+/**
+ * Starts writing a file that replaces 'path' (if it exists) once committed.
+ * The allocator is used for the paths, and must stay valid until the write is finished.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_BeginAtomicFileWrite(
+    PNSLR_Path path,
+    PNSLR_Allocator allocator,
+    VZKR_AtomicFileWrite* output
+);
+
+/**
+ * Makes sure everything written is on disk, then swaps the file in.
+ * The file is closed either way; on failure, the original is left untouched.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_CommitAtomicFileWrite(
+    VZKR_AtomicFileWrite* write
+);
+
+/**
+ * Throws away everything written, leaving the original untouched.
+ */
+void VZKR_AbortAtomicFileWrite(
+    VZKR_AtomicFileWrite* write
+);
+
+/**
+ * Replaces the contents of a file in one go, as an atomic file write.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_WriteAllContentsToFileAtomically(
+    PNSLR_Path path,
+    PNSLR_ArraySlice(u8) src
+);
+
+// Whole File Loading ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A cross-platform opaque handle to a file being loaded into memory in the background.
+ */
+typedef struct VZKR_FileLoad
+{
+    rawptr handle;
+} VZKR_FileLoad;
+
+/**
+ * How a file gets loaded.
+ * 'Auto' does a single read for small files, and reads large ones in parallel.
+ * 'SingleRead' reads everything on the calling thread, before the load even starts.
+ * 'ParallelDirect' also bypasses the OS' file cache, which is faster for large files
+ * that aren't cached already, and doesn't push everything else out of the cache.
+ */
+typedef u8 VZKR_FileLoadStrategy /* use as value */;
+#define VZKR_FileLoadStrategy_Auto ((VZKR_FileLoadStrategy) 0)
+#define VZKR_FileLoadStrategy_SingleRead ((VZKR_FileLoadStrategy) 1)
+#define VZKR_FileLoadStrategy_Parallel ((VZKR_FileLoadStrategy) 2)
+#define VZKR_FileLoadStrategy_ParallelDirect ((VZKR_FileLoadStrategy) 3)
+
+/**
+ * The signature of the delegate that's called as a file load makes progress.
+ * Called from the loading threads, one call at a time.
+ */
+typedef void (*VZKR_FileLoadProgressDelegate)(
+    rawptr userData,
+    i64 loadedSize,
+    i64 totalSize
+);
+
+/**
+ * Options for loading a file.
+ * 'numThreads' is the number of threads reading in parallel (defaults to 4).
+ * 'chunkSize' is the size of each read (defaults to 4MiB).
+ * The contents are allocated from the allocator, which must be thread-safe.
+ */
+typedef struct VZKR_FileLoadOptions
+{
+    PNSLR_Allocator allocator;
+    VZKR_FileLoadStrategy strategy;
+    i32 numThreads;
+    i32 chunkSize;
+    VZKR_FileLoadProgressDelegate progress;
+    rawptr userData;
+} VZKR_FileLoadOptions;
+
+/**
+ * Starts loading the contents of a file into a single buffer, in chunks read in the
+ * background. The contents can be processed as they come in, with
+ * `VZKR_GetLoadedFileContents` or `VZKR_WaitForFileLoad`.
+ * Files are limited to what the allocator can allocate at once (just under 2GiB).
+ * If starting failed, the returned handle will be zeroed.
+ */
+VZKR_FileLoad VZKR_BeginFileLoad(
+    PNSLR_Path path,
+    VZKR_FileLoadOptions options
+);
+
+/**
+ * Gets the size of the file being loaded.
+ */
+i64 VZKR_GetFileLoadTotalSize(
+    VZKR_FileLoad load
+);
+
+/**
+ * Gets the start of the file that's been loaded so far, without blocking.
+ * Chunks further ahead may already be done, but are only included once everything
+ * before them is.
+ */
+PNSLR_ArraySlice(u8) VZKR_GetLoadedFileContents(
+    VZKR_FileLoad load
+);
+
+/**
+ * Blocks until at least the first 'minSize' bytes (capped to the file size) are loaded,
+ * or the timeout expires. A negative timeout waits indefinitely.
+ * Returns true once they're loaded, false on timeout or failure.
+ */
+b8 VZKR_WaitForFileLoad(
+    VZKR_FileLoad load,
+    i64 minSize,
+    i32 timeoutNs
+);
+
+/**
+ * Waits for the whole file, and hands its contents over (free them with the
+ * allocator from the options). If 'output' is nil, the rest of the load is cancelled
+ * and everything is freed instead.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_FinishFileLoad(
+    VZKR_FileLoad* load,
+    PNSLR_ArraySlice(u8)* output
+);
+
+/**
+ * Reads the whole file in one go, like `PNSLR_ReadAllContentsFromFile`, but using
+ * a file load to do so.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_ReadAllContentsFromFileParallel(
+    PNSLR_Path path,
+    VZKR_FileLoadOptions options,
+    PNSLR_ArraySlice(u8)* dst
+);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_FILE_IO_H ===========================================================
@@ -0,0 +1,605 @@
+#define VZKR_IMPLEMENTATION
+#include "FileWatcher.h"
+
+// Internal Declarations ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_FILE_WATCHER_BUFFER_SIZE (64 * 1024)
+#define VZKR_INTERNAL_FILE_WATCHER_MAX_NAME    1024
+
+#if PNSLR_LINUX
+    #define VZKR_INTERNAL_INOTIFY_MASK (IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | \
+                                        IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR)
+#elif PNSLR_OSX || PNSLR_IOS
+    #define VZKR_INTERNAL_KQUEUE_MASK (NOTE_WRITE | NOTE_EXTEND | NOTE_ATTRIB | NOTE_DELETE | NOTE_RENAME)
+#endif
+
+/**
+ * A single watched path. Files are watched through their parent directory everywhere
+ * except OSX/iOS, which is what lets file watches survive the file being replaced.
+ */
+typedef struct VZKR_Internal_FileWatch
+{
+    PNSLR_Path path;  // owned, and nul-terminated
+    i64 dirLength;    // length of the directory part of the path, trailing slash included
+    i64 osHandle;     // inotify watch descriptor, kqueue file descriptor or directory handle
+
+    #if PNSLR_WINDOWS
+        OVERLAPPED overlapped;
+        wchar_t* widePath; // the directory part
+        i32 widePathLength;
+        PNSLR_ArraySlice(u8) buffer;
+    #endif
+} VZKR_Internal_FileWatch;
+
+typedef VZKR_Internal_FileWatch* VZKR_Internal_FileWatchPtr;
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_Internal_FileWatchPtr);
+
+typedef struct VZKR_Internal_FileWatcher
+{
+    PNSLR_Allocator allocator;
+    i64 osHandle; // inotify/kqueue file descriptor
+    PNSLR_ArraySlice(VZKR_Internal_FileWatchPtr) watches;
+    i64 numWatches;
+    PNSLR_ArraySlice(u8) buffer;
+
+    // valid until the next gather
+    PNSLR_Allocator tempAllocator;
+    PNSLR_ArraySlice(VZKR_FileChangeEvent) events;
+    i64 numEvents;
+} VZKR_Internal_FileWatcher;
+
+// Collecting Changes ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+static b8 VZKR_Internal_FileWatchIsDirectory(VZKR_Internal_FileWatch* watch)
+{
+    return watch->dirLength == watch->path.path.count;
+}
+
+/** Records a change to 'prefix' + 'name', adding a trailing slash for directories. */
+static void VZKR_Internal_FileWatcherPush(
+    VZKR_Internal_FileWatcher* watcher,
+    utf8str prefix,
+    const u8* name,
+    i64 nameLength,
+    b8 isDirectory,
+    VZKR_FileChange changes
+)
+{
+    if (changes == VZKR_FileChange_None) return;
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    if (watcher->numEvents == watcher->events.count)
+    {
+        i64 newCount = watcher->events.count ? watcher->events.count * 2 : 64;
+        PNSLR_ResizeSlice(VZKR_FileChangeEvent, &watcher->events, newCount, false, watcher->tempAllocator, PNSLR_GET_LOC(), &err);
+        if (err != PNSLR_AllocatorError_None) return;
+    }
+
+    i64 length = prefix.count + nameLength + ((isDirectory && nameLength > 0) ? 1 : 0);
+    u8* data = (u8*) PNSLR_Allocate(watcher->tempAllocator, false, (i32) length + 1, 1, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !data) return;
+
+    PNSLR_MemCopy(data, prefix.data, (i32) prefix.count);
+    if (nameLength > 0) PNSLR_MemCopy(data + prefix.count, (rawptr) name, (i32) nameLength);
+    if (length > prefix.count + nameLength) data[length - 1] = '/';
+    data[length] = '\0';
+
+    watcher->events.data[watcher->numEvents++] = (VZKR_FileChangeEvent) {.path = {.path = {.data = data, .count = length}}, .changes = changes};
+}
+
+/** Records a change to one of the watched paths itself. */
+static void VZKR_Internal_FileWatcherPushWatch(VZKR_Internal_FileWatcher* watcher, VZKR_Internal_FileWatch* watch, VZKR_FileChange changes)
+{
+    VZKR_Internal_FileWatcherPush(watcher, watch->path.path, nil, 0, false, changes);
+}
+
+/**
+ * Records a change to 'name' inside a watch's directory, if the watch cares about it:
+ * directory watches care about everything, file watches only about their own file.
+ */
+static void VZKR_Internal_FileWatcherPushChild(
+    VZKR_Internal_FileWatcher* watcher,
+    VZKR_Internal_FileWatch* watch,
+    const u8* name,
+    i64 nameLength,
+    b8 isDirectory,
+    VZKR_FileChange changes
+)
+{
+    if (VZKR_Internal_FileWatchIsDirectory(watch))
+    {
+        VZKR_Internal_FileWatcherPush(watcher, watch->path.path, name, nameLength, isDirectory, changes);
+        return;
+    }
+
+    utf8str fileName = {.data = watch->path.path.data + watch->dirLength, .count = watch->path.path.count - watch->dirLength};
+    utf8str childName = {.data = (u8*) name, .count = nameLength};
+    if (PNSLR_AreStringsEqual(fileName, childName, PNSLR_StringComparisonType_CaseSensitive))
+    {
+        VZKR_Internal_FileWatcherPushWatch(watcher, watch, changes);
+    }
+}
+
+static u64 VZKR_Internal_FileWatcherHashPath(utf8str path)
+{
+    u64 hash = 0xCBF29CE484222325ull; // FNV-1a
+    for (i64 i = 0; i < path.count; i++) { hash = (hash ^ path.data[i]) * 0x100000001B3ull; }
+    return hash;
+}
+
+/** Combines every change to the same path into its first event, keeping their order. */
+static void VZKR_Internal_FileWatcherCoalesce(VZKR_Internal_FileWatcher* watcher)
+{
+    i64 count = watcher->numEvents;
+    watcher->events.count = count;
+    if (count < 2) return;
+
+    i64 tableSize = 16;
+    while (tableSize < count * 2) { tableSize *= 2; }
+
+    // holds event index + 1, so zeroed slots are empty
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    PNSLR_ArraySlice(i64) table = PNSLR_MakeSlice(i64, tableSize, true, watcher->tempAllocator, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None) return;
+
+    i64 numUnique = 0;
+    for (i64 i = 0; i < count; i++)
+    {
+        VZKR_FileChangeEvent event = watcher->events.data[i];
+        for (u64 slot = VZKR_Internal_FileWatcherHashPath(event.path.path);; slot++)
+        {
+            i64* entry = &table.data[slot & (u64) (tableSize - 1)];
+            if (*entry == 0)
+            {
+                watcher->events.data[numUnique++] = event;
+                *entry = numUnique;
+                break;
+            }
+
+            VZKR_FileChangeEvent* existing = &watcher->events.data[*entry - 1];
+            if (PNSLR_AreStringsEqual(existing->path.path, event.path.path, PNSLR_StringComparisonType_CaseSensitive))
+            {
+                existing->changes |= event.changes;
+                break;
+            }
+        }
+    }
+
+    watcher->events.count = numUnique;
+    PNSLR_FreeSlice(&table, watcher->tempAllocator, PNSLR_GET_LOC(), nil);
+}
+
+// Platform Backends ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#if PNSLR_WINDOWS
+    static b8 VZKR_Internal_FileWatchIssueRead(VZKR_Internal_FileWatch* watch)
+    {
+        DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE |
+                       FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_CREATION;
+
+        ResetEvent(watch->overlapped.hEvent);
+        return ReadDirectoryChangesW((HANDLE) watch->osHandle, watch->buffer.data, (DWORD) watch->buffer.count, FALSE, filter, nil, &watch->overlapped, nil) != 0;
+    }
+#endif
+
+/** Starts watching with the OS, the path must already be set up. */
+static b8 VZKR_Internal_FileWatchOpen(VZKR_Internal_FileWatcher* watcher, VZKR_Internal_FileWatch* watch)
+{
+    #if PNSLR_LINUX
+        // watch the directory part, by terminating the path there for a moment
+        u8* data = watch->path.path.data;
+        u8 saved = data[watch->dirLength];
+        data[watch->dirLength] = '\0';
+        int wd = inotify_add_watch((int) watcher->osHandle, (const char*) data, VZKR_INTERNAL_INOTIFY_MASK);
+        data[watch->dirLength] = saved;
+
+        if (wd < 0) return false;
+        watch->osHandle = wd;
+        return true;
+    #elif PNSLR_OSX || PNSLR_IOS
+        int fd = open((const char*) watch->path.path.data, O_EVTONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+
+        struct kevent change;
+        EV_SET(&change, fd, EVFILT_VNODE, EV_ADD | EV_CLEAR, VZKR_INTERNAL_KQUEUE_MASK, 0, watch);
+        if (kevent((int) watcher->osHandle, &change, 1, nil, 0, nil) < 0) { close(fd); return false; }
+
+        watch->osHandle = fd;
+        return true;
+    #elif PNSLR_WINDOWS
+        if (!watch->widePath)
+        {
+            i32 numWide = MultiByteToWideChar(CP_UTF8, 0, (LPCCH) watch->path.path.data, (i32) watch->dirLength, nil, 0);
+            if (numWide <= 0) return false;
+
+            PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+            watch->widePath = (wchar_t*) PNSLR_Allocate(watcher->allocator, false, (numWide + 1) * (i32) sizeof(wchar_t), (i32) alignof(wchar_t), PNSLR_GET_LOC(), &err);
+            if (err != PNSLR_AllocatorError_None || !watch->widePath) return false;
+
+            MultiByteToWideChar(CP_UTF8, 0, (LPCCH) watch->path.path.data, (i32) watch->dirLength, watch->widePath, numWide);
+            watch->widePath[numWide] = L'\0';
+            watch->widePathLength = numWide;
+        }
+
+        if (!watch->buffer.data)
+        {
+            // ReadDirectoryChangesW wants a DWORD-aligned buffer
+            PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+            watch->buffer = PNSLR_MakeSlice(u8, VZKR_INTERNAL_FILE_WATCHER_BUFFER_SIZE, false, watcher->allocator, PNSLR_GET_LOC(), &err);
+            if (err != PNSLR_AllocatorError_None) return false;
+        }
+
+        HANDLE dir = CreateFileW(watch->widePath, FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                 nil, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nil);
+        if (dir == INVALID_HANDLE_VALUE) return false;
+
+        watch->overlapped = (OVERLAPPED) {0};
+        watch->overlapped.hEvent = CreateEventW(nil, TRUE, FALSE, nil);
+        watch->osHandle = (i64) dir;
+        if (!watch->overlapped.hEvent || !VZKR_Internal_FileWatchIssueRead(watch))
+        {
+            if (watch->overlapped.hEvent) CloseHandle(watch->overlapped.hEvent);
+            CloseHandle(dir);
+            watch->osHandle = 0;
+            return false;
+        }
+
+        return true;
+    #else
+        return false;
+    #endif
+}
+
+/** Stops watching with the OS, keeping the path. */
+static void VZKR_Internal_FileWatchClose(VZKR_Internal_FileWatcher* watcher, VZKR_Internal_FileWatch* watch)
+{
+    #if PNSLR_LINUX
+        if (watch->osHandle < 0) return;
+
+        // other watches in the same directory share the watch descriptor
+        for (i64 i = 0; i < watcher->numWatches; i++)
+        {
+            VZKR_Internal_FileWatch* other = watcher->watches.data[i];
+            if (other != watch && other->osHandle == watch->osHandle) { watch->osHandle = -1; return; }
+        }
+
+        inotify_rm_watch((int) watcher->osHandle, (int) watch->osHandle);
+        watch->osHandle = -1;
+    #elif PNSLR_OSX || PNSLR_IOS
+        if (watch->osHandle >= 0) close((int) watch->osHandle); // also removes it from the kqueue
+        watch->osHandle = -1;
+    #elif PNSLR_WINDOWS
+        if (!watch->osHandle) return;
+
+        CancelIoEx((HANDLE) watch->osHandle, &watch->overlapped);
+        DWORD ignored;
+        GetOverlappedResult((HANDLE) watch->osHandle, &watch->overlapped, &ignored, TRUE);
+        CloseHandle(watch->overlapped.hEvent);
+        CloseHandle((HANDLE) watch->osHandle);
+        watch->osHandle = 0;
+    #endif
+}
+
+static void VZKR_Internal_FileWatchFree(VZKR_Internal_FileWatcher* watcher, VZKR_Internal_FileWatch* watch)
+{
+    VZKR_Internal_FileWatchClose(watcher, watch);
+
+    #if PNSLR_WINDOWS
+        if (watch->widePath) PNSLR_Free(watcher->allocator, watch->widePath, PNSLR_GET_LOC(), nil);
+        PNSLR_FreeSlice(&watch->buffer, watcher->allocator, PNSLR_GET_LOC(), nil);
+    #endif
+
+    PNSLR_Free(watcher->allocator, watch->path.path.data, PNSLR_GET_LOC(), nil);
+    PNSLR_Free(watcher->allocator, watch, PNSLR_GET_LOC(), nil);
+}
+
+static void VZKR_Internal_FileWatcherGatherNative(VZKR_Internal_FileWatcher* watcher)
+{
+    #if PNSLR_LINUX
+        while (true)
+        {
+            ssize_t numRead = read((int) watcher->osHandle, watcher->buffer.data, (size_t) watcher->buffer.count);
+            if (numRead < 0 && errno == EINTR) continue;
+            if (numRead <= 0) break;
+
+            for (ssize_t pos = 0; pos < numRead;)
+            {
+                struct inotify_event* event = (struct inotify_event*) (watcher->buffer.data + pos);
+                pos += (ssize_t) sizeof(struct inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    for (i64 i = 0; i < watcher->numWatches; i++) { VZKR_Internal_FileWatcherPushWatch(watcher, watcher->watches.data[i], VZKR_FileChange_Overflow); }
+                    continue;
+                }
+
+                VZKR_FileChange changes = VZKR_FileChange_None;
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))                       changes |= VZKR_FileChange_Created;
+                if (event->mask & (IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB))        changes |= VZKR_FileChange_Modified;
+                if (event->mask & (IN_DELETE | IN_MOVED_FROM))                     changes |= VZKR_FileChange_Deleted;
+                if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF))                 changes |= VZKR_FileChange_Deleted;
+
+                // the name is padded with nuls
+                i64 nameLength = 0;
+                while (nameLength < event->len && event->name[nameLength]) { nameLength++; }
+
+                for (i64 i = 0; i < watcher->numWatches; i++)
+                {
+                    VZKR_Internal_FileWatch* watch = watcher->watches.data[i];
+                    if (watch->osHandle != event->wd) continue;
+
+                    // the directory itself went away, so everything watched in it did too
+                    if (event->mask & IN_IGNORED) { watch->osHandle = -1; continue; }
+
+                    if (nameLength == 0) VZKR_Internal_FileWatcherPushWatch(watcher, watch, changes);
+                    else VZKR_Internal_FileWatcherPushChild(watcher, watch, (const u8*) event->name, nameLength, (event->mask & IN_ISDIR) != 0, changes);
+                }
+            }
+        }
+    #elif PNSLR_OSX || PNSLR_IOS
+        struct kevent events[64];
+        struct timespec noWait = {0};
+        while (true)
+        {
+            int numEvents = kevent((int) watcher->osHandle, nil, 0, events, 64, &noWait);
+            if (numEvents < 0 && errno == EINTR) continue;
+            if (numEvents <= 0) break;
+
+            for (int i = 0; i < numEvents; i++)
+            {
+                VZKR_Internal_FileWatch* watch = (VZKR_Internal_FileWatch*) events[i].udata;
+                u32 flags = events[i].fflags;
+
+                VZKR_FileChange changes = VZKR_FileChange_None;
+                if (flags & (NOTE_WRITE | NOTE_EXTEND | NOTE_ATTRIB)) changes |= VZKR_FileChange_Modified;
+                if (flags & (NOTE_DELETE | NOTE_RENAME))
+                {
+                    // reopened below, once something's at the path again
+                    changes |= VZKR_FileChange_Deleted;
+                    VZKR_Internal_FileWatchClose(watcher, watch);
+                }
+
+                VZKR_Internal_FileWatcherPushWatch(watcher, watch, changes);
+            }
+
+            if (numEvents < 64) break;
+        }
+
+        for (i64 i = 0; i < watcher->numWatches; i++)
+        {
+            VZKR_Internal_FileWatch* watch = watcher->watches.data[i];
+            if (watch->osHandle < 0 && VZKR_Internal_FileWatchOpen(watcher, watch)) VZKR_Internal_FileWatcherPushWatch(watcher, watch, VZKR_FileChange_Created);
+        }
+    #elif PNSLR_WINDOWS
+        for (i64 i = 0; i < watcher->numWatches; i++)
+        {
+            VZKR_Internal_FileWatch* watch = watcher->watches.data[i];
+            if (!watch->osHandle) continue;
+
+            DWORD numBytes = 0;
+            if (!GetOverlappedResult((HANDLE) watch->osHandle, &watch->overlapped, &numBytes, FALSE))
+            {
+                if (GetLastError() == ERROR_IO_INCOMPLETE) continue;
+
+                // the directory went away
+                VZKR_Internal_FileWatchClose(watcher, watch);
+                VZKR_Internal_FileWatcherPushWatch(watcher, watch, VZKR_FileChange_Deleted);
+                continue;
+            }
+
+            if (numBytes == 0) VZKR_Internal_FileWatcherPushWatch(watcher, watch, VZKR_FileChange_Overflow);
+
+            for (DWORD pos = 0; numBytes > 0;)
+            {
+                FILE_NOTIFY_INFORMATION* info = (FILE_NOTIFY_INFORMATION*) (watch->buffer.data + pos);
+
+                VZKR_FileChange changes = VZKR_FileChange_None;
+                switch (info->Action)
+                {
+                    case FILE_ACTION_ADDED:
+                    case FILE_ACTION_RENAMED_NEW_NAME: changes = VZKR_FileChange_Created;  break;
+                    case FILE_ACTION_MODIFIED:         changes = VZKR_FileChange_Modified; break;
+                    case FILE_ACTION_REMOVED:
+                    case FILE_ACTION_RENAMED_OLD_NAME: changes = VZKR_FileChange_Deleted;  break;
+                    default: break;
+                }
+
+                i32 wideLength = (i32) (info->FileNameLength / sizeof(wchar_t));
+                char name[VZKR_INTERNAL_FILE_WATCHER_MAX_NAME];
+                i32 nameLength = WideCharToMultiByte(CP_UTF8, 0, info->FileName, wideLength, name, (i32) sizeof(name), nil, nil);
+
+                // the type only needs looking up for things that still exist in watched directories
+                b8 isDirectory = false;
+                if (nameLength > 0 && VZKR_Internal_FileWatchIsDirectory(watch) && changes != VZKR_FileChange_Deleted &&
+                    watch->widePathLength + wideLength < VZKR_INTERNAL_FILE_WATCHER_MAX_NAME)
+                {
+                    wchar_t fullPath[VZKR_INTERNAL_FILE_WATCHER_MAX_NAME];
+                    PNSLR_MemCopy(fullPath, watch->widePath, watch->widePathLength * (i32) sizeof(wchar_t));
+                    PNSLR_MemCopy(fullPath + watch->widePathLength, info->FileName, wideLength * (i32) sizeof(wchar_t));
+                    fullPath[watch->widePathLength + wideLength] = L'\0';
+
+                    DWORD attributes = GetFileAttributesW(fullPath);
+                    isDirectory = (attributes != INVALID_FILE_ATTRIBUTES) && (attributes & FILE_ATTRIBUTE_DIRECTORY);
+                }
+
+                if (nameLength > 0) VZKR_Internal_FileWatcherPushChild(watcher, watch, (const u8*) name, nameLength, isDirectory, changes);
+
+                if (!info->NextEntryOffset) break;
+                pos += info->NextEntryOffset;
+            }
+
+            if (!VZKR_Internal_FileWatchIssueRead(watch))
+            {
+                VZKR_Internal_FileWatchClose(watcher, watch);
+                VZKR_Internal_FileWatcherPushWatch(watcher, watch, VZKR_FileChange_Deleted);
+            }
+        }
+    #endif
+}
+
+// File Watcher Functions ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+VZKR_FileWatcher VZKR_CreateFileWatcher(VZKR_FileWatcherCreationOptions options)
+{
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_FileWatcher* watcher = (VZKR_Internal_FileWatcher*) PNSLR_Allocate(options.allocator, true, (i32) sizeof(VZKR_Internal_FileWatcher), (i32) alignof(VZKR_Internal_FileWatcher), PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !watcher) return (VZKR_FileWatcher) {0};
+
+    watcher->allocator = options.allocator;
+
+    #if PNSLR_LINUX
+        watcher->osHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        watcher->buffer   = PNSLR_MakeSlice(u8, VZKR_INTERNAL_FILE_WATCHER_BUFFER_SIZE, false, watcher->allocator, PNSLR_GET_LOC(), &err);
+        b8 success = (watcher->osHandle >= 0) && (err == PNSLR_AllocatorError_None);
+    #elif PNSLR_OSX || PNSLR_IOS
+        watcher->osHandle = kqueue();
+        b8 success = (watcher->osHandle >= 0);
+    #elif PNSLR_WINDOWS
+        b8 success = true;
+    #else
+        b8 success = false;
+    #endif
+
+    if (!success)
+    {
+        VZKR_FileWatcher output = {.handle = watcher};
+        VZKR_DestroyFileWatcher(&output);
+        return (VZKR_FileWatcher) {0};
+    }
+
+    return (VZKR_FileWatcher) {.handle = watcher};
+}
+
+void VZKR_DestroyFileWatcher(VZKR_FileWatcher* watcher)
+{
+    if (!watcher || !watcher->handle) return;
+    VZKR_Internal_FileWatcher* internal = (VZKR_Internal_FileWatcher*) watcher->handle;
+
+    while (internal->numWatches > 0) { VZKR_Internal_FileWatchFree(internal, internal->watches.data[--internal->numWatches]); }
+
+    #if PNSLR_UNIX
+        if (internal->osHandle > 0) close((int) internal->osHandle);
+    #endif
+
+    PNSLR_FreeSlice(&internal->watches, internal->allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&internal->buffer, internal->allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_Free(internal->allocator, internal, PNSLR_GET_LOC(), nil);
+    *watcher = (VZKR_FileWatcher) {0};
+}
+
+static i64 VZKR_Internal_FindFileWatch(VZKR_Internal_FileWatcher* watcher, PNSLR_Path path)
+{
+    for (i64 i = 0; i < watcher->numWatches; i++)
+    {
+        if (PNSLR_AreStringsEqual(watcher->watches.data[i]->path.path, path.path, PNSLR_StringComparisonType_CaseSensitive)) return i;
+    }
+
+    return -1;
+}
+
+b8 VZKR_AddFileWatch(VZKR_FileWatcher watcher, PNSLR_Path path)
+{
+    if (!watcher.handle || path.path.count <= 0) return false;
+    VZKR_Internal_FileWatcher* internal = (VZKR_Internal_FileWatcher*) watcher.handle;
+    if (VZKR_Internal_FindFileWatch(internal, path) >= 0) return true;
+
+    i64 dirLength = path.path.count;
+    while (dirLength > 0 && path.path.data[dirLength - 1] != '/') { dirLength--; }
+    if (dirLength == 0) return false;
+
+    if (internal->numWatches == internal->watches.count)
+    {
+        PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+        i64 newCount = internal->watches.count ? internal->watches.count * 2 : 16;
+        PNSLR_ResizeSlice(VZKR_Internal_FileWatchPtr, &internal->watches, newCount, false, internal->allocator, PNSLR_GET_LOC(), &err);
+        if (err != PNSLR_AllocatorError_None) return false;
+    }
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_FileWatch* watch = (VZKR_Internal_FileWatch*) PNSLR_Allocate(internal->allocator, true, (i32) sizeof(VZKR_Internal_FileWatch), (i32) alignof(VZKR_Internal_FileWatch), PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !watch) return false;
+
+    u8* data = (u8*) PNSLR_Allocate(internal->allocator, false, (i32) path.path.count + 1, 1, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !data) { PNSLR_Free(internal->allocator, watch, PNSLR_GET_LOC(), nil); return false; }
+
+    PNSLR_MemCopy(data, path.path.data, (i32) path.path.count);
+    data[path.path.count] = '\0';
+    watch->path      = (PNSLR_Path) {.path = {.data = data, .count = path.path.count}};
+    watch->dirLength = dirLength;
+    watch->osHandle  = -1;
+
+    #if PNSLR_WINDOWS
+        watch->osHandle = 0;
+    #endif
+
+    if (!VZKR_Internal_FileWatchOpen(internal, watch))
+    {
+        VZKR_Internal_FileWatchFree(internal, watch);
+        return false;
+    }
+
+    internal->watches.data[internal->numWatches++] = watch;
+    return true;
+}
+
+b8 VZKR_RemoveFileWatch(VZKR_FileWatcher watcher, PNSLR_Path path)
+{
+    if (!watcher.handle) return false;
+    VZKR_Internal_FileWatcher* internal = (VZKR_Internal_FileWatcher*) watcher.handle;
+
+    i64 idx = VZKR_Internal_FindFileWatch(internal, path);
+    if (idx < 0) return false;
+
+    // out of the list first, so it's not counted as sharing its own watch descriptor
+    VZKR_Internal_FileWatch* watch = internal->watches.data[idx];
+    internal->watches.data[idx] = internal->watches.data[--internal->numWatches];
+    VZKR_Internal_FileWatchFree(internal, watch);
+    return true;
+}
+
+void VZKR_GatherFileChanges(VZKR_FileWatcher watcher, PNSLR_Allocator tempAllocator)
+{
+    if (!watcher.handle) return;
+    VZKR_Internal_FileWatcher* internal = (VZKR_Internal_FileWatcher*) watcher.handle;
+
+    internal->tempAllocator = tempAllocator;
+    internal->events        = (PNSLR_ArraySlice(VZKR_FileChangeEvent)) {0};
+    internal->numEvents     = 0;
+
+    VZKR_Internal_FileWatcherGatherNative(internal);
+    VZKR_Internal_FileWatcherCoalesce(internal);
+}
+
+PNSLR_ArraySlice(VZKR_FileChangeEvent) VZKR_GetFileChanges(VZKR_FileWatcher watcher)
+{
+    if (!watcher.handle) return (PNSLR_ArraySlice(VZKR_FileChangeEvent)) {0};
+    return ((VZKR_Internal_FileWatcher*) watcher.handle)->events;
+}
+
+b8 VZKR_WaitForFileChanges(VZKR_FileWatcher watcher, i32 timeoutNs)
+{
+    if (!watcher.handle) return false;
+    VZKR_Internal_FileWatcher* internal = (VZKR_Internal_FileWatcher*) watcher.handle;
+
+    #if PNSLR_UNIX
+        // both inotify and kqueue descriptors become readable when there's something queued
+        struct pollfd pfd = {.fd = (int) internal->osHandle, .events = POLLIN};
+        int timeoutMs = (timeoutNs < 0) ? -1 : (int) (((i64) timeoutNs + 999999) / 1000000);
+        int res;
+        do { res = poll(&pfd, 1, timeoutMs); } while (res < 0 && errno == EINTR);
+        return res > 0;
+    #elif PNSLR_WINDOWS
+        HANDLE events[MAXIMUM_WAIT_OBJECTS];
+        DWORD numEvents = 0;
+        for (i64 i = 0; i < internal->numWatches && numEvents < MAXIMUM_WAIT_OBJECTS; i++)
+        {
+            if (internal->watches.data[i]->osHandle) events[numEvents++] = internal->watches.data[i]->overlapped.hEvent;
+        }
+
+        DWORD timeoutMs = (timeoutNs < 0) ? INFINITE : (DWORD) (((i64) timeoutNs + 999999) / 1000000);
+        if (numEvents == 0) return false;
+        return WaitForMultipleObjects(numEvents, events, FALSE, timeoutMs) < WAIT_OBJECT_0 + numEvents;
+    #else
+        return false;
+    #endif
+}
@@ -0,0 +1,125 @@
+#ifndef VZKR_FILE_WATCHER_H // =====================================================
+#define VZKR_FILE_WATCHER_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// File Watcher Declaration ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A cross-platform opaque handle to a file watcher.
+ * Uses inotify on Linux, kqueue on OSX/iOS and ReadDirectoryChangesW on Windows;
+ * the OS queues changes up, so nothing runs between gathers.
+ * Not thread-safe.
+ */
+typedef struct VZKR_FileWatcher
+{
+    rawptr handle;
+} VZKR_FileWatcher;
+
+/**
+ * The kinds of changes reported for a path.
+ * 'Overflow' means the OS dropped changes, and everything watched should be reloaded.
+ */
+typedef u8 VZKR_FileChange /* use as flags */;
+#define VZKR_FileChange_None ((VZKR_FileChange) 0)
+#define VZKR_FileChange_Created ((VZKR_FileChange) 1)
+#define VZKR_FileChange_Modified ((VZKR_FileChange) 2)
+#define VZKR_FileChange_Deleted ((VZKR_FileChange) 4)
+#define VZKR_FileChange_Overflow ((VZKR_FileChange) 8)
+
+/**
+ * All the changes to a single path since the last gather, combined.
+ * Since the flags are combined, a path that was deleted and created again has both set;
+ * check whether it exists if the order matters.
+ * Directory paths end with a trailing slash, as per Panshilar conventions.
+ */
+typedef struct VZKR_FileChangeEvent
+{
+    PNSLR_Path path;
+    VZKR_FileChange changes;
+} VZKR_FileChangeEvent;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_FileChangeEvent);
+
+/**
+ * Options for creating a file watcher.
+ */
+typedef struct VZKR_FileWatcherCreationOptions
+{
+    PNSLR_Allocator allocator;
+} VZKR_FileWatcherCreationOptions;
+
+/**
+ * Creates a file watcher.
+ * If creation failed, the returned handle will be zeroed.
+ */
+VZKR_FileWatcher VZKR_CreateFileWatcher(
+    VZKR_FileWatcherCreationOptions options
+);
+
+/**
+ * Destroys a file watcher, along with all of its watches.
+ */
+void VZKR_DestroyFileWatcher(
+    VZKR_FileWatcher* watcher
+);
+
+// File Watches ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Starts watching a path. Paths ending with a slash are watched as directories, and
+ * report changes to their direct children; anything else is watched as a single file.
+ * File watches survive the file being replaced (as editors do when saving).
+ * On OSX/iOS, directory watches only report the directory itself as modified.
+ * Returns true on success (including if the path was already watched), false on failure.
+ */
+b8 VZKR_AddFileWatch(
+    VZKR_FileWatcher watcher,
+    PNSLR_Path path
+);
+
+/**
+ * Stops watching a path that was previously added.
+ * Returns true on success, false if the path wasn't being watched.
+ */
+b8 VZKR_RemoveFileWatch(
+    VZKR_FileWatcher watcher,
+    PNSLR_Path path
+);
+
+// File Change Events ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Gathers every change since the last call without blocking, combining the changes
+ * to each path into a single event. Meant to be called once per frame.
+ */
+void VZKR_GatherFileChanges(
+    VZKR_FileWatcher watcher,
+    PNSLR_Allocator tempAllocator
+);
+
+/**
+ * Returns a slice of changes that is valid until the next call to VZKR_GatherFileChanges.
+ */
+PNSLR_ArraySlice(VZKR_FileChangeEvent) VZKR_GetFileChanges(
+    VZKR_FileWatcher watcher
+);
+
+/**
+ * Blocks until there are changes to gather, or the timeout expires.
+ * A negative timeout waits indefinitely.
+ * Returns true if there's something to gather, false on timeout.
+ */
+b8 VZKR_WaitForFileChanges(
+    VZKR_FileWatcher watcher,
+    i32 timeoutNs
+);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_FILE_WATCHER_H ======================================================
@@ -0,0 +1,428 @@
+#define VZKR_IMPLEMENTATION
+#include "LockProfiling.h"
+
+// Lock Profiles ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#if VZKR_LOCK_PROFILING
+
+#define VZKR_INTERNAL_LOCK_PROFILE_TABLE_SIZE 256
+
+typedef struct VZKR_Internal_LockProfile
+{
+    struct VZKR_Internal_LockProfile* next; // in the same table slot
+    VZKR_LockProfile recorded;              // location and kind fixed, counters atomic
+} VZKR_Internal_LockProfile;
+
+/** Profiles are created on first use of a location, and live as long as the process. */
+static VZKR_FastMutex             VZKR_Internal_LockProfilesMutex = {0};
+static VZKR_Internal_LockProfile* VZKR_Internal_LockProfiles[VZKR_INTERNAL_LOCK_PROFILE_TABLE_SIZE] = {0};
+static i32                        VZKR_Internal_NumLockProfiles = 0;
+
+static i32 VZKR_Internal_LockProfileHighestBit(u64 mask)
+{
+    #if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long idx; _BitScanReverse64(&idx, mask); return (i32) idx;
+    #else
+        return 63 - __builtin_clzll(mask);
+    #endif
+}
+
+static u32 VZKR_Internal_LockProfileHash(PNSLR_SourceCodeLocation location)
+{
+    // FNV-1a
+    u32 hash = 2166136261u;
+    for (i64 i = 0; i < location.file.count; i++)     { hash = (hash ^ location.file.data[i])     * 16777619u; }
+    for (i64 i = 0; i < location.function.count; i++) { hash = (hash ^ location.function.data[i]) * 16777619u; }
+    hash = (hash ^ (u32) location.line)   * 16777619u;
+    hash = (hash ^ (u32) location.column) * 16777619u;
+    return hash;
+}
+
+static VZKR_Internal_LockProfile* VZKR_Internal_GetLockProfile(PNSLR_SourceCodeLocation location, b8 readWrite)
+{
+    u32 slot = VZKR_Internal_LockProfileHash(location) % VZKR_INTERNAL_LOCK_PROFILE_TABLE_SIZE;
+
+    VZKR_LockFastMutex(&VZKR_Internal_LockProfilesMutex);
+
+    VZKR_Internal_LockProfile* profile = VZKR_Internal_LockProfiles[slot];
+    while (profile)
+    {
+        PNSLR_SourceCodeLocation existing = profile->recorded.location;
+        if (existing.line == location.line && existing.column == location.column && profile->recorded.readWrite == readWrite &&
+            PNSLR_AreStringsEqual(existing.file, location.file, PNSLR_StringComparisonType_CaseSensitive) &&
+            PNSLR_AreStringsEqual(existing.function, location.function, PNSLR_StringComparisonType_CaseSensitive))
+            break;
+
+        profile = profile->next;
+    }
+
+    if (!profile)
+    {
+        PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+        profile = (VZKR_Internal_LockProfile*) PNSLR_Allocate(PNSLR_GetAllocator_DefaultHeap(), true, (i32) sizeof(VZKR_Internal_LockProfile), (i32) alignof(VZKR_Internal_LockProfile), PNSLR_GET_LOC(), &err);
+        if (err == PNSLR_AllocatorError_None && profile)
+        {
+            // locations come from PNSLR_GET_LOC, so the strings are literals
+            profile->recorded.location  = location;
+            profile->recorded.readWrite = readWrite;
+            profile->next               = VZKR_Internal_LockProfiles[slot];
+            VZKR_Internal_LockProfiles[slot] = profile;
+            VZKR_Internal_NumLockProfiles++;
+        }
+        else
+        {
+            profile = nil;
+        }
+    }
+
+    VZKR_UnlockFastMutex(&VZKR_Internal_LockProfilesMutex);
+    return profile;
+}
+
+static i32 VZKR_Internal_LockProfileBucket(i64 durationNs)
+{
+    if (durationNs < 2) return 0;
+
+    i32 bucket = VZKR_Internal_LockProfileHighestBit((u64) durationNs);
+    return bucket < VZKR_LOCK_PROFILE_HISTOGRAM_BUCKETS ? bucket : VZKR_LOCK_PROFILE_HISTOGRAM_BUCKETS - 1;
+}
+
+static void VZKR_Internal_LockProfileMax(i64* max, i64 value)
+{
+    i64 current = VZKR_AtomicLoadI64(max, VZKR_MemoryOrder_Relaxed);
+    while (value > current && !VZKR_AtomicCompareExchangeI64(max, &current, value, VZKR_MemoryOrder_Relaxed)) { }
+}
+
+static void VZKR_Internal_RecordLockAcquire(rawptr profile, b8 contended, u64 waitTicks)
+{
+    if (!profile) return;
+
+    VZKR_LockProfile* recorded = &((VZKR_Internal_LockProfile*) profile)->recorded;
+    VZKR_AtomicFetchAddI64(&recorded->numAcquires, 1, VZKR_MemoryOrder_Relaxed);
+    if (!contended) return;
+
+    i64 waitNs = VZKR_TimestampToNanoseconds(waitTicks);
+    VZKR_AtomicFetchAddI64(&recorded->numContendedAcquires, 1, VZKR_MemoryOrder_Relaxed);
+    VZKR_AtomicFetchAddI64(&recorded->totalWaitNs, waitNs, VZKR_MemoryOrder_Relaxed);
+    VZKR_AtomicFetchAddI64(&recorded->waitHistogram[VZKR_Internal_LockProfileBucket(waitNs)], 1, VZKR_MemoryOrder_Relaxed);
+    VZKR_Internal_LockProfileMax(&recorded->maxWaitNs, waitNs);
+}
+
+static void VZKR_Internal_RecordLockHold(rawptr profile, u64 lockedAt)
+{
+    if (!profile) return;
+
+    VZKR_LockProfile* recorded = &((VZKR_Internal_LockProfile*) profile)->recorded;
+    i64 holdNs = VZKR_TimestampToNanoseconds(VZKR_ReadTimestamp() - lockedAt);
+    VZKR_AtomicFetchAddI64(&recorded->totalHoldNs, holdNs, VZKR_MemoryOrder_Relaxed);
+    VZKR_AtomicFetchAddI64(&recorded->holdHistogram[VZKR_Internal_LockProfileBucket(holdNs)], 1, VZKR_MemoryOrder_Relaxed);
+    VZKR_Internal_LockProfileMax(&recorded->maxHoldNs, holdNs);
+}
+
+#endif
+
+PNSLR_ArraySlice(VZKR_LockProfile) VZKR_GetLockProfiles(PNSLR_Allocator allocator)
+{
+    PNSLR_ArraySlice(VZKR_LockProfile) output = {0};
+
+    #if VZKR_LOCK_PROFILING
+        VZKR_LockFastMutex(&VZKR_Internal_LockProfilesMutex);
+
+        PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+        output = PNSLR_MakeSlice(VZKR_LockProfile, VZKR_Internal_NumLockProfiles, false, allocator, PNSLR_GET_LOC(), &err);
+        if (err != PNSLR_AllocatorError_None) { VZKR_UnlockFastMutex(&VZKR_Internal_LockProfilesMutex); return (PNSLR_ArraySlice(VZKR_LockProfile)) {0}; }
+
+        i64 count = 0;
+        for (i32 slot = 0; slot < VZKR_INTERNAL_LOCK_PROFILE_TABLE_SIZE; slot++)
+        {
+            for (VZKR_Internal_LockProfile* profile = VZKR_Internal_LockProfiles[slot]; profile; profile = profile->next)
+            {
+                VZKR_LockProfile* source = &profile->recorded;
+                VZKR_LockProfile* target = &output.data[count++];
+                target->location             = source->location;
+                target->readWrite            = source->readWrite;
+                target->numAcquires          = VZKR_AtomicLoadI64(&source->numAcquires,          VZKR_MemoryOrder_Relaxed);
+                target->numContendedAcquires = VZKR_AtomicLoadI64(&source->numContendedAcquires, VZKR_MemoryOrder_Relaxed);
+                target->totalWaitNs          = VZKR_AtomicLoadI64(&source->totalWaitNs,          VZKR_MemoryOrder_Relaxed);
+                target->maxWaitNs            = VZKR_AtomicLoadI64(&source->maxWaitNs,            VZKR_MemoryOrder_Relaxed);
+                target->totalHoldNs          = VZKR_AtomicLoadI64(&source->totalHoldNs,          VZKR_MemoryOrder_Relaxed);
+                target->maxHoldNs            = VZKR_AtomicLoadI64(&source->maxHoldNs,            VZKR_MemoryOrder_Relaxed);
+                for (i32 i = 0; i < VZKR_LOCK_PROFILE_HISTOGRAM_BUCKETS; i++)
+                {
+                    target->waitHistogram[i] = VZKR_AtomicLoadI64(&source->waitHistogram[i], VZKR_MemoryOrder_Relaxed);
+                    target->holdHistogram[i] = VZKR_AtomicLoadI64(&source->holdHistogram[i], VZKR_MemoryOrder_Relaxed);
+                }
+            }
+        }
+
+        VZKR_UnlockFastMutex(&VZKR_Internal_LockProfilesMutex);
+
+        // there won't be many
+        for (i64 i = 1; i < output.count; i++)
+        {
+            VZKR_LockProfile profile = output.data[i];
+            i64 j = i;
+            for (; j > 0 && output.data[j - 1].totalWaitNs < profile.totalWaitNs; j--) output.data[j] = output.data[j - 1];
+            output.data[j] = profile;
+        }
+    #else
+        (void) allocator;
+    #endif
+
+    return output;
+}
+
+b8 VZKR_AppendLockProfileReport(
+    PNSLR_StringBuilder* builder,
+    PNSLR_Allocator tempAllocator
+)
+{
+    PNSLR_ArraySlice(VZKR_LockProfile) profiles = VZKR_GetLockProfiles(tempAllocator);
+
+    b8 success = true;
+    for (i64 i = 0; i < profiles.count && success; i++)
+    {
+        VZKR_LockProfile* profile = &profiles.data[i];
+        if (!profile->numAcquires) continue;
+
+        success = PNSLR_FormatAndAppendToStringBuilder(builder, PNSLR_StringLiteral("$:$ ($)$: $ acquires, $ contended; waited $ns in total, $ns at most; held $ns in total, $ns at most\n"), PNSLR_FmtArgs(
+            PNSLR_FmtString(profile->location.file),
+            PNSLR_FmtI32(profile->location.line, PNSLR_IntegerBase_Decimal),
+            PNSLR_FmtString(profile->location.function),
+            PNSLR_FmtString(profile->readWrite ? PNSLR_StringLiteral(" [read-write]") : PNSLR_StringLiteral("")),
+            PNSLR_FmtI64(profile->numAcquires, PNSLR_IntegerBase_Decimal),
+            PNSLR_FmtI64(profile->numContendedAcquires, PNSLR_IntegerBase_Decimal),
+            PNSLR_FmtI64(profile->totalWaitNs, PNSLR_IntegerBase_Decimal),
+            PNSLR_FmtI64(profile->maxWaitNs, PNSLR_IntegerBase_Decimal),
+            PNSLR_FmtI64(profile->totalHoldNs, PNSLR_IntegerBase_Decimal),
+            PNSLR_FmtI64(profile->maxHoldNs, PNSLR_IntegerBase_Decimal)
+        ));
+
+        for (i32 bucket = 0; bucket < VZKR_LOCK_PROFILE_HISTOGRAM_BUCKETS && success; bucket++)
+        {
+            if (!profile->waitHistogram[bucket]) continue;
+            success = PNSLR_FormatAndAppendToStringBuilder(builder, PNSLR_StringLiteral("    waited $ns+: $\n"), PNSLR_FmtArgs(
+                PNSLR_FmtI64(bucket ? (i64) 1 << bucket : 0, PNSLR_IntegerBase_Decimal),
+                PNSLR_FmtI64(profile->waitHistogram[bucket], PNSLR_IntegerBase_Decimal)
+            ));
+        }
+
+        for (i32 bucket = 0; bucket < VZKR_LOCK_PROFILE_HISTOGRAM_BUCKETS && success; bucket++)
+        {
+            if (!profile->holdHistogram[bucket]) continue;
+            success = PNSLR_FormatAndAppendToStringBuilder(builder, PNSLR_StringLiteral("    held $ns+: $\n"), PNSLR_FmtArgs(
+                PNSLR_FmtI64(bucket ? (i64) 1 << bucket : 0, PNSLR_IntegerBase_Decimal),
+                PNSLR_FmtI64(profile->holdHistogram[bucket], PNSLR_IntegerBase_Decimal)
+            ));
+        }
+    }
+
+    PNSLR_FreeSlice(&profiles, tempAllocator, PNSLR_GET_LOC(), nil);
+    return success;
+}
+
+void VZKR_ResetLockProfiles(void)
+{
+    #if VZKR_LOCK_PROFILING
+        VZKR_LockFastMutex(&VZKR_Internal_LockProfilesMutex);
+
+        for (i32 slot = 0; slot < VZKR_INTERNAL_LOCK_PROFILE_TABLE_SIZE; slot++)
+        {
+            for (VZKR_Internal_LockProfile* profile = VZKR_Internal_LockProfiles[slot]; profile; profile = profile->next)
+            {
+                VZKR_LockProfile* recorded = &profile->recorded;
+                VZKR_AtomicStoreI64(&recorded->numAcquires,          0, VZKR_MemoryOrder_Relaxed);
+                VZKR_AtomicStoreI64(&recorded->numContendedAcquires, 0, VZKR_MemoryOrder_Relaxed);
+                VZKR_AtomicStoreI64(&recorded->totalWaitNs,          0, VZKR_MemoryOrder_Relaxed);
+                VZKR_AtomicStoreI64(&recorded->maxWaitNs,            0, VZKR_MemoryOrder_Relaxed);
+                VZKR_AtomicStoreI64(&recorded->totalHoldNs,          0, VZKR_MemoryOrder_Relaxed);
+                VZKR_AtomicStoreI64(&recorded->maxHoldNs,            0, VZKR_MemoryOrder_Relaxed);
+                for (i32 i = 0; i < VZKR_LOCK_PROFILE_HISTOGRAM_BUCKETS; i++)
+                {
+                    VZKR_AtomicStoreI64(&recorded->waitHistogram[i], 0, VZKR_MemoryOrder_Relaxed);
+                    VZKR_AtomicStoreI64(&recorded->holdHistogram[i], 0, VZKR_MemoryOrder_Relaxed);
+                }
+            }
+        }
+
+        VZKR_UnlockFastMutex(&VZKR_Internal_LockProfilesMutex);
+    #endif
+}
+
+// Profiled Mutex ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+VZKR_ProfiledMutex VZKR_CreateProfiledMutex(PNSLR_SourceCodeLocation location)
+{
+    VZKR_ProfiledMutex output = {.mutex = PNSLR_CreateMutex()};
+    #if VZKR_LOCK_PROFILING
+        output.profile = (rawptr) VZKR_Internal_GetLockProfile(location, false);
+    #else
+        (void) location;
+    #endif
+    return output;
+}
+
+void VZKR_DestroyProfiledMutex(VZKR_ProfiledMutex* mutex)
+{
+    PNSLR_DestroyMutex(&mutex->mutex);
+}
+
+void VZKR_LockProfiledMutex(VZKR_ProfiledMutex* mutex)
+{
+    #if VZKR_LOCK_PROFILING
+        // trying first tells whether anyone else had it, without timing the common case
+        if (PNSLR_TryLockMutex(&mutex->mutex))
+        {
+            VZKR_Internal_RecordLockAcquire(mutex->profile, false, 0);
+        }
+        else
+        {
+            u64 start = VZKR_ReadTimestamp();
+            PNSLR_LockMutex(&mutex->mutex);
+            VZKR_Internal_RecordLockAcquire(mutex->profile, true, VZKR_ReadTimestamp() - start);
+        }
+
+        mutex->lockedAt = VZKR_ReadTimestamp();
+    #else
+        PNSLR_LockMutex(&mutex->mutex);
+    #endif
+}
+
+void VZKR_UnlockProfiledMutex(VZKR_ProfiledMutex* mutex)
+{
+    #if VZKR_LOCK_PROFILING
+        VZKR_Internal_RecordLockHold(mutex->profile, mutex->lockedAt);
+    #endif
+    PNSLR_UnlockMutex(&mutex->mutex);
+}
+
+b8 VZKR_TryLockProfiledMutex(VZKR_ProfiledMutex* mutex)
+{
+    if (!PNSLR_TryLockMutex(&mutex->mutex)) return false;
+
+    #if VZKR_LOCK_PROFILING
+        VZKR_Internal_RecordLockAcquire(mutex->profile, false, 0);
+        mutex->lockedAt = VZKR_ReadTimestamp();
+    #endif
+    return true;
+}
+
+void VZKR_WaitProfiledConditionVariable(
+    PNSLR_ConditionVariable* condvar,
+    VZKR_ProfiledMutex* mutex
+)
+{
+    #if VZKR_LOCK_PROFILING
+        VZKR_Internal_RecordLockHold(mutex->profile, mutex->lockedAt);
+    #endif
+    PNSLR_WaitConditionVariable(condvar, &mutex->mutex);
+    #if VZKR_LOCK_PROFILING
+        mutex->lockedAt = VZKR_ReadTimestamp();
+    #endif
+}
+
+b8 VZKR_WaitProfiledConditionVariableTimeout(
+    PNSLR_ConditionVariable* condvar,
+    VZKR_ProfiledMutex* mutex,
+    i32 timeoutNs
+)
+{
+    #if VZKR_LOCK_PROFILING
+        VZKR_Internal_RecordLockHold(mutex->profile, mutex->lockedAt);
+    #endif
+    b8 signaled = PNSLR_WaitConditionVariableTimeout(condvar, &mutex->mutex, timeoutNs);
+    #if VZKR_LOCK_PROFILING
+        mutex->lockedAt = VZKR_ReadTimestamp();
+    #endif
+    return signaled;
+}
+
+// Profiled Read-Write Mutex ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+VZKR_ProfiledRWMutex VZKR_CreateProfiledRWMutex(PNSLR_SourceCodeLocation location)
+{
+    VZKR_ProfiledRWMutex output = {.rwmutex = PNSLR_CreateRWMutex()};
+    #if VZKR_LOCK_PROFILING
+        output.profile = (rawptr) VZKR_Internal_GetLockProfile(location, true);
+    #else
+        (void) location;
+    #endif
+    return output;
+}
+
+void VZKR_DestroyProfiledRWMutex(VZKR_ProfiledRWMutex* rwmutex)
+{
+    PNSLR_DestroyRWMutex(&rwmutex->rwmutex);
+}
+
+void VZKR_LockProfiledRWMutexShared(VZKR_ProfiledRWMutex* rwmutex)
+{
+    #if VZKR_LOCK_PROFILING
+        if (PNSLR_TryLockRWMutexShared(&rwmutex->rwmutex))
+        {
+            VZKR_Internal_RecordLockAcquire(rwmutex->profile, false, 0);
+        }
+        else
+        {
+            u64 start = VZKR_ReadTimestamp();
+            PNSLR_LockRWMutexShared(&rwmutex->rwmutex);
+            VZKR_Internal_RecordLockAcquire(rwmutex->profile, true, VZKR_ReadTimestamp() - start);
+        }
+    #else
+        PNSLR_LockRWMutexShared(&rwmutex->rwmutex);
+    #endif
+}
+
+void VZKR_LockProfiledRWMutexExclusive(VZKR_ProfiledRWMutex* rwmutex)
+{
+    #if VZKR_LOCK_PROFILING
+        if (PNSLR_TryLockRWMutexExclusive(&rwmutex->rwmutex))
+        {
+            VZKR_Internal_RecordLockAcquire(rwmutex->profile, false, 0);
+        }
+        else
+        {
+            u64 start = VZKR_ReadTimestamp();
+            PNSLR_LockRWMutexExclusive(&rwmutex->rwmutex);
+            VZKR_Internal_RecordLockAcquire(rwmutex->profile, true, VZKR_ReadTimestamp() - start);
+        }
+
+        rwmutex->lockedAt = VZKR_ReadTimestamp();
+    #else
+        PNSLR_LockRWMutexExclusive(&rwmutex->rwmutex);
+    #endif
+}
+
+void VZKR_UnlockProfiledRWMutexShared(VZKR_ProfiledRWMutex* rwmutex)
+{
+    PNSLR_UnlockRWMutexShared(&rwmutex->rwmutex);
+}
+
+void VZKR_UnlockProfiledRWMutexExclusive(VZKR_ProfiledRWMutex* rwmutex)
+{
+    #if VZKR_LOCK_PROFILING
+        VZKR_Internal_RecordLockHold(rwmutex->profile, rwmutex->lockedAt);
+    #endif
+    PNSLR_UnlockRWMutexExclusive(&rwmutex->rwmutex);
+}
+
+b8 VZKR_TryLockProfiledRWMutexShared(VZKR_ProfiledRWMutex* rwmutex)
+{
+    if (!PNSLR_TryLockRWMutexShared(&rwmutex->rwmutex)) return false;
+
+    #if VZKR_LOCK_PROFILING
+        VZKR_Internal_RecordLockAcquire(rwmutex->profile, false, 0);
+    #endif
+    return true;
+}
+
+b8 VZKR_TryLockProfiledRWMutexExclusive(VZKR_ProfiledRWMutex* rwmutex)
+{
+    if (!PNSLR_TryLockRWMutexExclusive(&rwmutex->rwmutex)) return false;
+
+    #if VZKR_LOCK_PROFILING
+        VZKR_Internal_RecordLockAcquire(rwmutex->profile, false, 0);
+        rwmutex->lockedAt = VZKR_ReadTimestamp();
+    #endif
+    return true;
+}
@@ -0,0 +1,221 @@
+#ifndef VZKR_LOCK_PROFILING_H // ===================================================
+#define VZKR_LOCK_PROFILING_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Define as 1 (before including anything) to record how contended every profiled mutex
+ * is. Otherwise, profiled mutexes are exactly Panshilar's, and every function below just
+ * forwards to its counterpart (reports are all empty).
+ */
+#ifndef VZKR_LOCK_PROFILING
+    #define VZKR_LOCK_PROFILING 0
+#endif
+
+// Profiled Mutex ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A 'PNSLR_Mutex' whose acquires (how long they waited, and whether they had to), and how
+ * long it stays locked, get recorded along with those of every other one created at the
+ * same place in the code, if lock profiling is enabled.
+ */
+typedef struct VZKR_ProfiledMutex
+{
+    PNSLR_Mutex mutex;
+    #if VZKR_LOCK_PROFILING
+        rawptr profile;
+        u64 lockedAt;
+    #endif
+} VZKR_ProfiledMutex;
+
+/**
+ * Creates a profiled mutex, whose recordings are kept under the location it's created at
+ * (pass 'PNSLR_GET_LOC()').
+ */
+VZKR_ProfiledMutex VZKR_CreateProfiledMutex(
+    PNSLR_SourceCodeLocation location
+);
+
+/**
+ * Destroys a profiled mutex. Its recordings are kept.
+ */
+void VZKR_DestroyProfiledMutex(
+    VZKR_ProfiledMutex* mutex
+);
+
+/**
+ * Locks a profiled mutex.
+ */
+void VZKR_LockProfiledMutex(
+    VZKR_ProfiledMutex* mutex
+);
+
+/**
+ * Unlocks a profiled mutex.
+ */
+void VZKR_UnlockProfiledMutex(
+    VZKR_ProfiledMutex* mutex
+);
+
+/**
+ * Tries to lock a profiled mutex. Failed tries aren't recorded.
+ * Returns true if the mutex was successfully locked, false otherwise.
+ */
+b8 VZKR_TryLockProfiledMutex(
+    VZKR_ProfiledMutex* mutex
+);
+
+/**
+ * Waits on a condition variable, with a locked profiled mutex.
+ * The time spent waiting doesn't count as the mutex being held.
+ */
+void VZKR_WaitProfiledConditionVariable(
+    PNSLR_ConditionVariable* condvar,
+    VZKR_ProfiledMutex* mutex
+);
+
+/**
+ * Waits on a condition variable with a timeout, with a locked profiled mutex.
+ * The time spent waiting doesn't count as the mutex being held.
+ * Returns true if the condition variable was signaled, false if the timeout expired.
+ */
+b8 VZKR_WaitProfiledConditionVariableTimeout(
+    PNSLR_ConditionVariable* condvar,
+    VZKR_ProfiledMutex* mutex,
+    i32 timeoutNs
+);
+
+// Profiled Read-Write Mutex ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A 'PNSLR_RWMutex' that gets recorded like a profiled mutex. Only exclusive holds count
+ * towards how long it stays locked, since shared ones overlap.
+ */
+typedef struct VZKR_ProfiledRWMutex
+{
+    PNSLR_RWMutex rwmutex;
+    #if VZKR_LOCK_PROFILING
+        rawptr profile;
+        u64 lockedAt;
+    #endif
+} VZKR_ProfiledRWMutex;
+
+/**
+ * Creates a profiled read-write mutex, whose recordings are kept under the location it's
+ * created at (pass 'PNSLR_GET_LOC()').
+ */
+VZKR_ProfiledRWMutex VZKR_CreateProfiledRWMutex(
+    PNSLR_SourceCodeLocation location
+);
+
+/**
+ * Destroys a profiled read-write mutex. Its recordings are kept.
+ */
+void VZKR_DestroyProfiledRWMutex(
+    VZKR_ProfiledRWMutex* rwmutex
+);
+
+/**
+ * Locks a profiled read-write mutex for reading.
+ */
+void VZKR_LockProfiledRWMutexShared(
+    VZKR_ProfiledRWMutex* rwmutex
+);
+
+/**
+ * Locks a profiled read-write mutex for writing.
+ */
+void VZKR_LockProfiledRWMutexExclusive(
+    VZKR_ProfiledRWMutex* rwmutex
+);
+
+/**
+ * Unlocks a profiled read-write mutex locked for reading.
+ */
+void VZKR_UnlockProfiledRWMutexShared(
+    VZKR_ProfiledRWMutex* rwmutex
+);
+
+/**
+ * Unlocks a profiled read-write mutex locked for writing.
+ */
+void VZKR_UnlockProfiledRWMutexExclusive(
+    VZKR_ProfiledRWMutex* rwmutex
+);
+
+/**
+ * Tries to lock a profiled read-write mutex for reading. Failed tries aren't recorded.
+ * Returns true if the mutex was successfully locked, false otherwise.
+ */
+b8 VZKR_TryLockProfiledRWMutexShared(
+    VZKR_ProfiledRWMutex* rwmutex
+);
+
+/**
+ * Tries to lock a profiled read-write mutex for writing. Failed tries aren't recorded.
+ * Returns true if the mutex was successfully locked, false otherwise.
+ */
+b8 VZKR_TryLockProfiledRWMutexExclusive(
+    VZKR_ProfiledRWMutex* rwmutex
+);
+
+// Lock Profiles ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * The number of buckets in a lock profile's histograms. Bucket 'i' counts durations of at
+ * least 2^i nanoseconds but under 2^(i+1) (the first one also counts anything shorter,
+ * and the last one anything longer, i.e. from about a second).
+ */
+#define VZKR_LOCK_PROFILE_HISTOGRAM_BUCKETS 31
+
+/**
+ * Everything recorded for the profiled mutexes created at one location.
+ * Waits are only timed for contended acquires (when the mutex was already locked).
+ */
+typedef struct VZKR_LockProfile
+{
+    PNSLR_SourceCodeLocation location;
+    b8 readWrite;
+    i64 numAcquires;
+    i64 numContendedAcquires;
+    i64 totalWaitNs;
+    i64 maxWaitNs;
+    i64 totalHoldNs;
+    i64 maxHoldNs;
+    i64 waitHistogram[VZKR_LOCK_PROFILE_HISTOGRAM_BUCKETS];
+    i64 holdHistogram[VZKR_LOCK_PROFILE_HISTOGRAM_BUCKETS];
+} VZKR_LockProfile;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_LockProfile);
+
+/**
+ * Gets a snapshot of every lock profile, most contended (by total wait time) first.
+ * The slice is empty if lock profiling is disabled, or allocating failed.
+ */
+PNSLR_ArraySlice(VZKR_LockProfile) VZKR_GetLockProfiles(
+    PNSLR_Allocator allocator
+);
+
+/**
+ * Appends a readable report of every lock profile that has been acquired, histograms
+ * included, most contended first.
+ * Returns false if appending failed.
+ */
+b8 VZKR_AppendLockProfileReport(
+    PNSLR_StringBuilder* builder,
+    PNSLR_Allocator tempAllocator
+);
+
+/**
+ * Clears every lock profile's recordings (without forgetting any locations).
+ */
+void VZKR_ResetLockProfiles(void);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_LOCK_PROFILING_H ====================================================
@@ -0,0 +1,380 @@
+#define VZKR_IMPLEMENTATION
+#include "Parallel.h"
+
+// Shared Internals ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_PARALLEL_MIN_GRAIN         1024
+#define VZKR_INTERNAL_PARALLEL_CHUNKS_PER_THREAD 4
+#define VZKR_INTERNAL_PARALLEL_MAX_COPY          (1 << 30) // bytes per PNSLR_MemCopy
+
+/** What every chunk does during one pass over the slice. */
+typedef u8 VZKR_Internal_ParallelPass /* use as value */;
+#define VZKR_Internal_ParallelPass_For       ((VZKR_Internal_ParallelPass) 0)
+#define VZKR_Internal_ParallelPass_Transform ((VZKR_Internal_ParallelPass) 1)
+#define VZKR_Internal_ParallelPass_Fold      ((VZKR_Internal_ParallelPass) 2)
+#define VZKR_Internal_ParallelPass_Scan      ((VZKR_Internal_ParallelPass) 3)
+#define VZKR_Internal_ParallelPass_Flag      ((VZKR_Internal_ParallelPass) 4)
+#define VZKR_Internal_ParallelPass_Scatter   ((VZKR_Internal_ParallelPass) 5)
+#define VZKR_Internal_ParallelPass_CopyBack  ((VZKR_Internal_ParallelPass) 6)
+
+/**
+ * Lives on the calling thread's stack for the duration of an algorithm; every thread
+ * helping out claims chunks off 'nextChunk', which is kept away from the rest.
+ * Chunk 'i' covers elements [i * grainSize, min((i + 1) * grainSize, count)).
+ */
+typedef struct VZKR_Internal_Parallel
+{
+    i64 nextChunk;
+    VZKR_CACHE_LINE_PADDING(nextChunkPadding, 8);
+    VZKR_Internal_ParallelPass pass;
+    i64 count;
+    i64 grainSize;
+    i64 numChunks;
+    u8* input;
+    i32 inputSize;
+    u8* output;
+    i32 outputSize;
+    u8* accumulators; // one per chunk, 'accumulatorStride' apart
+    i64 accumulatorStride;
+    i32 accumulatorSize;
+    rawptr identity;
+    u8* flags;        // whether the predicate accepted each element
+    i64* offsets;     // accepted elements per chunk, then the number before each chunk
+    i64 numAccepted;
+    VZKR_ParallelForProcedure forProcedure;
+    VZKR_ParallelTransformProcedure transformProcedure;
+    VZKR_ParallelFoldProcedure fold;
+    VZKR_ParallelScanProcedure scan;
+    VZKR_ParallelPredicate predicate;
+    rawptr userData;
+} VZKR_Internal_Parallel;
+
+static void VZKR_Internal_ParallelCopy(u8* dst, u8* src, i64 numBytes)
+{
+    while (numBytes > 0)
+    {
+        i32 n = numBytes > VZKR_INTERNAL_PARALLEL_MAX_COPY ? VZKR_INTERNAL_PARALLEL_MAX_COPY : (i32) numBytes;
+        PNSLR_MemCopy(dst, src, n);
+        dst += n; src += n; numBytes -= n;
+    }
+}
+
+/** Picks the grain size and number of chunks; a single chunk means running serially. */
+static void VZKR_Internal_ParallelSetup(VZKR_Internal_Parallel* parallel, VZKR_JobSystem jobs, i64 count, i64 grainSize)
+{
+    i64 numThreads = jobs.handle ? VZKR_GetJobSystemNumThreads(jobs) : 1;
+    if (grainSize <= 0)
+    {
+        grainSize = count / (numThreads * VZKR_INTERNAL_PARALLEL_CHUNKS_PER_THREAD);
+        if (grainSize < VZKR_INTERNAL_PARALLEL_MIN_GRAIN) grainSize = VZKR_INTERNAL_PARALLEL_MIN_GRAIN;
+    }
+
+    if (numThreads <= 1 || grainSize > count) grainSize = count;
+
+    parallel->count     = count;
+    parallel->grainSize = grainSize;
+    parallel->numChunks = grainSize > 0 ? (count + grainSize - 1) / grainSize : 0;
+}
+
+static void VZKR_Internal_ParallelRunChunk(VZKR_Internal_Parallel* parallel, i64 chunk)
+{
+    i64 start = chunk * parallel->grainSize;
+    i64 count = parallel->count - start < parallel->grainSize ? parallel->count - start : parallel->grainSize;
+    u8* input = parallel->input + start * parallel->inputSize;
+    u8* accumulator = parallel->accumulators + chunk * parallel->accumulatorStride;
+
+    switch (parallel->pass)
+    {
+        case VZKR_Internal_ParallelPass_For:
+            parallel->forProcedure(parallel->userData, input, start, count);
+            break;
+        case VZKR_Internal_ParallelPass_Transform:
+            parallel->transformProcedure(parallel->userData, input, parallel->output + start * parallel->outputSize, count);
+            break;
+        case VZKR_Internal_ParallelPass_Fold:
+            PNSLR_MemCopy(accumulator, parallel->identity, parallel->accumulatorSize);
+            parallel->fold(parallel->userData, input, count, accumulator);
+            break;
+        case VZKR_Internal_ParallelPass_Scan:
+            parallel->scan(parallel->userData, input, parallel->output + start * parallel->outputSize, count, accumulator);
+            break;
+        case VZKR_Internal_ParallelPass_Flag:
+        {
+            i64 numAccepted = 0;
+            for (i64 i = 0; i < count; i++)
+            {
+                b8 accepted = parallel->predicate(parallel->userData, input + i * parallel->inputSize) ? 1 : 0;
+                parallel->flags[start + i] = accepted;
+                numAccepted += accepted;
+            }
+
+            parallel->offsets[chunk] = numAccepted;
+            break;
+        }
+        case VZKR_Internal_ParallelPass_Scatter:
+        {
+            // accepted elements go after the ones accepted in earlier chunks, the rest after
+            // every accepted element and the ones rejected in earlier chunks
+            i64 front = parallel->offsets[chunk];
+            i64 back  = parallel->numAccepted + start - front;
+            for (i64 i = 0; i < count; i++)
+            {
+                i64 index = parallel->flags[start + i] ? front++ : back++;
+                PNSLR_MemCopy(parallel->output + index * parallel->inputSize, input + i * parallel->inputSize, parallel->inputSize);
+            }
+            break;
+        }
+        case VZKR_Internal_ParallelPass_CopyBack:
+            VZKR_Internal_ParallelCopy(input, parallel->output + start * parallel->inputSize, count * parallel->inputSize);
+            break;
+        default:
+            break;
+    }
+}
+
+static void VZKR_Internal_ParallelWork(rawptr userData)
+{
+    VZKR_Internal_Parallel* parallel = (VZKR_Internal_Parallel*) userData;
+    for (;;)
+    {
+        i64 chunk = VZKR_AtomicFetchAddI64(&parallel->nextChunk, 1, VZKR_MemoryOrder_Relaxed);
+        if (chunk >= parallel->numChunks) break;
+        VZKR_Internal_ParallelRunChunk(parallel, chunk);
+    }
+}
+
+/** Runs a pass over every chunk, with up to one helper job per other thread, and waits for it. */
+static void VZKR_Internal_ParallelRun(VZKR_Internal_Parallel* parallel, VZKR_JobSystem jobs, VZKR_Internal_ParallelPass pass)
+{
+    parallel->pass      = pass;
+    parallel->nextChunk = 0;
+
+    i64 numHelpers = parallel->numChunks > 1 ? VZKR_GetJobSystemNumThreads(jobs) - 1 : 0;
+    if (numHelpers > parallel->numChunks - 1) numHelpers = parallel->numChunks - 1;
+    if (numHelpers <= 0) { VZKR_Internal_ParallelWork(parallel); return; }
+
+    VZKR_JobCounter counter = {0};
+    for (i64 i = 0; i < numHelpers; i++)
+    {
+        VZKR_RunJob(jobs, (VZKR_JobDecl) {.procedure = VZKR_Internal_ParallelWork, .userData = parallel}, &counter);
+    }
+
+    // helpers that only get to run once every chunk is claimed return straight away
+    VZKR_Internal_ParallelWork(parallel);
+    VZKR_WaitForJobs(jobs, &counter);
+}
+
+/** Allocates one accumulator per chunk (plus any extra ones), each on its own cache line. */
+static b8 VZKR_Internal_ParallelAllocateAccumulators(VZKR_Internal_Parallel* parallel, i64 numExtra, PNSLR_Allocator allocator, PNSLR_RawArraySlice* memory)
+{
+    parallel->accumulatorStride = ((i64) parallel->accumulatorSize + VZKR_CACHE_LINE_SIZE - 1) & ~((i64) VZKR_CACHE_LINE_SIZE - 1);
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    *memory = PNSLR_MakeRawSlice(1, VZKR_CACHE_LINE_SIZE, parallel->accumulatorStride * (parallel->numChunks + numExtra), false, allocator, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !memory->data) return false;
+
+    parallel->accumulators = (u8*) memory->data;
+    return true;
+}
+
+// Parallel Algorithms ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+void VZKR_ParallelForRaw(
+    VZKR_JobSystem jobs,
+    PNSLR_RawArraySlice slice,
+    i32 elementSize,
+    i64 grainSize,
+    VZKR_ParallelForProcedure procedure,
+    rawptr userData
+)
+{
+    if (!procedure || elementSize <= 0 || slice.count <= 0) return;
+
+    VZKR_Internal_Parallel parallel = {0};
+    VZKR_Internal_ParallelSetup(&parallel, jobs, slice.count, grainSize);
+    parallel.input        = (u8*) slice.data;
+    parallel.inputSize    = elementSize;
+    parallel.forProcedure = procedure;
+    parallel.userData     = userData;
+    VZKR_Internal_ParallelRun(&parallel, jobs, VZKR_Internal_ParallelPass_For);
+}
+
+b8 VZKR_ParallelTransformRaw(
+    VZKR_JobSystem jobs,
+    PNSLR_RawArraySlice input,
+    i32 inputElementSize,
+    PNSLR_RawArraySlice output,
+    i32 outputElementSize,
+    i64 grainSize,
+    VZKR_ParallelTransformProcedure procedure,
+    rawptr userData
+)
+{
+    if (!procedure || inputElementSize <= 0 || outputElementSize <= 0 || output.count < input.count) return false;
+    if (input.count <= 0) return true;
+
+    VZKR_Internal_Parallel parallel = {0};
+    VZKR_Internal_ParallelSetup(&parallel, jobs, input.count, grainSize);
+    parallel.input              = (u8*) input.data;
+    parallel.inputSize          = inputElementSize;
+    parallel.output             = (u8*) output.data;
+    parallel.outputSize         = outputElementSize;
+    parallel.transformProcedure = procedure;
+    parallel.userData           = userData;
+    VZKR_Internal_ParallelRun(&parallel, jobs, VZKR_Internal_ParallelPass_Transform);
+    return true;
+}
+
+b8 VZKR_ParallelReduceRaw(
+    VZKR_JobSystem jobs,
+    PNSLR_RawArraySlice slice,
+    i32 elementSize,
+    i64 grainSize,
+    rawptr identity,
+    rawptr result,
+    i32 resultSize,
+    VZKR_ParallelFoldProcedure fold,
+    VZKR_ParallelCombineProcedure combine,
+    rawptr userData,
+    PNSLR_Allocator allocator
+)
+{
+    if (!fold || !combine || !identity || !result || elementSize <= 0 || resultSize <= 0) return false;
+
+    VZKR_Internal_Parallel parallel = {0};
+    VZKR_Internal_ParallelSetup(&parallel, jobs, slice.count > 0 ? slice.count : 0, grainSize);
+
+    // a single chunk folds straight into the result
+    if (parallel.numChunks <= 1)
+    {
+        if (result != identity) PNSLR_MemCopy(result, identity, resultSize);
+        if (parallel.numChunks) fold(userData, slice.data, slice.count, result);
+        return true;
+    }
+
+    parallel.input           = (u8*) slice.data;
+    parallel.inputSize       = elementSize;
+    parallel.accumulatorSize = resultSize;
+    parallel.identity        = identity;
+    parallel.fold            = fold;
+    parallel.userData        = userData;
+
+    PNSLR_RawArraySlice memory = {0};
+    if (!VZKR_Internal_ParallelAllocateAccumulators(&parallel, 0, allocator, &memory)) return false;
+
+    VZKR_Internal_ParallelRun(&parallel, jobs, VZKR_Internal_ParallelPass_Fold);
+
+    PNSLR_MemCopy(result, parallel.accumulators, resultSize);
+    for (i64 i = 1; i < parallel.numChunks; i++)
+    {
+        combine(userData, result, parallel.accumulators + i * parallel.accumulatorStride);
+    }
+
+    PNSLR_FreeRawSlice(&memory, allocator, PNSLR_GET_LOC(), nil);
+    return true;
+}
+
+b8 VZKR_ParallelScanRaw(
+    VZKR_JobSystem jobs,
+    PNSLR_RawArraySlice input,
+    i32 inputElementSize,
+    PNSLR_RawArraySlice output,
+    i32 outputElementSize,
+    i64 grainSize,
+    rawptr identity,
+    i32 accumulatorSize,
+    VZKR_ParallelFoldProcedure fold,
+    VZKR_ParallelCombineProcedure combine,
+    VZKR_ParallelScanProcedure scan,
+    rawptr userData,
+    PNSLR_Allocator allocator
+)
+{
+    if (!fold || !combine || !scan || !identity || inputElementSize <= 0 || outputElementSize <= 0 || accumulatorSize <= 0) return false;
+    if (output.count < input.count) return false;
+    if (input.count <= 0) return true;
+
+    VZKR_Internal_Parallel parallel = {0};
+    VZKR_Internal_ParallelSetup(&parallel, jobs, input.count, grainSize);
+    parallel.input           = (u8*) input.data;
+    parallel.inputSize       = inputElementSize;
+    parallel.output          = (u8*) output.data;
+    parallel.outputSize      = outputElementSize;
+    parallel.accumulatorSize = accumulatorSize;
+    parallel.identity        = identity;
+    parallel.fold            = fold;
+    parallel.scan            = scan;
+    parallel.userData        = userData;
+
+    // two extra accumulators for the running prefix, and the one being replaced
+    PNSLR_RawArraySlice memory = {0};
+    if (!VZKR_Internal_ParallelAllocateAccumulators(&parallel, 2, allocator, &memory)) return false;
+
+    u8* running  = parallel.accumulators + parallel.numChunks * parallel.accumulatorStride;
+    u8* previous = running + parallel.accumulatorStride;
+
+    if (parallel.numChunks > 1) VZKR_Internal_ParallelRun(&parallel, jobs, VZKR_Internal_ParallelPass_Fold);
+
+    // turn every chunk's total into the total of everything before it
+    PNSLR_MemCopy(running, identity, accumulatorSize);
+    for (i64 i = 0; i < parallel.numChunks; i++)
+    {
+        u8* accumulator = parallel.accumulators + i * parallel.accumulatorStride;
+        PNSLR_MemCopy(previous, running, accumulatorSize);
+        if (i + 1 < parallel.numChunks) combine(userData, running, accumulator);
+        PNSLR_MemCopy(accumulator, previous, accumulatorSize);
+    }
+
+    VZKR_Internal_ParallelRun(&parallel, jobs, VZKR_Internal_ParallelPass_Scan);
+
+    PNSLR_FreeRawSlice(&memory, allocator, PNSLR_GET_LOC(), nil);
+    return true;
+}
+
+i64 VZKR_ParallelPartitionRaw(
+    VZKR_JobSystem jobs,
+    PNSLR_RawArraySlice slice,
+    i32 elementSize,
+    i64 grainSize,
+    VZKR_ParallelPredicate predicate,
+    rawptr userData,
+    PNSLR_Allocator allocator
+)
+{
+    if (!predicate || elementSize <= 0) return -1;
+    if (slice.count <= 0) return 0;
+
+    VZKR_Internal_Parallel parallel = {0};
+    VZKR_Internal_ParallelSetup(&parallel, jobs, slice.count, grainSize);
+    parallel.input     = (u8*) slice.data;
+    parallel.inputSize = elementSize;
+    parallel.predicate = predicate;
+    parallel.userData  = userData;
+
+    // the copy the elements get scattered into, the per-chunk offsets, and the flags
+    i64 copySize    = (slice.count * elementSize + 7) & ~7LL;
+    i64 offsetsSize = parallel.numChunks * (i64) sizeof(i64);
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    PNSLR_RawArraySlice memory = PNSLR_MakeRawSlice(1, VZKR_CACHE_LINE_SIZE, copySize + offsetsSize + slice.count, false, allocator, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !memory.data) return -1;
+
+    parallel.output  = (u8*) memory.data;
+    parallel.offsets = (i64*) (parallel.output + copySize);
+    parallel.flags   = parallel.output + copySize + offsetsSize;
+
+    VZKR_Internal_ParallelRun(&parallel, jobs, VZKR_Internal_ParallelPass_Flag);
+
+    for (i64 i = 0; i < parallel.numChunks; i++)
+    {
+        i64 numAccepted = parallel.offsets[i];
+        parallel.offsets[i] = parallel.numAccepted;
+        parallel.numAccepted += numAccepted;
+    }
+
+    VZKR_Internal_ParallelRun(&parallel, jobs, VZKR_Internal_ParallelPass_Scatter);
+    VZKR_Internal_ParallelRun(&parallel, jobs, VZKR_Internal_ParallelPass_CopyBack);
+
+    PNSLR_FreeRawSlice(&memory, allocator, PNSLR_GET_LOC(), nil);
+    return parallel.numAccepted;
+}
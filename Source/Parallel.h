@@ -0,0 +1,306 @@
+#ifndef VZKR_PARALLEL_H // =========================================================
+#define VZKR_PARALLEL_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Parallel Algorithms ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Every algorithm here splits a slice into chunks of 'grainSize' elements, and has the
+ * threads of a job system (the calling one included) take chunks until there are none
+ * left, returning once all of them are done.
+ * A non-positive grain size picks one that gives each thread a few chunks, but never
+ * fewer than 1024 elements per chunk. Inputs that fit in a single chunk, or job systems
+ * with a single thread (or a zeroed handle), run serially on the calling thread.
+ *
+ * They can be called from any thread, including from inside other jobs.
+ * The procedures passed in are called concurrently, once per chunk, with the chunks in no
+ * particular order; reductions and scans still combine them left to right, so the
+ * operation only needs to be associative, not commutative.
+ */
+
+/**
+ * Processes a chunk of a slice in place: 'count' elements starting at 'elements', which
+ * is element 'startIndex' of the whole slice.
+ */
+typedef void (*VZKR_ParallelForProcedure)(
+    rawptr userData,
+    rawptr elements,
+    i64 startIndex,
+    i64 count
+);
+
+/**
+ * Reads 'count' elements from 'input', writing as many to 'output'.
+ */
+typedef void (*VZKR_ParallelTransformProcedure)(
+    rawptr userData,
+    rawptr input,
+    rawptr output,
+    i64 count
+);
+
+/**
+ * Folds 'count' elements into an accumulator (which starts as a copy of the identity).
+ */
+typedef void (*VZKR_ParallelFoldProcedure)(
+    rawptr userData,
+    rawptr elements,
+    i64 count,
+    rawptr accumulator
+);
+
+/**
+ * Folds one accumulator into another: accumulator = accumulator (op) other.
+ * 'other' always covers elements after the ones already in 'accumulator'.
+ */
+typedef void (*VZKR_ParallelCombineProcedure)(
+    rawptr userData,
+    rawptr accumulator,
+    rawptr other
+);
+
+/**
+ * Scans 'count' elements from 'input' into 'output', starting from an accumulator that
+ * already holds everything before them. Whether each output includes its own input
+ * (inclusive) or not (exclusive) is up to the procedure.
+ */
+typedef void (*VZKR_ParallelScanProcedure)(
+    rawptr userData,
+    rawptr input,
+    rawptr output,
+    i64 count,
+    rawptr accumulator
+);
+
+/**
+ * Tells whether an element belongs in the front of a partitioned slice.
+ */
+typedef b8 (*VZKR_ParallelPredicate)(
+    rawptr userData,
+    rawptr element
+);
+
+/**
+ * Runs a procedure over every element of a slice, a chunk at a time.
+ */
+void VZKR_ParallelForRaw(
+    VZKR_JobSystem jobs,
+    PNSLR_RawArraySlice slice,
+    i32 elementSize,
+    i64 grainSize,
+    VZKR_ParallelForProcedure procedure,
+    rawptr userData
+);
+
+/**
+ * Maps every element of one slice to the element at the same index of another.
+ * Returns false (doing nothing) if the output is shorter than the input.
+ */
+b8 VZKR_ParallelTransformRaw(
+    VZKR_JobSystem jobs,
+    PNSLR_RawArraySlice input,
+    i32 inputElementSize,
+    PNSLR_RawArraySlice output,
+    i32 outputElementSize,
+    i64 grainSize,
+    VZKR_ParallelTransformProcedure procedure,
+    rawptr userData
+);
+
+/**
+ * Reduces a slice to a single value: every chunk is folded into its own copy of the
+ * identity, and those are then combined in order into 'result' (which gets overwritten).
+ * The per-chunk accumulators are allocated with the given allocator.
+ * Returns false if allocating failed.
+ */
+b8 VZKR_ParallelReduceRaw(
+    VZKR_JobSystem jobs,
+    PNSLR_RawArraySlice slice,
+    i32 elementSize,
+    i64 grainSize,
+    rawptr identity,
+    rawptr result,
+    i32 resultSize,
+    VZKR_ParallelFoldProcedure fold,
+    VZKR_ParallelCombineProcedure combine,
+    rawptr userData,
+    PNSLR_Allocator allocator
+);
+
+/**
+ * Computes a prefix scan of one slice into another (which can be the same one) in two
+ * passes: every chunk is folded into its own accumulator, those are combined into the
+ * prefix each chunk starts from, and then every chunk is scanned from its prefix.
+ * The per-chunk accumulators are allocated with the given allocator.
+ * Returns false if the output is shorter than the input, or allocating failed.
+ */
+b8 VZKR_ParallelScanRaw(
+    VZKR_JobSystem jobs,
+    PNSLR_RawArraySlice input,
+    i32 inputElementSize,
+    PNSLR_RawArraySlice output,
+    i32 outputElementSize,
+    i64 grainSize,
+    rawptr identity,
+    i32 accumulatorSize,
+    VZKR_ParallelFoldProcedure fold,
+    VZKR_ParallelCombineProcedure combine,
+    VZKR_ParallelScanProcedure scan,
+    rawptr userData,
+    PNSLR_Allocator allocator
+);
+
+/**
+ * Reorders a slice so that every element the predicate accepts comes before every one it
+ * doesn't, keeping their relative order on both sides.
+ * The predicate runs exactly once per element.
+ * A copy of the slice is allocated with the given allocator while it works.
+ * Returns the number of elements accepted, or -1 if allocating failed.
+ */
+i64 VZKR_ParallelPartitionRaw(
+    VZKR_JobSystem jobs,
+    PNSLR_RawArraySlice slice,
+    i32 elementSize,
+    i64 grainSize,
+    VZKR_ParallelPredicate predicate,
+    rawptr userData,
+    PNSLR_Allocator allocator
+);
+
+// Typed Parallel Algorithms ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/** Same as the raw versions, over typed array slices (with the element sizes filled in). */
+#define VZKR_ParallelFor(jobs, slice, grainSize, procedure, userData) \
+    VZKR_ParallelForRaw(jobs, (slice).raw, (i32) sizeof(*(slice).data), grainSize, procedure, userData)
+#define VZKR_ParallelTransform(jobs, input, output, grainSize, procedure, userData) \
+    VZKR_ParallelTransformRaw(jobs, (input).raw, (i32) sizeof(*(input).data), (output).raw, (i32) sizeof(*(output).data), grainSize, procedure, userData)
+#define VZKR_ParallelReduce(jobs, slice, grainSize, identityPtr, resultPtr, fold, combine, userData, allocator) \
+    VZKR_ParallelReduceRaw(jobs, (slice).raw, (i32) sizeof(*(slice).data), grainSize, identityPtr, (1 ? (resultPtr) : (identityPtr)), (i32) sizeof(*(resultPtr)), fold, combine, userData, allocator)
+#define VZKR_ParallelScan(jobs, input, output, grainSize, identityPtr, fold, combine, scan, userData, allocator) \
+    VZKR_ParallelScanRaw(jobs, (input).raw, (i32) sizeof(*(input).data), (output).raw, (i32) sizeof(*(output).data), grainSize, identityPtr, (i32) sizeof(*(identityPtr)), fold, combine, scan, userData, allocator)
+#define VZKR_ParallelPartition(jobs, slice, grainSize, predicate, userData, allocator) \
+    VZKR_ParallelPartitionRaw(jobs, (slice).raw, (i32) sizeof(*(slice).data), grainSize, predicate, userData, allocator)
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#ifdef __cplusplus
+namespace Vizkaar
+{
+    // the same algorithms over anything with 'data' and 'count' (both PNSLR_ArraySlice(T)
+    // and ArraySlice<T>), taking callables that work one element at a time
+
+    /** Calls 'fn(element, index)' for every element. */
+    template <typename S, typename F> void ParallelFor(VZKR_JobSystem jobs, S slice, i64 grainSize, const F& fn)
+    {
+        struct Helper
+        {
+            static void For(rawptr userData, rawptr elements, i64 startIndex, i64 count)
+            {
+                const F& fn   = *(const F*) userData;
+                auto*    data = (decltype(S::data)) elements;
+                for (i64 i = 0; i < count; i++) fn(data[i], startIndex + i);
+            }
+        };
+
+        PNSLR_RawArraySlice raw = {(rawptr) slice.data, slice.count};
+        VZKR_ParallelForRaw(jobs, raw, (i32) sizeof(*slice.data), grainSize, Helper::For, (rawptr) &fn);
+    }
+
+    /** Sets 'output[i] = fn(input[i])' for every element. */
+    template <typename S, typename D, typename F> b8 ParallelTransform(VZKR_JobSystem jobs, S input, D output, i64 grainSize, const F& fn)
+    {
+        struct Helper
+        {
+            static void Transform(rawptr userData, rawptr in, rawptr out, i64 count)
+            {
+                const F& fn = *(const F*) userData;
+                auto* src = (decltype(S::data)) in;
+                auto* dst = (decltype(D::data)) out;
+                for (i64 i = 0; i < count; i++) dst[i] = fn(src[i]);
+            }
+        };
+
+        PNSLR_RawArraySlice rawInput = {(rawptr) input.data, input.count}, rawOutput = {(rawptr) output.data, output.count};
+        return VZKR_ParallelTransformRaw(jobs, rawInput, (i32) sizeof(*input.data), rawOutput, (i32) sizeof(*output.data), grainSize, Helper::Transform, (rawptr) &fn);
+    }
+
+    /** Folds every element into 'identity' with 'fold(accumulator, element)', joining chunks with 'combine(a, b)'. */
+    template <typename S, typename A, typename F, typename C> A ParallelReduce(VZKR_JobSystem jobs, S slice, i64 grainSize, A identity, const F& fold, const C& combine, PNSLR_Allocator allocator)
+    {
+        struct Helper
+        {
+            const F* fold; const C* combine;
+
+            static void Fold(rawptr userData, rawptr elements, i64 count, rawptr accumulator)
+            {
+                auto* data = (decltype(S::data)) elements;
+                A&    acc  = *(A*) accumulator;
+                for (i64 i = 0; i < count; i++) acc = (*((Helper*) userData)->fold)(acc, data[i]);
+            }
+
+            static void Combine(rawptr userData, rawptr accumulator, rawptr other)
+            {
+                *(A*) accumulator = (*((Helper*) userData)->combine)(*(A*) accumulator, *(A*) other);
+            }
+        };
+
+        Helper helper = {&fold, &combine};
+        A result = identity;
+        PNSLR_RawArraySlice raw = {(rawptr) slice.data, slice.count};
+        VZKR_ParallelReduceRaw(jobs, raw, (i32) sizeof(*slice.data), grainSize, &identity, &result, (i32) sizeof(A), Helper::Fold, Helper::Combine, &helper, allocator);
+        return result;
+    }
+
+    /** Sets 'output[i] = op(output[i - 1], input[i])', starting from 'identity'. */
+    template <typename S, typename D, typename A, typename O> b8 ParallelInclusiveScan(VZKR_JobSystem jobs, S input, D output, i64 grainSize, A identity, const O& op, PNSLR_Allocator allocator)
+    {
+        struct Helper
+        {
+            static void Fold(rawptr userData, rawptr elements, i64 count, rawptr accumulator)
+            {
+                const O& op   = *(const O*) userData;
+                auto*    data = (decltype(S::data)) elements;
+                A&       acc  = *(A*) accumulator;
+                for (i64 i = 0; i < count; i++) acc = op(acc, data[i]);
+            }
+
+            static void Combine(rawptr userData, rawptr accumulator, rawptr other)
+            {
+                *(A*) accumulator = (*(const O*) userData)(*(A*) accumulator, *(A*) other);
+            }
+
+            static void Scan(rawptr userData, rawptr in, rawptr out, i64 count, rawptr accumulator)
+            {
+                const O& op  = *(const O*) userData;
+                auto*    src = (decltype(S::data)) in;
+                auto*    dst = (decltype(D::data)) out;
+                A        acc = *(A*) accumulator;
+                for (i64 i = 0; i < count; i++) { acc = op(acc, src[i]); dst[i] = acc; }
+            }
+        };
+
+        PNSLR_RawArraySlice rawInput = {(rawptr) input.data, input.count}, rawOutput = {(rawptr) output.data, output.count};
+        return VZKR_ParallelScanRaw(jobs, rawInput, (i32) sizeof(*input.data), rawOutput, (i32) sizeof(*output.data), grainSize, &identity, (i32) sizeof(A), Helper::Fold, Helper::Combine, Helper::Scan, (rawptr) &op, allocator);
+    }
+
+    /** Moves every element 'predicate(element)' accepts to the front, stably; returns how many there are (-1 on failure). */
+    template <typename S, typename P> i64 ParallelPartition(VZKR_JobSystem jobs, S slice, i64 grainSize, const P& predicate, PNSLR_Allocator allocator)
+    {
+        struct Helper
+        {
+            static b8 Predicate(rawptr userData, rawptr element) { return (*(const P*) userData)(*(decltype(S::data)) element) ? true : false; }
+        };
+
+        PNSLR_RawArraySlice raw = {(rawptr) slice.data, slice.count};
+        return VZKR_ParallelPartitionRaw(jobs, raw, (i32) sizeof(*slice.data), grainSize, Helper::Predicate, (rawptr) &predicate, allocator);
+    }
+}
+#endif
+
+#endif // VZKR_PARALLEL_H ==========================================================
@@ -0,0 +1,1152 @@
+#define VZKR_IMPLEMENTATION
+#include "PatternMatch.h"
+
+// NFA Construction ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_PATTERN_NFA_RANGE   0
+#define VZKR_INTERNAL_PATTERN_NFA_SPLIT   1
+#define VZKR_INTERNAL_PATTERN_NFA_EPSILON 2
+#define VZKR_INTERNAL_PATTERN_NFA_MATCH   3
+
+#define VZKR_INTERNAL_PATTERN_MAX_NFA_STATES  65536
+#define VZKR_INTERNAL_PATTERN_MAX_REPEAT      1000
+#define VZKR_INTERNAL_PATTERN_MAX_DFA_STATES  2048
+#define VZKR_INTERNAL_PATTERN_MAX_LITERAL     64
+
+/**
+ * A partially built piece of the NFA (Thompson construction).
+ * 'outs' is the head of a list of unpatched out-slots, encoded as (state * 2 + slot).
+ * While unpatched, a slot holds the encoded next entry of the list as -(next + 2),
+ * so -1 terminates the list.
+ */
+typedef struct VZKR_Internal_PatternFrag
+{
+    i32 start;
+    i32 outs;
+} VZKR_Internal_PatternFrag;
+
+typedef struct VZKR_Internal_PatternParser
+{
+    VZKR_Pattern* pattern;
+    utf8str src;
+    i64 pos;
+    i32 depth;
+    b8 failed;
+    b8 caseInsensitive;
+    b8 topLevelAlternation;
+    b8 prefixClosed;
+    i32 prefixLen;
+    i32 suffixLen;
+    u8 prefix[VZKR_INTERNAL_PATTERN_MAX_LITERAL];
+    u8 suffix[VZKR_INTERNAL_PATTERN_MAX_LITERAL];
+} VZKR_Internal_PatternParser;
+
+static i32 VZKR_Internal_PatternAddState(VZKR_Internal_PatternParser* p, u8 kind, u8 lo, u8 hi, i32 out, i32 out1)
+{
+    if (p->failed) return 0;
+
+    VZKR_Pattern* pat = p->pattern;
+    if (pat->numNfaStates >= VZKR_INTERNAL_PATTERN_MAX_NFA_STATES) { p->failed = true; return 0; }
+
+    if (pat->numNfaStates >= pat->nfa.count)
+    {
+        PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+        i64 newCount = pat->nfa.count ? pat->nfa.count * 2 : 64;
+        PNSLR_ResizeSlice(VZKR_PatternNfaState, &pat->nfa, newCount, false, pat->allocator, PNSLR_GET_LOC(), &err);
+        if (err != PNSLR_AllocatorError_None) { p->failed = true; return 0; }
+    }
+
+    i32 idx = pat->numNfaStates++;
+    pat->nfa.data[idx] = (VZKR_PatternNfaState) {.kind = kind, .lo = lo, .hi = hi, .out = out, .out1 = out1};
+    return idx;
+}
+
+static i32* VZKR_Internal_PatternSlot(VZKR_Internal_PatternParser* p, i32 ref)
+{
+    VZKR_PatternNfaState* st = &p->pattern->nfa.data[ref >> 1];
+    return (ref & 1) ? &st->out1 : &st->out;
+}
+
+static void VZKR_Internal_PatternPatch(VZKR_Internal_PatternParser* p, i32 list, i32 target)
+{
+    if (p->failed) return;
+    while (list != -1)
+    {
+        i32* slot = VZKR_Internal_PatternSlot(p, list);
+        list  = -(*slot) - 2;
+        *slot = target;
+    }
+}
+
+static i32 VZKR_Internal_PatternAppend(VZKR_Internal_PatternParser* p, i32 l1, i32 l2)
+{
+    if (p->failed || l1 == -1) return l2;
+    i32 last = l1;
+    while (true)
+    {
+        i32 next = -(*VZKR_Internal_PatternSlot(p, last)) - 2;
+        if (next == -1) break;
+        last = next;
+    }
+
+    *VZKR_Internal_PatternSlot(p, last) = -(l2 + 2);
+    return l1;
+}
+
+static VZKR_Internal_PatternFrag VZKR_Internal_PatternByteRange(VZKR_Internal_PatternParser* p, u8 lo, u8 hi)
+{
+    i32 s = VZKR_Internal_PatternAddState(p, VZKR_INTERNAL_PATTERN_NFA_RANGE, lo, hi, -1, -1);
+    return (VZKR_Internal_PatternFrag) {.start = s, .outs = s * 2};
+}
+
+static VZKR_Internal_PatternFrag VZKR_Internal_PatternEmpty(VZKR_Internal_PatternParser* p)
+{
+    i32 s = VZKR_Internal_PatternAddState(p, VZKR_INTERNAL_PATTERN_NFA_EPSILON, 0, 0, -1, -1);
+    return (VZKR_Internal_PatternFrag) {.start = s, .outs = s * 2};
+}
+
+static VZKR_Internal_PatternFrag VZKR_Internal_PatternConcat(VZKR_Internal_PatternParser* p, VZKR_Internal_PatternFrag a, VZKR_Internal_PatternFrag b)
+{
+    VZKR_Internal_PatternPatch(p, a.outs, b.start);
+    return (VZKR_Internal_PatternFrag) {.start = a.start, .outs = b.outs};
+}
+
+static VZKR_Internal_PatternFrag VZKR_Internal_PatternAlt(VZKR_Internal_PatternParser* p, VZKR_Internal_PatternFrag a, VZKR_Internal_PatternFrag b)
+{
+    i32 s = VZKR_Internal_PatternAddState(p, VZKR_INTERNAL_PATTERN_NFA_SPLIT, 0, 0, a.start, b.start);
+    return (VZKR_Internal_PatternFrag) {.start = s, .outs = VZKR_Internal_PatternAppend(p, a.outs, b.outs)};
+}
+
+static VZKR_Internal_PatternFrag VZKR_Internal_PatternStar(VZKR_Internal_PatternParser* p, VZKR_Internal_PatternFrag a)
+{
+    i32 s = VZKR_Internal_PatternAddState(p, VZKR_INTERNAL_PATTERN_NFA_SPLIT, 0, 0, a.start, -1);
+    VZKR_Internal_PatternPatch(p, a.outs, s);
+    return (VZKR_Internal_PatternFrag) {.start = s, .outs = s * 2 + 1};
+}
+
+static VZKR_Internal_PatternFrag VZKR_Internal_PatternPlus(VZKR_Internal_PatternParser* p, VZKR_Internal_PatternFrag a)
+{
+    i32 s = VZKR_Internal_PatternAddState(p, VZKR_INTERNAL_PATTERN_NFA_SPLIT, 0, 0, a.start, -1);
+    VZKR_Internal_PatternPatch(p, a.outs, s);
+    return (VZKR_Internal_PatternFrag) {.start = a.start, .outs = s * 2 + 1};
+}
+
+static VZKR_Internal_PatternFrag VZKR_Internal_PatternQuest(VZKR_Internal_PatternParser* p, VZKR_Internal_PatternFrag a)
+{
+    i32 s = VZKR_Internal_PatternAddState(p, VZKR_INTERNAL_PATTERN_NFA_SPLIT, 0, 0, a.start, -1);
+    return (VZKR_Internal_PatternFrag) {.start = s, .outs = VZKR_Internal_PatternAppend(p, a.outs, s * 2 + 1)};
+}
+
+/** Any well-formed multi-byte UTF-8 sequence. */
+static VZKR_Internal_PatternFrag VZKR_Internal_PatternAnyMultiByte(VZKR_Internal_PatternParser* p)
+{
+    VZKR_Internal_PatternFrag two = VZKR_Internal_PatternByteRange(p, 0xC2, 0xDF);
+    two = VZKR_Internal_PatternConcat(p, two, VZKR_Internal_PatternByteRange(p, 0x80, 0xBF));
+
+    VZKR_Internal_PatternFrag three = VZKR_Internal_PatternByteRange(p, 0xE0, 0xEF);
+    three = VZKR_Internal_PatternConcat(p, three, VZKR_Internal_PatternByteRange(p, 0x80, 0xBF));
+    three = VZKR_Internal_PatternConcat(p, three, VZKR_Internal_PatternByteRange(p, 0x80, 0xBF));
+
+    VZKR_Internal_PatternFrag four = VZKR_Internal_PatternByteRange(p, 0xF0, 0xF4);
+    four = VZKR_Internal_PatternConcat(p, four, VZKR_Internal_PatternByteRange(p, 0x80, 0xBF));
+    four = VZKR_Internal_PatternConcat(p, four, VZKR_Internal_PatternByteRange(p, 0x80, 0xBF));
+    four = VZKR_Internal_PatternConcat(p, four, VZKR_Internal_PatternByteRange(p, 0x80, 0xBF));
+
+    return VZKR_Internal_PatternAlt(p, two, VZKR_Internal_PatternAlt(p, three, four));
+}
+
+// Character Sets ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * An ASCII bitmap, plus either every multi-byte character or a list of specific ones.
+ */
+typedef struct VZKR_Internal_PatternCharSet
+{
+    u8 ascii[16];
+    b8 allMultiByte;
+    b8 hasExtra;
+    VZKR_Internal_PatternFrag extra;
+} VZKR_Internal_PatternCharSet;
+
+static void VZKR_Internal_PatternSetAsciiRange(VZKR_Internal_PatternCharSet* set, u8 lo, u8 hi)
+{
+    for (i32 c = lo; c <= hi && c < 128; c++) { set->ascii[c >> 3] |= (u8) (1 << (c & 7)); }
+}
+
+static b8 VZKR_Internal_PatternHasAscii(const VZKR_Internal_PatternCharSet* set, i32 c)
+{
+    return (set->ascii[c >> 3] >> (c & 7)) & 1;
+}
+
+/** Adds one of the `\d \w \s` shorthands (or their negation) to a set. */
+static b8 VZKR_Internal_PatternAddShorthand(VZKR_Internal_PatternCharSet* set, u8 c)
+{
+    VZKR_Internal_PatternCharSet tmp = {0};
+    switch (c)
+    {
+        case 'd': case 'D': VZKR_Internal_PatternSetAsciiRange(&tmp, '0', '9'); break;
+        case 's': case 'S': VZKR_Internal_PatternSetAsciiRange(&tmp, '\t', '\r'); VZKR_Internal_PatternSetAsciiRange(&tmp, ' ', ' '); break;
+        case 'w': case 'W':
+            VZKR_Internal_PatternSetAsciiRange(&tmp, '0', '9');
+            VZKR_Internal_PatternSetAsciiRange(&tmp, 'A', 'Z');
+            VZKR_Internal_PatternSetAsciiRange(&tmp, 'a', 'z');
+            VZKR_Internal_PatternSetAsciiRange(&tmp, '_', '_');
+            break;
+        default: return false;
+    }
+
+    b8 negated = (c == 'D' || c == 'S' || c == 'W');
+    for (i32 i = 0; i < 16; i++) { set->ascii[i] |= negated ? (u8) ~tmp.ascii[i] : tmp.ascii[i]; }
+    if (negated) set->allMultiByte = true;
+    return true;
+}
+
+static VZKR_Internal_PatternFrag VZKR_Internal_PatternFromCharSet(VZKR_Internal_PatternParser* p, VZKR_Internal_PatternCharSet* set)
+{
+    if (p->caseInsensitive)
+    {
+        for (i32 c = 'a'; c <= 'z'; c++)
+        {
+            if (VZKR_Internal_PatternHasAscii(set, c) || VZKR_Internal_PatternHasAscii(set, c - 'a' + 'A'))
+            {
+                VZKR_Internal_PatternSetAsciiRange(set, (u8) c, (u8) c);
+                VZKR_Internal_PatternSetAsciiRange(set, (u8) (c - 'a' + 'A'), (u8) (c - 'a' + 'A'));
+            }
+        }
+    }
+
+    b8 any = false;
+    VZKR_Internal_PatternFrag result = {0};
+    for (i32 c = 0; c < 128;)
+    {
+        if (!VZKR_Internal_PatternHasAscii(set, c)) { c++; continue; }
+        i32 end = c;
+        while (end + 1 < 128 && VZKR_Internal_PatternHasAscii(set, end + 1)) { end++; }
+
+        VZKR_Internal_PatternFrag range = VZKR_Internal_PatternByteRange(p, (u8) c, (u8) end);
+        result = any ? VZKR_Internal_PatternAlt(p, result, range) : range;
+        any    = true;
+        c      = end + 1;
+    }
+
+    if (set->allMultiByte || set->hasExtra)
+    {
+        VZKR_Internal_PatternFrag mb = set->allMultiByte ? VZKR_Internal_PatternAnyMultiByte(p) : set->extra;
+        result = any ? VZKR_Internal_PatternAlt(p, result, mb) : mb;
+        any    = true;
+    }
+
+    // an empty set can never match, a reversed range does exactly that
+    if (!any) result = VZKR_Internal_PatternByteRange(p, 1, 0);
+    return result;
+}
+
+// Parsing Helpers ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+static i32 VZKR_Internal_PatternUtf8Length(u8 lead)
+{
+    if (lead < 0x80) return 1;
+    if (lead >= 0xC2 && lead <= 0xDF) return 2;
+    if (lead >= 0xE0 && lead <= 0xEF) return 3;
+    if (lead >= 0xF0 && lead <= 0xF4) return 4;
+    return 0;
+}
+
+/** Reads one (possibly multi-byte) character from the source, into 'bytes'. */
+static i32 VZKR_Internal_PatternReadChar(VZKR_Internal_PatternParser* p, u8 bytes[4])
+{
+    if (p->pos >= p->src.count) { p->failed = true; return 0; }
+    i32 len = VZKR_Internal_PatternUtf8Length(p->src.data[p->pos]);
+    if (len == 0 || p->pos + len > p->src.count) { p->failed = true; return 0; }
+    for (i32 i = 0; i < len; i++)
+    {
+        bytes[i] = p->src.data[p->pos + i];
+        if (i > 0 && (bytes[i] & 0xC0) != 0x80) { p->failed = true; return 0; }
+    }
+
+    p->pos += len;
+    return len;
+}
+
+/** A literal character; ASCII letters match either case if the pattern is case-insensitive. */
+static VZKR_Internal_PatternFrag VZKR_Internal_PatternLiteral(VZKR_Internal_PatternParser* p, const u8* bytes, i32 len)
+{
+    if (len == 1 && p->caseInsensitive)
+    {
+        u8 c = bytes[0];
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+        {
+            VZKR_Internal_PatternCharSet set = {0};
+            VZKR_Internal_PatternSetAsciiRange(&set, c, c);
+            return VZKR_Internal_PatternFromCharSet(p, &set);
+        }
+    }
+
+    VZKR_Internal_PatternFrag f = VZKR_Internal_PatternByteRange(p, bytes[0], bytes[0]);
+    for (i32 i = 1; i < len; i++) { f = VZKR_Internal_PatternConcat(p, f, VZKR_Internal_PatternByteRange(p, bytes[i], bytes[i])); }
+    return f;
+}
+
+/** Records what the top level of the pattern looks like, for the literal prefilters. */
+static void VZKR_Internal_PatternNoteTopLevel(VZKR_Internal_PatternParser* p, const u8* bytes, i32 len)
+{
+    if (p->depth != 0) return;
+
+    if (!bytes || p->caseInsensitive)
+    {
+        p->prefixClosed = true;
+        p->suffixLen    = 0;
+        return;
+    }
+
+    for (i32 i = 0; i < len; i++)
+    {
+        if (!p->prefixClosed)
+        {
+            if (p->prefixLen < VZKR_INTERNAL_PATTERN_MAX_LITERAL) p->prefix[p->prefixLen++] = bytes[i];
+            else                                                   p->prefixClosed = true;
+        }
+
+        if (p->suffixLen == VZKR_INTERNAL_PATTERN_MAX_LITERAL)
+        {
+            for (i32 j = 1; j < p->suffixLen; j++) { p->suffix[j - 1] = p->suffix[j]; }
+            p->suffixLen--;
+        }
+
+        p->suffix[p->suffixLen++] = bytes[i];
+    }
+}
+
+/** Parses the inside of a `[...]` class, with the opening bracket already consumed. */
+static VZKR_Internal_PatternFrag VZKR_Internal_PatternParseClass(VZKR_Internal_PatternParser* p, b8 glob)
+{
+    VZKR_Internal_PatternCharSet set = {0};
+    b8 negated = false;
+    if (p->pos < p->src.count && (p->src.data[p->pos] == '^' || (glob && p->src.data[p->pos] == '!')))
+    {
+        negated = true;
+        p->pos++;
+    }
+
+    b8 first = true;
+    while (!p->failed)
+    {
+        if (p->pos >= p->src.count) { p->failed = true; break; }
+
+        u8 c = p->src.data[p->pos];
+        if (c == ']' && !first) { p->pos++; break; }
+        first = false;
+
+        u8 lo[4] = {0};
+        i32 loLen = 0;
+        if (c == '\\' && p->pos + 1 < p->src.count)
+        {
+            u8 e = p->src.data[p->pos + 1];
+            if (!glob && VZKR_Internal_PatternAddShorthand(&set, e)) { p->pos += 2; continue; }
+
+            p->pos++;
+            switch (e)
+            {
+                case 'n': lo[0] = '\n'; loLen = 1; p->pos++; break;
+                case 'r': lo[0] = '\r'; loLen = 1; p->pos++; break;
+                case 't': lo[0] = '\t'; loLen = 1; p->pos++; break;
+                default:  loLen = VZKR_Internal_PatternReadChar(p, lo); break;
+            }
+        }
+        else
+        {
+            loLen = VZKR_Internal_PatternReadChar(p, lo);
+        }
+
+        if (p->failed) break;
+
+        // a range, unless the dash is the last thing in the class
+        if (loLen == 1 && p->pos + 1 < p->src.count && p->src.data[p->pos] == '-' && p->src.data[p->pos + 1] != ']')
+        {
+            p->pos++;
+            u8 hi[4] = {0};
+            if (p->src.data[p->pos] == '\\') p->pos++;
+            i32 hiLen = VZKR_Internal_PatternReadChar(p, hi);
+            if (p->failed || hiLen != 1 || hi[0] >= 0x80 || hi[0] < lo[0]) { p->failed = true; break; }
+
+            VZKR_Internal_PatternSetAsciiRange(&set, lo[0], hi[0]);
+            continue;
+        }
+
+        if (loLen == 1 && lo[0] < 0x80)
+        {
+            VZKR_Internal_PatternSetAsciiRange(&set, lo[0], lo[0]);
+            continue;
+        }
+
+        // specific multi-byte characters are only supported in positive classes
+        if (negated) { p->failed = true; break; }
+
+        VZKR_Internal_PatternFrag mb = VZKR_Internal_PatternLiteral(p, lo, loLen);
+        set.extra    = set.hasExtra ? VZKR_Internal_PatternAlt(p, set.extra, mb) : mb;
+        set.hasExtra = true;
+    }
+
+    if (p->failed) return (VZKR_Internal_PatternFrag) {0};
+
+    if (negated)
+    {
+        if (set.allMultiByte) { p->failed = true; return (VZKR_Internal_PatternFrag) {0}; }
+
+        if (p->caseInsensitive)
+        {
+            // fold before negating, otherwise [^a] would still match 'A'
+            for (i32 c = 'a'; c <= 'z'; c++)
+            {
+                if (VZKR_Internal_PatternHasAscii(&set, c) || VZKR_Internal_PatternHasAscii(&set, c - 'a' + 'A'))
+                {
+                    VZKR_Internal_PatternSetAsciiRange(&set, (u8) c, (u8) c);
+                    VZKR_Internal_PatternSetAsciiRange(&set, (u8) (c - 'a' + 'A'), (u8) (c - 'a' + 'A'));
+                }
+            }
+        }
+
+        for (i32 i = 0; i < 16; i++) { set.ascii[i] = (u8) ~set.ascii[i]; }
+        if (glob) set.ascii['/' >> 3] &= (u8) ~(1 << ('/' & 7));
+        set.allMultiByte = true;
+    }
+
+    return VZKR_Internal_PatternFromCharSet(p, &set);
+}
+
+// Regex Parsing ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+static VZKR_Internal_PatternFrag VZKR_Internal_ParseRegexAlternation(VZKR_Internal_PatternParser* p);
+
+static VZKR_Internal_PatternFrag VZKR_Internal_ParseRegexAtom(VZKR_Internal_PatternParser* p, u8 lit[4], i32* litLen)
+{
+    *litLen = 0;
+    u8 c = p->src.data[p->pos];
+    switch (c)
+    {
+        case '(':
+        {
+            p->pos++;
+            if (p->pos + 1 < p->src.count && p->src.data[p->pos] == '?' && p->src.data[p->pos + 1] == ':') p->pos += 2;
+
+            p->depth++;
+            VZKR_Internal_PatternFrag f = VZKR_Internal_ParseRegexAlternation(p);
+            p->depth--;
+
+            if (p->pos >= p->src.count || p->src.data[p->pos] != ')') { p->failed = true; return f; }
+            p->pos++;
+            return f;
+        }
+        case '.':
+        {
+            p->pos++;
+            VZKR_Internal_PatternCharSet set = {0};
+            VZKR_Internal_PatternSetAsciiRange(&set, 0, 127);
+            set.ascii['\n' >> 3] &= (u8) ~(1 << ('\n' & 7));
+            set.allMultiByte = true;
+            return VZKR_Internal_PatternFromCharSet(p, &set);
+        }
+        case '[':
+        {
+            p->pos++;
+            return VZKR_Internal_PatternParseClass(p, false);
+        }
+        case '^':
+        {
+            if (p->pos != 0) { p->failed = true; return (VZKR_Internal_PatternFrag) {0}; }
+            p->pos++;
+            p->pattern->anchoredStart = true;
+            *litLen = -1;
+            return VZKR_Internal_PatternEmpty(p);
+        }
+        case '$':
+        {
+            if (p->pos != p->src.count - 1 || p->depth != 0) { p->failed = true; return (VZKR_Internal_PatternFrag) {0}; }
+            p->pos++;
+            p->pattern->anchoredEnd = true;
+            *litLen = -1;
+            return VZKR_Internal_PatternEmpty(p);
+        }
+        case '*': case '+': case '?': case '{':
+        {
+            p->failed = true; // nothing to repeat
+            return (VZKR_Internal_PatternFrag) {0};
+        }
+        case '\\':
+        {
+            if (p->pos + 1 >= p->src.count) { p->failed = true; return (VZKR_Internal_PatternFrag) {0}; }
+
+            u8 e = p->src.data[p->pos + 1];
+            VZKR_Internal_PatternCharSet set = {0};
+            if (VZKR_Internal_PatternAddShorthand(&set, e))
+            {
+                p->pos += 2;
+                return VZKR_Internal_PatternFromCharSet(p, &set);
+            }
+
+            p->pos++;
+            switch (e)
+            {
+                case 'n': lit[0] = '\n'; *litLen = 1; p->pos++; break;
+                case 'r': lit[0] = '\r'; *litLen = 1; p->pos++; break;
+                case 't': lit[0] = '\t'; *litLen = 1; p->pos++; break;
+                case 'x':
+                {
+                    u8 value = 0;
+                    for (i32 i = 0; i < 2; i++)
+                    {
+                        u8 h = (p->pos + 1 + i < p->src.count) ? p->src.data[p->pos + 1 + i] : 0;
+                        if      (h >= '0' && h <= '9') value = (u8) (value * 16 + (h - '0'));
+                        else if (h >= 'a' && h <= 'f') value = (u8) (value * 16 + (h - 'a' + 10));
+                        else if (h >= 'A' && h <= 'F') value = (u8) (value * 16 + (h - 'A' + 10));
+                        else { p->failed = true; return (VZKR_Internal_PatternFrag) {0}; }
+                    }
+
+                    lit[0] = value; *litLen = 1; p->pos += 3;
+                    break;
+                }
+                default:
+                {
+                    *litLen = VZKR_Internal_PatternReadChar(p, lit);
+                    break;
+                }
+            }
+
+            if (p->failed) return (VZKR_Internal_PatternFrag) {0};
+            return VZKR_Internal_PatternLiteral(p, lit, *litLen);
+        }
+        default:
+        {
+            *litLen = VZKR_Internal_PatternReadChar(p, lit);
+            if (p->failed) return (VZKR_Internal_PatternFrag) {0};
+            return VZKR_Internal_PatternLiteral(p, lit, *litLen);
+        }
+    }
+}
+
+static b8 VZKR_Internal_ParseRegexCount(VZKR_Internal_PatternParser* p, i32* value)
+{
+    i64 begin = p->pos;
+    i32 v = 0;
+    while (p->pos < p->src.count && p->src.data[p->pos] >= '0' && p->src.data[p->pos] <= '9')
+    {
+        v = v * 10 + (p->src.data[p->pos] - '0');
+        if (v > VZKR_INTERNAL_PATTERN_MAX_REPEAT) return false;
+        p->pos++;
+    }
+
+    *value = v;
+    return p->pos > begin;
+}
+
+static VZKR_Internal_PatternFrag VZKR_Internal_ParseRegexRepeat(VZKR_Internal_PatternParser* p)
+{
+    i64 atomStart = p->pos;
+    u8 lit[4] = {0};
+    i32 litLen = 0;
+    VZKR_Internal_PatternFrag f = VZKR_Internal_ParseRegexAtom(p, lit, &litLen);
+
+    b8 quantified = false;
+    while (!p->failed && p->pos < p->src.count)
+    {
+        u8 c = p->src.data[p->pos];
+        if      (c == '*') { p->pos++; f = VZKR_Internal_PatternStar(p, f);  }
+        else if (c == '+') { p->pos++; f = VZKR_Internal_PatternPlus(p, f);  }
+        else if (c == '?') { p->pos++; f = VZKR_Internal_PatternQuest(p, f); }
+        else if (c == '{')
+        {
+            // counted repetition, copies of the atom are made by parsing it again
+            p->pos++;
+            i32 minCount = 0, maxCount = 0;
+            if (!VZKR_Internal_ParseRegexCount(p, &minCount)) { p->failed = true; break; }
+
+            b8 unbounded = false;
+            maxCount = minCount;
+            if (p->pos < p->src.count && p->src.data[p->pos] == ',')
+            {
+                p->pos++;
+                if (!VZKR_Internal_ParseRegexCount(p, &maxCount)) unbounded = true;
+            }
+
+            if (p->pos >= p->src.count || p->src.data[p->pos] != '}' || (!unbounded && maxCount < minCount)) { p->failed = true; break; }
+            p->pos++;
+
+            if (quantified) { p->failed = true; break; } // `a*{2}` and friends
+            i64 resume = p->pos;
+
+            VZKR_Internal_PatternFrag result = {0};
+            b8 hasResult = false;
+            i32 copies = minCount + (unbounded ? 1 : (maxCount - minCount));
+            for (i32 i = 0; i < copies && !p->failed; i++)
+            {
+                VZKR_Internal_PatternFrag copy = f;
+                if (i > 0)
+                {
+                    i32 ignored = 0;
+                    p->pos = atomStart;
+                    copy   = VZKR_Internal_ParseRegexAtom(p, lit, &ignored);
+                }
+
+                if (i >= minCount) copy = unbounded ? VZKR_Internal_PatternStar(p, copy) : VZKR_Internal_PatternQuest(p, copy);
+                result    = hasResult ? VZKR_Internal_PatternConcat(p, result, copy) : copy;
+                hasResult = true;
+            }
+
+            p->pos = resume;
+            f = hasResult ? result : VZKR_Internal_PatternEmpty(p);
+        }
+        else
+        {
+            break;
+        }
+
+        quantified = true;
+    }
+
+    if (litLen >= 0) VZKR_Internal_PatternNoteTopLevel(p, (quantified || litLen == 0) ? nil : lit, litLen);
+    return f;
+}
+
+static VZKR_Internal_PatternFrag VZKR_Internal_ParseRegexConcat(VZKR_Internal_PatternParser* p)
+{
+    VZKR_Internal_PatternFrag f = {0};
+    b8 hasAny = false;
+    while (!p->failed && p->pos < p->src.count)
+    {
+        u8 c = p->src.data[p->pos];
+        if (c == '|' || c == ')') break;
+
+        VZKR_Internal_PatternFrag g = VZKR_Internal_ParseRegexRepeat(p);
+        f      = hasAny ? VZKR_Internal_PatternConcat(p, f, g) : g;
+        hasAny = true;
+    }
+
+    return hasAny ? f : VZKR_Internal_PatternEmpty(p);
+}
+
+static VZKR_Internal_PatternFrag VZKR_Internal_ParseRegexAlternation(VZKR_Internal_PatternParser* p)
+{
+    VZKR_Internal_PatternFrag f = VZKR_Internal_ParseRegexConcat(p);
+    while (!p->failed && p->pos < p->src.count && p->src.data[p->pos] == '|')
+    {
+        p->pos++;
+        if (p->depth == 0) p->topLevelAlternation = true;
+        f = VZKR_Internal_PatternAlt(p, f, VZKR_Internal_ParseRegexConcat(p));
+    }
+
+    return f;
+}
+
+// Glob Parsing ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+static VZKR_Internal_PatternFrag VZKR_Internal_PatternAnyChar(VZKR_Internal_PatternParser* p, b8 allowSlash)
+{
+    VZKR_Internal_PatternCharSet set = {0};
+    VZKR_Internal_PatternSetAsciiRange(&set, 0, 127);
+    if (!allowSlash) set.ascii['/' >> 3] &= (u8) ~(1 << ('/' & 7));
+    set.allMultiByte = true;
+    return VZKR_Internal_PatternFromCharSet(p, &set);
+}
+
+static VZKR_Internal_PatternFrag VZKR_Internal_ParseGlobSequence(VZKR_Internal_PatternParser* p)
+{
+    VZKR_Internal_PatternFrag f = {0};
+    b8 hasAny = false;
+    while (!p->failed && p->pos < p->src.count)
+    {
+        u8 c = p->src.data[p->pos];
+        if (p->depth > 0 && (c == ',' || c == '}')) break;
+
+        VZKR_Internal_PatternFrag g = {0};
+        if (c == '*')
+        {
+            p->pos++;
+            if (p->pos < p->src.count && p->src.data[p->pos] == '*')
+            {
+                p->pos++;
+                g = VZKR_Internal_PatternStar(p, VZKR_Internal_PatternAnyChar(p, true));
+                if (p->pos < p->src.count && p->src.data[p->pos] == '/')
+                {
+                    p->pos++;
+                    g = VZKR_Internal_PatternConcat(p, g, VZKR_Internal_PatternByteRange(p, '/', '/'));
+                    g = VZKR_Internal_PatternQuest(p, g);
+                }
+            }
+            else
+            {
+                g = VZKR_Internal_PatternStar(p, VZKR_Internal_PatternAnyChar(p, false));
+            }
+
+            VZKR_Internal_PatternNoteTopLevel(p, nil, 0);
+        }
+        else if (c == '?')
+        {
+            p->pos++;
+            g = VZKR_Internal_PatternAnyChar(p, false);
+            VZKR_Internal_PatternNoteTopLevel(p, nil, 0);
+        }
+        else if (c == '[')
+        {
+            p->pos++;
+            g = VZKR_Internal_PatternParseClass(p, true);
+            VZKR_Internal_PatternNoteTopLevel(p, nil, 0);
+        }
+        else if (c == '{')
+        {
+            p->pos++;
+            p->depth++;
+            g = VZKR_Internal_ParseGlobSequence(p);
+            while (!p->failed && p->pos < p->src.count && p->src.data[p->pos] == ',')
+            {
+                p->pos++;
+                g = VZKR_Internal_PatternAlt(p, g, VZKR_Internal_ParseGlobSequence(p));
+            }
+
+            p->depth--;
+            if (p->pos >= p->src.count || p->src.data[p->pos] != '}') { p->failed = true; break; }
+            p->pos++;
+            VZKR_Internal_PatternNoteTopLevel(p, nil, 0);
+        }
+        else
+        {
+            if (c == '\\' && p->pos + 1 < p->src.count) p->pos++;
+
+            u8 lit[4] = {0};
+            i32 litLen = VZKR_Internal_PatternReadChar(p, lit);
+            if (p->failed) break;
+
+            g = VZKR_Internal_PatternLiteral(p, lit, litLen);
+            VZKR_Internal_PatternNoteTopLevel(p, lit, litLen);
+        }
+
+        f      = hasAny ? VZKR_Internal_PatternConcat(p, f, g) : g;
+        hasAny = true;
+    }
+
+    return hasAny ? f : VZKR_Internal_PatternEmpty(p);
+}
+
+// Compilation ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+static void VZKR_Internal_PatternResetDfa(VZKR_Pattern* pattern);
+
+b8 VZKR_CompilePattern(
+    utf8str source,
+    VZKR_PatternSyntax syntax,
+    VZKR_PatternFlags flags,
+    PNSLR_Allocator allocator,
+    VZKR_Pattern* output,
+    i64* errorOffset
+)
+{
+    if (errorOffset) *errorOffset = -1;
+    if (!output) return false;
+
+    *output = (VZKR_Pattern) {0};
+    output->allocator = allocator;
+    output->syntax    = syntax;
+
+    VZKR_Internal_PatternParser parser = {0};
+    parser.pattern         = output;
+    parser.src             = source;
+    parser.caseInsensitive = !!(flags & VZKR_PatternFlags_CaseInsensitive);
+
+    VZKR_Internal_PatternFrag frag = {0};
+    if (syntax == VZKR_PatternSyntax_Glob)
+    {
+        output->anchoredStart = true;
+        output->anchoredEnd   = true;
+        frag = VZKR_Internal_ParseGlobSequence(&parser);
+    }
+    else
+    {
+        frag = VZKR_Internal_ParseRegexAlternation(&parser);
+        if (parser.pos < source.count) parser.failed = true; // unbalanced ')'
+        if (parser.topLevelAlternation && (output->anchoredStart || output->anchoredEnd)) parser.failed = true;
+    }
+
+    i32 match = VZKR_Internal_PatternAddState(&parser, VZKR_INTERNAL_PATTERN_NFA_MATCH, 0, 0, -1, -1);
+    VZKR_Internal_PatternPatch(&parser, frag.outs, match);
+    output->nfaStart = frag.start;
+
+    if (parser.failed)
+    {
+        if (errorOffset) *errorOffset = parser.pos;
+        VZKR_DestroyPattern(output);
+        return false;
+    }
+
+    // literal prefilters, only meaningful when the whole pattern is one concatenation
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    if (!parser.topLevelAlternation)
+    {
+        if (parser.prefixLen > 0)
+        {
+            output->prefixLiteral = PNSLR_MakeString(parser.prefixLen, false, allocator, PNSLR_GET_LOC(), &err);
+            if (output->prefixLiteral.data) PNSLR_MemCopy(output->prefixLiteral.data, parser.prefix, parser.prefixLen);
+            else                            output->prefixLiteral = (utf8str) {0}; // matching just goes without it
+        }
+
+        if (parser.suffixLen > 0 && output->anchoredEnd)
+        {
+            output->suffixLiteral = PNSLR_MakeString(parser.suffixLen, false, allocator, PNSLR_GET_LOC(), &err);
+            if (output->suffixLiteral.data) PNSLR_MemCopy(output->suffixLiteral.data, parser.suffix, parser.suffixLen);
+            else                            output->suffixLiteral = (utf8str) {0}; // matching just goes without it
+        }
+    }
+
+    // byte equivalence classes, bytes that no range tells apart share a class
+    b8 boundaries[257] = {0};
+    for (i32 i = 0; i < output->numNfaStates; i++)
+    {
+        VZKR_PatternNfaState* st = &output->nfa.data[i];
+        if (st->kind != VZKR_INTERNAL_PATTERN_NFA_RANGE || st->lo > st->hi) continue;
+        boundaries[st->lo]     = true;
+        boundaries[st->hi + 1] = true;
+    }
+
+    i32 numClasses = 0;
+    for (i32 b = 0; b < 256; b++)
+    {
+        if (b > 0 && boundaries[b]) numClasses++;
+        output->byteClasses[b] = (u8) numClasses;
+        if (b == 0 || boundaries[b]) output->classRepresentatives[numClasses] = (u8) b;
+    }
+
+    output->numClasses = numClasses + 1;
+
+    // everything the lazy dfa needs is allocated here, so matching never allocates
+    i32 numNfa = output->numNfaStates;
+    i32 maxDfa = VZKR_INTERNAL_PATTERN_MAX_DFA_STATES;
+    i32 hashSize = 1;
+    while (hashSize < maxDfa * 2) { hashSize <<= 1; }
+
+    i64 poolSize = (i64) maxDfa * 8;
+    if (poolSize < (i64) numNfa * 4) poolSize = (i64) numNfa * 4;
+
+    // each allocation only goes ahead if the ones before it worked, so a later success can't
+    // hide an earlier failure (the prefilters above are optional, so they don't count)
+    err = PNSLR_AllocatorError_None;
+    output->maxDfaStates = maxDfa;
+    output->dfaTransitions = PNSLR_MakeSlice(i32, (i64) maxDfa * output->numClasses, false, allocator, PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) output->dfaStates    = PNSLR_MakeSlice(VZKR_PatternDfaState, maxDfa, false, allocator, PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) output->dfaHashTable = PNSLR_MakeSlice(i32, hashSize, false, allocator, PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) output->setPool      = PNSLR_MakeSlice(i32, poolSize, false, allocator, PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) output->scratchMarks = PNSLR_MakeSlice(u32, numNfa, true, allocator, PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) output->scratchStack = PNSLR_MakeSlice(i32, numNfa * 2 + 1, false, allocator, PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) output->scratchSet   = PNSLR_MakeSlice(i32, numNfa * 2, false, allocator, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None)
+    {
+        VZKR_DestroyPattern(output);
+        return false;
+    }
+
+    VZKR_Internal_PatternResetDfa(output);
+    return true;
+}
+
+void VZKR_DestroyPattern(VZKR_Pattern* pattern)
+{
+    if (!pattern) return;
+
+    PNSLR_Allocator allocator = pattern->allocator;
+    if (pattern->prefixLiteral.data) PNSLR_FreeString(pattern->prefixLiteral, allocator, PNSLR_GET_LOC(), nil);
+    if (pattern->suffixLiteral.data) PNSLR_FreeString(pattern->suffixLiteral, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&pattern->nfa, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&pattern->dfaTransitions, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&pattern->dfaStates, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&pattern->dfaHashTable, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&pattern->setPool, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&pattern->scratchMarks, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&pattern->scratchStack, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&pattern->scratchSet, allocator, PNSLR_GET_LOC(), nil);
+    *pattern = (VZKR_Pattern) {0};
+}
+
+// Lazy DFA ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Adds the epsilon closure of an NFA state to the scratch set, keeping only the states
+ * that matter for the DFA (byte ranges and the match state). Returns the new set size.
+ */
+static i32 VZKR_Internal_PatternClosure(VZKR_Pattern* pattern, i32 count, i32 nfaIdx)
+{
+    u32 gen = pattern->scratchGeneration;
+    u32* marks = pattern->scratchMarks.data;
+    i32* stack = pattern->scratchStack.data;
+    i32* set = pattern->scratchSet.data;
+    i32 top = 0;
+
+    stack[top++] = nfaIdx;
+    while (top > 0)
+    {
+        i32 idx = stack[--top];
+        if (idx < 0 || marks[idx] == gen) continue;
+        marks[idx] = gen;
+
+        VZKR_PatternNfaState* st = &pattern->nfa.data[idx];
+        switch (st->kind)
+        {
+            case VZKR_INTERNAL_PATTERN_NFA_SPLIT:   stack[top++] = st->out1; stack[top++] = st->out; break;
+            case VZKR_INTERNAL_PATTERN_NFA_EPSILON: stack[top++] = st->out; break;
+            default:                                set[count++] = idx; break;
+        }
+    }
+
+    return count;
+}
+
+static void VZKR_Internal_PatternNextGeneration(VZKR_Pattern* pattern)
+{
+    if (++pattern->scratchGeneration != 0) return;
+
+    // wrapped around, stale marks could now look current
+    for (i64 i = 0; i < pattern->scratchMarks.count; i++) { pattern->scratchMarks.data[i] = 0; }
+    pattern->scratchGeneration = 1;
+}
+
+static u32 VZKR_Internal_PatternHashSet(const i32* set, i32 count)
+{
+    u32 h = 2166136261u;
+    for (i32 i = 0; i < count; i++) { h = (h ^ (u32) set[i]) * 16777619u; }
+    return h;
+}
+
+/**
+ * Finds or adds the DFA state for a sorted set of NFA states.
+ * The caller makes sure there's room for one more state.
+ */
+static i32 VZKR_Internal_PatternInternSet(VZKR_Pattern* pattern, const i32* set, i32 count)
+{
+    i32 mask = (i32) pattern->dfaHashTable.count - 1;
+    i32* table = pattern->dfaHashTable.data;
+    i32* pool = pattern->setPool.data;
+
+    i32 slot = (i32) (VZKR_Internal_PatternHashSet(set, count) & (u32) mask);
+    while (table[slot] >= 0)
+    {
+        VZKR_PatternDfaState* existing = &pattern->dfaStates.data[table[slot]];
+        if (existing->setCount == count)
+        {
+            b8 same = true;
+            for (i32 i = 0; i < count && same; i++) { same = (pool[existing->setOffset + i] == set[i]); }
+            if (same) return table[slot];
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    i32 idx = pattern->numDfaStates++;
+    VZKR_PatternDfaState* st = &pattern->dfaStates.data[idx];
+    st->setOffset = pattern->setPoolUsed;
+    st->setCount  = count;
+    st->accepting = false;
+    st->dead      = (count == 0);
+    for (i32 i = 0; i < count; i++)
+    {
+        pool[pattern->setPoolUsed++] = set[i];
+        if (pattern->nfa.data[set[i]].kind == VZKR_INTERNAL_PATTERN_NFA_MATCH) st->accepting = true;
+    }
+
+    i32* trans = &pattern->dfaTransitions.data[(i64) idx * pattern->numClasses];
+    for (i32 i = 0; i < pattern->numClasses; i++) { trans[i] = -1; }
+
+    table[slot] = idx;
+    return idx;
+}
+
+static void VZKR_Internal_PatternSortSet(i32* set, i32 count)
+{
+    for (i32 i = 1; i < count; i++)
+    {
+        i32 v = set[i], j = i - 1;
+        while (j >= 0 && set[j] > v) { set[j + 1] = set[j]; j--; }
+        set[j + 1] = v;
+    }
+}
+
+static void VZKR_Internal_PatternResetDfa(VZKR_Pattern* pattern)
+{
+    pattern->numDfaStates = 0;
+    pattern->setPoolUsed  = 0;
+    for (i64 i = 0; i < pattern->dfaHashTable.count; i++) { pattern->dfaHashTable.data[i] = -1; }
+
+    VZKR_Internal_PatternNextGeneration(pattern);
+    i32 count = VZKR_Internal_PatternClosure(pattern, 0, pattern->nfaStart);
+    VZKR_Internal_PatternSortSet(pattern->scratchSet.data, count);
+    pattern->dfaStartState = VZKR_Internal_PatternInternSet(pattern, pattern->scratchSet.data, count);
+}
+
+/** Builds the transition out of a DFA state for one byte class. May flush the cache. */
+static i32 VZKR_Internal_PatternComputeTransition(VZKR_Pattern* pattern, i32 from, i32 cls)
+{
+    i32 numNfa = pattern->numNfaStates;
+
+    // out of room, start over, keeping just the start state and the one being left
+    if (pattern->numDfaStates + 2 > pattern->maxDfaStates || pattern->setPoolUsed + numNfa * 2 > pattern->setPool.count)
+    {
+        VZKR_PatternDfaState src = pattern->dfaStates.data[from];
+        i32* saved = pattern->scratchSet.data + numNfa;
+        for (i32 i = 0; i < src.setCount; i++) { saved[i] = pattern->setPool.data[src.setOffset + i]; }
+
+        VZKR_Internal_PatternResetDfa(pattern);
+        from = VZKR_Internal_PatternInternSet(pattern, saved, src.setCount);
+    }
+
+    VZKR_PatternDfaState src = pattern->dfaStates.data[from];
+    u8 rep = pattern->classRepresentatives[cls];
+
+    VZKR_Internal_PatternNextGeneration(pattern);
+    i32 count = 0;
+    for (i32 i = 0; i < src.setCount; i++)
+    {
+        VZKR_PatternNfaState* st = &pattern->nfa.data[pattern->setPool.data[src.setOffset + i]];
+        if (st->kind == VZKR_INTERNAL_PATTERN_NFA_RANGE && rep >= st->lo && rep <= st->hi)
+        {
+            count = VZKR_Internal_PatternClosure(pattern, count, st->out);
+        }
+    }
+
+    // unanchored patterns can start a new match at every byte
+    if (!pattern->anchoredStart) count = VZKR_Internal_PatternClosure(pattern, count, pattern->nfaStart);
+
+    VZKR_Internal_PatternSortSet(pattern->scratchSet.data, count);
+    i32 to = VZKR_Internal_PatternInternSet(pattern, pattern->scratchSet.data, count);
+    pattern->dfaTransitions.data[(i64) from * pattern->numClasses + cls] = to;
+    return to;
+}
+
+// Literal Search ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+static b8 VZKR_Internal_PatternBytesEqual(const u8* a, const u8* b, i64 count)
+{
+    for (i64 i = 0; i < count; i++) { if (a[i] != b[i]) return false; }
+    return true;
+}
+
+static i32 VZKR_Internal_PatternLowestBit(u64 mask)
+{
+    #if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long idx; _BitScanForward64(&idx, mask); return (i32) idx;
+    #else
+        return __builtin_ctzll(mask);
+    #endif
+}
+
+/**
+ * Finds the first occurrence of 'needle' at or after 'from'. Compares the first and last
+ * byte of the needle against 16 positions at a time, and only verifies the candidates.
+ */
+static i64 VZKR_Internal_PatternFindLiteral(utf8str hay, utf8str needle, i64 from)
+{
+    i64 n = needle.count;
+    i64 last = hay.count - n; // last valid start
+    if (n <= 0) return from <= hay.count ? from : -1;
+
+    i64 i = from;
+
+    #if PNSLR_X64
+        __m128i first = _mm_set1_epi8((char) needle.data[0]);
+        __m128i final = _mm_set1_epi8((char) needle.data[n - 1]);
+        for (; i + 15 <= last; i += 16)
+        {
+            __m128i blockFirst = _mm_loadu_si128((const __m128i*) (hay.data + i));
+            __m128i blockFinal = _mm_loadu_si128((const __m128i*) (hay.data + i + n - 1));
+            u64 mask = (u64) (u32) _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockFinal, final)));
+            while (mask)
+            {
+                i64 cand = i + VZKR_Internal_PatternLowestBit(mask);
+                if (VZKR_Internal_PatternBytesEqual(hay.data + cand + 1, needle.data + 1, n - 1)) return cand;
+                mask &= mask - 1;
+            }
+        }
+    #elif PNSLR_ARM64
+        uint8x16_t first = vdupq_n_u8(needle.data[0]);
+        uint8x16_t final = vdupq_n_u8(needle.data[n - 1]);
+        for (; i + 15 <= last; i += 16)
+        {
+            uint8x16_t eq = vandq_u8(vceqq_u8(vld1q_u8(hay.data + i), first), vceqq_u8(vld1q_u8(hay.data + i + n - 1), final));
+
+            // narrow every byte of the comparison to a nibble, four bits per lane
+            u64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+            while (mask)
+            {
+                i32 bit = VZKR_Internal_PatternLowestBit(mask) & ~3;
+                i64 cand = i + (bit >> 2);
+                if (VZKR_Internal_PatternBytesEqual(hay.data + cand + 1, needle.data + 1, n - 1)) return cand;
+                mask &= ~((u64) 0xF << bit);
+            }
+        }
+    #endif
+
+    for (; i <= last; i++)
+    {
+        if (hay.data[i] == needle.data[0] && VZKR_Internal_PatternBytesEqual(hay.data + i + 1, needle.data + 1, n - 1)) return i;
+    }
+
+    return -1;
+}
+
+// Pattern Matching ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+b8 VZKR_MatchPattern(VZKR_Pattern* pattern, utf8str str)
+{
+    if (!pattern || !pattern->dfaStates.data) return false;
+
+    utf8str prefix = pattern->prefixLiteral;
+    utf8str suffix = pattern->suffixLiteral;
+    if (suffix.count > 0)
+    {
+        if (str.count < suffix.count) return false;
+        if (!VZKR_Internal_PatternBytesEqual(str.data + str.count - suffix.count, suffix.data, suffix.count)) return false;
+    }
+
+    i64 i = 0;
+    if (prefix.count > 0)
+    {
+        if (pattern->anchoredStart)
+        {
+            if (str.count < prefix.count || !VZKR_Internal_PatternBytesEqual(str.data, prefix.data, prefix.count)) return false;
+        }
+        else
+        {
+            i = VZKR_Internal_PatternFindLiteral(str, prefix, 0);
+            if (i < 0) return false;
+        }
+    }
+
+    b8 earlyExit = !pattern->anchoredEnd;
+    b8 skipAhead = (prefix.count > 0 && !pattern->anchoredStart);
+    i32 numClasses = pattern->numClasses;
+    i32 startState = pattern->dfaStartState;
+    const u8* classes = pattern->byteClasses;
+    const i32* transitions = pattern->dfaTransitions.data;
+    const VZKR_PatternDfaState* states = pattern->dfaStates.data;
+    i32 s = startState;
+    if (earlyExit && states[s].accepting) return true;
+
+    for (; i < str.count; i++)
+    {
+        // back at the start with nothing in flight, jump to where a match could begin
+        if (skipAhead && s == startState && i > 0)
+        {
+            i = VZKR_Internal_PatternFindLiteral(str, prefix, i);
+            if (i < 0) return false;
+        }
+
+        i32 cls = classes[str.data[i]];
+        i32 next = transitions[(i64) s * numClasses + cls];
+        if (next < 0)
+        {
+            // may flush the cache, which can renumber the start state
+            next = VZKR_Internal_PatternComputeTransition(pattern, s, cls);
+            startState = pattern->dfaStartState;
+        }
+
+        s = next;
+        if (states[s].dead) return false;
+        if (earlyExit && states[s].accepting) return true;
+    }
+
+    return states[s].accepting;
+}
@@ -0,0 +1,142 @@
+#ifndef VZKR_PATTERN_MATCH_H // ====================================================
+#define VZKR_PATTERN_MATCH_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Pattern Declaration ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * The syntax a pattern is written in.
+ *
+ * Globs always match the whole string. They support `*` (anything except '/'),
+ * `?` (one character except '/'), `**` (anything, `**` followed by '/' also matches
+ * zero directories), `[abc]`/`[a-z]`/`[!abc]` classes, `{a,b}` alternatives and
+ * `\` escapes.
+ *
+ * Regexes match anywhere in the string unless anchored. They support literals,
+ * `.`, `[...]`/`[^...]` classes, `\d \w \s \D \W \S \n \r \t \xHH`, groups,
+ * `|`, `*`, `+`, `?`, `{m}`, `{m,}`, `{m,n}`, and `^`/`$` at the very start/end
+ * of the whole pattern. There are no backreferences or lookarounds, by design.
+ */
+typedef u8 VZKR_PatternSyntax /* use as value */;
+#define VZKR_PatternSyntax_Glob ((VZKR_PatternSyntax) 0)
+#define VZKR_PatternSyntax_Regex ((VZKR_PatternSyntax) 1)
+
+/**
+ * Options for compiling a pattern.
+ */
+typedef u8 VZKR_PatternFlags /* use as flags */;
+#define VZKR_PatternFlags_None ((VZKR_PatternFlags) 0)
+#define VZKR_PatternFlags_CaseInsensitive ((VZKR_PatternFlags) 1)
+
+/**
+ * A single state of the NFA a pattern compiles to.
+ * Byte ranges consume one byte in [lo, hi] and go to 'out'.
+ * Splits go to both 'out' and 'out1' without consuming anything, epsilons only to 'out'.
+ */
+typedef struct VZKR_PatternNfaState
+{
+    u8 kind;
+    u8 lo;
+    u8 hi;
+    i32 out;
+    i32 out1;
+} VZKR_PatternNfaState;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_PatternNfaState);
+
+/**
+ * A state of the lazily built DFA; refers to a sorted set of NFA states in the set pool.
+ */
+typedef struct VZKR_PatternDfaState
+{
+    i32 setOffset;
+    i32 setCount;
+    b8 accepting;
+    b8 dead;
+} VZKR_PatternDfaState;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_PatternDfaState);
+
+/**
+ * A compiled glob or regex.
+ *
+ * The pattern is compiled to an NFA, and DFA states are built from it lazily as input
+ * is matched, so matching runs in linear time with one table lookup per byte once warm.
+ * The DFA cache has a fixed size and is flushed when it fills up; everything is allocated
+ * up front, so matching never allocates.
+ *
+ * Literal prefixes/suffixes are extracted at compile-time and checked first, using SIMD
+ * to skip ahead to candidate positions for unanchored regexes.
+ *
+ * Matching updates the DFA cache, so a pattern must not be matched on several threads at once.
+ */
+typedef struct VZKR_Pattern
+{
+    PNSLR_Allocator allocator;
+    VZKR_PatternSyntax syntax;
+    b8 anchoredStart;
+    b8 anchoredEnd;
+    utf8str prefixLiteral;
+    utf8str suffixLiteral;
+    i32 nfaStart;
+    i32 numNfaStates;
+    PNSLR_ArraySlice(VZKR_PatternNfaState) nfa;
+    u8 byteClasses[256];
+    u8 classRepresentatives[256];
+    i32 numClasses;
+    i32 dfaStartState;
+    i32 numDfaStates;
+    i32 maxDfaStates;
+    i32 setPoolUsed;
+    PNSLR_ArraySlice(i32) dfaTransitions;
+    PNSLR_ArraySlice(VZKR_PatternDfaState) dfaStates;
+    PNSLR_ArraySlice(i32) dfaHashTable;
+    PNSLR_ArraySlice(i32) setPool;
+    PNSLR_ArraySlice(u32) scratchMarks;
+    PNSLR_ArraySlice(i32) scratchStack;
+    PNSLR_ArraySlice(i32) scratchSet;
+    u32 scratchGeneration;
+} VZKR_Pattern;
+
+/**
+ * Compiles a glob or a regex. On failure, optionally stores the byte offset in the
+ * source where compilation stopped.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_CompilePattern(
+    utf8str source,
+    VZKR_PatternSyntax syntax,
+    VZKR_PatternFlags flags,
+    PNSLR_Allocator allocator,
+    VZKR_Pattern* output,
+    i64* errorOffset
+);
+
+/**
+ * Frees the resources used by a compiled pattern.
+ */
+void VZKR_DestroyPattern(
+    VZKR_Pattern* pattern
+);
+
+// Pattern Matching ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Checks whether a string matches a compiled pattern.
+ * Globs need to match the whole string, regexes anywhere (unless anchored).
+ * Not thread-safe, see `VZKR_Pattern`.
+ */
+b8 VZKR_MatchPattern(
+    VZKR_Pattern* pattern,
+    utf8str str
+);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_PATTERN_MATCH_H =====================================================
@@ -0,0 +1,336 @@
+#define VZKR_IMPLEMENTATION
+#include "Queues.h"
+
+// Shared Internals ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_QUEUE_DEFAULT_CAPACITY 1024
+#define VZKR_INTERNAL_QUEUE_MAX_CAPACITY     (1 << 30)
+
+/** Returns the capacity to use, or zero if it (or the element layout) can't work. */
+static u64 VZKR_Internal_QueueCapacity(i32 capacity, i32 elementSize, i32 elementAlignment)
+{
+    if (elementSize <= 0 || elementAlignment <= 0 || (elementAlignment & (elementAlignment - 1)) != 0) return 0;
+    if (capacity <= 0) capacity = VZKR_INTERNAL_QUEUE_DEFAULT_CAPACITY;
+    if (capacity > VZKR_INTERNAL_QUEUE_MAX_CAPACITY) return 0;
+
+    u64 rounded = 1;
+    while (rounded < (u64) capacity) rounded <<= 1;
+    return rounded;
+}
+
+/** Gets a permit off a blocking queue's semaphore, waiting as long as it's allowed to. */
+static b8 VZKR_Internal_QueueAcquire(PNSLR_Semaphore* semaphore, i32 timeoutNs)
+{
+    if (timeoutNs < 0) { PNSLR_WaitSemaphore(semaphore); return true; }
+    return PNSLR_WaitSemaphoreTimeout(semaphore, timeoutNs);
+}
+
+// SPSC Queue ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// each end only writes its own cache line: its position, and the last position it saw
+// of the other end, which it only reloads once the queue looks full (or empty)
+
+typedef struct VZKR_Internal_SpscQueue
+{
+    u64 head;
+    u64 cachedTail;
+    VZKR_CACHE_LINE_PADDING(headPadding, 16);
+    u64 tail;
+    u64 cachedHead;
+    VZKR_CACHE_LINE_PADDING(tailPadding, 16);
+    u64 mask;
+    i32 elementSize;
+    i32 elementStride;
+    u8* elements;
+    VZKR_QueueMode mode;
+    PNSLR_Allocator allocator;
+    PNSLR_Semaphore numElements;
+    PNSLR_Semaphore numFreeSlots;
+} VZKR_Internal_SpscQueue;
+
+static void VZKR_Internal_SpscQueueFree(VZKR_Internal_SpscQueue* queue)
+{
+    if (queue->elements) PNSLR_Free(queue->allocator, queue->elements, PNSLR_GET_LOC(), nil);
+    if (queue->mode == VZKR_QueueMode_Blocking)
+    {
+        PNSLR_DestroySemaphore(&queue->numElements);
+        PNSLR_DestroySemaphore(&queue->numFreeSlots);
+    }
+
+    PNSLR_Free(queue->allocator, queue, PNSLR_GET_LOC(), nil);
+}
+
+VZKR_RawSpscQueue VZKR_CreateRawSpscQueue(
+    i32 elementSize,
+    i32 elementAlignment,
+    i32 capacity,
+    VZKR_QueueMode mode,
+    PNSLR_Allocator allocator
+)
+{
+    u64 numSlots = VZKR_Internal_QueueCapacity(capacity, elementSize, elementAlignment);
+    if (!numSlots) return (VZKR_RawSpscQueue) {0};
+
+    i64 stride = ((i64) elementSize + elementAlignment - 1) & ~((i64) elementAlignment - 1);
+    if (stride * (i64) numSlots > 0x7FFFFFFF) return (VZKR_RawSpscQueue) {0};
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_SpscQueue* queue = (VZKR_Internal_SpscQueue*) PNSLR_Allocate(allocator, true, (i32) sizeof(VZKR_Internal_SpscQueue), VZKR_CACHE_LINE_SIZE, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !queue) return (VZKR_RawSpscQueue) {0};
+
+    queue->mask          = numSlots - 1;
+    queue->elementSize   = elementSize;
+    queue->elementStride = (i32) stride;
+    queue->mode          = mode;
+    queue->allocator     = allocator;
+
+    i32 bufferAlignment = elementAlignment > VZKR_CACHE_LINE_SIZE ? elementAlignment : VZKR_CACHE_LINE_SIZE;
+    queue->elements = (u8*) PNSLR_Allocate(allocator, false, (i32) (stride * (i64) numSlots), bufferAlignment, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !queue->elements)
+    {
+        queue->mode = VZKR_QueueMode_NonBlocking; // no semaphores to destroy yet
+        VZKR_Internal_SpscQueueFree(queue);
+        return (VZKR_RawSpscQueue) {0};
+    }
+
+    if (mode == VZKR_QueueMode_Blocking)
+    {
+        queue->numElements  = PNSLR_CreateSemaphore(0);
+        queue->numFreeSlots = PNSLR_CreateSemaphore((i32) numSlots);
+    }
+
+    return (VZKR_RawSpscQueue) {.handle = (rawptr) queue};
+}
+
+void VZKR_DestroyRawSpscQueue(VZKR_RawSpscQueue* queue)
+{
+    if (!queue || !queue->handle) return;
+
+    VZKR_Internal_SpscQueueFree((VZKR_Internal_SpscQueue*) queue->handle);
+    *queue = (VZKR_RawSpscQueue) {0};
+}
+
+static b8 VZKR_Internal_SpscQueueTryPush(VZKR_Internal_SpscQueue* queue, rawptr element)
+{
+    u64 tail = queue->tail; // only ever written by this end
+    if (tail - queue->cachedHead > queue->mask)
+    {
+        queue->cachedHead = VZKR_AtomicLoadU64(&queue->head, VZKR_MemoryOrder_Acquire);
+        if (tail - queue->cachedHead > queue->mask) return false;
+    }
+
+    PNSLR_MemCopy(queue->elements + (tail & queue->mask) * (u64) queue->elementStride, element, queue->elementSize);
+    VZKR_AtomicStoreU64(&queue->tail, tail + 1, VZKR_MemoryOrder_Release);
+    return true;
+}
+
+static b8 VZKR_Internal_SpscQueueTryPop(VZKR_Internal_SpscQueue* queue, rawptr element)
+{
+    u64 head = queue->head; // only ever written by this end
+    if (head == queue->cachedTail)
+    {
+        queue->cachedTail = VZKR_AtomicLoadU64(&queue->tail, VZKR_MemoryOrder_Acquire);
+        if (head == queue->cachedTail) return false;
+    }
+
+    PNSLR_MemCopy(element, queue->elements + (head & queue->mask) * (u64) queue->elementStride, queue->elementSize);
+    VZKR_AtomicStoreU64(&queue->head, head + 1, VZKR_MemoryOrder_Release);
+    return true;
+}
+
+b8 VZKR_PushToRawSpscQueue(VZKR_RawSpscQueue queue, rawptr element, i32 timeoutNs)
+{
+    if (!queue.handle || !element) return false;
+    VZKR_Internal_SpscQueue* internal = (VZKR_Internal_SpscQueue*) queue.handle;
+
+    if (internal->mode != VZKR_QueueMode_Blocking) return VZKR_Internal_SpscQueueTryPush(internal, element);
+
+    // a free slot permit means the consumer has already moved past it
+    if (!VZKR_Internal_QueueAcquire(&internal->numFreeSlots, timeoutNs)) return false;
+    VZKR_Internal_SpscQueueTryPush(internal, element);
+    PNSLR_SignalSemaphore(&internal->numElements, 1);
+    return true;
+}
+
+b8 VZKR_PopFromRawSpscQueue(VZKR_RawSpscQueue queue, rawptr element, i32 timeoutNs)
+{
+    if (!queue.handle || !element) return false;
+    VZKR_Internal_SpscQueue* internal = (VZKR_Internal_SpscQueue*) queue.handle;
+
+    if (internal->mode != VZKR_QueueMode_Blocking) return VZKR_Internal_SpscQueueTryPop(internal, element);
+
+    if (!VZKR_Internal_QueueAcquire(&internal->numElements, timeoutNs)) return false;
+    VZKR_Internal_SpscQueueTryPop(internal, element);
+    PNSLR_SignalSemaphore(&internal->numFreeSlots, 1);
+    return true;
+}
+
+// MPMC Queue ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// Dmitry Vyukov's bounded queue: a slot whose sequence number equals a push position is
+// free for that push, and one equal to a pop position plus one holds that pop's element;
+// claiming a position is a compare-and-swap, and publishing the slot a release store
+
+typedef struct VZKR_Internal_MpmcQueue
+{
+    u64 pushPos;
+    VZKR_CACHE_LINE_PADDING(pushPadding, 8);
+    u64 popPos;
+    VZKR_CACHE_LINE_PADDING(popPadding, 8);
+    u64 mask;
+    i32 elementSize;
+    i32 elementOffset;
+    i32 slotStride;
+    u8* slots;
+    VZKR_QueueMode mode;
+    PNSLR_Allocator allocator;
+    PNSLR_Semaphore numElements;
+    PNSLR_Semaphore numFreeSlots;
+} VZKR_Internal_MpmcQueue;
+
+static u64* VZKR_Internal_MpmcQueueSequence(VZKR_Internal_MpmcQueue* queue, u64 position)
+{
+    return (u64*) (queue->slots + (position & queue->mask) * (u64) queue->slotStride);
+}
+
+static void VZKR_Internal_MpmcQueueFree(VZKR_Internal_MpmcQueue* queue)
+{
+    if (queue->slots) PNSLR_Free(queue->allocator, queue->slots, PNSLR_GET_LOC(), nil);
+    if (queue->mode == VZKR_QueueMode_Blocking)
+    {
+        PNSLR_DestroySemaphore(&queue->numElements);
+        PNSLR_DestroySemaphore(&queue->numFreeSlots);
+    }
+
+    PNSLR_Free(queue->allocator, queue, PNSLR_GET_LOC(), nil);
+}
+
+VZKR_RawMpmcQueue VZKR_CreateRawMpmcQueue(
+    i32 elementSize,
+    i32 elementAlignment,
+    i32 capacity,
+    VZKR_QueueMode mode,
+    PNSLR_Allocator allocator
+)
+{
+    u64 numSlots = VZKR_Internal_QueueCapacity(capacity, elementSize, elementAlignment);
+    if (!numSlots) return (VZKR_RawMpmcQueue) {0};
+
+    // every slot is its sequence number, followed by the element
+    i64 slotAlignment = elementAlignment > (i32) sizeof(u64) ? elementAlignment : (i32) sizeof(u64);
+    i64 offset        = ((i64) sizeof(u64) + elementAlignment - 1) & ~((i64) elementAlignment - 1);
+    i64 stride        = (offset + elementSize + slotAlignment - 1) & ~(slotAlignment - 1);
+    if (stride * (i64) numSlots > 0x7FFFFFFF) return (VZKR_RawMpmcQueue) {0};
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_MpmcQueue* queue = (VZKR_Internal_MpmcQueue*) PNSLR_Allocate(allocator, true, (i32) sizeof(VZKR_Internal_MpmcQueue), VZKR_CACHE_LINE_SIZE, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !queue) return (VZKR_RawMpmcQueue) {0};
+
+    queue->mask          = numSlots - 1;
+    queue->elementSize   = elementSize;
+    queue->elementOffset = (i32) offset;
+    queue->slotStride    = (i32) stride;
+    queue->mode          = mode;
+    queue->allocator     = allocator;
+
+    i32 bufferAlignment = slotAlignment > VZKR_CACHE_LINE_SIZE ? (i32) slotAlignment : VZKR_CACHE_LINE_SIZE;
+    queue->slots = (u8*) PNSLR_Allocate(allocator, false, (i32) (stride * (i64) numSlots), bufferAlignment, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !queue->slots)
+    {
+        queue->mode = VZKR_QueueMode_NonBlocking; // no semaphores to destroy yet
+        VZKR_Internal_MpmcQueueFree(queue);
+        return (VZKR_RawMpmcQueue) {0};
+    }
+
+    for (u64 i = 0; i < numSlots; i++) *VZKR_Internal_MpmcQueueSequence(queue, i) = i;
+
+    if (mode == VZKR_QueueMode_Blocking)
+    {
+        queue->numElements  = PNSLR_CreateSemaphore(0);
+        queue->numFreeSlots = PNSLR_CreateSemaphore((i32) numSlots);
+    }
+
+    return (VZKR_RawMpmcQueue) {.handle = (rawptr) queue};
+}
+
+void VZKR_DestroyRawMpmcQueue(VZKR_RawMpmcQueue* queue)
+{
+    if (!queue || !queue->handle) return;
+
+    VZKR_Internal_MpmcQueueFree((VZKR_Internal_MpmcQueue*) queue->handle);
+    *queue = (VZKR_RawMpmcQueue) {0};
+}
+
+static b8 VZKR_Internal_MpmcQueueTryPush(VZKR_Internal_MpmcQueue* queue, rawptr element)
+{
+    u64  position = VZKR_AtomicLoadU64(&queue->pushPos, VZKR_MemoryOrder_Acquire);
+    u64* sequence;
+    for (;;)
+    {
+        sequence = VZKR_Internal_MpmcQueueSequence(queue, position);
+        i64 lag  = (i64) (VZKR_AtomicLoadU64(sequence, VZKR_MemoryOrder_Acquire) - position);
+
+        if (lag == 0)
+        {
+            if (VZKR_AtomicCompareExchangeU64(&queue->pushPos, &position, position + 1, VZKR_MemoryOrder_Relaxed)) break;
+            position = VZKR_AtomicLoadU64(&queue->pushPos, VZKR_MemoryOrder_Acquire);
+        }
+        else if (lag < 0) return false; // still holds the element from a lap ago
+        else              position = VZKR_AtomicLoadU64(&queue->pushPos, VZKR_MemoryOrder_Acquire);
+    }
+
+    PNSLR_MemCopy((u8*) sequence + queue->elementOffset, element, queue->elementSize);
+    VZKR_AtomicStoreU64(sequence, position + 1, VZKR_MemoryOrder_Release);
+    return true;
+}
+
+static b8 VZKR_Internal_MpmcQueueTryPop(VZKR_Internal_MpmcQueue* queue, rawptr element)
+{
+    u64  position = VZKR_AtomicLoadU64(&queue->popPos, VZKR_MemoryOrder_Acquire);
+    u64* sequence;
+    for (;;)
+    {
+        sequence = VZKR_Internal_MpmcQueueSequence(queue, position);
+        i64 lag  = (i64) (VZKR_AtomicLoadU64(sequence, VZKR_MemoryOrder_Acquire) - (position + 1));
+
+        if (lag == 0)
+        {
+            if (VZKR_AtomicCompareExchangeU64(&queue->popPos, &position, position + 1, VZKR_MemoryOrder_Relaxed)) break;
+            position = VZKR_AtomicLoadU64(&queue->popPos, VZKR_MemoryOrder_Acquire);
+        }
+        else if (lag < 0) return false; // not pushed to yet
+        else              position = VZKR_AtomicLoadU64(&queue->popPos, VZKR_MemoryOrder_Acquire);
+    }
+
+    PNSLR_MemCopy(element, (u8*) sequence + queue->elementOffset, queue->elementSize);
+    VZKR_AtomicStoreU64(sequence, position + queue->mask + 1, VZKR_MemoryOrder_Release);
+    return true;
+}
+
+b8 VZKR_PushToRawMpmcQueue(VZKR_RawMpmcQueue queue, rawptr element, i32 timeoutNs)
+{
+    if (!queue.handle || !element) return false;
+    VZKR_Internal_MpmcQueue* internal = (VZKR_Internal_MpmcQueue*) queue.handle;
+
+    if (internal->mode != VZKR_QueueMode_Blocking) return VZKR_Internal_MpmcQueueTryPush(internal, element);
+
+    // a permit guarantees a free slot, but the one next in line may still be being popped
+    // from by a slower consumer, so it can take a few tries
+    if (!VZKR_Internal_QueueAcquire(&internal->numFreeSlots, timeoutNs)) return false;
+    while (!VZKR_Internal_MpmcQueueTryPush(internal, element)) VZKR_YieldThread();
+    PNSLR_SignalSemaphore(&internal->numElements, 1);
+    return true;
+}
+
+b8 VZKR_PopFromRawMpmcQueue(VZKR_RawMpmcQueue queue, rawptr element, i32 timeoutNs)
+{
+    if (!queue.handle || !element) return false;
+    VZKR_Internal_MpmcQueue* internal = (VZKR_Internal_MpmcQueue*) queue.handle;
+
+    if (internal->mode != VZKR_QueueMode_Blocking) return VZKR_Internal_MpmcQueueTryPop(internal, element);
+
+    if (!VZKR_Internal_QueueAcquire(&internal->numElements, timeoutNs)) return false;
+    while (!VZKR_Internal_MpmcQueueTryPop(internal, element)) VZKR_YieldThread();
+    PNSLR_SignalSemaphore(&internal->numFreeSlots, 1);
+    return true;
+}
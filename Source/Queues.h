@@ -0,0 +1,211 @@
+#ifndef VZKR_QUEUES_H // ===========================================================
+#define VZKR_QUEUES_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Queue Modes ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * What pushing to a full queue, or popping from an empty one, does.
+ * Non-blocking queues fail straight away, and never take a lock.
+ * Blocking queues also keep count of their elements and free slots in a pair of
+ * semaphores, so they can wait up to a timeout (at the cost of signalling one of them on
+ * every push and pop).
+ */
+typedef u8 VZKR_QueueMode /* use as value */;
+#define VZKR_QueueMode_NonBlocking ((VZKR_QueueMode) 0)
+#define VZKR_QueueMode_Blocking ((VZKR_QueueMode) 1)
+
+// SPSC Queue ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A cross-platform opaque handle to a bounded single-producer single-consumer queue:
+ * one thread pushes fixed-size elements, and another one pops them, in order.
+ * Each end keeps its position on a cache line of its own, and only looks at the other
+ * one's when it seems to be full (or empty), so it's the fastest way to hand elements over
+ * between exactly two threads.
+ *
+ * Elements are copied in and out bytewise.
+ */
+typedef struct VZKR_RawSpscQueue
+{
+    rawptr handle;
+} VZKR_RawSpscQueue;
+
+/**
+ * Creates a queue holding up to 'capacity' elements (rounded up to a power of two, 1024 if
+ * not positive), of the given size and alignment (a power of two).
+ * If creating failed, the returned handle will be zeroed.
+ */
+VZKR_RawSpscQueue VZKR_CreateRawSpscQueue(
+    i32 elementSize,
+    i32 elementAlignment,
+    i32 capacity,
+    VZKR_QueueMode mode,
+    PNSLR_Allocator allocator
+);
+
+/**
+ * Frees a queue, along with any elements still in it.
+ * Neither end may be using it anymore.
+ */
+void VZKR_DestroyRawSpscQueue(
+    VZKR_RawSpscQueue* queue
+);
+
+/**
+ * Pushes a copy of an element. Only one thread may push to a queue.
+ * If the queue is full, a blocking one waits up to a timeout for a slot to free up; a
+ * timeout of zero doesn't wait at all, a negative one waits indefinitely.
+ * Returns true on success, false if the queue was full.
+ */
+b8 VZKR_PushToRawSpscQueue(
+    VZKR_RawSpscQueue queue,
+    rawptr element,
+    i32 timeoutNs
+);
+
+/**
+ * Pops the oldest element, copying it out. Only one thread may pop from a queue.
+ * If the queue is empty, a blocking one waits up to a timeout for something to be pushed;
+ * a timeout of zero doesn't wait at all, a negative one waits indefinitely.
+ * Returns true on success, false if the queue was empty.
+ */
+b8 VZKR_PopFromRawSpscQueue(
+    VZKR_RawSpscQueue queue,
+    rawptr element,
+    i32 timeoutNs
+);
+
+// MPMC Queue ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A cross-platform opaque handle to a bounded multi-producer multi-consumer queue: any
+ * number of threads push fixed-size elements, and any number pop them.
+ * Every slot keeps a sequence number saying whose turn it is, so pushing and popping each
+ * take a single compare-and-swap, with no locks.
+ *
+ * Elements are copied in and out bytewise.
+ */
+typedef struct VZKR_RawMpmcQueue
+{
+    rawptr handle;
+} VZKR_RawMpmcQueue;
+
+/**
+ * Creates a queue holding up to 'capacity' elements (rounded up to a power of two, 1024 if
+ * not positive), of the given size and alignment (a power of two).
+ * If creating failed, the returned handle will be zeroed.
+ */
+VZKR_RawMpmcQueue VZKR_CreateRawMpmcQueue(
+    i32 elementSize,
+    i32 elementAlignment,
+    i32 capacity,
+    VZKR_QueueMode mode,
+    PNSLR_Allocator allocator
+);
+
+/**
+ * Frees a queue, along with any elements still in it.
+ * Nobody may be using it anymore.
+ */
+void VZKR_DestroyRawMpmcQueue(
+    VZKR_RawMpmcQueue* queue
+);
+
+/**
+ * Pushes a copy of an element. Can be called from any thread.
+ * If the queue is full, a blocking one waits up to a timeout for a slot to free up; a
+ * timeout of zero doesn't wait at all, a negative one waits indefinitely.
+ * Returns true on success, false if the queue was full.
+ */
+b8 VZKR_PushToRawMpmcQueue(
+    VZKR_RawMpmcQueue queue,
+    rawptr element,
+    i32 timeoutNs
+);
+
+/**
+ * Pops the oldest element, copying it out. Can be called from any thread.
+ * If the queue is empty, a blocking one waits up to a timeout for something to be pushed;
+ * a timeout of zero doesn't wait at all, a negative one waits indefinitely.
+ * Returns true on success, false if the queue was empty.
+ */
+b8 VZKR_PopFromRawMpmcQueue(
+    VZKR_RawMpmcQueue queue,
+    rawptr element,
+    i32 timeoutNs
+);
+
+// Typed Queues ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/** A queue of elements of type 'ty'. */
+#define VZKR_SpscQueue(ty) VZKR_SpscQueue_##ty
+#define VZKR_MpmcQueue(ty) VZKR_MpmcQueue_##ty
+
+/** Declare queues of type 'ty'. 'element' is never set, it only carries the type. */
+#define VZKR_DECLARE_SPSC_QUEUE(ty) \
+    typedef union VZKR_SpscQueue(ty) { ty* element; VZKR_RawSpscQueue raw; } VZKR_SpscQueue(ty);
+#define VZKR_DECLARE_MPMC_QUEUE(ty) \
+    typedef union VZKR_MpmcQueue(ty) { ty* element; VZKR_RawMpmcQueue raw; } VZKR_MpmcQueue(ty);
+
+/** Create a queue of up to 'capacity' elements of type 'ty'. */
+#define VZKR_CreateSpscQueue(ty, capacity, mode, allocator) \
+    (VZKR_SpscQueue_##ty) {.raw = VZKR_CreateRawSpscQueue((i32) sizeof(ty), (i32) alignof(ty), capacity, mode, allocator)}
+#define VZKR_CreateMpmcQueue(ty, capacity, mode, allocator) \
+    (VZKR_MpmcQueue_##ty) {.raw = VZKR_CreateRawMpmcQueue((i32) sizeof(ty), (i32) alignof(ty), capacity, mode, allocator)}
+
+/** Destroy a 'queue' (passed by ptr). */
+#define VZKR_DestroySpscQueue(queue) \
+    do { if (queue) VZKR_DestroyRawSpscQueue(&((queue)->raw)); } while(0)
+#define VZKR_DestroyMpmcQueue(queue) \
+    do { if (queue) VZKR_DestroyRawMpmcQueue(&((queue)->raw)); } while(0)
+
+/** Push/pop an element through a pointer of the queue's type (mismatched pointers warn). */
+#define VZKR_PushToSpscQueue(queue, elementPtr, timeoutNs) \
+    VZKR_PushToRawSpscQueue((queue).raw, (1 ? (elementPtr) : (queue).element), timeoutNs)
+#define VZKR_PopFromSpscQueue(queue, elementPtr, timeoutNs) \
+    VZKR_PopFromRawSpscQueue((queue).raw, (1 ? (elementPtr) : (queue).element), timeoutNs)
+#define VZKR_PushToMpmcQueue(queue, elementPtr, timeoutNs) \
+    VZKR_PushToRawMpmcQueue((queue).raw, (1 ? (elementPtr) : (queue).element), timeoutNs)
+#define VZKR_PopFromMpmcQueue(queue, elementPtr, timeoutNs) \
+    VZKR_PopFromRawMpmcQueue((queue).raw, (1 ? (elementPtr) : (queue).element), timeoutNs)
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#ifdef __cplusplus
+namespace Vizkaar
+{
+    /** A queue of elements of type 'T', which have to be trivially copyable. */
+    template <typename T> struct SpscQueue { VZKR_RawSpscQueue raw; };
+    template <typename T> struct MpmcQueue { VZKR_RawMpmcQueue raw; };
+
+    /** Create a queue of up to 'capacity' elements of type 'T'. */
+    template <typename T> SpscQueue<T> CreateSpscQueue(i32 capacity, VZKR_QueueMode mode, PNSLR_Allocator allocator)
+    {
+        SpscQueue<T> queue; queue.raw = VZKR_CreateRawSpscQueue((i32) sizeof(T), (i32) alignof(T), capacity, mode, allocator); return queue;
+    }
+
+    template <typename T> MpmcQueue<T> CreateMpmcQueue(i32 capacity, VZKR_QueueMode mode, PNSLR_Allocator allocator)
+    {
+        MpmcQueue<T> queue; queue.raw = VZKR_CreateRawMpmcQueue((i32) sizeof(T), (i32) alignof(T), capacity, mode, allocator); return queue;
+    }
+
+    /** Destroy a queue. */
+    template <typename T> void DestroySpscQueue(SpscQueue<T>* queue) { if (queue) VZKR_DestroyRawSpscQueue(&queue->raw); }
+    template <typename T> void DestroyMpmcQueue(MpmcQueue<T>* queue) { if (queue) VZKR_DestroyRawMpmcQueue(&queue->raw); }
+
+    /** Push/pop an element. */
+    template <typename T> b8 PushToSpscQueue(SpscQueue<T> queue, const T& element, i32 timeoutNs = 0)  { return VZKR_PushToRawSpscQueue(queue.raw, (rawptr) &element, timeoutNs); }
+    template <typename T> b8 PopFromSpscQueue(SpscQueue<T> queue, T* element, i32 timeoutNs = 0)      { return VZKR_PopFromRawSpscQueue(queue.raw, (rawptr) element, timeoutNs); }
+    template <typename T> b8 PushToMpmcQueue(MpmcQueue<T> queue, const T& element, i32 timeoutNs = 0)  { return VZKR_PushToRawMpmcQueue(queue.raw, (rawptr) &element, timeoutNs); }
+    template <typename T> b8 PopFromMpmcQueue(MpmcQueue<T> queue, T* element, i32 timeoutNs = 0)      { return VZKR_PopFromRawMpmcQueue(queue.raw, (rawptr) element, timeoutNs); }
+}
+#endif
+
+#endif // VZKR_QUEUES_H ============================================================
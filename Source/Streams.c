@@ -0,0 +1,717 @@
+#define VZKR_IMPLEMENTATION
+#include "Streams.h"
+
+// Buffered Stream ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_BUFFERED_STREAM_DEFAULT_SIZE   (64 * 1024)
+#define VZKR_INTERNAL_BUFFERED_STREAM_MIN_READ_AHEAD (4 * 1024)
+
+static i64 VZKR_Internal_BufferedStreamMinReadAhead(VZKR_BufferedStream* stream)
+{
+    i64 size = stream->buffer.count;
+    return size < VZKR_INTERNAL_BUFFERED_STREAM_MIN_READ_AHEAD ? size : VZKR_INTERNAL_BUFFERED_STREAM_MIN_READ_AHEAD;
+}
+
+b8 VZKR_CreateBufferedStream(
+    PNSLR_Stream inner,
+    i32 bufferSize,
+    PNSLR_Allocator allocator,
+    VZKR_BufferedStream* output
+)
+{
+    if (!output || !inner.procedure) return false;
+    *output = (VZKR_BufferedStream) {0};
+    if (bufferSize <= 0) bufferSize = VZKR_INTERNAL_BUFFERED_STREAM_DEFAULT_SIZE;
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    PNSLR_ArraySlice(u8) buffer = PNSLR_MakeSlice(u8, bufferSize, false, allocator, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None) return false;
+
+    output->allocator = allocator;
+    output->inner     = inner;
+    output->buffer    = buffer;
+    output->readAhead = VZKR_Internal_BufferedStreamMinReadAhead(output);
+    return true;
+}
+
+/** Writes out the pending writes, without flushing the underlying stream itself. */
+static b8 VZKR_Internal_BufferedStreamDrainWrites(VZKR_BufferedStream* stream)
+{
+    if (stream->writeCount == 0) return true;
+
+    PNSLR_ArraySlice(u8) pending = {.data = stream->buffer.data, .count = stream->writeCount};
+    stream->writeCount = 0;
+    return PNSLR_WriteToStream(stream->inner, pending);
+}
+
+/**
+ * Throws away the read-ahead data, moving the underlying stream back to where
+ * the reader actually is.
+ */
+static b8 VZKR_Internal_BufferedStreamDropReadAhead(VZKR_BufferedStream* stream)
+{
+    i64 unread = stream->readEnd - stream->readStart;
+    stream->readStart = 0;
+    stream->readEnd   = 0;
+    stream->readAhead = VZKR_Internal_BufferedStreamMinReadAhead(stream);
+    return (unread == 0) || PNSLR_SeekPositionInStream(stream->inner, -unread, true);
+}
+
+/** Gets the underlying stream and the buffer in sync with the logical position. */
+static b8 VZKR_Internal_BufferedStreamSync(VZKR_BufferedStream* stream)
+{
+    if (!VZKR_Internal_BufferedStreamDrainWrites(stream)) return false;
+    return VZKR_Internal_BufferedStreamDropReadAhead(stream);
+}
+
+/** Refills an empty read buffer. Returns the number of bytes read, -1 on failure. */
+static i64 VZKR_Internal_BufferedStreamRefill(VZKR_BufferedStream* stream)
+{
+    // a fully consumed buffer means the reads are sequential, so read further ahead next time
+    if (stream->readEnd > 0 && stream->readStart == stream->readEnd)
+    {
+        i64 grown = stream->readAhead * 2;
+        stream->readAhead = grown < stream->buffer.count ? grown : stream->buffer.count;
+    }
+
+    stream->readStart = 0;
+    stream->readEnd   = 0;
+
+    i64 readSize = 0;
+    PNSLR_ArraySlice(u8) dst = {.data = stream->buffer.data, .count = stream->readAhead};
+    if (!PNSLR_ReadFromStream(stream->inner, dst, &readSize)) return -1;
+
+    stream->readEnd = readSize;
+    return readSize;
+}
+
+static b8 VZKR_Internal_BufferedStreamRead(VZKR_BufferedStream* stream, PNSLR_ArraySlice(u8) dst, i64* readSize)
+{
+    if (!VZKR_Internal_BufferedStreamDrainWrites(stream)) return false;
+
+    i64 copied = 0;
+    while (copied < dst.count)
+    {
+        i64 available = stream->readEnd - stream->readStart;
+        if (available == 0)
+        {
+            i64 remaining = dst.count - copied;
+            if (remaining >= stream->buffer.count)
+            {
+                // big enough to not be worth going through the buffer; the emptied buffer
+                // no longer sits right before the inner position, so seeks can't use it
+                stream->readStart = 0;
+                stream->readEnd   = 0;
+
+                i64 direct = 0;
+                PNSLR_ArraySlice(u8) rest = {.data = dst.data + copied, .count = remaining};
+                if (!PNSLR_ReadFromStream(stream->inner, rest, &direct)) { if (readSize) *readSize = copied; return false; }
+                if (direct == 0) break;
+                copied += direct;
+                continue;
+            }
+
+            i64 refilled = VZKR_Internal_BufferedStreamRefill(stream);
+            if (refilled < 0) { if (readSize) *readSize = copied; return false; }
+            if (refilled == 0) break;
+            available = refilled;
+        }
+
+        i64 count = dst.count - copied;
+        if (count > available) count = available;
+        PNSLR_MemCopy(dst.data + copied, stream->buffer.data + stream->readStart, (i32) count);
+        stream->readStart += count;
+        copied            += count;
+    }
+
+    if (readSize) *readSize = copied;
+    return true;
+}
+
+static b8 VZKR_Internal_BufferedStreamWrite(VZKR_BufferedStream* stream, PNSLR_ArraySlice(u8) src)
+{
+    if (!VZKR_Internal_BufferedStreamDropReadAhead(stream)) return false;
+
+    if (stream->writeCount + src.count > stream->buffer.count)
+    {
+        if (!VZKR_Internal_BufferedStreamDrainWrites(stream)) return false;
+        if (src.count >= stream->buffer.count) return PNSLR_WriteToStream(stream->inner, src);
+    }
+
+    PNSLR_MemCopy(stream->buffer.data + stream->writeCount, src.data, (i32) src.count);
+    stream->writeCount += src.count;
+    return true;
+}
+
+static b8 VZKR_Internal_BufferedStreamSeek(VZKR_BufferedStream* stream, i64 offset, b8 relative)
+{
+    if (!VZKR_Internal_BufferedStreamDrainWrites(stream)) return false;
+
+    // stay inside the read buffer if possible
+    if (stream->readEnd > 0)
+    {
+        i64 target = offset;
+        if (!relative)
+        {
+            i64 innerPos = PNSLR_GetCurrentPositionInStream(stream->inner);
+            if (innerPos < 0) return false;
+            target = offset - (innerPos - stream->readEnd) - stream->readStart;
+        }
+
+        i64 newStart = stream->readStart + target;
+        if (newStart >= 0 && newStart <= stream->readEnd)
+        {
+            stream->readStart = newStart;
+            return true;
+        }
+    }
+
+    if (!VZKR_Internal_BufferedStreamDropReadAhead(stream)) return false;
+    return PNSLR_SeekPositionInStream(stream->inner, offset, relative);
+}
+
+static b8 VZKR_Internal_BufferedStreamProc(
+    rawptr streamData,
+    PNSLR_StreamMode mode,
+    PNSLR_ArraySlice(u8) data,
+    i64 offset,
+    i64* extraRet
+)
+{
+    VZKR_BufferedStream* stream = (VZKR_BufferedStream*) streamData;
+    if (!stream || !stream->buffer.data) return false;
+
+    switch (mode)
+    {
+        case PNSLR_StreamMode_GetSize:
+        {
+            if (!VZKR_Internal_BufferedStreamDrainWrites(stream)) return false;
+            i64 size = PNSLR_GetSizeOfStream(stream->inner);
+            if (extraRet) *extraRet = size;
+            return true;
+        }
+        case PNSLR_StreamMode_GetCurrentPos:
+        {
+            i64 innerPos = PNSLR_GetCurrentPositionInStream(stream->inner);
+            if (innerPos < 0) return false;
+            if (extraRet) *extraRet = innerPos - (stream->readEnd - stream->readStart) + stream->writeCount;
+            return true;
+        }
+        case PNSLR_StreamMode_SeekAbsolute:
+        case PNSLR_StreamMode_SeekRelative:
+            return VZKR_Internal_BufferedStreamSeek(stream, offset, mode == PNSLR_StreamMode_SeekRelative);
+        case PNSLR_StreamMode_Read:
+            return VZKR_Internal_BufferedStreamRead(stream, data, extraRet);
+        case PNSLR_StreamMode_Write:
+            return VZKR_Internal_BufferedStreamWrite(stream, data);
+        case PNSLR_StreamMode_Truncate:
+            if (!VZKR_Internal_BufferedStreamSync(stream)) return false;
+            return PNSLR_TruncateStream(stream->inner, offset);
+        case PNSLR_StreamMode_Flush:
+            if (!VZKR_Internal_BufferedStreamDrainWrites(stream)) return false;
+            return PNSLR_FlushStream(stream->inner);
+        case PNSLR_StreamMode_Close:
+        {
+            b8 success = VZKR_Internal_BufferedStreamDrainWrites(stream);
+            PNSLR_CloseStream(stream->inner);
+            PNSLR_FreeSlice(&stream->buffer, stream->allocator, PNSLR_GET_LOC(), nil);
+            *stream = (VZKR_BufferedStream) {0};
+            return success;
+        }
+        default:
+            return false;
+    }
+}
+
+PNSLR_Stream VZKR_StreamFromBufferedStream(VZKR_BufferedStream* stream)
+{
+    return (PNSLR_Stream) {.procedure = VZKR_Internal_BufferedStreamProc, .data = (rawptr) stream};
+}
+
+b8 VZKR_PeekBufferedStream(
+    VZKR_BufferedStream* stream,
+    i64 minCount,
+    PNSLR_ArraySlice(u8)* output
+)
+{
+    if (!stream || !stream->buffer.data || !output) return false;
+    *output = (PNSLR_ArraySlice(u8)) {0};
+    if (!VZKR_Internal_BufferedStreamDrainWrites(stream)) return false;
+    if (minCount > stream->buffer.count) minCount = stream->buffer.count;
+
+    if (stream->readEnd - stream->readStart < minCount)
+    {
+        // move what's left to the front, and fill the rest of the buffer
+        i64 unread = stream->readEnd - stream->readStart;
+        if (unread > 0 && stream->readStart > 0)
+        {
+            PNSLR_MemMove(stream->buffer.data, stream->buffer.data + stream->readStart, (i32) unread);
+        }
+
+        stream->readStart = 0;
+        stream->readEnd   = unread;
+
+        while (stream->readEnd < minCount)
+        {
+            i64 readSize = 0;
+            PNSLR_ArraySlice(u8) dst = {.data = stream->buffer.data + stream->readEnd, .count = stream->buffer.count - stream->readEnd};
+            if (!PNSLR_ReadFromStream(stream->inner, dst, &readSize)) return false;
+            if (readSize == 0) break;
+            stream->readEnd += readSize;
+        }
+    }
+
+    output->data  = stream->buffer.data + stream->readStart;
+    output->count = stream->readEnd - stream->readStart;
+    return true;
+}
+
+void VZKR_ConsumeBufferedStream(VZKR_BufferedStream* stream, i64 count)
+{
+    if (!stream || count <= 0) return;
+
+    i64 available = stream->readEnd - stream->readStart;
+    stream->readStart += (count < available) ? count : available;
+}
+
+// Memory Stream ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+VZKR_MemoryStream VZKR_CreateMemoryStream(PNSLR_ArraySlice(u8) data)
+{
+    return (VZKR_MemoryStream) {.data = data, .position = 0};
+}
+
+static b8 VZKR_Internal_MemoryStreamProc(
+    rawptr streamData,
+    PNSLR_StreamMode mode,
+    PNSLR_ArraySlice(u8) data,
+    i64 offset,
+    i64* extraRet
+)
+{
+    VZKR_MemoryStream* stream = (VZKR_MemoryStream*) streamData;
+    if (!stream) return false;
+
+    i64 total = stream->data.count;
+
+    switch (mode)
+    {
+        case PNSLR_StreamMode_GetSize:
+            if (extraRet) *extraRet = total;
+            return true;
+        case PNSLR_StreamMode_GetCurrentPos:
+            if (extraRet) *extraRet = stream->position;
+            return true;
+        case PNSLR_StreamMode_SeekAbsolute:
+        case PNSLR_StreamMode_SeekRelative:
+        {
+            i64 newPos = (mode == PNSLR_StreamMode_SeekRelative) ? stream->position + offset : offset;
+            if (newPos < 0 || newPos > total) return false;
+            stream->position = newPos;
+            return true;
+        }
+        case PNSLR_StreamMode_Read:
+        {
+            i64 count = total - stream->position;
+            if (count > data.count) count = data.count;
+            VZKR_Internal_CopyBytes(data.data, stream->data.data + stream->position, count);
+            stream->position += count;
+            if (extraRet) *extraRet = count;
+            return true;
+        }
+        case PNSLR_StreamMode_Flush:
+            return true;
+        case PNSLR_StreamMode_Close:
+            *stream = (VZKR_MemoryStream) {0};
+            return true;
+        default: // read-only
+            return false;
+    }
+}
+
+PNSLR_Stream VZKR_StreamFromMemoryStream(VZKR_MemoryStream* stream)
+{
+    return (PNSLR_Stream) {.procedure = VZKR_Internal_MemoryStreamProc, .data = (rawptr) stream};
+}
+
+b8 VZKR_ReadMemoryStreamView(
+    VZKR_MemoryStream* stream,
+    i64 count,
+    PNSLR_ArraySlice(u8)* output
+)
+{
+    if (!stream || !output || count < 0) return false;
+
+    i64 available = stream->data.count - stream->position;
+    if (count > available) count = available;
+
+    output->data      = stream->data.data + stream->position;
+    output->count     = count;
+    stream->position += count;
+    return true;
+}
+
+// Pipes ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_PIPE_DEFAULT_CAPACITY (64 * 1024)
+#define VZKR_INTERNAL_PIPE_MAX_CAPACITY     (1 << 30)
+
+/**
+ * The positions only ever grow, and wrap around the buffer with 'mask'.
+ * 'readPos' is only written by the reading end and 'writePos' by the writing end, each
+ * on its own cache line so the two ends don't keep stealing it from each other.
+ * The mutex/condition variable are only used to sleep and wake up.
+ */
+typedef struct VZKR_Internal_Pipe
+{
+    u64 readPos;
+    u64 readerWaiting;
+    u64 readerClosed;
+    VZKR_CACHE_LINE_PADDING(readPadding, 24);
+    u64 writePos;
+    u64 writerWaiting;
+    u64 writerClosed;
+    VZKR_CACHE_LINE_PADDING(writePadding, 24);
+    u64 numClosedEnds;
+    u64 mask;
+    u8* buffer;
+    VZKR_PipeMode mode;
+    PNSLR_Allocator allocator;
+    VZKR_ProfiledMutex mutex;
+    PNSLR_ConditionVariable wakeUp;
+} VZKR_Internal_Pipe;
+
+// everything shared between the ends is sequentially consistent, so a sleeping end never
+// misses the other one making progress (it either sees the progress, or gets woken up)
+
+/** Whether the reading end can make progress: there's data, or there's never going to be. */
+static b8 VZKR_Internal_PipeCanRead(VZKR_Internal_Pipe* pipe)
+{
+    return VZKR_AtomicLoadU64(&pipe->writerClosed, VZKR_MemoryOrder_SequentiallyConsistent) || VZKR_AtomicLoadU64(&pipe->writePos, VZKR_MemoryOrder_SequentiallyConsistent) != pipe->readPos;
+}
+
+/** Whether the writing end can make progress: there's space, or the data would go nowhere. */
+static b8 VZKR_Internal_PipeCanWrite(VZKR_Internal_Pipe* pipe)
+{
+    return VZKR_AtomicLoadU64(&pipe->readerClosed, VZKR_MemoryOrder_SequentiallyConsistent) || pipe->writePos - VZKR_AtomicLoadU64(&pipe->readPos, VZKR_MemoryOrder_SequentiallyConsistent) <= pipe->mask;
+}
+
+/** Whether the reading end has caught up with everything written, or never will. */
+static b8 VZKR_Internal_PipeIsDrained(VZKR_Internal_Pipe* pipe)
+{
+    return VZKR_AtomicLoadU64(&pipe->readerClosed, VZKR_MemoryOrder_SequentiallyConsistent) || VZKR_AtomicLoadU64(&pipe->readPos, VZKR_MemoryOrder_SequentiallyConsistent) == pipe->writePos;
+}
+
+/**
+ * Sleeps until the other end may have made 'ready' true, or the deadline (if 'timeoutNs'
+ * isn't negative) passes. Can wake up early.
+ * Returns false once the deadline has passed.
+ */
+static b8 VZKR_Internal_PipeSleep(VZKR_Internal_Pipe* pipe, b8 reader, b8 (*ready)(VZKR_Internal_Pipe*), i32 timeoutNs, i64 deadline)
+{
+    u64* waiting = reader ? &pipe->readerWaiting : &pipe->writerWaiting;
+
+    i64 remaining = 0;
+    if (timeoutNs >= 0)
+    {
+        remaining = deadline - VZKR_GetMonotonicTime();
+        if (remaining <= 0) return false;
+    }
+
+    VZKR_LockProfiledMutex(&pipe->mutex);
+    VZKR_AtomicStoreU64(waiting, 1, VZKR_MemoryOrder_SequentiallyConsistent);
+
+    // check again now that the other end is bound to see this one waiting
+    if (!ready(pipe))
+    {
+        if (timeoutNs < 0) VZKR_WaitProfiledConditionVariable(&pipe->wakeUp, &pipe->mutex);
+        else               VZKR_WaitProfiledConditionVariableTimeout(&pipe->wakeUp, &pipe->mutex, (i32) remaining);
+    }
+
+    VZKR_AtomicStoreU64(waiting, 0, VZKR_MemoryOrder_SequentiallyConsistent);
+    VZKR_UnlockProfiledMutex(&pipe->mutex);
+    return true;
+}
+
+/** Wakes up the other end, if it's asleep. */
+static void VZKR_Internal_PipeWake(VZKR_Internal_Pipe* pipe, b8 reader, b8 force)
+{
+    if (!force && !VZKR_AtomicLoadU64(reader ? &pipe->readerWaiting : &pipe->writerWaiting, VZKR_MemoryOrder_SequentiallyConsistent)) return;
+
+    VZKR_LockProfiledMutex(&pipe->mutex);
+    PNSLR_BroadcastConditionVariable(&pipe->wakeUp);
+    VZKR_UnlockProfiledMutex(&pipe->mutex);
+}
+
+static void VZKR_Internal_PipeCloseEnd(VZKR_Internal_Pipe* pipe, b8 reader)
+{
+    u64* closed = reader ? &pipe->readerClosed : &pipe->writerClosed;
+    if (VZKR_AtomicLoadU64(closed, VZKR_MemoryOrder_SequentiallyConsistent)) return;
+
+    VZKR_AtomicStoreU64(closed, 1, VZKR_MemoryOrder_SequentiallyConsistent);
+    VZKR_Internal_PipeWake(pipe, !reader, true);
+
+    // the last end out frees everything
+    if (VZKR_AtomicFetchAddU64(&pipe->numClosedEnds, 1, VZKR_MemoryOrder_SequentiallyConsistent) == 0) return;
+
+    PNSLR_DestroyConditionVariable(&pipe->wakeUp);
+    VZKR_DestroyProfiledMutex(&pipe->mutex);
+    PNSLR_Allocator allocator = pipe->allocator;
+    PNSLR_Free(allocator, pipe->buffer, PNSLR_GET_LOC(), nil);
+    PNSLR_Free(allocator, pipe, PNSLR_GET_LOC(), nil);
+}
+
+VZKR_Pipe VZKR_CreatePipe(
+    i32 capacity,
+    VZKR_PipeMode mode,
+    PNSLR_Allocator allocator
+)
+{
+    if (capacity <= 0) capacity = VZKR_INTERNAL_PIPE_DEFAULT_CAPACITY;
+    if (capacity > VZKR_INTERNAL_PIPE_MAX_CAPACITY) return (VZKR_Pipe) {0};
+
+    i32 rounded = 1;
+    while (rounded < capacity) rounded <<= 1;
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_Pipe* pipe = (VZKR_Internal_Pipe*) PNSLR_Allocate(allocator, true, (i32) sizeof(VZKR_Internal_Pipe), VZKR_CACHE_LINE_SIZE, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !pipe) return (VZKR_Pipe) {0};
+
+    pipe->buffer = (u8*) PNSLR_Allocate(allocator, false, rounded, VZKR_CACHE_LINE_SIZE, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !pipe->buffer)
+    {
+        PNSLR_Free(allocator, pipe, PNSLR_GET_LOC(), nil);
+        return (VZKR_Pipe) {0};
+    }
+
+    pipe->mask      = (u64) rounded - 1;
+    pipe->mode      = mode;
+    pipe->allocator = allocator;
+    pipe->mutex     = VZKR_CreateProfiledMutex(PNSLR_GET_LOC());
+    pipe->wakeUp    = PNSLR_CreateConditionVariable();
+    return (VZKR_Pipe) {.handle = (rawptr) pipe};
+}
+
+/** Copies out whatever can be read right now, without waiting. */
+static i64 VZKR_Internal_PipeReadAvailable(VZKR_Internal_Pipe* pipe, u8* dst, i64 count)
+{
+    u64 readPos   = pipe->readPos;
+    u64 available = VZKR_AtomicLoadU64(&pipe->writePos, VZKR_MemoryOrder_SequentiallyConsistent) - readPos;
+    if ((u64) count > available) count = (i64) available;
+    if (count == 0) return 0;
+
+    u64 start = readPos & pipe->mask;
+    u64 first = pipe->mask + 1 - start;
+    if (first > (u64) count) first = (u64) count;
+
+    if (dst)
+    {
+        PNSLR_MemCopy(dst, pipe->buffer + start, (i32) first);
+        if ((u64) count > first) PNSLR_MemCopy(dst + first, pipe->buffer, (i32) ((u64) count - first));
+    }
+
+    VZKR_AtomicStoreU64(&pipe->readPos, readPos + (u64) count, VZKR_MemoryOrder_SequentiallyConsistent);
+    VZKR_Internal_PipeWake(pipe, false, false);
+    return count;
+}
+
+/** Copies in whatever fits right now, without waiting. */
+static i64 VZKR_Internal_PipeWriteAvailable(VZKR_Internal_Pipe* pipe, const u8* src, i64 count)
+{
+    u64 writePos = pipe->writePos;
+    u64 space    = pipe->mask + 1 - (writePos - VZKR_AtomicLoadU64(&pipe->readPos, VZKR_MemoryOrder_SequentiallyConsistent));
+    if ((u64) count > space) count = (i64) space;
+    if (count == 0) return 0;
+
+    u64 start = writePos & pipe->mask;
+    u64 first = pipe->mask + 1 - start;
+    if (first > (u64) count) first = (u64) count;
+
+    PNSLR_MemCopy(pipe->buffer + start, (rawptr) src, (i32) first);
+    if ((u64) count > first) PNSLR_MemCopy(pipe->buffer, (rawptr) (src + first), (i32) ((u64) count - first));
+
+    VZKR_AtomicStoreU64(&pipe->writePos, writePos + (u64) count, VZKR_MemoryOrder_SequentiallyConsistent);
+    VZKR_Internal_PipeWake(pipe, true, false);
+    return count;
+}
+
+/** Reads into 'dst' (or just skips, if nil), returning once anything was read. */
+static b8 VZKR_Internal_PipeRead(VZKR_Internal_Pipe* pipe, u8* dst, i64 count, i32 timeoutNs, i64* readSize)
+{
+    if (readSize) *readSize = 0;
+    if (VZKR_AtomicLoadU64(&pipe->readerClosed, VZKR_MemoryOrder_SequentiallyConsistent)) return false;
+    if (count <= 0) return true;
+
+    i64 deadline = (timeoutNs > 0) ? VZKR_GetMonotonicTime() + timeoutNs : 0;
+    while (true)
+    {
+        // see the writer closing first, so anything written before that isn't missed
+        b8 ended = VZKR_AtomicLoadU64(&pipe->writerClosed, VZKR_MemoryOrder_SequentiallyConsistent);
+
+        i64 numRead = VZKR_Internal_PipeReadAvailable(pipe, dst, count);
+        if (numRead > 0 || ended || timeoutNs == 0)
+        {
+            if (readSize) *readSize = numRead;
+            return true;
+        }
+
+        if (!VZKR_Internal_PipeSleep(pipe, true, VZKR_Internal_PipeCanRead, timeoutNs, deadline)) return true;
+    }
+}
+
+static b8 VZKR_Internal_PipeWrite(VZKR_Internal_Pipe* pipe, const u8* src, i64 count, i32 timeoutNs, i64* writtenSize)
+{
+    if (writtenSize) *writtenSize = 0;
+    if (VZKR_AtomicLoadU64(&pipe->writerClosed, VZKR_MemoryOrder_SequentiallyConsistent)) return false;
+
+    i64 deadline = (timeoutNs > 0) ? VZKR_GetMonotonicTime() + timeoutNs : 0;
+    i64 written  = 0;
+    while (true)
+    {
+        if (VZKR_AtomicLoadU64(&pipe->readerClosed, VZKR_MemoryOrder_SequentiallyConsistent)) break;
+
+        written += VZKR_Internal_PipeWriteAvailable(pipe, src + written, count - written);
+        if (written == count || timeoutNs == 0 || !VZKR_Internal_PipeSleep(pipe, false, VZKR_Internal_PipeCanWrite, timeoutNs, deadline))
+        {
+            if (writtenSize) *writtenSize = written;
+            return true;
+        }
+    }
+
+    if (writtenSize) *writtenSize = written;
+    return false;
+}
+
+static b8 VZKR_Internal_PipeReaderStreamProc(
+    rawptr streamData,
+    PNSLR_StreamMode mode,
+    PNSLR_ArraySlice(u8) data,
+    i64 offset,
+    i64* extraRet
+)
+{
+    VZKR_Internal_Pipe* pipe = (VZKR_Internal_Pipe*) streamData;
+    if (!pipe) return false;
+
+    i32 timeoutNs = (pipe->mode == VZKR_PipeMode_Blocking) ? -1 : 0;
+
+    switch (mode)
+    {
+        case PNSLR_StreamMode_GetSize: // everything written so far
+            if (extraRet) *extraRet = (i64) VZKR_AtomicLoadU64(&pipe->writePos, VZKR_MemoryOrder_SequentiallyConsistent);
+            return true;
+        case PNSLR_StreamMode_GetCurrentPos:
+            if (extraRet) *extraRet = (i64) pipe->readPos;
+            return true;
+        case PNSLR_StreamMode_SeekAbsolute:
+        case PNSLR_StreamMode_SeekRelative:
+        {
+            i64 skip = (mode == PNSLR_StreamMode_SeekRelative) ? offset : offset - (i64) pipe->readPos;
+            if (skip < 0) return false;
+
+            while (skip > 0)
+            {
+                i64 skipped = 0;
+                if (!VZKR_Internal_PipeRead(pipe, nil, skip, timeoutNs, &skipped) || skipped == 0) return false;
+                skip -= skipped;
+            }
+
+            return true;
+        }
+        case PNSLR_StreamMode_Read:
+            return VZKR_Internal_PipeRead(pipe, data.data, data.count, timeoutNs, extraRet);
+        case PNSLR_StreamMode_Flush:
+            return true;
+        case PNSLR_StreamMode_Close:
+            VZKR_Internal_PipeCloseEnd(pipe, true);
+            return true;
+        default:
+            return false;
+    }
+}
+
+static b8 VZKR_Internal_PipeWriterStreamProc(
+    rawptr streamData,
+    PNSLR_StreamMode mode,
+    PNSLR_ArraySlice(u8) data,
+    i64 offset,
+    i64* extraRet
+)
+{
+    (void) offset; // the write end can't seek
+
+    VZKR_Internal_Pipe* pipe = (VZKR_Internal_Pipe*) streamData;
+    if (!pipe) return false;
+
+    switch (mode)
+    {
+        case PNSLR_StreamMode_GetSize:
+        case PNSLR_StreamMode_GetCurrentPos:
+            if (extraRet) *extraRet = (i64) pipe->writePos;
+            return true;
+        case PNSLR_StreamMode_Write:
+        {
+            if (pipe->mode == VZKR_PipeMode_Blocking) return VZKR_Internal_PipeWrite(pipe, data.data, data.count, -1, nil);
+
+            // all or nothing, as there's no way to say how much was written
+            if (VZKR_AtomicLoadU64(&pipe->writerClosed, VZKR_MemoryOrder_SequentiallyConsistent) || VZKR_AtomicLoadU64(&pipe->readerClosed, VZKR_MemoryOrder_SequentiallyConsistent)) return false;
+            if ((u64) data.count > pipe->mask + 1 - (pipe->writePos - VZKR_AtomicLoadU64(&pipe->readPos, VZKR_MemoryOrder_SequentiallyConsistent))) return false;
+            return VZKR_Internal_PipeWrite(pipe, data.data, data.count, 0, nil);
+        }
+        case PNSLR_StreamMode_Flush:
+        {
+            if (pipe->mode != VZKR_PipeMode_Blocking) return true;
+
+            // wait for the reader to catch up, so the pipe ends up empty
+            while (!VZKR_Internal_PipeIsDrained(pipe)) { VZKR_Internal_PipeSleep(pipe, false, VZKR_Internal_PipeIsDrained, -1, 0); }
+            return !VZKR_AtomicLoadU64(&pipe->readerClosed, VZKR_MemoryOrder_SequentiallyConsistent) || VZKR_AtomicLoadU64(&pipe->readPos, VZKR_MemoryOrder_SequentiallyConsistent) == pipe->writePos;
+        }
+        case PNSLR_StreamMode_Close:
+            VZKR_Internal_PipeCloseEnd(pipe, false);
+            return true;
+        default:
+            return false;
+    }
+}
+
+PNSLR_Stream VZKR_StreamFromPipeReader(VZKR_Pipe pipe)
+{
+    return (PNSLR_Stream) {.procedure = VZKR_Internal_PipeReaderStreamProc, .data = pipe.handle};
+}
+
+PNSLR_Stream VZKR_StreamFromPipeWriter(VZKR_Pipe pipe)
+{
+    return (PNSLR_Stream) {.procedure = VZKR_Internal_PipeWriterStreamProc, .data = pipe.handle};
+}
+
+b8 VZKR_ReadFromPipe(
+    VZKR_Pipe pipe,
+    PNSLR_ArraySlice(u8) dst,
+    i32 timeoutNs,
+    i64* readSize
+)
+{
+    if (readSize) *readSize = 0;
+    if (!pipe.handle) return false;
+    return VZKR_Internal_PipeRead((VZKR_Internal_Pipe*) pipe.handle, dst.data, dst.count, timeoutNs, readSize);
+}
+
+b8 VZKR_WriteToPipe(
+    VZKR_Pipe pipe,
+    PNSLR_ArraySlice(u8) src,
+    i32 timeoutNs,
+    i64* writtenSize
+)
+{
+    if (writtenSize) *writtenSize = 0;
+    if (!pipe.handle) return false;
+    return VZKR_Internal_PipeWrite((VZKR_Internal_Pipe*) pipe.handle, src.data, src.count, timeoutNs, writtenSize);
+}
+
+b8 VZKR_HasPipeEnded(VZKR_Pipe pipe)
+{
+    VZKR_Internal_Pipe* internal = (VZKR_Internal_Pipe*) pipe.handle;
+    if (!internal) return true;
+
+    return VZKR_AtomicLoadU64(&internal->writerClosed, VZKR_MemoryOrder_SequentiallyConsistent) && VZKR_AtomicLoadU64(&internal->writePos, VZKR_MemoryOrder_SequentiallyConsistent) == internal->readPos;
+}
@@ -0,0 +1,216 @@
+#ifndef VZKR_STREAMS_H // ==========================================================
+#define VZKR_STREAMS_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Buffered Stream ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Wraps another stream with a buffer, so lots of small reads/writes turn into a few
+ * large ones on the underlying stream.
+ *
+ * The buffer holds either read-ahead data or pending writes, never both. Read-ahead
+ * starts small and doubles for as long as reads stay sequential, up to the buffer size;
+ * seeking resets it. Reads and writes at least as big as the buffer skip it entirely.
+ * Pending writes go out when the buffer fills up, on flush, seek, and close.
+ *
+ * Create with `VZKR_CreateBufferedStream`. Closing the stream flushes it, closes the
+ * underlying stream and frees the buffer. Not thread-safe.
+ */
+typedef struct VZKR_BufferedStream
+{
+    PNSLR_Allocator allocator;
+    PNSLR_Stream inner;
+    PNSLR_ArraySlice(u8) buffer;
+    i64 readStart;
+    i64 readEnd;
+    i64 writeCount;
+    i64 readAhead;
+} VZKR_BufferedStream;
+
+/**
+ * Creates a buffered stream over another stream, with a buffer of 'bufferSize' bytes
+ * (64KiB if not positive) allocated from the provided allocator.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_CreateBufferedStream(
+    PNSLR_Stream inner,
+    i32 bufferSize,
+    PNSLR_Allocator allocator,
+    VZKR_BufferedStream* output
+);
+
+/**
+ * Creates a stream that reads/writes through a buffered stream.
+ * The buffered stream must outlive the returned stream.
+ */
+PNSLR_Stream VZKR_StreamFromBufferedStream(
+    VZKR_BufferedStream* stream
+);
+
+/**
+ * Makes sure at least 'minCount' bytes (capped to the buffer size) are buffered, unless
+ * the stream ends first, then gives a view of everything buffered so far without copying.
+ * The view stays valid until the next operation on the stream.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_PeekBufferedStream(
+    VZKR_BufferedStream* stream,
+    i64 minCount,
+    PNSLR_ArraySlice(u8)* output
+);
+
+/**
+ * Skips over bytes that were looked at with `VZKR_PeekBufferedStream`.
+ * Can't skip more than what's buffered.
+ */
+void VZKR_ConsumeBufferedStream(
+    VZKR_BufferedStream* stream,
+    i64 count
+);
+
+// Memory Stream ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A read-only, seekable stream over data that's already in memory (a slice, the 'data'
+ * of a file mapping, a zip entry view), so code written against streams can parse it
+ * without copying it anywhere first.
+ *
+ * The data isn't owned by the stream, and must outlive it; closing the stream only
+ * resets it. Not thread-safe, but any number of memory streams can read the same data.
+ */
+typedef struct VZKR_MemoryStream
+{
+    PNSLR_ArraySlice(u8) data;
+    i64 position;
+} VZKR_MemoryStream;
+
+/**
+ * Creates a memory stream over some data, positioned at its start.
+ */
+VZKR_MemoryStream VZKR_CreateMemoryStream(
+    PNSLR_ArraySlice(u8) data
+);
+
+/**
+ * Creates a stream that reads through a memory stream.
+ * The memory stream must outlive the returned stream.
+ */
+PNSLR_Stream VZKR_StreamFromMemoryStream(
+    VZKR_MemoryStream* stream
+);
+
+/**
+ * Reads up to 'count' bytes by giving a view of them, instead of copying them out.
+ * The view is shorter only if the data ends first, and stays valid as long as the data.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_ReadMemoryStreamView(
+    VZKR_MemoryStream* stream,
+    i64 count,
+    PNSLR_ArraySlice(u8)* output
+);
+
+// Pipes ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A cross-platform opaque handle to an in-process pipe: a fixed-size ring buffer with
+ * one thread writing into it and another one reading out of it, like a reader thread
+ * feeding a parser thread.
+ *
+ * Both ends only ever touch their own position, so data goes through without any locks;
+ * a thread only takes a lock to go to sleep when its end can't make progress, and the
+ * other end only takes it to wake it back up.
+ *
+ * Each end is closed on its own, and the pipe is freed once both are. Once the writing
+ * end is closed, reads drain what's left and then see the end of the stream. Once the
+ * reading end is closed, writes fail.
+ */
+typedef struct VZKR_Pipe
+{
+    rawptr handle;
+} VZKR_Pipe;
+
+/**
+ * How the streams over a pipe behave when their end can't make progress.
+ * Blocking reads wait until there's at least something to read, and blocking writes
+ * until everything is written.
+ * Non-blocking reads return whatever is there, possibly nothing (so use
+ * `VZKR_HasPipeEnded` to tell an empty pipe apart from the end of the stream), and
+ * non-blocking writes fail without writing anything if everything doesn't fit.
+ */
+typedef u8 VZKR_PipeMode /* use as value */;
+#define VZKR_PipeMode_Blocking ((VZKR_PipeMode) 0)
+#define VZKR_PipeMode_NonBlocking ((VZKR_PipeMode) 1)
+
+/**
+ * Creates a pipe holding up to 'capacity' bytes (rounded up to a power of two, 64KiB if
+ * not positive), allocated from the provided allocator.
+ * The allocator must be thread-safe, since the pipe is freed by whichever end closes last.
+ * If creating failed, the returned handle will be zeroed.
+ */
+VZKR_Pipe VZKR_CreatePipe(
+    i32 capacity,
+    VZKR_PipeMode mode,
+    PNSLR_Allocator allocator
+);
+
+/**
+ * Creates a stream that reads from a pipe. Only one thread may read from a pipe.
+ * Seeking can only skip forward. Closing the stream closes the reading end.
+ */
+PNSLR_Stream VZKR_StreamFromPipeReader(
+    VZKR_Pipe pipe
+);
+
+/**
+ * Creates a stream that writes to a pipe. Only one thread may write to a pipe.
+ * Flushing waits until everything has been read (blocking mode only).
+ * Closing the stream closes the writing end.
+ */
+PNSLR_Stream VZKR_StreamFromPipeWriter(
+    VZKR_Pipe pipe
+);
+
+/**
+ * Reads from a pipe, waiting up to a timeout for there to be something to read;
+ * a timeout of zero doesn't wait at all, a negative one waits indefinitely.
+ * Optionally stores the number of bytes read, which is zero on timeout, and at the end.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_ReadFromPipe(
+    VZKR_Pipe pipe,
+    PNSLR_ArraySlice(u8) dst,
+    i32 timeoutNs,
+    i64* readSize
+);
+
+/**
+ * Writes to a pipe, waiting up to a timeout for there to be space for everything;
+ * a timeout of zero doesn't wait at all, a negative one waits indefinitely.
+ * Optionally stores the number of bytes written, which is less than asked for on timeout.
+ * Returns true on success, false if the reading end has been closed.
+ */
+b8 VZKR_WriteToPipe(
+    VZKR_Pipe pipe,
+    PNSLR_ArraySlice(u8) src,
+    i32 timeoutNs,
+    i64* writtenSize
+);
+
+/**
+ * Checks whether the writing end of a pipe has been closed, and everything written has
+ * been read.
+ */
+b8 VZKR_HasPipeEnded(
+    VZKR_Pipe pipe
+);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_STREAMS_H ===========================================================
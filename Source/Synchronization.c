@@ -0,0 +1,341 @@
+#define VZKR_IMPLEMENTATION
+#include "Synchronization.h"
+
+// Waiting On Addresses ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#if PNSLR_WINDOWS && defined(_MSC_VER)
+    #pragma comment(lib, "Synchronization.lib") // WaitOnAddress and friends
+#elif PNSLR_OSX || PNSLR_IOS
+    // not in the SDK's headers, but what libc++ waits on atomics with
+    extern int __ulock_wait(u32 operation, void* address, u64 value, u32 timeoutUs);
+    extern int __ulock_wake(u32 operation, void* address, u64 wakeValue);
+
+    #define VZKR_INTERNAL_ULOCK_COMPARE_AND_WAIT 0x00000001u
+    #define VZKR_INTERNAL_ULOCK_WAKE_ALL         0x00000100u
+    #define VZKR_INTERNAL_ULOCK_NO_ERRNO         0x01000000u
+#endif
+
+/** Sleeps while the value at the address is still what's expected. Can wake up spuriously. */
+static void VZKR_Internal_WaitOnAddress(u32* address, u32 expected)
+{
+    #if PNSLR_WINDOWS
+        WaitOnAddress((volatile VOID*) address, &expected, sizeof(u32), INFINITE);
+    #elif PNSLR_LINUX
+        syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, nil, nil, 0);
+    #elif PNSLR_OSX || PNSLR_IOS
+        __ulock_wait(VZKR_INTERNAL_ULOCK_COMPARE_AND_WAIT | VZKR_INTERNAL_ULOCK_NO_ERRNO, address, expected, 0);
+    #else
+        (void) address; (void) expected;
+        VZKR_YieldThread();
+    #endif
+}
+
+static void VZKR_Internal_WakeOnAddress(u32* address, b8 all)
+{
+    #if PNSLR_WINDOWS
+        if (all) WakeByAddressAll((PVOID) address);
+        else     WakeByAddressSingle((PVOID) address);
+    #elif PNSLR_LINUX
+        syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, all ? 0x7FFFFFFF : 1, nil, nil, 0);
+    #elif PNSLR_OSX || PNSLR_IOS
+        __ulock_wake(VZKR_INTERNAL_ULOCK_COMPARE_AND_WAIT | VZKR_INTERNAL_ULOCK_NO_ERRNO | (all ? VZKR_INTERNAL_ULOCK_WAKE_ALL : 0), address, 0);
+    #else
+        (void) address; (void) all;
+    #endif
+}
+
+// Fast Mutex ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// the low bits say whether it's held, and whether anyone might be asleep waiting for it;
+// the high half keeps a running average of how many spins it took to get it lately
+
+#define VZKR_INTERNAL_FAST_MUTEX_LOCKED     0x00000001u
+#define VZKR_INTERNAL_FAST_MUTEX_SLEEPERS   0x00000002u
+#define VZKR_INTERNAL_FAST_MUTEX_SPIN_SHIFT 16
+#define VZKR_INTERNAL_FAST_MUTEX_MIN_SPINS  16
+#define VZKR_INTERNAL_FAST_MUTEX_MAX_SPINS  512
+
+/** Holder only, so the estimate never changes under it. */
+static void VZKR_Internal_FastMutexUpdateSpins(VZKR_FastMutex* mutex, i32 numSpins)
+{
+    i32 estimate = (i32) (VZKR_AtomicLoadU32(&mutex->state, VZKR_MemoryOrder_Acquire) >> VZKR_INTERNAL_FAST_MUTEX_SPIN_SHIFT);
+    i32 delta    = (numSpins - estimate) / 8;
+    if (delta != 0) VZKR_AtomicFetchAddU32(&mutex->state, (u32) delta << VZKR_INTERNAL_FAST_MUTEX_SPIN_SHIFT, VZKR_MemoryOrder_Relaxed);
+}
+
+static void VZKR_Internal_LockFastMutexSlow(VZKR_FastMutex* mutex)
+{
+    // spin for up to twice as long as it usually takes, in case it's about to be let go
+    i32 estimate = (i32) (VZKR_AtomicLoadU32(&mutex->state, VZKR_MemoryOrder_Acquire) >> VZKR_INTERNAL_FAST_MUTEX_SPIN_SHIFT);
+    i32 maxSpins = estimate * 2 + VZKR_INTERNAL_FAST_MUTEX_MIN_SPINS;
+    if (maxSpins > VZKR_INTERNAL_FAST_MUTEX_MAX_SPINS) maxSpins = VZKR_INTERNAL_FAST_MUTEX_MAX_SPINS;
+
+    for (i32 i = 0; i < maxSpins; i++)
+    {
+        VZKR_CpuRelax();
+
+        u32 state = VZKR_AtomicLoadU32(&mutex->state, VZKR_MemoryOrder_Acquire);
+        if (!(state & VZKR_INTERNAL_FAST_MUTEX_LOCKED) && VZKR_AtomicCompareExchangeU32(&mutex->state, &state, state | VZKR_INTERNAL_FAST_MUTEX_LOCKED, VZKR_MemoryOrder_Acquire))
+        {
+            VZKR_Internal_FastMutexUpdateSpins(mutex, i);
+            return;
+        }
+    }
+
+    // marking it as having sleepers even when taking it means an extra wake-up now and
+    // then, but never a missed one
+    for (;;)
+    {
+        u32 previous = VZKR_AtomicFetchOrU32(&mutex->state, VZKR_INTERNAL_FAST_MUTEX_LOCKED | VZKR_INTERNAL_FAST_MUTEX_SLEEPERS, VZKR_MemoryOrder_Acquire);
+        if (!(previous & VZKR_INTERNAL_FAST_MUTEX_LOCKED)) break;
+
+        VZKR_Internal_WaitOnAddress(&mutex->state, previous | VZKR_INTERNAL_FAST_MUTEX_LOCKED | VZKR_INTERNAL_FAST_MUTEX_SLEEPERS);
+    }
+
+    VZKR_Internal_FastMutexUpdateSpins(mutex, maxSpins);
+}
+
+void VZKR_LockFastMutex(VZKR_FastMutex* mutex)
+{
+    if (!mutex) return;
+
+    if (VZKR_TryLockFastMutex(mutex)) return;
+    VZKR_Internal_LockFastMutexSlow(mutex);
+}
+
+b8 VZKR_TryLockFastMutex(VZKR_FastMutex* mutex)
+{
+    if (!mutex) return false;
+
+    u32 state = VZKR_AtomicLoadU32(&mutex->state, VZKR_MemoryOrder_Acquire);
+    while (!(state & VZKR_INTERNAL_FAST_MUTEX_LOCKED))
+    {
+        if (VZKR_AtomicCompareExchangeU32(&mutex->state, &state, state | VZKR_INTERNAL_FAST_MUTEX_LOCKED, VZKR_MemoryOrder_Acquire)) return true;
+    }
+
+    return false;
+}
+
+void VZKR_UnlockFastMutex(VZKR_FastMutex* mutex)
+{
+    if (!mutex) return;
+
+    u32 previous = VZKR_AtomicFetchAndU32(&mutex->state, ~(VZKR_INTERNAL_FAST_MUTEX_LOCKED | VZKR_INTERNAL_FAST_MUTEX_SLEEPERS), VZKR_MemoryOrder_Release);
+    if (previous & VZKR_INTERNAL_FAST_MUTEX_SLEEPERS) VZKR_Internal_WakeOnAddress(&mutex->state, false);
+}
+
+// Ticket Lock ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// spins between checks grow with the number of threads ahead in line, so they aren't all
+// hammering the same cache line; after a while it yields, in case the holder isn't running
+
+#define VZKR_INTERNAL_TICKET_LOCK_SPINS_PER_WAITER 16
+#define VZKR_INTERNAL_TICKET_LOCK_ROUNDS_BEFORE_YIELD 16
+
+void VZKR_LockTicketLock(VZKR_TicketLock* lock)
+{
+    if (!lock) return;
+
+    u32 ticket = VZKR_AtomicFetchAddU32(&lock->next, 1, VZKR_MemoryOrder_Relaxed);
+    for (i32 rounds = 0;; rounds++)
+    {
+        u32 serving = VZKR_AtomicLoadU32(&lock->serving, VZKR_MemoryOrder_Acquire);
+        if (serving == ticket) return;
+
+        if (rounds >= VZKR_INTERNAL_TICKET_LOCK_ROUNDS_BEFORE_YIELD) { VZKR_YieldThread(); continue; }
+
+        u32 numSpins = (ticket - serving) * VZKR_INTERNAL_TICKET_LOCK_SPINS_PER_WAITER;
+        for (u32 i = 0; i < numSpins; i++) VZKR_CpuRelax();
+    }
+}
+
+b8 VZKR_TryLockTicketLock(VZKR_TicketLock* lock)
+{
+    if (!lock) return false;
+
+    u32 serving = VZKR_AtomicLoadU32(&lock->serving, VZKR_MemoryOrder_Acquire);
+    return VZKR_AtomicCompareExchangeU32(&lock->next, &serving, serving + 1, VZKR_MemoryOrder_Acquire);
+}
+
+void VZKR_UnlockTicketLock(VZKR_TicketLock* lock)
+{
+    if (!lock) return;
+
+    // only the holder ever changes it
+    VZKR_AtomicStoreU32(&lock->serving, VZKR_AtomicLoadU32(&lock->serving, VZKR_MemoryOrder_Relaxed) + 1, VZKR_MemoryOrder_Release);
+}
+
+// Fast Read-Write Mutex ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// the top bits say whether a writer holds it, and whether writers or readers might be
+// asleep waiting for it; the rest count the readers holding it
+//
+// a writer letting go clears both waiting bits and wakes everyone, and the last reader
+// letting go wakes everyone if a writer's waiting; sleepers that lose the race to take it
+// set their bit again before going back to sleep
+
+#define VZKR_INTERNAL_FAST_RW_MUTEX_WRITER          0x80000000u
+#define VZKR_INTERNAL_FAST_RW_MUTEX_WRITERS_WAITING 0x40000000u
+#define VZKR_INTERNAL_FAST_RW_MUTEX_READERS_WAITING 0x20000000u
+#define VZKR_INTERNAL_FAST_RW_MUTEX_READERS         0x1FFFFFFFu
+#define VZKR_INTERNAL_FAST_RW_MUTEX_SPINS           64
+
+void VZKR_LockFastRWMutexShared(VZKR_FastRWMutex* rwmutex)
+{
+    if (!rwmutex) return;
+
+    const u32 blocking = VZKR_INTERNAL_FAST_RW_MUTEX_WRITER | VZKR_INTERNAL_FAST_RW_MUTEX_WRITERS_WAITING;
+    for (i32 spins = 0;;)
+    {
+        u32 state = VZKR_AtomicLoadU32(&rwmutex->state, VZKR_MemoryOrder_Acquire);
+        if (!(state & blocking))
+        {
+            if (VZKR_AtomicCompareExchangeU32(&rwmutex->state, &state, state + 1, VZKR_MemoryOrder_Acquire)) return;
+            continue;
+        }
+
+        if (spins++ < VZKR_INTERNAL_FAST_RW_MUTEX_SPINS) { VZKR_CpuRelax(); continue; }
+
+        u32 waiting = state | VZKR_INTERNAL_FAST_RW_MUTEX_READERS_WAITING;
+        if (state != waiting && !VZKR_AtomicCompareExchangeU32(&rwmutex->state, &state, waiting, VZKR_MemoryOrder_Relaxed)) continue;
+        VZKR_Internal_WaitOnAddress(&rwmutex->state, waiting);
+    }
+}
+
+void VZKR_LockFastRWMutexExclusive(VZKR_FastRWMutex* rwmutex)
+{
+    if (!rwmutex) return;
+
+    const u32 blocking = VZKR_INTERNAL_FAST_RW_MUTEX_WRITER | VZKR_INTERNAL_FAST_RW_MUTEX_READERS;
+    for (i32 spins = 0;;)
+    {
+        u32 state = VZKR_AtomicLoadU32(&rwmutex->state, VZKR_MemoryOrder_Acquire);
+        if (!(state & blocking))
+        {
+            // keeps the waiting bits, since whoever set them may still be asleep
+            if (VZKR_AtomicCompareExchangeU32(&rwmutex->state, &state, state | VZKR_INTERNAL_FAST_RW_MUTEX_WRITER, VZKR_MemoryOrder_Acquire)) return;
+            continue;
+        }
+
+        if (spins++ < VZKR_INTERNAL_FAST_RW_MUTEX_SPINS) { VZKR_CpuRelax(); continue; }
+
+        u32 waiting = state | VZKR_INTERNAL_FAST_RW_MUTEX_WRITERS_WAITING;
+        if (state != waiting && !VZKR_AtomicCompareExchangeU32(&rwmutex->state, &state, waiting, VZKR_MemoryOrder_Relaxed)) continue;
+        VZKR_Internal_WaitOnAddress(&rwmutex->state, waiting);
+    }
+}
+
+void VZKR_UnlockFastRWMutexShared(VZKR_FastRWMutex* rwmutex)
+{
+    if (!rwmutex) return;
+
+    u32 previous = VZKR_AtomicFetchSubU32(&rwmutex->state, 1, VZKR_MemoryOrder_Release);
+    if ((previous & VZKR_INTERNAL_FAST_RW_MUTEX_READERS) == 1 && (previous & VZKR_INTERNAL_FAST_RW_MUTEX_WRITERS_WAITING))
+    {
+        // readers sleep on the same address, so waking just one could miss the writer
+        VZKR_Internal_WakeOnAddress(&rwmutex->state, true);
+    }
+}
+
+void VZKR_UnlockFastRWMutexExclusive(VZKR_FastRWMutex* rwmutex)
+{
+    if (!rwmutex) return;
+
+    // no readers can hold it alongside a writer, so there's nothing else to keep
+    u32 previous = VZKR_AtomicExchangeU32(&rwmutex->state, 0, VZKR_MemoryOrder_Release);
+    if (previous & (VZKR_INTERNAL_FAST_RW_MUTEX_WRITERS_WAITING | VZKR_INTERNAL_FAST_RW_MUTEX_READERS_WAITING))
+    {
+        VZKR_Internal_WakeOnAddress(&rwmutex->state, true);
+    }
+}
+
+b8 VZKR_TryLockFastRWMutexShared(VZKR_FastRWMutex* rwmutex)
+{
+    if (!rwmutex) return false;
+
+    u32 state = VZKR_AtomicLoadU32(&rwmutex->state, VZKR_MemoryOrder_Acquire);
+    while (!(state & (VZKR_INTERNAL_FAST_RW_MUTEX_WRITER | VZKR_INTERNAL_FAST_RW_MUTEX_WRITERS_WAITING)))
+    {
+        if (VZKR_AtomicCompareExchangeU32(&rwmutex->state, &state, state + 1, VZKR_MemoryOrder_Acquire)) return true;
+    }
+
+    return false;
+}
+
+b8 VZKR_TryLockFastRWMutexExclusive(VZKR_FastRWMutex* rwmutex)
+{
+    if (!rwmutex) return false;
+
+    u32 state = VZKR_AtomicLoadU32(&rwmutex->state, VZKR_MemoryOrder_Acquire);
+    while (!(state & (VZKR_INTERNAL_FAST_RW_MUTEX_WRITER | VZKR_INTERNAL_FAST_RW_MUTEX_READERS)))
+    {
+        if (VZKR_AtomicCompareExchangeU32(&rwmutex->state, &state, state | VZKR_INTERNAL_FAST_RW_MUTEX_WRITER, VZKR_MemoryOrder_Acquire)) return true;
+    }
+
+    return false;
+}
+
+// Sequence Lock ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// the sequence is odd while a write is in progress, and goes up by two with each one; a
+// read that saw the same even sequence before and after copying can't have been torn
+//
+// the data is copied with relaxed atomics (plain moves, a word at a time where both sides
+// are aligned for it), since the guarded side may be getting written at the same time
+
+#define VZKR_INTERNAL_SEQ_LOCK_SPINS_BEFORE_YIELD 64
+
+static void VZKR_Internal_SeqLockCopy(u8* destination, u8* source, i32 size)
+{
+    i32 offset = 0;
+    if (!(((uintptr_t) destination | (uintptr_t) source) & 7))
+    {
+        for (; offset + 8 <= size; offset += 8) VZKR_AtomicStoreU64((u64*) (destination + offset), VZKR_AtomicLoadU64((u64*) (source + offset), VZKR_MemoryOrder_Relaxed), VZKR_MemoryOrder_Relaxed);
+    }
+
+    if (!(((uintptr_t) destination | (uintptr_t) source) & 3))
+    {
+        for (; offset + 4 <= size; offset += 4) VZKR_AtomicStoreU32((u32*) (destination + offset), VZKR_AtomicLoadU32((u32*) (source + offset), VZKR_MemoryOrder_Relaxed), VZKR_MemoryOrder_Relaxed);
+    }
+
+    for (; offset < size; offset++) ((volatile u8*) destination)[offset] = ((volatile u8*) source)[offset];
+}
+
+void VZKR_ReadSeqLocked(VZKR_SeqLock* lock, rawptr guarded, rawptr destination, i32 size)
+{
+    if (!lock || !guarded || !destination || size <= 0) return;
+
+    for (i32 spins = 0;;)
+    {
+        u32 before = VZKR_AtomicLoadU32(&lock->sequence, VZKR_MemoryOrder_Acquire);
+        if (before & 1)
+        {
+            if (spins++ < VZKR_INTERNAL_SEQ_LOCK_SPINS_BEFORE_YIELD) VZKR_CpuRelax();
+            else                                                      VZKR_YieldThread(); // the writer might not be running
+            continue;
+        }
+
+        VZKR_Internal_SeqLockCopy((u8*) destination, (u8*) guarded, size);
+
+        // the fence keeps the copy from moving after the second read of the sequence
+        VZKR_AtomicFence(VZKR_MemoryOrder_Acquire);
+        if (VZKR_AtomicLoadU32(&lock->sequence, VZKR_MemoryOrder_Relaxed) == before) return;
+    }
+}
+
+void VZKR_WriteSeqLocked(VZKR_SeqLock* lock, rawptr guarded, rawptr source, i32 size)
+{
+    if (!lock || !guarded || !source || size <= 0) return;
+
+    VZKR_LockFastMutex(&lock->writeMutex);
+
+    // the fence keeps the copy from moving before the sequence turns odd
+    u32 sequence = VZKR_AtomicLoadU32(&lock->sequence, VZKR_MemoryOrder_Relaxed);
+    VZKR_AtomicStoreU32(&lock->sequence, sequence + 1, VZKR_MemoryOrder_Relaxed);
+    VZKR_AtomicFence(VZKR_MemoryOrder_Release);
+
+    VZKR_Internal_SeqLockCopy((u8*) guarded, (u8*) source, size);
+
+    VZKR_AtomicStoreU32(&lock->sequence, sequence + 2, VZKR_MemoryOrder_Release);
+    VZKR_UnlockFastMutex(&lock->writeMutex);
+}
@@ -0,0 +1,187 @@
+#ifndef VZKR_SYNCHRONIZATION_H // ==================================================
+#define VZKR_SYNCHRONIZATION_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fast Mutex ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A mutex that fits in 4 bytes, small enough to give every column, tile or cache entry
+ * one of its own. Zero-initialise it to create it; there's nothing to destroy.
+ *
+ * Locking spins for a while before going to sleep (on a futex on Linux, WaitOnAddress on
+ * Windows, and the equivalent on Apple platforms), and how long it spins adapts to how
+ * long it has been held for recently. It is not recursive, and not fair.
+ */
+typedef struct VZKR_FastMutex
+{
+    u32 state;
+} VZKR_FastMutex;
+
+/**
+ * Locks a fast mutex.
+ */
+void VZKR_LockFastMutex(
+    VZKR_FastMutex* mutex
+);
+
+/**
+ * Tries to lock a fast mutex, without waiting.
+ * Returns true if the mutex was successfully locked, false otherwise.
+ */
+b8 VZKR_TryLockFastMutex(
+    VZKR_FastMutex* mutex
+);
+
+/**
+ * Unlocks a fast mutex.
+ */
+void VZKR_UnlockFastMutex(
+    VZKR_FastMutex* mutex
+);
+
+// Ticket Lock ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A spinlock that hands itself out in the order it was asked for, so no thread waits
+ * longer than the ones that came before it. Zero-initialise it to create it.
+ *
+ * It never sleeps (only yielding once it's been waiting a while), so it's only worth it
+ * for very short critical sections, with no more threads fighting over it than there are
+ * cores.
+ */
+typedef struct VZKR_TicketLock
+{
+    u32 next;
+    u32 serving;
+} VZKR_TicketLock;
+
+/**
+ * Locks a ticket lock.
+ */
+void VZKR_LockTicketLock(
+    VZKR_TicketLock* lock
+);
+
+/**
+ * Tries to lock a ticket lock, if nobody holds or is waiting for it.
+ * Returns true if the lock was successfully locked, false otherwise.
+ */
+b8 VZKR_TryLockTicketLock(
+    VZKR_TicketLock* lock
+);
+
+/**
+ * Unlocks a ticket lock, handing it to the next thread in line.
+ */
+void VZKR_UnlockTicketLock(
+    VZKR_TicketLock* lock
+);
+
+// Fast Read-Write Mutex ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A read-write mutex that fits in 4 bytes, sleeping the same way a fast mutex does.
+ * Zero-initialise it to create it; there's nothing to destroy.
+ *
+ * Writers come first: once one is waiting, new readers wait too, so a steady stream of
+ * readers can't keep it out. Neither side is recursive.
+ */
+typedef struct VZKR_FastRWMutex
+{
+    u32 state;
+} VZKR_FastRWMutex;
+
+/**
+ * Locks a fast read-write mutex for reading.
+ * Multiple threads can read simultaneously.
+ */
+void VZKR_LockFastRWMutexShared(
+    VZKR_FastRWMutex* rwmutex
+);
+
+/**
+ * Locks a fast read-write mutex for writing.
+ * Only one thread can write at a time, and no other threads can read while writing.
+ */
+void VZKR_LockFastRWMutexExclusive(
+    VZKR_FastRWMutex* rwmutex
+);
+
+/**
+ * Unlocks a fast read-write mutex after reading.
+ */
+void VZKR_UnlockFastRWMutexShared(
+    VZKR_FastRWMutex* rwmutex
+);
+
+/**
+ * Unlocks a fast read-write mutex after writing.
+ */
+void VZKR_UnlockFastRWMutexExclusive(
+    VZKR_FastRWMutex* rwmutex
+);
+
+/**
+ * Tries to lock a fast read-write mutex for reading, without waiting.
+ * Returns true if the mutex was successfully locked for reading, false otherwise.
+ */
+b8 VZKR_TryLockFastRWMutexShared(
+    VZKR_FastRWMutex* rwmutex
+);
+
+/**
+ * Tries to lock a fast read-write mutex for writing, without waiting.
+ * Returns true if the mutex was successfully locked for writing, false otherwise.
+ */
+b8 VZKR_TryLockFastRWMutexExclusive(
+    VZKR_FastRWMutex* rwmutex
+);
+
+// Sequence Lock ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Guards a small piece of plain data (like viewport parameters) that's read by many
+ * threads and written rarely. Zero-initialise it to create it; there's nothing to destroy.
+ *
+ * Readers never write to it (unlike a read-write mutex, where every reader bumps the
+ * same count), so they don't fight over its cache line; they copy the data out, and copy
+ * it again if a writer changed it in the meantime. Writers take turns, and never wait for
+ * readers. Only ever access the guarded data through the functions below.
+ */
+typedef struct VZKR_SeqLock
+{
+    u32 sequence;
+    VZKR_FastMutex writeMutex;
+} VZKR_SeqLock;
+
+/**
+ * Copies 'size' bytes of data guarded by a sequence lock out, as a consistent snapshot of
+ * what some writer wrote. Spins while a write is in progress.
+ */
+void VZKR_ReadSeqLocked(
+    VZKR_SeqLock* lock,
+    rawptr guarded,
+    rawptr destination,
+    i32 size
+);
+
+/**
+ * Copies 'size' bytes into data guarded by a sequence lock, waiting for any other writer
+ * to finish first.
+ */
+void VZKR_WriteSeqLocked(
+    VZKR_SeqLock* lock,
+    rawptr guarded,
+    rawptr source,
+    i32 size
+);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_SYNCHRONIZATION_H ===================================================
@@ -0,0 +1,338 @@
+#define VZKR_IMPLEMENTATION
+#include "TaskGraph.h"
+
+// Task Graph ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+typedef struct VZKR_Internal_TaskNode
+{
+    VZKR_JobDecl job;
+    i64 estimatedCostNs;
+    i64 priority;       // the critical path from the start of this task to the end of the run
+    i32 numDependencies;
+    i32 firstDependent; // into 'dependents'
+    i32 numDependents;
+    i32 pending;        // dependencies that haven't finished yet on this run
+    i64 startNs;
+    i64 endNs;
+} VZKR_Internal_TaskNode;
+
+typedef struct VZKR_Internal_TaskEdge
+{
+    i32 task;
+    i32 dependency;
+} VZKR_Internal_TaskEdge;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_Internal_TaskNode);
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_Internal_TaskEdge);
+
+/**
+ * Edges are kept as added, and only turned into per-task lists of dependents (and checked
+ * for cycles) the first time the graph runs after changing.
+ * Runners are jobs that keep taking the highest-priority ready task until there are none;
+ * whoever makes several tasks ready starts more of them, up to one per thread.
+ */
+typedef struct VZKR_Internal_TaskGraph
+{
+    PNSLR_Allocator allocator;
+    PNSLR_ArraySlice(VZKR_Internal_TaskNode) nodes;
+    i32 numNodes;
+    PNSLR_ArraySlice(VZKR_Internal_TaskEdge) edges;
+    i32 numEdges;
+    b8 built;
+    PNSLR_ArraySlice(i32) dependents;
+    PNSLR_ArraySlice(i32) order; // topological
+    PNSLR_ArraySlice(i32) ready; // a max-heap on priority
+    i32 numReady;
+    VZKR_FastMutex readyMutex;
+    VZKR_JobSystem jobs;
+    VZKR_JobCounter runners;
+    i32 numRunners;
+    i32 maxRunners;
+    i64 runStartNs;
+    i64 runEndNs;
+    i64 criticalPathNs;
+} VZKR_Internal_TaskGraph;
+
+static i64 VZKR_Internal_TaskGraphNow(VZKR_Internal_TaskGraph* graph)
+{
+    return VZKR_GetMonotonicTime() - graph->runStartNs;
+}
+
+static void VZKR_Internal_TaskGraphPushReady(VZKR_Internal_TaskGraph* graph, i32 task)
+{
+    i32* heap  = graph->ready.data;
+    i32  index = graph->numReady++;
+    while (index > 0)
+    {
+        i32 parent = (index - 1) / 2;
+        if (graph->nodes.data[heap[parent]].priority >= graph->nodes.data[task].priority) break;
+        heap[index] = heap[parent];
+        index = parent;
+    }
+
+    heap[index] = task;
+}
+
+static i32 VZKR_Internal_TaskGraphPopReady(VZKR_Internal_TaskGraph* graph)
+{
+    if (graph->numReady == 0) return -1;
+
+    i32* heap = graph->ready.data;
+    i32  top  = heap[0];
+    i32  last = heap[--graph->numReady];
+    i32  index = 0;
+    for (;;)
+    {
+        i32 child = index * 2 + 1;
+        if (child >= graph->numReady) break;
+        if (child + 1 < graph->numReady && graph->nodes.data[heap[child + 1]].priority > graph->nodes.data[heap[child]].priority) child++;
+        if (graph->nodes.data[heap[child]].priority <= graph->nodes.data[last].priority) break;
+        heap[index] = heap[child];
+        index = child;
+    }
+
+    if (graph->numReady > 0) heap[index] = last;
+    return top;
+}
+
+/** Turns the edges into lists of dependents, and sorts the tasks. Returns false on a cycle. */
+static b8 VZKR_Internal_TaskGraphBuild(VZKR_Internal_TaskGraph* graph)
+{
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    PNSLR_ResizeSlice(i32, &graph->dependents, graph->numEdges, false, graph->allocator, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None) return false;
+    PNSLR_ResizeSlice(i32, &graph->order, graph->numNodes, false, graph->allocator, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None) return false;
+    PNSLR_ResizeSlice(i32, &graph->ready, graph->numNodes, false, graph->allocator, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None) return false;
+
+    VZKR_Internal_TaskNode* nodes = graph->nodes.data;
+    for (i32 i = 0; i < graph->numNodes; i++) { nodes[i].numDependencies = 0; nodes[i].numDependents = 0; }
+    for (i32 i = 0; i < graph->numEdges; i++)
+    {
+        nodes[graph->edges.data[i].task].numDependencies++;
+        nodes[graph->edges.data[i].dependency].numDependents++;
+    }
+
+    i32 offset = 0;
+    for (i32 i = 0; i < graph->numNodes; i++) { nodes[i].firstDependent = offset; offset += nodes[i].numDependents; nodes[i].numDependents = 0; }
+    for (i32 i = 0; i < graph->numEdges; i++)
+    {
+        VZKR_Internal_TaskNode* dependency = &nodes[graph->edges.data[i].dependency];
+        graph->dependents.data[dependency->firstDependent + dependency->numDependents++] = graph->edges.data[i].task;
+    }
+
+    // Kahn's algorithm, with 'order' doubling as its queue
+    i32 numOrdered = 0;
+    for (i32 i = 0; i < graph->numNodes; i++)
+    {
+        nodes[i].pending = nodes[i].numDependencies;
+        if (!nodes[i].pending) graph->order.data[numOrdered++] = i;
+    }
+
+    for (i32 i = 0; i < numOrdered; i++)
+    {
+        VZKR_Internal_TaskNode* node = &nodes[graph->order.data[i]];
+        for (i32 j = 0; j < node->numDependents; j++)
+        {
+            i32 dependent = graph->dependents.data[node->firstDependent + j];
+            if (--nodes[dependent].pending == 0) graph->order.data[numOrdered++] = dependent;
+        }
+    }
+
+    graph->built = numOrdered == graph->numNodes;
+    return graph->built;
+}
+
+static void VZKR_Internal_TaskGraphRunner(rawptr userData);
+
+static void VZKR_Internal_TaskGraphStartRunners(VZKR_Internal_TaskGraph* graph, i32 count)
+{
+    while (count > 0)
+    {
+        i32 numRunners = VZKR_AtomicLoadI32(&graph->numRunners, VZKR_MemoryOrder_Relaxed);
+        if (numRunners >= graph->maxRunners) return;
+        if (!VZKR_AtomicCompareExchangeI32(&graph->numRunners, &numRunners, numRunners + 1, VZKR_MemoryOrder_Relaxed)) continue;
+
+        VZKR_RunJob(graph->jobs, (VZKR_JobDecl) {.procedure = VZKR_Internal_TaskGraphRunner, .userData = graph}, &graph->runners);
+        count--;
+    }
+}
+
+static void VZKR_Internal_TaskGraphRunner(rawptr userData)
+{
+    VZKR_Internal_TaskGraph* graph = (VZKR_Internal_TaskGraph*) userData;
+    for (;;)
+    {
+        VZKR_LockFastMutex(&graph->readyMutex);
+        i32 task = VZKR_Internal_TaskGraphPopReady(graph);
+        VZKR_UnlockFastMutex(&graph->readyMutex);
+        if (task < 0) break;
+
+        VZKR_Internal_TaskNode* node = &graph->nodes.data[task];
+        node->startNs = VZKR_Internal_TaskGraphNow(graph);
+        node->job.procedure(node->job.userData);
+        node->endNs = VZKR_Internal_TaskGraphNow(graph);
+
+        // this runner carries on with one of the tasks it made ready, and starts others
+        // for the rest
+        i32 numMadeReady = 0;
+        for (i32 i = 0; i < node->numDependents; i++)
+        {
+            VZKR_Internal_TaskNode* dependent = &graph->nodes.data[graph->dependents.data[node->firstDependent + i]];
+            if (VZKR_AtomicFetchSubI32(&dependent->pending, 1, VZKR_MemoryOrder_AcquireRelease) != 1) continue;
+
+            VZKR_LockFastMutex(&graph->readyMutex);
+            VZKR_Internal_TaskGraphPushReady(graph, graph->dependents.data[node->firstDependent + i]);
+            VZKR_UnlockFastMutex(&graph->readyMutex);
+            numMadeReady++;
+        }
+
+        if (numMadeReady > 1) VZKR_Internal_TaskGraphStartRunners(graph, numMadeReady - 1);
+    }
+
+    VZKR_AtomicFetchSubI32(&graph->numRunners, 1, VZKR_MemoryOrder_Relaxed);
+}
+
+VZKR_TaskGraph VZKR_CreateTaskGraph(PNSLR_Allocator allocator)
+{
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_TaskGraph* graph = (VZKR_Internal_TaskGraph*) PNSLR_Allocate(allocator, true, (i32) sizeof(VZKR_Internal_TaskGraph), (i32) alignof(VZKR_Internal_TaskGraph), PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !graph) return (VZKR_TaskGraph) {0};
+
+    graph->allocator = allocator;
+    return (VZKR_TaskGraph) {.handle = (rawptr) graph};
+}
+
+void VZKR_DestroyTaskGraph(VZKR_TaskGraph* graph)
+{
+    if (!graph || !graph->handle) return;
+
+    VZKR_Internal_TaskGraph* internal = (VZKR_Internal_TaskGraph*) graph->handle;
+    PNSLR_FreeSlice(&internal->nodes, internal->allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&internal->edges, internal->allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&internal->dependents, internal->allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&internal->order, internal->allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&internal->ready, internal->allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_Free(internal->allocator, internal, PNSLR_GET_LOC(), nil);
+    *graph = (VZKR_TaskGraph) {0};
+}
+
+i32 VZKR_AddTask(
+    VZKR_TaskGraph graph,
+    VZKR_JobDecl job,
+    i64 estimatedCostNs
+)
+{
+    VZKR_Internal_TaskGraph* internal = (VZKR_Internal_TaskGraph*) graph.handle;
+    if (!internal || !job.procedure) return -1;
+
+    if (internal->numNodes == internal->nodes.count)
+    {
+        PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+        PNSLR_ResizeSlice(VZKR_Internal_TaskNode, &internal->nodes, internal->nodes.count ? internal->nodes.count * 2 : 16, false, internal->allocator, PNSLR_GET_LOC(), &err);
+        if (err != PNSLR_AllocatorError_None) return -1;
+    }
+
+    internal->nodes.data[internal->numNodes] = (VZKR_Internal_TaskNode) {.job = job, .estimatedCostNs = estimatedCostNs};
+    internal->built = false;
+    return internal->numNodes++;
+}
+
+b8 VZKR_AddTaskDependency(
+    VZKR_TaskGraph graph,
+    i32 task,
+    i32 dependency
+)
+{
+    VZKR_Internal_TaskGraph* internal = (VZKR_Internal_TaskGraph*) graph.handle;
+    if (!internal || task < 0 || task >= internal->numNodes || dependency < 0 || dependency >= internal->numNodes) return false;
+
+    if (internal->numEdges == internal->edges.count)
+    {
+        PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+        PNSLR_ResizeSlice(VZKR_Internal_TaskEdge, &internal->edges, internal->edges.count ? internal->edges.count * 2 : 16, false, internal->allocator, PNSLR_GET_LOC(), &err);
+        if (err != PNSLR_AllocatorError_None) return false;
+    }
+
+    internal->edges.data[internal->numEdges++] = (VZKR_Internal_TaskEdge) {.task = task, .dependency = dependency};
+    internal->built = false;
+    return true;
+}
+
+b8 VZKR_RunTaskGraph(
+    VZKR_TaskGraph graph,
+    VZKR_JobSystem jobs
+)
+{
+    VZKR_Internal_TaskGraph* internal = (VZKR_Internal_TaskGraph*) graph.handle;
+    if (!internal) return false;
+    if (!internal->built && !VZKR_Internal_TaskGraphBuild(internal)) return false;
+
+    // critical paths, from the end backwards; tasks with no estimate use their last
+    // duration, or count as taking no time at all if they haven't run yet
+    VZKR_Internal_TaskNode* nodes = internal->nodes.data;
+    internal->criticalPathNs = 0;
+    for (i32 i = internal->numNodes - 1; i >= 0; i--)
+    {
+        VZKR_Internal_TaskNode* node = &nodes[internal->order.data[i]];
+        i64 longest = 0;
+        for (i32 j = 0; j < node->numDependents; j++)
+        {
+            i64 priority = nodes[internal->dependents.data[node->firstDependent + j]].priority;
+            if (priority > longest) longest = priority;
+        }
+
+        node->priority = (node->estimatedCostNs > 0 ? node->estimatedCostNs : node->endNs - node->startNs) + longest;
+        if (node->priority > internal->criticalPathNs) internal->criticalPathNs = node->priority;
+    }
+
+    internal->numReady = 0;
+    for (i32 i = 0; i < internal->numNodes; i++)
+    {
+        nodes[i].pending = nodes[i].numDependencies;
+        nodes[i].startNs = nodes[i].endNs = 0;
+        if (!nodes[i].pending) VZKR_Internal_TaskGraphPushReady(internal, i);
+    }
+
+    internal->jobs       = jobs;
+    internal->runners    = (VZKR_JobCounter) {0};
+    internal->numRunners = 0;
+    internal->maxRunners = jobs.handle ? VZKR_GetJobSystemNumThreads(jobs) : 1;
+    internal->runStartNs = 0;
+    internal->runStartNs = VZKR_Internal_TaskGraphNow(internal);
+
+    if (!jobs.handle)
+    {
+        internal->numRunners = 1;
+        VZKR_Internal_TaskGraphRunner(internal);
+    }
+    else
+    {
+        VZKR_Internal_TaskGraphStartRunners(internal, internal->numReady);
+        VZKR_WaitForJobs(jobs, &internal->runners);
+    }
+
+    internal->runEndNs = VZKR_Internal_TaskGraphNow(internal);
+    return true;
+}
+
+VZKR_TaskTiming VZKR_GetTaskTiming(
+    VZKR_TaskGraph graph,
+    i32 task
+)
+{
+    VZKR_Internal_TaskGraph* internal = (VZKR_Internal_TaskGraph*) graph.handle;
+    if (!internal || task < 0 || task >= internal->numNodes) return (VZKR_TaskTiming) {0};
+
+    VZKR_Internal_TaskNode* node = &internal->nodes.data[task];
+    return (VZKR_TaskTiming) {.startNs = node->startNs, .endNs = node->endNs, .criticalPathNs = node->priority};
+}
+
+VZKR_TaskTiming VZKR_GetTaskGraphTiming(VZKR_TaskGraph graph)
+{
+    VZKR_Internal_TaskGraph* internal = (VZKR_Internal_TaskGraph*) graph.handle;
+    if (!internal) return (VZKR_TaskTiming) {0};
+
+    return (VZKR_TaskTiming) {.startNs = 0, .endNs = internal->runEndNs, .criticalPathNs = internal->criticalPathNs};
+}
@@ -0,0 +1,106 @@
+#ifndef VZKR_TASK_GRAPH_H // =======================================================
+#define VZKR_TASK_GRAPH_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Task Graph ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A cross-platform opaque handle to a task graph: tasks (jobs) with dependencies between
+ * them, built once and then run as many times as needed (e.g. once per frame), each run
+ * starting every task as soon as everything it depends on has finished.
+ *
+ * When several tasks are ready at once, the ones with the longest chain of work still
+ * hanging off them (their critical path) go first, so the run finishes as early as it
+ * can. Every run also records when each task started and finished.
+ *
+ * Building and running must not overlap.
+ */
+typedef struct VZKR_TaskGraph
+{
+    rawptr handle;
+} VZKR_TaskGraph;
+
+/**
+ * When a task (or a whole run) started and finished, in nanoseconds since the start of
+ * the last run, and the length of the longest chain of tasks from it to the end of the
+ * run, as estimated when the run started.
+ */
+typedef struct VZKR_TaskTiming
+{
+    i64 startNs;
+    i64 endNs;
+    i64 criticalPathNs;
+} VZKR_TaskTiming;
+
+/**
+ * Creates an empty task graph.
+ * If creating failed, the returned handle will be zeroed.
+ */
+VZKR_TaskGraph VZKR_CreateTaskGraph(
+    PNSLR_Allocator allocator
+);
+
+/**
+ * Frees a task graph. It must not be running.
+ */
+void VZKR_DestroyTaskGraph(
+    VZKR_TaskGraph* graph
+);
+
+/**
+ * Adds a task, which runs its job once per run.
+ * 'estimatedCostNs' is how long it's expected to take, for working out critical paths;
+ * if not positive, its duration from the last run is used instead.
+ * Returns the task's index, or -1 if allocating failed.
+ */
+i32 VZKR_AddTask(
+    VZKR_TaskGraph graph,
+    VZKR_JobDecl job,
+    i64 estimatedCostNs
+);
+
+/**
+ * Makes a task wait for another one to finish before it starts, on every run.
+ * Returns false if either index is invalid, or allocating failed.
+ */
+b8 VZKR_AddTaskDependency(
+    VZKR_TaskGraph graph,
+    i32 task,
+    i32 dependency
+);
+
+/**
+ * Runs every task once, on a job system's threads (or serially on the calling thread, if
+ * it's zeroed), and waits for all of them to finish, running jobs in the meantime.
+ * Returns false (running nothing) if the dependencies have a cycle.
+ */
+b8 VZKR_RunTaskGraph(
+    VZKR_TaskGraph graph,
+    VZKR_JobSystem jobs
+);
+
+/**
+ * Gets when a task started and finished on the last run.
+ * Zeroed if the index is invalid, or the graph hasn't run since the task was added.
+ */
+VZKR_TaskTiming VZKR_GetTaskTiming(
+    VZKR_TaskGraph graph,
+    i32 task
+);
+
+/**
+ * Gets how long the last run took (starting at zero), and its critical path.
+ */
+VZKR_TaskTiming VZKR_GetTaskGraphTiming(
+    VZKR_TaskGraph graph
+);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_TASK_GRAPH_H ========================================================
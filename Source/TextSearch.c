@@ -0,0 +1,293 @@
+#define VZKR_IMPLEMENTATION
+#include "TextSearch.h"
+
+// Multi-Pattern Automaton ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+static u8 VZKR_Internal_FoldAsciiCase(u8 c)
+{
+    return (c >= 'A' && c <= 'Z') ? (u8) (c - 'A' + 'a') : c;
+}
+
+b8 VZKR_CompileMultiPattern(
+    PNSLR_ArraySlice(utf8str) patterns,
+    PNSLR_StringComparisonType comparisonType,
+    PNSLR_Allocator allocator,
+    VZKR_MultiPattern* output
+)
+{
+    if (!output) return false;
+    *output = (VZKR_MultiPattern) {0};
+    output->allocator = allocator;
+
+    b8 caseInsensitive = (comparisonType == PNSLR_StringComparisonType_CaseInsensitive);
+
+    // assign an equivalence class to every byte that appears in a pattern,
+    // everything else shares one last class that always falls back to the root
+    b8 seen[256] = {0};
+    i64 maxStates = 1;
+    for (i64 i = 0; i < patterns.count; i++)
+    {
+        utf8str pat = patterns.data[i];
+        maxStates += pat.count;
+        for (i64 j = 0; j < pat.count; j++)
+        {
+            seen[caseInsensitive ? VZKR_Internal_FoldAsciiCase(pat.data[j]) : pat.data[j]] = true;
+        }
+    }
+
+    i32 numClasses = 0;
+    for (i32 c = 0; c < 256; c++) { if (seen[c]) output->byteClasses[c] = (u8) numClasses++; }
+    if (numClasses < 256)
+    {
+        for (i32 c = 0; c < 256; c++) { if (!seen[c]) output->byteClasses[c] = (u8) numClasses; }
+        numClasses++;
+    }
+
+    if (caseInsensitive)
+    {
+        for (i32 c = 'A'; c <= 'Z'; c++) { output->byteClasses[c] = output->byteClasses[c - 'A' + 'a']; }
+    }
+
+    if (maxStates * numClasses > 0x7FFFFFFF / (i64) sizeof(i32)) return false;
+
+    // each allocation only goes ahead if the ones before it worked, so a later success can't
+    // hide an earlier failure
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    PNSLR_ArraySlice(i32) failLinks = {0};
+    output->numClasses = numClasses;
+    output->transitions = PNSLR_MakeSlice(i32, maxStates * numClasses, false, allocator, PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) output->states         = PNSLR_MakeSlice(VZKR_MultiPatternState, maxStates, false, allocator, PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) output->patternLengths = PNSLR_MakeSlice(i32, patterns.count, false, allocator, PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) failLinks              = PNSLR_MakeSlice(i32, maxStates, false, allocator, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None)
+    {
+        PNSLR_FreeSlice(&failLinks, allocator, PNSLR_GET_LOC(), nil);
+        VZKR_DestroyMultiPattern(output);
+        return false;
+    }
+
+    i32* trans = output->transitions.data;
+    VZKR_MultiPatternState* states = output->states.data;
+    for (i64 i = 0; i < output->transitions.count; i++) { trans[i] = -1; }
+
+    // build the trie
+    i32 numStates = 1;
+    states[0] = (VZKR_MultiPatternState) {.patternIdx = -1, .outputState = -1, .dictLink = -1, .depth = 0};
+    for (i64 i = 0; i < patterns.count; i++)
+    {
+        utf8str pat = patterns.data[i];
+        output->patternLengths.data[i] = (i32) pat.count;
+        if (pat.count == 0) continue;
+
+        i32 s = 0;
+        for (i64 j = 0; j < pat.count; j++)
+        {
+            i32* next = &trans[s * numClasses + output->byteClasses[pat.data[j]]];
+            if (*next < 0)
+            {
+                states[numStates] = (VZKR_MultiPatternState) {.patternIdx = -1, .outputState = -1, .dictLink = -1, .depth = states[s].depth + 1};
+                *next = numStates++;
+            }
+
+            s = *next;
+        }
+
+        if (states[s].patternIdx < 0) { states[s].patternIdx = (i32) i; }
+    }
+
+    // breadth-first pass to compute failure links and resolve every missing transition,
+    // states are numbered in insertion order rather than by depth, so an explicit queue is needed
+    PNSLR_ArraySlice(i32) queue = PNSLR_MakeSlice(i32, numStates, false, allocator, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None)
+    {
+        PNSLR_FreeSlice(&failLinks, allocator, PNSLR_GET_LOC(), nil);
+        VZKR_DestroyMultiPattern(output);
+        return false;
+    }
+
+    i32* fail = failLinks.data;
+    i32 queueHead = 0, queueTail = 0;
+    fail[0] = 0;
+    for (i32 c = 0; c < numClasses; c++)
+    {
+        i32 v = trans[c];
+        if (v < 0) { trans[c] = 0; continue; }
+        fail[v] = 0;
+        queue.data[queueTail++] = v;
+    }
+
+    while (queueHead < queueTail)
+    {
+        i32 u = queue.data[queueHead++];
+        i32 f = fail[u];
+
+        states[u].dictLink    = states[f].outputState;
+        states[u].outputState = (states[u].patternIdx >= 0) ? u : states[u].dictLink;
+
+        for (i32 c = 0; c < numClasses; c++)
+        {
+            i32* v = &trans[u * numClasses + c];
+            i32 fv = trans[f * numClasses + c];
+            if (*v < 0) { *v = fv; continue; }
+            fail[*v] = fv;
+            queue.data[queueTail++] = *v;
+        }
+    }
+
+    PNSLR_FreeSlice(&queue, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&failLinks, allocator, PNSLR_GET_LOC(), nil);
+
+    output->numStates = numStates;
+    return true;
+}
+
+void VZKR_DestroyMultiPattern(VZKR_MultiPattern* pattern)
+{
+    if (!pattern) return;
+    PNSLR_FreeSlice(&pattern->transitions, pattern->allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&pattern->states, pattern->allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&pattern->patternLengths, pattern->allocator, PNSLR_GET_LOC(), nil);
+    *pattern = (VZKR_MultiPattern) {0};
+}
+
+// Multi-Pattern Matching ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+b8 VZKR_FeedMultiPatternScanner(
+    VZKR_MultiPatternScanner* scanner,
+    PNSLR_ArraySlice(u8) chunk,
+    rawptr payload,
+    VZKR_MultiPatternMatchDelegate delegate
+)
+{
+    if (!scanner || !scanner->pattern || !delegate) return false;
+
+    VZKR_MultiPattern* pat = scanner->pattern;
+    const i32* trans = pat->transitions.data;
+    const VZKR_MultiPatternState* states = pat->states.data;
+    const u8* classes = pat->byteClasses;
+    i32 numClasses = pat->numClasses;
+    i32 s = scanner->state;
+
+    for (i64 i = 0; i < chunk.count; i++)
+    {
+        s = trans[s * numClasses + classes[chunk.data[i]]];
+
+        for (i32 o = states[s].outputState; o >= 0; o = states[o].dictLink)
+        {
+            i64 end = scanner->position + i + 1;
+            VZKR_MultiPatternMatch match = {.patternIdx = states[o].patternIdx, .start = end - states[o].depth, .end = end};
+            if (!delegate(payload, match))
+            {
+                scanner->state     = s;
+                scanner->position += i + 1;
+                return false;
+            }
+        }
+    }
+
+    scanner->state     = s;
+    scanner->position += chunk.count;
+    return true;
+}
+
+b8 VZKR_FindAllPatternsInString(
+    VZKR_MultiPattern* pattern,
+    utf8str str,
+    rawptr payload,
+    VZKR_MultiPatternMatchDelegate delegate
+)
+{
+    VZKR_MultiPatternScanner scanner = {.pattern = pattern};
+    return VZKR_FeedMultiPatternScanner(&scanner, str, payload, delegate);
+}
+
+b8 VZKR_FindAllPatternsInStream(
+    VZKR_MultiPattern* pattern,
+    PNSLR_Stream stream,
+    PNSLR_ArraySlice(u8) scratch,
+    rawptr payload,
+    VZKR_MultiPatternMatchDelegate delegate
+)
+{
+    if (!scratch.data || scratch.count <= 0) return false;
+
+    VZKR_MultiPatternScanner scanner = {.pattern = pattern};
+    while (true)
+    {
+        i64 readSize = 0;
+        if (!PNSLR_ReadFromStream(stream, scratch, &readSize)) return false;
+        if (readSize <= 0) return true;
+
+        PNSLR_ArraySlice(u8) chunk = {.data = scratch.data, .count = readSize};
+        if (!VZKR_FeedMultiPatternScanner(&scanner, chunk, payload, delegate)) return false;
+    }
+}
+
+b8 VZKR_ReplaceAllPatternsInString(
+    VZKR_MultiPattern* pattern,
+    utf8str str,
+    PNSLR_ArraySlice(utf8str) replacements,
+    PNSLR_StringBuilder* builder
+)
+{
+    if (!pattern || !builder || replacements.count != pattern->patternLengths.count) return false;
+
+    const i32* trans = pattern->transitions.data;
+    const VZKR_MultiPatternState* states = pattern->states.data;
+    const u8* classes = pattern->byteClasses;
+    i32 numClasses = pattern->numClasses;
+
+    // a candidate match is only committed once no match that starts at or before it
+    // can still show up, i.e. when it starts before the prefix the automaton is tracking.
+    // after committing, scanning resumes right after the match from the root, which
+    // rewinds by at most the length of the longest pattern.
+    i64 copiedUpTo = 0;
+    i64 candStart = -1, candEnd = -1;
+    i32 candIdx = -1;
+    i32 s = 0;
+    i64 i = 0;
+    while (true)
+    {
+        b8 atEnd = (i >= str.count);
+        if (!atEnd)
+        {
+            s = trans[s * numClasses + classes[str.data[i]]];
+            i++;
+
+            // the first output on the chain is the longest match ending here, hence the leftmost
+            i32 o = states[s].outputState;
+            if (o >= 0)
+            {
+                i64 start = i - states[o].depth;
+                if (candIdx < 0 || start < candStart || (start == candStart && i > candEnd))
+                {
+                    candStart = start;
+                    candEnd   = i;
+                    candIdx   = states[o].patternIdx;
+                }
+            }
+        }
+
+        if (candIdx < 0)
+        {
+            if (atEnd) break;
+            continue;
+        }
+
+        if (!atEnd && candStart >= i - states[s].depth) continue;
+
+        utf8str before = {.data = str.data + copiedUpTo, .count = candStart - copiedUpTo};
+        if (!PNSLR_AppendStringToStringBuilder(builder, before)) return false;
+        if (!PNSLR_AppendStringToStringBuilder(builder, replacements.data[candIdx])) return false;
+
+        copiedUpTo = candEnd;
+        i          = candEnd;
+        s          = 0;
+        candIdx    = -1;
+        candStart  = -1;
+        candEnd    = -1;
+    }
+
+    utf8str rest = {.data = str.data + copiedUpTo, .count = str.count - copiedUpTo};
+    return PNSLR_AppendStringToStringBuilder(builder, rest);
+}
@@ -0,0 +1,156 @@
+#ifndef VZKR_TEXT_SEARCH_H // ======================================================
+#define VZKR_TEXT_SEARCH_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Multi-Pattern Automaton ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A single state of a compiled multi-pattern automaton.
+ * 'patternIdx' is the pattern that ends exactly at this state (-1 if none).
+ * 'outputState' is the first state on the suffix chain (including this one) that ends a pattern.
+ * 'dictLink' is the next such state after 'outputState', used to enumerate overlapping matches.
+ * 'depth' is the length of the prefix this state represents.
+ */
+typedef struct VZKR_MultiPatternState
+{
+    i32 patternIdx;
+    i32 outputState;
+    i32 dictLink;
+    i32 depth;
+} VZKR_MultiPatternState;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_MultiPatternState);
+
+/**
+ * A set of patterns compiled into an Aho-Corasick automaton.
+ * Finds every occurrence of every pattern in a single pass over the input,
+ * regardless of how many patterns there are.
+ *
+ * The transition table is a fully resolved DFA over byte equivalence classes,
+ * so scanning is a single table lookup per input byte.
+ */
+typedef struct VZKR_MultiPattern
+{
+    PNSLR_Allocator allocator;
+    u8 byteClasses[256];
+    i32 numClasses;
+    i32 numStates;
+    PNSLR_ArraySlice(i32) transitions;
+    PNSLR_ArraySlice(VZKR_MultiPatternState) states;
+    PNSLR_ArraySlice(i32) patternLengths;
+} VZKR_MultiPattern;
+
+/**
+ * Compiles a set of patterns into an automaton. Empty patterns are ignored.
+ * If a pattern occurs more than once, matches are reported against its first index.
+ * Case-insensitive comparison only folds ASCII letters.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_CompileMultiPattern(
+    PNSLR_ArraySlice(utf8str) patterns,
+    PNSLR_StringComparisonType comparisonType,
+    PNSLR_Allocator allocator,
+    VZKR_MultiPattern* output
+);
+
+/**
+ * Frees the resources used by a compiled automaton.
+ */
+void VZKR_DestroyMultiPattern(
+    VZKR_MultiPattern* pattern
+);
+
+// Multi-Pattern Matching ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A single match reported by the automaton.
+ * 'start' and 'end' are absolute byte offsets from the start of the scan (end is exclusive).
+ */
+typedef struct VZKR_MultiPatternMatch
+{
+    i32 patternIdx;
+    i64 start;
+    i64 end;
+} VZKR_MultiPatternMatch;
+
+/**
+ * The signature of the delegate that's called for every match found.
+ * Return false to stop scanning.
+ */
+typedef b8 (*VZKR_MultiPatternMatchDelegate)(
+    rawptr payload,
+    VZKR_MultiPatternMatch match
+);
+
+/**
+ * The state of an incremental scan. Holds the automaton state between chunks,
+ * so matches that straddle chunk boundaries are still reported.
+ *
+ * Create by setting the pattern and zeroing the rest of the fields.
+ */
+typedef struct VZKR_MultiPatternScanner
+{
+    VZKR_MultiPattern* pattern;
+    i32 state;
+    i64 position;
+} VZKR_MultiPatternScanner;
+
+/**
+ * Feeds the next chunk of input to a scanner, reporting every (possibly overlapping)
+ * match that ends inside this chunk.
+ * Returns false if the delegate asked to stop, true otherwise.
+ */
+b8 VZKR_FeedMultiPatternScanner(
+    VZKR_MultiPatternScanner* scanner,
+    PNSLR_ArraySlice(u8) chunk,
+    rawptr payload,
+    VZKR_MultiPatternMatchDelegate delegate
+);
+
+/**
+ * Reports every (possibly overlapping) match in a string.
+ * Returns false if the delegate asked to stop, true otherwise.
+ */
+b8 VZKR_FindAllPatternsInString(
+    VZKR_MultiPattern* pattern,
+    utf8str str,
+    rawptr payload,
+    VZKR_MultiPatternMatchDelegate delegate
+);
+
+/**
+ * Reads a stream to its end in chunks of the size of 'scratch', reporting every
+ * (possibly overlapping) match. The stream is read from its current position.
+ * Returns false on a read failure or if the delegate asked to stop, true otherwise.
+ */
+b8 VZKR_FindAllPatternsInStream(
+    VZKR_MultiPattern* pattern,
+    PNSLR_Stream stream,
+    PNSLR_ArraySlice(u8) scratch,
+    rawptr payload,
+    VZKR_MultiPatternMatchDelegate delegate
+);
+
+/**
+ * Replaces every occurrence of every pattern with the replacement at the same index,
+ * appending the result to the string builder.
+ * Matches don't overlap; where several could apply, the leftmost one wins, and among
+ * those starting at the same position, the longest one wins.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_ReplaceAllPatternsInString(
+    VZKR_MultiPattern* pattern,
+    utf8str str,
+    PNSLR_ArraySlice(utf8str) replacements,
+    PNSLR_StringBuilder* builder
+);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_TEXT_SEARCH_H =======================================================
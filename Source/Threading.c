@@ -0,0 +1,636 @@
+#define VZKR_IMPLEMENTATION
+#include "Threading.h"
+
+// Threads ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_THREAD_MAX_NAME 64
+
+typedef struct VZKR_Internal_Thread
+{
+    PNSLR_Allocator allocator;
+    VZKR_ThreadProcedure procedure;
+    rawptr userData;
+    u64 affinityMask;
+    utf8str name;
+    u8 nameBuffer[VZKR_INTERNAL_THREAD_MAX_NAME];
+    u64 native;
+} VZKR_Internal_Thread;
+
+/** Everything that can be set from the thread itself is, so it works the same everywhere. */
+static void VZKR_Internal_ThreadRun(VZKR_Internal_Thread* thread)
+{
+    if (thread->name.count > 0)   VZKR_SetCurrentThreadName(thread->name);
+    if (thread->affinityMask > 0) VZKR_SetCurrentThreadAffinity(thread->affinityMask);
+    thread->procedure(thread->userData);
+}
+
+#if PNSLR_WINDOWS
+    static DWORD WINAPI VZKR_Internal_ThreadEntry(LPVOID arg)
+    {
+        VZKR_Internal_ThreadRun((VZKR_Internal_Thread*) arg);
+        return 0;
+    }
+#elif PNSLR_UNIX
+    static void* VZKR_Internal_ThreadEntry(void* arg)
+    {
+        VZKR_Internal_ThreadRun((VZKR_Internal_Thread*) arg);
+        return nil;
+    }
+#endif
+
+VZKR_Thread VZKR_CreateThread(
+    VZKR_ThreadProcedure procedure,
+    rawptr userData,
+    VZKR_ThreadOptions options,
+    PNSLR_Allocator allocator
+)
+{
+    if (!procedure) return (VZKR_Thread) {0};
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_Thread* thread = (VZKR_Internal_Thread*) PNSLR_Allocate(allocator, true, (i32) sizeof(VZKR_Internal_Thread), (i32) alignof(VZKR_Internal_Thread), PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !thread) return (VZKR_Thread) {0};
+
+    thread->allocator    = allocator;
+    thread->procedure    = procedure;
+    thread->userData     = userData;
+    thread->affinityMask = options.affinityMask;
+
+    // the name is only used once the thread starts, so keep a copy
+    i64 nameLength = options.name.count < VZKR_INTERNAL_THREAD_MAX_NAME ? options.name.count : VZKR_INTERNAL_THREAD_MAX_NAME;
+    if (nameLength > 0) PNSLR_MemCopy(thread->nameBuffer, options.name.data, (i32) nameLength);
+    thread->name = (utf8str) {.data = thread->nameBuffer, .count = nameLength};
+
+    b8 started = false;
+    #if PNSLR_WINDOWS
+        HANDLE handle = CreateThread(nil, options.stackSize > 0 ? (SIZE_T) options.stackSize : 0, VZKR_Internal_ThreadEntry, thread, 0, nil);
+        if (handle) { thread->native = (u64) handle; started = true; }
+    #elif PNSLR_UNIX
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        if (options.stackSize > 0) pthread_attr_setstacksize(&attr, (size_t) options.stackSize); // too small just keeps the default
+
+        pthread_t handle;
+        if (pthread_create(&handle, &attr, VZKR_Internal_ThreadEntry, thread) == 0) { thread->native = (u64) handle; started = true; }
+        pthread_attr_destroy(&attr);
+    #endif
+
+    if (!started)
+    {
+        PNSLR_Free(allocator, thread, PNSLR_GET_LOC(), nil);
+        return (VZKR_Thread) {0};
+    }
+
+    return (VZKR_Thread) {.handle = (rawptr) thread};
+}
+
+void VZKR_JoinThread(VZKR_Thread* thread)
+{
+    if (!thread || !thread->handle) return;
+    VZKR_Internal_Thread* internal = (VZKR_Internal_Thread*) thread->handle;
+
+    #if PNSLR_WINDOWS
+        WaitForSingleObject((HANDLE) internal->native, INFINITE);
+        CloseHandle((HANDLE) internal->native);
+    #elif PNSLR_UNIX
+        pthread_join((pthread_t) internal->native, nil);
+    #endif
+
+    PNSLR_Free(internal->allocator, internal, PNSLR_GET_LOC(), nil);
+    *thread = (VZKR_Thread) {0};
+}
+
+b8 VZKR_SetCurrentThreadName(utf8str name)
+{
+    char buffer[VZKR_INTERNAL_THREAD_MAX_NAME];
+    i64 length = name.count < VZKR_INTERNAL_THREAD_MAX_NAME - 1 ? name.count : VZKR_INTERNAL_THREAD_MAX_NAME - 1;
+    if (length > 0) PNSLR_MemCopy(buffer, name.data, (i32) length);
+    buffer[length] = '\0';
+
+    #if PNSLR_WINDOWS
+        wchar_t wide[VZKR_INTERNAL_THREAD_MAX_NAME];
+        i32 numWide = MultiByteToWideChar(CP_UTF8, 0, buffer, -1, wide, VZKR_INTERNAL_THREAD_MAX_NAME);
+        if (numWide <= 0) return false;
+        return SUCCEEDED(SetThreadDescription(GetCurrentThread(), wide));
+    #elif PNSLR_OSX || PNSLR_IOS
+        return pthread_setname_np(buffer) == 0;
+    #elif PNSLR_UNIX
+        if (length > 15) buffer[15] = '\0'; // anything longer gets refused outright
+        return pthread_setname_np(pthread_self(), buffer) == 0;
+    #else
+        return false;
+    #endif
+}
+
+b8 VZKR_SetCurrentThreadAffinity(u64 affinityMask)
+{
+    #if PNSLR_WINDOWS
+        if (affinityMask == 0)
+        {
+            DWORD_PTR processMask = 0, systemMask = 0;
+            if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) return false;
+            affinityMask = (u64) processMask;
+        }
+
+        return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) affinityMask) != 0;
+    #elif PNSLR_OSX || PNSLR_IOS
+        return false;
+    #elif PNSLR_UNIX
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (i32 i = 0; i < CPU_SETSIZE; i++)
+        {
+            if (affinityMask == 0 || (i < 64 && (affinityMask & (1ull << i)))) CPU_SET(i, &set);
+        }
+
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+    #else
+        return false;
+    #endif
+}
+
+i32 VZKR_GetNumLogicalCores(void)
+{
+    i32 count = 1;
+    #if PNSLR_WINDOWS
+        count = (i32) GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+    #elif PNSLR_OSX || PNSLR_IOS
+        count = (i32) sysconf(_SC_NPROCESSORS_ONLN);
+    #elif PNSLR_UNIX
+        // only the ones this process is allowed to run on
+        cpu_set_t set;
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) count = CPU_COUNT(&set);
+        else                                               count = (i32) sysconf(_SC_NPROCESSORS_ONLN);
+    #endif
+    return count > 0 ? count : 1;
+}
+
+void VZKR_YieldThread(void)
+{
+    #if PNSLR_WINDOWS
+        SwitchToThread();
+    #elif PNSLR_UNIX
+        sched_yield();
+    #endif
+}
+
+// Job System ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_JOB_QUEUE_DEFAULT_CAPACITY 4096
+#define VZKR_INTERNAL_JOB_QUEUE_MAX_CAPACITY     (1 << 24)
+#define VZKR_INTERNAL_JOB_IDLE_ROUNDS            64 // times a worker looks around before going to sleep
+
+typedef struct VZKR_Internal_Job
+{
+    VZKR_JobProcedure procedure;
+    rawptr userData;
+    VZKR_JobCounter* counter;
+} VZKR_Internal_Job;
+
+/**
+ * A Chase-Lev deque. Its owner pushes and pops at the bottom, everyone else steals from
+ * the top. 'top' and 'bottom' only ever grow, and wrap around the slots with 'mask'.
+ * Each end is on its own cache line.
+ */
+typedef struct VZKR_Internal_JobQueue
+{
+    i64 top;
+    VZKR_CACHE_LINE_PADDING(topPadding, 8);
+    i64 bottom;
+    VZKR_Internal_Job* slots;
+    i64 mask;
+    VZKR_CACHE_LINE_PADDING(bottomPadding, 24);
+} VZKR_Internal_JobQueue;
+
+typedef struct VZKR_Internal_JobWorker
+{
+    struct VZKR_Internal_JobSystem* system;
+    i32 queueIndex;
+} VZKR_Internal_JobWorker;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_Internal_JobWorker);
+
+/**
+ * Queue 0 belongs to the owner, the rest to the workers, one each.
+ * The shared queue takes jobs from every other thread; 'sharedCount' is kept outside the
+ * lock so it can be checked without taking it.
+ */
+typedef struct VZKR_Internal_JobSystem
+{
+    PNSLR_Allocator allocator;
+    VZKR_Internal_JobQueue* queues;
+    i32 numQueues;
+    PNSLR_ArraySlice(VZKR_Thread) threads;
+    PNSLR_ArraySlice(VZKR_Internal_JobWorker) workers;
+
+    VZKR_ProfiledMutex sharedMutex;
+    VZKR_Internal_Job* sharedSlots;
+    i64 sharedMask;
+    i64 sharedHead;
+    i64 sharedCount;
+
+    PNSLR_Semaphore wakeUp;
+    i64 numSleeping;
+    i64 shuttingDown;
+} VZKR_Internal_JobSystem;
+
+// which job system's queue (if any) belongs to the calling thread
+static VZKR_INTERNAL_THREAD_LOCAL VZKR_Internal_JobSystem* VZKR_Internal_CurrentJobSystem = nil;
+static VZKR_INTERNAL_THREAD_LOCAL i32 VZKR_Internal_CurrentJobQueue = -1;
+
+// a thief can read a slot while its owner reuses it; it then fails to claim it and
+// throws what it read away, but the accesses still have to be atomic
+
+static void VZKR_Internal_JobSlotWrite(VZKR_Internal_Job* slot, VZKR_Internal_Job job)
+{
+    VZKR_AtomicStorePtr((rawptr*) &slot->procedure, (rawptr) job.procedure, VZKR_MemoryOrder_Relaxed);
+    VZKR_AtomicStorePtr((rawptr*) &slot->userData, job.userData, VZKR_MemoryOrder_Relaxed);
+    VZKR_AtomicStorePtr((rawptr*) &slot->counter, (rawptr) job.counter, VZKR_MemoryOrder_Relaxed);
+}
+
+static VZKR_Internal_Job VZKR_Internal_JobSlotRead(VZKR_Internal_Job* slot)
+{
+    VZKR_Internal_Job job;
+    job.procedure = (VZKR_JobProcedure) VZKR_AtomicLoadPtr((rawptr*) &slot->procedure, VZKR_MemoryOrder_Relaxed);
+    job.userData  = VZKR_AtomicLoadPtr((rawptr*) &slot->userData, VZKR_MemoryOrder_Relaxed);
+    job.counter   = (VZKR_JobCounter*) VZKR_AtomicLoadPtr((rawptr*) &slot->counter, VZKR_MemoryOrder_Relaxed);
+    return job;
+}
+
+/** Owner only. Returns false if the queue is full. */
+static b8 VZKR_Internal_JobQueuePush(VZKR_Internal_JobQueue* queue, VZKR_Internal_Job job)
+{
+    i64 bottom = queue->bottom;
+    i64 top    = VZKR_AtomicLoadI64(&queue->top, VZKR_MemoryOrder_Acquire);
+    if (bottom - top > queue->mask) return false;
+
+    VZKR_Internal_JobSlotWrite(&queue->slots[bottom & queue->mask], job);
+    VZKR_AtomicStoreI64(&queue->bottom, bottom + 1, VZKR_MemoryOrder_Release);
+    return true;
+}
+
+/** Owner only. Takes the newest job. */
+static b8 VZKR_Internal_JobQueuePop(VZKR_Internal_JobQueue* queue, VZKR_Internal_Job* output)
+{
+    i64 bottom = queue->bottom - 1;
+    VZKR_AtomicStoreI64(&queue->bottom, bottom, VZKR_MemoryOrder_Release);
+    VZKR_AtomicFence(VZKR_MemoryOrder_SequentiallyConsistent);
+    i64 top = VZKR_AtomicLoadI64(&queue->top, VZKR_MemoryOrder_Acquire);
+
+    if (top > bottom)
+    {
+        VZKR_AtomicStoreI64(&queue->bottom, bottom + 1, VZKR_MemoryOrder_Release);
+        return false;
+    }
+
+    *output = VZKR_Internal_JobSlotRead(&queue->slots[bottom & queue->mask]);
+    if (top < bottom) return true;
+
+    // the last job, which a thief could be going for too
+    b8 won = VZKR_AtomicCompareExchangeI64(&queue->top, &top, top + 1, VZKR_MemoryOrder_SequentiallyConsistent);
+    VZKR_AtomicStoreI64(&queue->bottom, bottom + 1, VZKR_MemoryOrder_Release);
+    return won;
+}
+
+/** Anyone. Takes the oldest job; gives up if another thief got there first. */
+static b8 VZKR_Internal_JobQueueSteal(VZKR_Internal_JobQueue* queue, VZKR_Internal_Job* output)
+{
+    i64 top = VZKR_AtomicLoadI64(&queue->top, VZKR_MemoryOrder_Acquire);
+    VZKR_AtomicFence(VZKR_MemoryOrder_SequentiallyConsistent);
+    i64 bottom = VZKR_AtomicLoadI64(&queue->bottom, VZKR_MemoryOrder_Acquire);
+    if (top >= bottom) return false;
+
+    *output = VZKR_Internal_JobSlotRead(&queue->slots[top & queue->mask]);
+    return VZKR_AtomicCompareExchangeI64(&queue->top, &top, top + 1, VZKR_MemoryOrder_SequentiallyConsistent);
+}
+
+static b8 VZKR_Internal_JobSharedPush(VZKR_Internal_JobSystem* system, VZKR_Internal_Job job)
+{
+    VZKR_LockProfiledMutex(&system->sharedMutex);
+    b8 fits = system->sharedCount <= system->sharedMask;
+    if (fits)
+    {
+        system->sharedSlots[(system->sharedHead + system->sharedCount) & system->sharedMask] = job;
+        VZKR_AtomicFetchAddI64(&system->sharedCount, 1, VZKR_MemoryOrder_SequentiallyConsistent);
+    }
+    VZKR_UnlockProfiledMutex(&system->sharedMutex);
+    return fits;
+}
+
+static b8 VZKR_Internal_JobSharedTake(VZKR_Internal_JobSystem* system, VZKR_Internal_Job* output)
+{
+    if (VZKR_AtomicLoadI64(&system->sharedCount, VZKR_MemoryOrder_Acquire) == 0) return false;
+
+    VZKR_LockProfiledMutex(&system->sharedMutex);
+    b8 found = system->sharedCount > 0;
+    if (found)
+    {
+        *output = system->sharedSlots[system->sharedHead & system->sharedMask];
+        system->sharedHead++;
+        VZKR_AtomicFetchAddI64(&system->sharedCount, -1, VZKR_MemoryOrder_SequentiallyConsistent);
+    }
+    VZKR_UnlockProfiledMutex(&system->sharedMutex);
+    return found;
+}
+
+/** Whether there's any job anywhere, without taking one. */
+static b8 VZKR_Internal_JobSystemHasWork(VZKR_Internal_JobSystem* system)
+{
+    if (VZKR_AtomicLoadI64(&system->sharedCount, VZKR_MemoryOrder_Acquire) > 0) return true;
+
+    for (i32 i = 0; i < system->numQueues; i++)
+    {
+        VZKR_Internal_JobQueue* queue = &system->queues[i];
+        if (VZKR_AtomicLoadI64(&queue->bottom, VZKR_MemoryOrder_Acquire) > VZKR_AtomicLoadI64(&queue->top, VZKR_MemoryOrder_Acquire)) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Finds a job for a thread with queue 'self' (-1 if it has none): its own newest job
+ * first, then the shared queue, then stealing from everyone else, starting at random.
+ */
+static b8 VZKR_Internal_JobSystemFindJob(VZKR_Internal_JobSystem* system, i32 self, u64* rng, VZKR_Internal_Job* output)
+{
+    if (self >= 0 && VZKR_Internal_JobQueuePop(&system->queues[self], output)) return true;
+    if (VZKR_Internal_JobSharedTake(system, output)) return true;
+
+    // xorshift, to keep thieves from all going after the same victim
+    *rng ^= *rng << 13;
+    *rng ^= *rng >> 7;
+    *rng ^= *rng << 17;
+
+    i32 start = (i32) (*rng % (u64) system->numQueues);
+    for (i32 i = 0; i < system->numQueues; i++)
+    {
+        i32 victim = (start + i) % system->numQueues;
+        if (victim != self && VZKR_Internal_JobQueueSteal(&system->queues[victim], output)) return true;
+    }
+
+    return false;
+}
+
+static void VZKR_Internal_JobRun(VZKR_Internal_Job job)
+{
+    job.procedure(job.userData);
+    if (job.counter) VZKR_AtomicFetchAddI64(&job.counter->remaining, -1, VZKR_MemoryOrder_SequentiallyConsistent);
+}
+
+/** Wakes up a sleeping worker, if there is one. */
+static void VZKR_Internal_JobSystemWakeOne(VZKR_Internal_JobSystem* system)
+{
+    // whoever is about to sleep either sees the new job, or is seen here
+    VZKR_AtomicFence(VZKR_MemoryOrder_SequentiallyConsistent);
+
+    i64 numSleeping = VZKR_AtomicLoadI64(&system->numSleeping, VZKR_MemoryOrder_Acquire);
+    while (numSleeping > 0)
+    {
+        if (VZKR_AtomicCompareExchangeI64(&system->numSleeping, &numSleeping, numSleeping - 1, VZKR_MemoryOrder_SequentiallyConsistent))
+        {
+            PNSLR_SignalSemaphore(&system->wakeUp, 1);
+            return;
+        }
+    }
+}
+
+static void VZKR_Internal_JobSystemSubmit(VZKR_Internal_JobSystem* system, VZKR_Internal_Job job)
+{
+    b8 queued = (VZKR_Internal_CurrentJobSystem == system) ?
+        VZKR_Internal_JobQueuePush(&system->queues[VZKR_Internal_CurrentJobQueue], job) :
+        VZKR_Internal_JobSharedPush(system, job);
+
+    // a full queue means there's plenty of work around already
+    if (!queued) { VZKR_Internal_JobRun(job); return; }
+    VZKR_Internal_JobSystemWakeOne(system);
+}
+
+static void VZKR_Internal_JobWorkerMain(rawptr arg)
+{
+    VZKR_Internal_JobWorker* worker = (VZKR_Internal_JobWorker*) arg;
+    VZKR_Internal_JobSystem* system = worker->system;
+    VZKR_Internal_CurrentJobSystem  = system;
+    VZKR_Internal_CurrentJobQueue   = worker->queueIndex;
+
+    u64 rng = 0x9E3779B97F4A7C15ull * (u64) (worker->queueIndex + 1);
+    i32 idleRounds = 0;
+    while (true)
+    {
+        VZKR_Internal_Job job;
+        if (VZKR_Internal_JobSystemFindJob(system, worker->queueIndex, &rng, &job))
+        {
+            VZKR_Internal_JobRun(job);
+            idleRounds = 0;
+            continue;
+        }
+
+        if (VZKR_AtomicLoadI64(&system->shuttingDown, VZKR_MemoryOrder_Acquire)) break;
+        if (++idleRounds < VZKR_INTERNAL_JOB_IDLE_ROUNDS) { VZKR_YieldThread(); continue; }
+        idleRounds = 0;
+
+        VZKR_AtomicFetchAddI64(&system->numSleeping, 1, VZKR_MemoryOrder_SequentiallyConsistent);
+        if (VZKR_Internal_JobSystemHasWork(system) || VZKR_AtomicLoadI64(&system->shuttingDown, VZKR_MemoryOrder_Acquire))
+        {
+            // back out, unless someone already counted this worker as woken up
+            i64 numSleeping = VZKR_AtomicLoadI64(&system->numSleeping, VZKR_MemoryOrder_Acquire);
+            while (numSleeping > 0 && !VZKR_AtomicCompareExchangeI64(&system->numSleeping, &numSleeping, numSleeping - 1, VZKR_MemoryOrder_SequentiallyConsistent))
+            {
+                VZKR_CpuRelax(); // a failed compare-and-swap has already reloaded 'numSleeping'
+            }
+
+            if (numSleeping > 0) continue;
+        }
+
+        PNSLR_WaitSemaphore(&system->wakeUp);
+    }
+
+    VZKR_Internal_CurrentJobSystem = nil;
+    VZKR_Internal_CurrentJobQueue  = -1;
+}
+
+static void VZKR_Internal_JobSystemFree(VZKR_Internal_JobSystem* system)
+{
+    PNSLR_Allocator allocator = system->allocator;
+    for (i32 i = 0; system->queues && i < system->numQueues; i++)
+    {
+        if (system->queues[i].slots) PNSLR_Free(allocator, system->queues[i].slots, PNSLR_GET_LOC(), nil);
+    }
+
+    if (system->queues)      PNSLR_Free(allocator, system->queues, PNSLR_GET_LOC(), nil);
+    if (system->sharedSlots) PNSLR_Free(allocator, system->sharedSlots, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&system->threads, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&system->workers, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_DestroySemaphore(&system->wakeUp);
+    VZKR_DestroyProfiledMutex(&system->sharedMutex);
+    PNSLR_Free(allocator, system, PNSLR_GET_LOC(), nil);
+}
+
+/** Stops and joins every worker that was started. */
+static void VZKR_Internal_JobSystemStopWorkers(VZKR_Internal_JobSystem* system)
+{
+    VZKR_AtomicStoreI64(&system->shuttingDown, 1, VZKR_MemoryOrder_Release);
+    PNSLR_SignalSemaphore(&system->wakeUp, (i32) system->threads.count);
+
+    for (i64 i = 0; i < system->threads.count; i++) { VZKR_JoinThread(&system->threads.data[i]); }
+}
+
+VZKR_JobSystem VZKR_CreateJobSystem(
+    VZKR_JobSystemOptions options,
+    PNSLR_Allocator allocator
+)
+{
+    i32 numCores   = VZKR_GetNumLogicalCores();
+    i32 numWorkers = (options.numWorkers > 0) ? options.numWorkers : numCores - 1;
+    if (numWorkers < 0) numWorkers = 0;
+
+    i32 capacity = (options.queueCapacity > 0) ? options.queueCapacity : VZKR_INTERNAL_JOB_QUEUE_DEFAULT_CAPACITY;
+    if (capacity > VZKR_INTERNAL_JOB_QUEUE_MAX_CAPACITY) capacity = VZKR_INTERNAL_JOB_QUEUE_MAX_CAPACITY;
+    i32 rounded = 1;
+    while (rounded < capacity) rounded <<= 1;
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_JobSystem* system = (VZKR_Internal_JobSystem*) PNSLR_Allocate(allocator, true, (i32) sizeof(VZKR_Internal_JobSystem), (i32) alignof(VZKR_Internal_JobSystem), PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !system) return (VZKR_JobSystem) {0};
+
+    system->allocator   = allocator;
+    system->numQueues   = numWorkers + 1;
+    system->sharedMask  = rounded - 1;
+    system->sharedMutex = VZKR_CreateProfiledMutex(PNSLR_GET_LOC());
+    system->wakeUp      = PNSLR_CreateSemaphore(0);
+
+    i32 slotsSize = rounded * (i32) sizeof(VZKR_Internal_Job);
+    system->queues      = (VZKR_Internal_JobQueue*) PNSLR_Allocate(allocator, true, system->numQueues * (i32) sizeof(VZKR_Internal_JobQueue), VZKR_CACHE_LINE_SIZE, PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) system->sharedSlots = (VZKR_Internal_Job*) PNSLR_Allocate(allocator, false, slotsSize, (i32) alignof(VZKR_Internal_Job), PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) system->threads     = PNSLR_MakeSlice(VZKR_Thread, numWorkers, true, allocator, PNSLR_GET_LOC(), &err);
+    if (err == PNSLR_AllocatorError_None) system->workers     = PNSLR_MakeSlice(VZKR_Internal_JobWorker, numWorkers, true, allocator, PNSLR_GET_LOC(), &err);
+
+    for (i32 i = 0; system->queues && i < system->numQueues && err == PNSLR_AllocatorError_None; i++)
+    {
+        system->queues[i].mask  = rounded - 1;
+        system->queues[i].slots = (VZKR_Internal_Job*) PNSLR_Allocate(allocator, false, slotsSize, (i32) alignof(VZKR_Internal_Job), PNSLR_GET_LOC(), &err);
+    }
+
+    if (err != PNSLR_AllocatorError_None || !system->queues || !system->sharedSlots)
+    {
+        VZKR_Internal_JobSystemFree(system);
+        return (VZKR_JobSystem) {0};
+    }
+
+    VZKR_Internal_CurrentJobSystem = system;
+    VZKR_Internal_CurrentJobQueue  = 0;
+
+    system->threads.count = 0;
+    for (i32 i = 0; i < numWorkers; i++)
+    {
+        system->workers.data[i] = (VZKR_Internal_JobWorker) {.system = system, .queueIndex = i + 1};
+
+        // "VzkrJob <n>", short enough to survive Linux's limit
+        u8 name[24] = {'V', 'z', 'k', 'r', 'J', 'o', 'b', ' '};
+        i32 nameLength = 8, number = i + 1, numDigits = 1;
+        for (i32 rest = number / 10; rest > 0; rest /= 10) numDigits++;
+        for (i32 d = numDigits - 1; d >= 0; d--, number /= 10) name[nameLength + d] = (u8) ('0' + number % 10);
+        nameLength += numDigits;
+
+        VZKR_ThreadOptions threadOptions = {.name = {.data = name, .count = nameLength}};
+        i32 core = (i + 1) % numCores;
+        if (options.pinWorkers && core < 64) threadOptions.affinityMask = 1ull << core;
+
+        VZKR_Thread thread = VZKR_CreateThread(VZKR_Internal_JobWorkerMain, &system->workers.data[i], threadOptions, allocator);
+        if (!thread.handle)
+        {
+            VZKR_Internal_JobSystemStopWorkers(system);
+            VZKR_Internal_CurrentJobSystem = nil;
+            VZKR_Internal_CurrentJobQueue  = -1;
+            VZKR_Internal_JobSystemFree(system);
+            return (VZKR_JobSystem) {0};
+        }
+
+        system->threads.data[system->threads.count++] = thread;
+    }
+
+    return (VZKR_JobSystem) {.handle = (rawptr) system};
+}
+
+void VZKR_DestroyJobSystem(VZKR_JobSystem* jobs)
+{
+    if (!jobs || !jobs->handle) return;
+    VZKR_Internal_JobSystem* system = (VZKR_Internal_JobSystem*) jobs->handle;
+
+    // the workers keep going until everything's done, so only the owner's queue is left
+    VZKR_Internal_Job job;
+    u64 rng = 0x9E3779B97F4A7C15ull;
+    while (VZKR_Internal_JobSystemFindJob(system, 0, &rng, &job)) { VZKR_Internal_JobRun(job); }
+
+    VZKR_Internal_JobSystemStopWorkers(system);
+
+    if (VZKR_Internal_CurrentJobSystem == system)
+    {
+        VZKR_Internal_CurrentJobSystem = nil;
+        VZKR_Internal_CurrentJobQueue  = -1;
+    }
+
+    VZKR_Internal_JobSystemFree(system);
+    *jobs = (VZKR_JobSystem) {0};
+}
+
+i32 VZKR_GetJobSystemNumThreads(VZKR_JobSystem jobs)
+{
+    if (!jobs.handle) return 0;
+    return ((VZKR_Internal_JobSystem*) jobs.handle)->numQueues;
+}
+
+void VZKR_RunJob(
+    VZKR_JobSystem jobs,
+    VZKR_JobDecl job,
+    VZKR_JobCounter* counter
+)
+{
+    if (!jobs.handle || !job.procedure) return;
+
+    if (counter) VZKR_AtomicFetchAddI64(&counter->remaining, 1, VZKR_MemoryOrder_SequentiallyConsistent);
+    VZKR_Internal_JobSystemSubmit((VZKR_Internal_JobSystem*) jobs.handle, (VZKR_Internal_Job) {.procedure = job.procedure, .userData = job.userData, .counter = counter});
+}
+
+void VZKR_RunJobs(
+    VZKR_JobSystem jobs,
+    PNSLR_ArraySlice(VZKR_JobDecl) decls,
+    VZKR_JobCounter* counter
+)
+{
+    if (!jobs.handle) return;
+    VZKR_Internal_JobSystem* system = (VZKR_Internal_JobSystem*) jobs.handle;
+
+    // counted up front, so none of them finishing early can make the counter hit zero
+    i64 numJobs = 0;
+    for (i64 i = 0; i < decls.count; i++) { if (decls.data[i].procedure) numJobs++; }
+    if (counter && numJobs > 0) VZKR_AtomicFetchAddI64(&counter->remaining, numJobs, VZKR_MemoryOrder_SequentiallyConsistent);
+
+    for (i64 i = 0; i < decls.count; i++)
+    {
+        VZKR_JobDecl decl = decls.data[i];
+        if (decl.procedure) VZKR_Internal_JobSystemSubmit(system, (VZKR_Internal_Job) {.procedure = decl.procedure, .userData = decl.userData, .counter = counter});
+    }
+}
+
+b8 VZKR_AreJobsDone(VZKR_JobCounter* counter)
+{
+    return !counter || VZKR_AtomicLoadI64(&counter->remaining, VZKR_MemoryOrder_Acquire) <= 0;
+}
+
+void VZKR_WaitForJobs(
+    VZKR_JobSystem jobs,
+    VZKR_JobCounter* counter
+)
+{
+    if (!jobs.handle || !counter) return;
+    VZKR_Internal_JobSystem* system = (VZKR_Internal_JobSystem*) jobs.handle;
+
+    i32 self = (VZKR_Internal_CurrentJobSystem == system) ? VZKR_Internal_CurrentJobQueue : -1;
+    u64 rng  = (0x9E3779B97F4A7C15ull ^ (u64) (rawptr) counter) | 1;
+    while (VZKR_AtomicLoadI64(&counter->remaining, VZKR_MemoryOrder_Acquire) > 0)
+    {
+        VZKR_Internal_Job job;
+        if (VZKR_Internal_JobSystemFindJob(system, self, &rng, &job)) VZKR_Internal_JobRun(job);
+        else                                                         VZKR_YieldThread();
+    }
+}
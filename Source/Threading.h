@@ -0,0 +1,215 @@
+#ifndef VZKR_THREADING_H // ========================================================
+#define VZKR_THREADING_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Threads ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A cross-platform opaque handle to a thread.
+ * Every thread that's created has to be joined, to free its resources.
+ */
+typedef struct VZKR_Thread
+{
+    rawptr handle;
+} VZKR_Thread;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_Thread);
+
+/**
+ * The signature of the procedure a thread runs.
+ */
+typedef void (*VZKR_ThreadProcedure)(
+    rawptr userData
+);
+
+/**
+ * Options for creating a thread.
+ * 'name' shows up in debuggers and profilers (and is cut short to 15 bytes on Linux).
+ * 'affinityMask' has a bit set for every logical core the thread may run on (only the
+ * first 64 can be picked); zero lets it run anywhere.
+ * 'stackSize' is in bytes, with the OS default if not positive.
+ */
+typedef struct VZKR_ThreadOptions
+{
+    utf8str name;
+    u64 affinityMask;
+    i32 stackSize;
+} VZKR_ThreadOptions;
+
+/**
+ * Creates a thread, running a procedure with some user data.
+ * The allocator is used for bookkeeping, and must stay valid until the thread is joined.
+ * If creating failed, the returned handle will be zeroed.
+ */
+VZKR_Thread VZKR_CreateThread(
+    VZKR_ThreadProcedure procedure,
+    rawptr userData,
+    VZKR_ThreadOptions options,
+    PNSLR_Allocator allocator
+);
+
+/**
+ * Waits for a thread to finish, and frees it.
+ */
+void VZKR_JoinThread(
+    VZKR_Thread* thread
+);
+
+/**
+ * Names the calling thread, for debuggers and profilers.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_SetCurrentThreadName(
+    utf8str name
+);
+
+/**
+ * Restricts the calling thread to the logical cores set in the mask (zero means any).
+ * Not supported on Apple platforms, where the OS doesn't allow it.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_SetCurrentThreadAffinity(
+    u64 affinityMask
+);
+
+/**
+ * Gets the number of logical cores available to the process (at least 1).
+ */
+i32 VZKR_GetNumLogicalCores(void);
+
+/**
+ * Gives up the rest of the calling thread's time slice, to any other thread that's ready
+ * to run.
+ */
+void VZKR_YieldThread(void);
+
+// Job System ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A cross-platform opaque handle to a job system: a pool of worker threads that run
+ * small jobs, so work like parsing, layout and rendering prep can use every core.
+ *
+ * Each worker (and the thread that created the system) has its own queue of jobs,
+ * taking the newest job from its own queue and, once that's empty, stealing the oldest
+ * one from someone else's. Jobs from other threads go to a shared queue.
+ * Workers sleep when there's nothing to do anywhere.
+ */
+typedef struct VZKR_JobSystem
+{
+    rawptr handle;
+} VZKR_JobSystem;
+
+/**
+ * The signature of the procedure a job runs.
+ */
+typedef void (*VZKR_JobProcedure)(
+    rawptr userData
+);
+
+/**
+ * A job to run.
+ */
+typedef struct VZKR_JobDecl
+{
+    VZKR_JobProcedure procedure;
+    rawptr userData;
+} VZKR_JobDecl;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_JobDecl);
+
+/**
+ * Counts the jobs that are still to finish, out of the ones started with it, so they
+ * can be waited on together. Start it zeroed; it can be reused once it's back at zero.
+ */
+typedef struct VZKR_JobCounter
+{
+    i64 remaining;
+} VZKR_JobCounter;
+
+/**
+ * Options for creating a job system.
+ * 'numWorkers' is the number of worker threads, defaulting to one less than the number of
+ * logical cores (so the creating thread makes up the rest).
+ * 'queueCapacity' is the number of jobs each queue can hold (rounded up to a power of two,
+ * 4096 if not positive); jobs that don't fit are run right away, on the starting thread.
+ * 'pinWorkers' restricts each worker to a core of its own.
+ */
+typedef struct VZKR_JobSystemOptions
+{
+    i32 numWorkers;
+    i32 queueCapacity;
+    b8 pinWorkers;
+} VZKR_JobSystemOptions;
+
+/**
+ * Creates a job system, whose workers start right away.
+ * The calling thread becomes its owner, and is the only other thread that gets a queue
+ * of its own.
+ * If creating failed, the returned handle will be zeroed.
+ */
+VZKR_JobSystem VZKR_CreateJobSystem(
+    VZKR_JobSystemOptions options,
+    PNSLR_Allocator allocator
+);
+
+/**
+ * Runs every job that's still queued, stops the workers, and frees the job system.
+ * Has to be called from the thread that created it.
+ */
+void VZKR_DestroyJobSystem(
+    VZKR_JobSystem* jobs
+);
+
+/**
+ * Gets the number of threads that run jobs: the workers, plus the owner.
+ */
+i32 VZKR_GetJobSystemNumThreads(
+    VZKR_JobSystem jobs
+);
+
+/**
+ * Queues up a job, optionally counting it in a counter.
+ * Can be called from any thread, including from inside other jobs.
+ */
+void VZKR_RunJob(
+    VZKR_JobSystem jobs,
+    VZKR_JobDecl job,
+    VZKR_JobCounter* counter
+);
+
+/**
+ * Queues up several jobs at once, optionally counting them in a counter.
+ * Can be called from any thread, including from inside other jobs.
+ */
+void VZKR_RunJobs(
+    VZKR_JobSystem jobs,
+    PNSLR_ArraySlice(VZKR_JobDecl) decls,
+    VZKR_JobCounter* counter
+);
+
+/**
+ * Checks whether every job counted in a counter has finished, without waiting.
+ */
+b8 VZKR_AreJobsDone(
+    VZKR_JobCounter* counter
+);
+
+/**
+ * Waits for every job counted in a counter to finish, running other jobs in the
+ * meantime instead of just blocking, so waiting from inside a job doesn't hold up a
+ * worker (and the owner can help out while it waits).
+ */
+void VZKR_WaitForJobs(
+    VZKR_JobSystem jobs,
+    VZKR_JobCounter* counter
+);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_THREADING_H =========================================================
@@ -0,0 +1,328 @@
+#define VZKR_IMPLEMENTATION
+#include "TimerWheel.h"
+
+// Timer Wheel ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_TIMER_WHEEL_SLOT_BITS 6
+#define VZKR_INTERNAL_TIMER_WHEEL_SLOTS     (1 << VZKR_INTERNAL_TIMER_WHEEL_SLOT_BITS)
+#define VZKR_INTERNAL_TIMER_WHEEL_LEVELS    11 // enough slot bits for every 64-bit tick
+#define VZKR_INTERNAL_TIMER_WHEEL_MAX_WAIT  ((i64) 0x7FFFFFFFFFFFFFFFLL)
+
+typedef struct VZKR_Internal_Timer
+{
+    VZKR_TimerProcedure procedure;
+    rawptr userData;
+    u64 expiry; // tick
+    u64 period; // ticks, zero if not periodic
+    i32 prev;
+    i32 next;   // the next free timer, while free
+    i32 slot;   // across every level, -1 while free
+    u32 generation;
+} VZKR_Internal_Timer;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_Internal_Timer);
+
+/**
+ * Each level has a slot per 6-bit digit of a tick, and a timer sits in the level of the
+ * highest digit where its expiry differs from the current tick, in the slot for its own
+ * digit there. That digit is always ahead of the current tick's, so reaching the slot
+ * means moving its timers down a level (or more), until they reach the bottom level and
+ * fire; a bit mask per level finds the next occupied slot, so advancing skips straight
+ * past empty ones.
+ */
+typedef struct VZKR_Internal_TimerWheel
+{
+    PNSLR_Allocator allocator;
+    VZKR_FastMutex mutex;
+    i64 tickNs;
+    i64 startNs;
+    u64 tick;
+    PNSLR_ArraySlice(VZKR_Internal_Timer) timers;
+    i32 numTimers;
+    i32 firstFree;
+    u64 occupied[VZKR_INTERNAL_TIMER_WHEEL_LEVELS];
+    i32 slots[VZKR_INTERNAL_TIMER_WHEEL_LEVELS * VZKR_INTERNAL_TIMER_WHEEL_SLOTS];
+} VZKR_Internal_TimerWheel;
+
+static i32 VZKR_Internal_TimerLowestBit(u64 mask)
+{
+    #if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long idx; _BitScanForward64(&idx, mask); return (i32) idx;
+    #else
+        return __builtin_ctzll(mask);
+    #endif
+}
+
+static i32 VZKR_Internal_TimerHighestBit(u64 mask)
+{
+    #if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long idx; _BitScanReverse64(&idx, mask); return (i32) idx;
+    #else
+        return 63 - __builtin_clzll(mask);
+    #endif
+}
+
+static u64 VZKR_Internal_TimerTicks(VZKR_Internal_TimerWheel* wheel, i64 durationNs)
+{
+    return durationNs <= 0 ? 0 : (u64) ((durationNs - 1) / wheel->tickNs) + 1;
+}
+
+static void VZKR_Internal_TimerLink(VZKR_Internal_TimerWheel* wheel, i32 index)
+{
+    VZKR_Internal_Timer* timer = &wheel->timers.data[index];
+    u64 difference = timer->expiry ^ wheel->tick;
+    i32 level      = difference ? VZKR_Internal_TimerHighestBit(difference) / VZKR_INTERNAL_TIMER_WHEEL_SLOT_BITS : 0;
+    i32 digit      = (i32) (timer->expiry >> (level * VZKR_INTERNAL_TIMER_WHEEL_SLOT_BITS)) & (VZKR_INTERNAL_TIMER_WHEEL_SLOTS - 1);
+
+    timer->slot = level * VZKR_INTERNAL_TIMER_WHEEL_SLOTS + digit;
+    timer->prev = -1;
+    timer->next = wheel->slots[timer->slot];
+    if (timer->next >= 0) wheel->timers.data[timer->next].prev = index;
+    wheel->slots[timer->slot] = index;
+    wheel->occupied[level] |= 1ULL << digit;
+}
+
+static void VZKR_Internal_TimerUnlink(VZKR_Internal_TimerWheel* wheel, i32 index)
+{
+    VZKR_Internal_Timer* timer = &wheel->timers.data[index];
+    if (timer->prev >= 0) wheel->timers.data[timer->prev].next = timer->next;
+    else                  wheel->slots[timer->slot] = timer->next;
+    if (timer->next >= 0) wheel->timers.data[timer->next].prev = timer->prev;
+
+    if (wheel->slots[timer->slot] < 0)
+        wheel->occupied[timer->slot / VZKR_INTERNAL_TIMER_WHEEL_SLOTS] &= ~(1ULL << (timer->slot % VZKR_INTERNAL_TIMER_WHEEL_SLOTS));
+
+    timer->slot = -1;
+}
+
+static void VZKR_Internal_TimerRelease(VZKR_Internal_TimerWheel* wheel, i32 index)
+{
+    VZKR_Internal_Timer* timer = &wheel->timers.data[index];
+    timer->generation++;
+    timer->next      = wheel->firstFree;
+    wheel->firstFree = index;
+}
+
+/** Finds the next tick that has a slot to move down or fire. Returns false if there are no timers. */
+static b8 VZKR_Internal_TimerNextEvent(VZKR_Internal_TimerWheel* wheel, u64* tick)
+{
+    // slots on lower levels always come before ones on higher levels
+    for (i32 level = 0; level < VZKR_INTERNAL_TIMER_WHEEL_LEVELS; level++)
+    {
+        i32 shift = level * VZKR_INTERNAL_TIMER_WHEEL_SLOT_BITS;
+        i32 digit = (i32) (wheel->tick >> shift) & (VZKR_INTERNAL_TIMER_WHEEL_SLOTS - 1);
+        u64 ahead = wheel->occupied[level] & ~((2ULL << digit) - 1);
+        if (!ahead) continue;
+
+        i32 upperShift = shift + VZKR_INTERNAL_TIMER_WHEEL_SLOT_BITS;
+        u64 upper      = upperShift < 64 ? (wheel->tick >> upperShift) << upperShift : 0;
+        *tick = upper | ((u64) VZKR_Internal_TimerLowestBit(ahead) << shift);
+        return true;
+    }
+
+    return false;
+}
+
+VZKR_TimerWheel VZKR_CreateTimerWheel(
+    i64 tickNs,
+    i64 nowNs,
+    PNSLR_Allocator allocator
+)
+{
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_TimerWheel* wheel = (VZKR_Internal_TimerWheel*) PNSLR_Allocate(allocator, true, (i32) sizeof(VZKR_Internal_TimerWheel), (i32) alignof(VZKR_Internal_TimerWheel), PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None || !wheel) return (VZKR_TimerWheel) {0};
+
+    wheel->allocator = allocator;
+    wheel->tickNs    = tickNs > 0 ? tickNs : 1000000;
+    wheel->startNs   = nowNs;
+    wheel->firstFree = -1;
+    for (i32 i = 0; i < VZKR_INTERNAL_TIMER_WHEEL_LEVELS * VZKR_INTERNAL_TIMER_WHEEL_SLOTS; i++) wheel->slots[i] = -1;
+
+    return (VZKR_TimerWheel) {.handle = (rawptr) wheel};
+}
+
+void VZKR_DestroyTimerWheel(VZKR_TimerWheel* wheel)
+{
+    if (!wheel || !wheel->handle) return;
+
+    VZKR_Internal_TimerWheel* internal = (VZKR_Internal_TimerWheel*) wheel->handle;
+    PNSLR_FreeSlice(&internal->timers, internal->allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_Free(internal->allocator, internal, PNSLR_GET_LOC(), nil);
+    *wheel = (VZKR_TimerWheel) {0};
+}
+
+VZKR_Timer VZKR_StartTimer(
+    VZKR_TimerWheel wheel,
+    i64 delayNs,
+    i64 periodNs,
+    VZKR_TimerProcedure procedure,
+    rawptr userData
+)
+{
+    VZKR_Internal_TimerWheel* internal = (VZKR_Internal_TimerWheel*) wheel.handle;
+    if (!internal || !procedure) return (VZKR_Timer) {0};
+
+    VZKR_LockFastMutex(&internal->mutex);
+
+    i32 index = internal->firstFree;
+    if (index >= 0)
+    {
+        internal->firstFree = internal->timers.data[index].next;
+    }
+    else
+    {
+        if (internal->numTimers == internal->timers.count)
+        {
+            PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+            PNSLR_ResizeSlice(VZKR_Internal_Timer, &internal->timers, internal->timers.count ? internal->timers.count * 2 : 64, false, internal->allocator, PNSLR_GET_LOC(), &err);
+            if (err != PNSLR_AllocatorError_None) { VZKR_UnlockFastMutex(&internal->mutex); return (VZKR_Timer) {0}; }
+        }
+
+        index = internal->numTimers++;
+        internal->timers.data[index].generation = 0;
+    }
+
+    u64 delay = VZKR_Internal_TimerTicks(internal, delayNs);
+    VZKR_Internal_Timer* timer = &internal->timers.data[index];
+    timer->procedure = procedure;
+    timer->userData  = userData;
+    timer->expiry    = internal->tick + (delay ? delay : 1);
+    timer->period    = VZKR_Internal_TimerTicks(internal, periodNs);
+    VZKR_Internal_TimerLink(internal, index);
+
+    VZKR_Timer output = {.handle = ((u64) timer->generation << 32) | (u64) (index + 1)};
+    VZKR_UnlockFastMutex(&internal->mutex);
+    return output;
+}
+
+b8 VZKR_CancelTimer(
+    VZKR_TimerWheel wheel,
+    VZKR_Timer timer
+)
+{
+    VZKR_Internal_TimerWheel* internal = (VZKR_Internal_TimerWheel*) wheel.handle;
+    if (!internal || !timer.handle) return false;
+
+    // the handle can be anything, so the index gets checked both ways
+    i32 index      = (i32) (timer.handle & 0xFFFFFFFF) - 1;
+    u32 generation = (u32) (timer.handle >> 32);
+
+    VZKR_LockFastMutex(&internal->mutex);
+
+    b8 output = index >= 0 && index < internal->numTimers && internal->timers.data[index].generation == generation && internal->timers.data[index].slot >= 0;
+    if (output)
+    {
+        VZKR_Internal_TimerUnlink(internal, index);
+        VZKR_Internal_TimerRelease(internal, index);
+    }
+
+    VZKR_UnlockFastMutex(&internal->mutex);
+    return output;
+}
+
+i32 VZKR_AdvanceTimerWheel(
+    VZKR_TimerWheel wheel,
+    i64 nowNs
+)
+{
+    VZKR_Internal_TimerWheel* internal = (VZKR_Internal_TimerWheel*) wheel.handle;
+    if (!internal) return 0;
+
+    i32 numFired = 0;
+    VZKR_LockFastMutex(&internal->mutex);
+
+    u64 target = nowNs > internal->startNs ? (u64) ((nowNs - internal->startNs) / internal->tickNs) : 0;
+    for (;;)
+    {
+        i32 due = internal->slots[internal->tick & (VZKR_INTERNAL_TIMER_WHEEL_SLOTS - 1)];
+        if (due < 0)
+        {
+            u64 next = 0;
+            if (!VZKR_Internal_TimerNextEvent(internal, &next) || next > target)
+            {
+                if (target > internal->tick) internal->tick = target;
+                break;
+            }
+
+            // move the timers in the slots just reached down, from the top level so they
+            // can drop several levels at once
+            internal->tick = next;
+            for (i32 level = VZKR_INTERNAL_TIMER_WHEEL_LEVELS - 1; level > 0; level--)
+            {
+                i32 slot  = level * VZKR_INTERNAL_TIMER_WHEEL_SLOTS + ((i32) (next >> (level * VZKR_INTERNAL_TIMER_WHEEL_SLOT_BITS)) & (VZKR_INTERNAL_TIMER_WHEEL_SLOTS - 1));
+                i32 index = internal->slots[slot];
+                if (index < 0) continue;
+
+                internal->slots[slot] = -1;
+                internal->occupied[level] &= ~(1ULL << (slot % VZKR_INTERNAL_TIMER_WHEEL_SLOTS));
+                while (index >= 0)
+                {
+                    i32 nextIndex = internal->timers.data[index].next;
+                    VZKR_Internal_TimerLink(internal, index);
+                    index = nextIndex;
+                }
+            }
+
+            continue;
+        }
+
+        // one at a time, so the procedures can start and cancel timers (including this
+        // one, if it's periodic) without the wheel locked
+        VZKR_Internal_Timer* timer     = &internal->timers.data[due];
+        VZKR_TimerProcedure  procedure = timer->procedure;
+        rawptr               userData  = timer->userData;
+        VZKR_Internal_TimerUnlink(internal, due);
+        if (timer->period)
+        {
+            timer->expiry += timer->period;
+            VZKR_Internal_TimerLink(internal, due);
+        }
+        else
+        {
+            VZKR_Internal_TimerRelease(internal, due);
+        }
+
+        VZKR_UnlockFastMutex(&internal->mutex);
+        procedure(userData);
+        numFired++;
+        VZKR_LockFastMutex(&internal->mutex);
+    }
+
+    VZKR_UnlockFastMutex(&internal->mutex);
+    return numFired;
+}
+
+i64 VZKR_GetTimerWheelWaitTime(
+    VZKR_TimerWheel wheel,
+    i64 nowNs
+)
+{
+    VZKR_Internal_TimerWheel* internal = (VZKR_Internal_TimerWheel*) wheel.handle;
+    if (!internal) return -1;
+
+    VZKR_LockFastMutex(&internal->mutex);
+
+    u64 next   = 0;
+    i64 output = -1;
+    if (internal->slots[internal->tick & (VZKR_INTERNAL_TIMER_WHEEL_SLOTS - 1)] >= 0)
+    {
+        output = 0;
+    }
+    else if (VZKR_Internal_TimerNextEvent(internal, &next))
+    {
+        u64 ahead = next - internal->tick;
+        if (ahead > (u64) (VZKR_INTERNAL_TIMER_WHEEL_MAX_WAIT / internal->tickNs))
+        {
+            output = VZKR_INTERNAL_TIMER_WHEEL_MAX_WAIT;
+        }
+        else
+        {
+            output = internal->startNs + (i64) internal->tick * internal->tickNs + (i64) ahead * internal->tickNs - nowNs;
+            if (output < 0) output = 0;
+        }
+    }
+
+    VZKR_UnlockFastMutex(&internal->mutex);
+    return output;
+}
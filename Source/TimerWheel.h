@@ -0,0 +1,112 @@
+#ifndef VZKR_TIMER_WHEEL_H // ======================================================
+#define VZKR_TIMER_WHEEL_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Timer Wheel ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A cross-platform opaque handle to a hierarchical timer wheel: one-shot and periodic
+ * timers of any 64-bit duration, fired by advancing the wheel to the current time (from
+ * the frame loop, or a thread of its own that sleeps until the next one is due).
+ *
+ * Starting and cancelling timers takes constant time, and advancing only costs anything
+ * for timers that fire (or move closer to firing, a handful of times over their life),
+ * so thousands of pending timers cost next to nothing.
+ *
+ * Time is counted in ticks of a fixed length; timers fire on the first advance at or
+ * after the tick they're due on. Every function can be called from any thread, and from
+ * the timers' own procedures (which run on the advancing thread, without the wheel
+ * locked).
+ */
+typedef struct VZKR_TimerWheel
+{
+    rawptr handle;
+} VZKR_TimerWheel;
+
+/**
+ * Identifies a timer started on a timer wheel, for cancelling it.
+ * Zeroed if starting failed.
+ */
+typedef struct VZKR_Timer
+{
+    u64 handle;
+} VZKR_Timer;
+
+/**
+ * The signature of the procedure a timer runs when it fires.
+ */
+typedef void (*VZKR_TimerProcedure)(
+    rawptr userData
+);
+
+/**
+ * Creates a timer wheel.
+ * 'tickNs' is the length of a tick (defaults to a millisecond, if not positive).
+ * 'nowNs' is the current time, in whatever nanosecond clock will be used to advance it.
+ * If creating failed, the returned handle will be zeroed.
+ */
+VZKR_TimerWheel VZKR_CreateTimerWheel(
+    i64 tickNs,
+    i64 nowNs,
+    PNSLR_Allocator allocator
+);
+
+/**
+ * Frees a timer wheel, without firing any of its timers.
+ */
+void VZKR_DestroyTimerWheel(
+    VZKR_TimerWheel* wheel
+);
+
+/**
+ * Starts a timer that fires after 'delayNs' (rounded up to whole ticks, at least one),
+ * counted from the wheel's last advance, and then every 'periodNs' (if positive) until
+ * cancelled. Periodic timers are rescheduled from when they were due, so they don't
+ * drift.
+ */
+VZKR_Timer VZKR_StartTimer(
+    VZKR_TimerWheel wheel,
+    i64 delayNs,
+    i64 periodNs,
+    VZKR_TimerProcedure procedure,
+    rawptr userData
+);
+
+/**
+ * Stops a timer from firing (again).
+ * Returns false if it had already fired (and isn't periodic) or been cancelled.
+ */
+b8 VZKR_CancelTimer(
+    VZKR_TimerWheel wheel,
+    VZKR_Timer timer
+);
+
+/**
+ * Advances the wheel to the current time, firing every timer due by then.
+ * Times earlier than the last advance are ignored.
+ * Returns the number of timers that fired.
+ */
+i32 VZKR_AdvanceTimerWheel(
+    VZKR_TimerWheel wheel,
+    i64 nowNs
+);
+
+/**
+ * Gets how long until the wheel next needs advancing (zero if it's already due), or -1
+ * if there are no timers. This can be earlier than the next timer is due, for ones far
+ * enough ahead, but never later.
+ */
+i64 VZKR_GetTimerWheelWaitTime(
+    VZKR_TimerWheel wheel,
+    i64 nowNs
+);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_TIMER_WHEEL_H =======================================================
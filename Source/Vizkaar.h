@@ -1,4 +1,23 @@
 #ifndef VZKR_MAIN_HEADER_H // ======================================================
 #define VZKR_MAIN_HEADER_H
 #include "__Prelude.h"
+#include "TextSearch.h"
+#include "PatternMatch.h"
+#include "Atomics.h"
+#include "Clock.h"
+#include "Threading.h"
+#include "Synchronization.h"
+#include "LockProfiling.h"
+#include "Queues.h"
+#include "Parallel.h"
+#include "TaskGraph.h"
+#include "TimerWheel.h"
+#include "FileIO.h"
+#include "AsyncIO.h"
+#include "Fibers.h"
+#include "Streams.h"
+#include "DirectoryWalk.h"
+#include "FileWatcher.h"
+#include "Compression.h"
+#include "ZipArchive.h"
 #endif // VZKR_MAIN_HEADER_H =======================================================
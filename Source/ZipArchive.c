@@ -0,0 +1,556 @@
+#define VZKR_IMPLEMENTATION
+#include "ZipArchive.h"
+
+// Internal Declarations ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#define VZKR_INTERNAL_ZIP_LOCAL_HEADER_SIGNATURE   0x04034B50u
+#define VZKR_INTERNAL_ZIP_CENTRAL_HEADER_SIGNATURE 0x02014B50u
+#define VZKR_INTERNAL_ZIP_END_SIGNATURE            0x06054B50u
+#define VZKR_INTERNAL_ZIP64_END_SIGNATURE          0x06064B50u
+#define VZKR_INTERNAL_ZIP64_LOCATOR_SIGNATURE      0x07064B50u
+#define VZKR_INTERNAL_ZIP_END_SIZE                 22
+#define VZKR_INTERNAL_ZIP_CENTRAL_HEADER_SIZE      46
+#define VZKR_INTERNAL_ZIP_LOCAL_HEADER_SIZE        30
+#define VZKR_INTERNAL_ZIP_DEFAULT_THREADS          4
+
+typedef struct VZKR_Internal_ZipArchive
+{
+    PNSLR_Allocator allocator;
+    VZKR_FileMapping mapping;
+    PNSLR_ArraySlice(VZKR_ZipEntry) entries;
+    PNSLR_ArraySlice(i64) table; // entry index + 1, so zeroed slots are empty
+} VZKR_Internal_ZipArchive;
+
+typedef struct VZKR_Internal_ZipEntryReader
+{
+    PNSLR_ArraySlice(u8) data;
+    VZKR_ZipCompression compression;
+    VZKR_Internal_Inflater* inflater;
+    i64 size;
+    i64 position;
+    u32 expectedCrc;
+    u32 crc;
+    b8 verifying;
+    u32 crcTable[4][256];
+} VZKR_Internal_ZipEntryReader;
+
+static u32 VZKR_Internal_ReadLE16(const u8* ptr)
+{
+    return (u32) ptr[0] | ((u32) ptr[1] << 8);
+}
+
+static u64 VZKR_Internal_ReadLE64(const u8* ptr)
+{
+    return (u64) VZKR_Internal_ReadLE32(ptr) | ((u64) VZKR_Internal_ReadLE32(ptr + 4) << 32);
+}
+
+static u64 VZKR_Internal_ZipHashName(utf8str name)
+{
+    u64 hash = 0xCBF29CE484222325ull; // FNV-1a
+    for (i64 i = 0; i < name.count; i++) { hash = (hash ^ name.data[i]) * 0x100000001B3ull; }
+    return hash;
+}
+
+// Zip Archive Functions ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Finds the end of central directory record, searching backwards since it's followed by
+ * a comment of unknown length, and reads where the central directory is from it (or
+ * from the zip64 one, if the values don't fit).
+ */
+static b8 VZKR_Internal_ZipFindCentralDirectory(PNSLR_ArraySlice(u8) data, i64* offset, i64* size, i64* count)
+{
+    if (data.count < VZKR_INTERNAL_ZIP_END_SIZE) return false;
+
+    i64 lowest = data.count - VZKR_INTERNAL_ZIP_END_SIZE - 0xFFFF;
+    if (lowest < 0) lowest = 0;
+
+    for (i64 pos = data.count - VZKR_INTERNAL_ZIP_END_SIZE; pos >= lowest; pos--)
+    {
+        const u8* record = data.data + pos;
+        if (VZKR_Internal_ReadLE32(record) != VZKR_INTERNAL_ZIP_END_SIGNATURE) continue;
+        if (pos + VZKR_INTERNAL_ZIP_END_SIZE + (i64) VZKR_Internal_ReadLE16(record + 20) > data.count) continue;
+
+        *count  = (i64) VZKR_Internal_ReadLE16(record + 10);
+        *size   = (i64) VZKR_Internal_ReadLE32(record + 12);
+        *offset = (i64) VZKR_Internal_ReadLE32(record + 16);
+
+        b8 zip64 = (*count == 0xFFFF || *size == 0xFFFFFFFF || *offset == 0xFFFFFFFF);
+        if (zip64 && pos >= 20 && VZKR_Internal_ReadLE32(record - 20) == VZKR_INTERNAL_ZIP64_LOCATOR_SIGNATURE)
+        {
+            u64 recordOffset = VZKR_Internal_ReadLE64(record - 20 + 8);
+            if (data.count < 56 || recordOffset > (u64) (data.count - 56)) return false;
+
+            const u8* record64 = data.data + recordOffset;
+            if (VZKR_Internal_ReadLE32(record64) != VZKR_INTERNAL_ZIP64_END_SIGNATURE) return false;
+
+            *count  = (i64) VZKR_Internal_ReadLE64(record64 + 32);
+            *size   = (i64) VZKR_Internal_ReadLE64(record64 + 40);
+            *offset = (i64) VZKR_Internal_ReadLE64(record64 + 48);
+        }
+
+        return *count >= 0 && *offset >= 0 && *size >= 0 && *offset <= data.count && *size <= data.count - *offset;
+    }
+
+    return false;
+}
+
+static b8 VZKR_Internal_ZipReadCentralDirectory(VZKR_Internal_ZipArchive* zip, i64 offset, i64 size, i64 count)
+{
+    const u8* ptr = zip->mapping.data.data + offset;
+    const u8* end = ptr + size;
+
+    // every entry takes up at least a header, which also caps absurd counts
+    if (count > size / VZKR_INTERNAL_ZIP_CENTRAL_HEADER_SIZE) return false;
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    zip->entries = PNSLR_MakeSlice(VZKR_ZipEntry, count, true, zip->allocator, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None) return false;
+
+    for (i64 i = 0; i < count; i++)
+    {
+        if (end - ptr < VZKR_INTERNAL_ZIP_CENTRAL_HEADER_SIZE || VZKR_Internal_ReadLE32(ptr) != VZKR_INTERNAL_ZIP_CENTRAL_HEADER_SIGNATURE) return false;
+
+        u32 flags         = VZKR_Internal_ReadLE16(ptr + 8);
+        u32 method        = VZKR_Internal_ReadLE16(ptr + 10);
+        i64 nameLength    = (i64) VZKR_Internal_ReadLE16(ptr + 28);
+        i64 extraLength   = (i64) VZKR_Internal_ReadLE16(ptr + 30);
+        i64 commentLength = (i64) VZKR_Internal_ReadLE16(ptr + 32);
+        if (end - ptr < VZKR_INTERNAL_ZIP_CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength) return false;
+
+        VZKR_ZipEntry* entry = &zip->entries.data[i];
+        entry->name             = (utf8str) {.data = (u8*) ptr + VZKR_INTERNAL_ZIP_CENTRAL_HEADER_SIZE, .count = nameLength};
+        entry->crc32            = VZKR_Internal_ReadLE32(ptr + 16);
+        entry->compressedSize   = (i64) VZKR_Internal_ReadLE32(ptr + 20);
+        entry->uncompressedSize = (i64) VZKR_Internal_ReadLE32(ptr + 24);
+        entry->headerOffset     = (i64) VZKR_Internal_ReadLE32(ptr + 42);
+
+        if (flags & 1)        entry->compression = VZKR_ZipCompression_Unsupported; // encrypted
+        else if (method == 0) entry->compression = VZKR_ZipCompression_Stored;
+        else if (method == 8) entry->compression = VZKR_ZipCompression_Deflated;
+        else                  entry->compression = VZKR_ZipCompression_Unsupported;
+
+        // values that don't fit are in the zip64 extra field instead, in this order
+        const u8* extra    = ptr + VZKR_INTERNAL_ZIP_CENTRAL_HEADER_SIZE + nameLength;
+        const u8* extraEnd = extra + extraLength;
+        while (extraEnd - extra >= 4)
+        {
+            u32 id       = VZKR_Internal_ReadLE16(extra);
+            i64 dataSize = (i64) VZKR_Internal_ReadLE16(extra + 2);
+            extra += 4;
+            if (dataSize > extraEnd - extra) break;
+
+            if (id == 0x0001)
+            {
+                const u8* field    = extra;
+                const u8* fieldEnd = extra + dataSize;
+                i64* values[3] = {&entry->uncompressedSize, &entry->compressedSize, &entry->headerOffset};
+                for (i32 j = 0; j < 3; j++)
+                {
+                    if (*values[j] != 0xFFFFFFFF) continue;
+                    if (fieldEnd - field < 8) return false;
+                    *values[j] = (i64) VZKR_Internal_ReadLE64(field);
+                    field += 8;
+                }
+            }
+
+            extra += dataSize;
+        }
+
+        if (entry->compressedSize < 0 || entry->uncompressedSize < 0 || entry->headerOffset < 0) return false;
+        ptr += VZKR_INTERNAL_ZIP_CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength;
+    }
+
+    return true;
+}
+
+static b8 VZKR_Internal_ZipBuildIndex(VZKR_Internal_ZipArchive* zip)
+{
+    i64 count = zip->entries.count;
+    i64 tableSize = 16;
+    while (tableSize < count * 2) { tableSize *= 2; }
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    zip->table = PNSLR_MakeSlice(i64, tableSize, true, zip->allocator, PNSLR_GET_LOC(), &err);
+    if (err != PNSLR_AllocatorError_None) return false;
+
+    // with duplicate names, the first one is found first
+    for (i64 i = 0; i < count; i++)
+    {
+        for (u64 slot = VZKR_Internal_ZipHashName(zip->entries.data[i].name);; slot++)
+        {
+            i64* entry = &zip->table.data[slot & (u64) (tableSize - 1)];
+            if (*entry == 0) { *entry = i + 1; break; }
+        }
+    }
+
+    return true;
+}
+
+static void VZKR_Internal_ZipFree(VZKR_Internal_ZipArchive* zip)
+{
+    PNSLR_Allocator allocator = zip->allocator;
+    PNSLR_FreeSlice(&zip->entries, allocator, PNSLR_GET_LOC(), nil);
+    PNSLR_FreeSlice(&zip->table, allocator, PNSLR_GET_LOC(), nil);
+    VZKR_UnmapFile(&zip->mapping);
+    PNSLR_Free(allocator, zip, PNSLR_GET_LOC(), nil);
+}
+
+VZKR_ZipArchive VZKR_OpenZipArchive(
+    PNSLR_Path path,
+    PNSLR_Allocator allocator
+)
+{
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_ZipArchive* zip = (VZKR_Internal_ZipArchive*) PNSLR_Allocate(allocator, true, (i32) sizeof(VZKR_Internal_ZipArchive), (i32) alignof(VZKR_Internal_ZipArchive), PNSLR_GET_LOC(), &err);
+    if (!zip || err != PNSLR_AllocatorError_None) return (VZKR_ZipArchive) {0};
+    zip->allocator = allocator;
+
+    PNSLR_File file = PNSLR_OpenFileToRead(path, false);
+    b8 success = file.handle && VZKR_MapFile(file, VZKR_FileMapMode_ReadOnly, 0, -1, &zip->mapping);
+    if (file.handle) PNSLR_CloseFileHandle(file);
+
+    i64 offset = 0, size = 0, count = 0;
+    success = success && VZKR_Internal_ZipFindCentralDirectory(zip->mapping.data, &offset, &size, &count);
+    success = success && VZKR_Internal_ZipReadCentralDirectory(zip, offset, size, count);
+    success = success && VZKR_Internal_ZipBuildIndex(zip);
+
+    if (!success)
+    {
+        VZKR_Internal_ZipFree(zip);
+        return (VZKR_ZipArchive) {0};
+    }
+
+    // entries are mostly read front to back
+    VZKR_AdviseFileMapping(&zip->mapping, VZKR_FileMapHint_Sequential, 0, -1);
+    return (VZKR_ZipArchive) {.handle = zip};
+}
+
+void VZKR_CloseZipArchive(VZKR_ZipArchive* archive)
+{
+    if (!archive || !archive->handle) return;
+
+    VZKR_Internal_ZipFree((VZKR_Internal_ZipArchive*) archive->handle);
+    archive->handle = nil;
+}
+
+// Zip Entries ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+PNSLR_ArraySlice(VZKR_ZipEntry) VZKR_GetZipEntries(VZKR_ZipArchive archive)
+{
+    VZKR_Internal_ZipArchive* zip = (VZKR_Internal_ZipArchive*) archive.handle;
+    if (!zip) return (PNSLR_ArraySlice(VZKR_ZipEntry)) {0};
+
+    return zip->entries;
+}
+
+i64 VZKR_FindZipEntry(VZKR_ZipArchive archive, utf8str name)
+{
+    VZKR_Internal_ZipArchive* zip = (VZKR_Internal_ZipArchive*) archive.handle;
+    if (!zip) return -1;
+
+    i64 mask = zip->table.count - 1;
+    for (u64 slot = VZKR_Internal_ZipHashName(name);; slot++)
+    {
+        i64 entry = zip->table.data[slot & (u64) mask];
+        if (entry == 0) return -1;
+        if (PNSLR_AreStringsEqual(zip->entries.data[entry - 1].name, name, PNSLR_StringComparisonType_CaseSensitive)) return entry - 1;
+    }
+}
+
+/** Finds an entry's data, which comes after its local header (whose variable parts can differ from the central one's). */
+static b8 VZKR_Internal_ZipGetEntryData(VZKR_Internal_ZipArchive* zip, i64 index, PNSLR_ArraySlice(u8)* output)
+{
+    if (!zip || index < 0 || index >= zip->entries.count) return false;
+
+    VZKR_ZipEntry* entry = &zip->entries.data[index];
+    PNSLR_ArraySlice(u8) archive = zip->mapping.data;
+    if (entry->headerOffset > archive.count - VZKR_INTERNAL_ZIP_LOCAL_HEADER_SIZE) return false;
+
+    const u8* header = archive.data + entry->headerOffset;
+    if (VZKR_Internal_ReadLE32(header) != VZKR_INTERNAL_ZIP_LOCAL_HEADER_SIGNATURE) return false;
+
+    i64 start = entry->headerOffset + VZKR_INTERNAL_ZIP_LOCAL_HEADER_SIZE + (i64) VZKR_Internal_ReadLE16(header + 26) + (i64) VZKR_Internal_ReadLE16(header + 28);
+    if (start > archive.count || entry->compressedSize > archive.count - start) return false;
+
+    output->data  = archive.data + start;
+    output->count = entry->compressedSize;
+    return true;
+}
+
+b8 VZKR_GetZipEntryView(
+    VZKR_ZipArchive archive,
+    i64 index,
+    PNSLR_ArraySlice(u8)* output
+)
+{
+    if (!output) return false;
+    *output = (PNSLR_ArraySlice(u8)) {0};
+
+    VZKR_Internal_ZipArchive* zip = (VZKR_Internal_ZipArchive*) archive.handle;
+    if (!zip || index < 0 || index >= zip->entries.count) return false;
+
+    VZKR_ZipEntry* entry = &zip->entries.data[index];
+    if (entry->compression != VZKR_ZipCompression_Stored || entry->compressedSize != entry->uncompressedSize) return false;
+
+    return VZKR_Internal_ZipGetEntryData(zip, index, output);
+}
+
+b8 VZKR_OpenZipEntryStream(
+    VZKR_ZipArchive archive,
+    i64 index,
+    PNSLR_Allocator allocator,
+    VZKR_ZipEntryStream* output
+)
+{
+    if (!output) return false;
+    *output = (VZKR_ZipEntryStream) {0};
+
+    VZKR_Internal_ZipArchive* zip = (VZKR_Internal_ZipArchive*) archive.handle;
+    PNSLR_ArraySlice(u8) data = {0};
+    if (!VZKR_Internal_ZipGetEntryData(zip, index, &data)) return false;
+
+    VZKR_ZipEntry* entry = &zip->entries.data[index];
+    if (entry->compression == VZKR_ZipCompression_Unsupported) return false;
+    if (entry->compression == VZKR_ZipCompression_Stored && entry->compressedSize != entry->uncompressedSize) return false;
+
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    VZKR_Internal_ZipEntryReader* reader = (VZKR_Internal_ZipEntryReader*) PNSLR_Allocate(allocator, true, (i32) sizeof(VZKR_Internal_ZipEntryReader), (i32) alignof(VZKR_Internal_ZipEntryReader), PNSLR_GET_LOC(), &err);
+    if (!reader || err != PNSLR_AllocatorError_None) return false;
+
+    reader->data        = data;
+    reader->compression = entry->compression;
+    reader->size        = entry->uncompressedSize;
+    reader->expectedCrc = entry->crc32;
+    reader->verifying   = true;
+    VZKR_Internal_InitCrc32Table(reader->crcTable);
+
+    // deflated entries are decompressed straight out of the mapping
+    if (entry->compression == VZKR_ZipCompression_Deflated)
+    {
+        reader->inflater = VZKR_Internal_CreateInflater((PNSLR_Stream) {0}, VZKR_InflateFormat_Raw, allocator);
+        if (!reader->inflater)
+        {
+            PNSLR_Free(allocator, reader, PNSLR_GET_LOC(), nil);
+            return false;
+        }
+
+        VZKR_Internal_ResetInflater(reader->inflater, data.data, data.count);
+    }
+
+    output->allocator = allocator;
+    output->reader    = reader;
+    return true;
+}
+
+static b8 VZKR_Internal_ZipEntryRead(VZKR_Internal_ZipEntryReader* reader, PNSLR_ArraySlice(u8) dst, i64* readSize)
+{
+    i64 copied = 0;
+    b8 success = true;
+    while (copied < dst.count && reader->position < reader->size)
+    {
+        const u8* src = nil;
+        i64 count = 0;
+        if (reader->compression == VZKR_ZipCompression_Stored)
+        {
+            src   = reader->data.data + reader->position;
+            count = reader->size - reader->position;
+        }
+        else
+        {
+            VZKR_Internal_Inflater* inf = reader->inflater;
+            if (inf->outStart == inf->outEnd)
+            {
+                // running out before the entry's size is just as wrong as bad data
+                if (inf->phase == VZKR_INTERNAL_INFLATE_PHASE_DONE || !VZKR_Internal_InflateRun(inf)) { success = false; break; }
+                continue;
+            }
+
+            src   = inf->window + inf->outStart;
+            count = inf->outEnd - inf->outStart;
+            if (count > reader->size - reader->position) { success = false; break; }
+        }
+
+        if (count > dst.count - copied) count = dst.count - copied;
+        if (dst.data) PNSLR_MemCopy(dst.data + copied, (rawptr) src, (i32) count);
+        if (reader->verifying) reader->crc = VZKR_Internal_UpdateCrc32(reader->crcTable, reader->crc, src, count);
+        if (reader->inflater) reader->inflater->outStart += count;
+
+        reader->position += count;
+        copied           += count;
+    }
+
+    if (success && reader->verifying && reader->position == reader->size && reader->crc != reader->expectedCrc) success = false;
+    if (!success) reader->verifying = false; // so it's only reported once
+
+    if (readSize) *readSize = copied;
+    return success;
+}
+
+static b8 VZKR_Internal_ZipEntryStreamProc(
+    rawptr streamData,
+    PNSLR_StreamMode mode,
+    PNSLR_ArraySlice(u8) data,
+    i64 offset,
+    i64* extraRet
+)
+{
+    VZKR_ZipEntryStream* stream = (VZKR_ZipEntryStream*) streamData;
+    if (!stream || !stream->reader) return false;
+
+    VZKR_Internal_ZipEntryReader* reader = (VZKR_Internal_ZipEntryReader*) stream->reader;
+    switch (mode)
+    {
+        case PNSLR_StreamMode_GetSize:
+            if (extraRet) *extraRet = reader->size;
+            return true;
+        case PNSLR_StreamMode_GetCurrentPos:
+            if (extraRet) *extraRet = reader->position;
+            return true;
+        case PNSLR_StreamMode_SeekAbsolute:
+        case PNSLR_StreamMode_SeekRelative:
+        {
+            i64 target = (mode == PNSLR_StreamMode_SeekRelative) ? reader->position + offset : offset;
+            if (target < 0 || target > reader->size) return false;
+            if (target == reader->position) return true;
+
+            if (reader->compression == VZKR_ZipCompression_Stored)
+            {
+                reader->position  = target;
+                reader->verifying = false;
+                return true;
+            }
+
+            // deflated entries can only skip forward, by decompressing and throwing it away
+            i64 skip = target - reader->position, skipped = 0;
+            if (skip < 0) return false;
+            return VZKR_Internal_ZipEntryRead(reader, (PNSLR_ArraySlice(u8)) {.data = nil, .count = skip}, &skipped) && skipped == skip;
+        }
+        case PNSLR_StreamMode_Read:
+            return VZKR_Internal_ZipEntryRead(reader, data, extraRet);
+        case PNSLR_StreamMode_Flush:
+            return true;
+        case PNSLR_StreamMode_Close:
+            if (reader->inflater) VZKR_Internal_DestroyInflater(reader->inflater);
+            PNSLR_Free(stream->allocator, reader, PNSLR_GET_LOC(), nil);
+            *stream = (VZKR_ZipEntryStream) {0};
+            return true;
+        default:
+            return false;
+    }
+}
+
+PNSLR_Stream VZKR_StreamFromZipEntryStream(VZKR_ZipEntryStream* stream)
+{
+    return (PNSLR_Stream) {.procedure = VZKR_Internal_ZipEntryStreamProc, .data = (rawptr) stream};
+}
+
+b8 VZKR_ReadZipEntry(
+    VZKR_ZipArchive archive,
+    i64 index,
+    PNSLR_Allocator allocator,
+    PNSLR_ArraySlice(u8)* output
+)
+{
+    if (!output) return false;
+    *output = (PNSLR_ArraySlice(u8)) {0};
+
+    VZKR_ZipEntryStream stream = {0};
+    if (!VZKR_OpenZipEntryStream(archive, index, allocator, &stream)) return false;
+
+    VZKR_Internal_ZipEntryReader* reader = (VZKR_Internal_ZipEntryReader*) stream.reader;
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    PNSLR_ArraySlice(u8) buffer = {0};
+    b8 success = (reader->size <= VZKR_INTERNAL_FILE_MAX_TRANSFER);
+    if (success)
+    {
+        buffer  = PNSLR_MakeSlice(u8, reader->size > 0 ? reader->size : 1, false, allocator, PNSLR_GET_LOC(), &err);
+        success = (err == PNSLR_AllocatorError_None);
+    }
+
+    i64 readSize = 0;
+    success = success && VZKR_Internal_ZipEntryRead(reader, (PNSLR_ArraySlice(u8)) {.data = buffer.data, .count = reader->size}, &readSize) && readSize == reader->size;
+    PNSLR_CloseStream(VZKR_StreamFromZipEntryStream(&stream));
+
+    if (!success)
+    {
+        PNSLR_FreeSlice(&buffer, allocator, PNSLR_GET_LOC(), nil);
+        return false;
+    }
+
+    output->data  = buffer.data;
+    output->count = readSize;
+    return true;
+}
+
+typedef struct VZKR_Internal_ZipParallelRead
+{
+    VZKR_ZipArchive archive;
+    PNSLR_ArraySlice(i64) indices;
+    PNSLR_ArraySlice(utf8str) outputs;
+    PNSLR_Allocator allocator;
+    VZKR_ProfiledMutex mutex;
+    i64 next;
+    b8 failed;
+} VZKR_Internal_ZipParallelRead;
+
+static void VZKR_Internal_ZipReadWorker(rawptr arg)
+{
+    VZKR_Internal_ZipParallelRead* read = (VZKR_Internal_ZipParallelRead*) arg;
+    while (true)
+    {
+        VZKR_LockProfiledMutex(&read->mutex);
+        i64 idx = (read->failed) ? read->indices.count : read->next++;
+        VZKR_UnlockProfiledMutex(&read->mutex);
+        if (idx >= read->indices.count) break;
+
+        if (!VZKR_ReadZipEntry(read->archive, read->indices.data[idx], read->allocator, &read->outputs.data[idx]))
+        {
+            VZKR_LockProfiledMutex(&read->mutex);
+            read->failed = true;
+            VZKR_UnlockProfiledMutex(&read->mutex);
+        }
+    }
+}
+
+b8 VZKR_ReadZipEntriesParallel(
+    VZKR_ZipArchive archive,
+    PNSLR_ArraySlice(i64) indices,
+    i32 numThreads,
+    PNSLR_Allocator allocator,
+    PNSLR_ArraySlice(utf8str) outputs
+)
+{
+    if (!archive.handle || outputs.count < indices.count) return false;
+    for (i64 i = 0; i < indices.count; i++) { outputs.data[i] = (utf8str) {0}; }
+
+    VZKR_Internal_ZipParallelRead read = {.archive = archive, .indices = indices, .outputs = outputs, .allocator = allocator, .mutex = VZKR_CreateProfiledMutex(PNSLR_GET_LOC())};
+
+    if (numThreads <= 0) numThreads = VZKR_INTERNAL_ZIP_DEFAULT_THREADS;
+    if (numThreads > indices.count) numThreads = (i32) indices.count;
+
+    // the calling thread reads too
+    PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
+    PNSLR_ArraySlice(VZKR_Thread) threads = PNSLR_MakeSlice(VZKR_Thread, numThreads > 1 ? numThreads - 1 : 1, true, allocator, PNSLR_GET_LOC(), &err);
+    VZKR_ThreadOptions threadOptions = {.name = PNSLR_StringLiteral("VzkrZip")};
+    for (i32 i = 0; err == PNSLR_AllocatorError_None && i < numThreads - 1; i++)
+    {
+        threads.data[i] = VZKR_CreateThread(VZKR_Internal_ZipReadWorker, &read, threadOptions, allocator);
+        if (!threads.data[i].handle) break;
+    }
+
+    VZKR_Internal_ZipReadWorker(&read);
+
+    for (i32 i = 0; err == PNSLR_AllocatorError_None && i < numThreads - 1; i++) { VZKR_JoinThread(&threads.data[i]); }
+
+    PNSLR_FreeSlice(&threads, allocator, PNSLR_GET_LOC(), nil);
+    VZKR_DestroyProfiledMutex(&read.mutex);
+
+    if (read.failed)
+    {
+        for (i64 i = 0; i < indices.count; i++) { PNSLR_FreeSlice(&outputs.data[i], allocator, PNSLR_GET_LOC(), nil); }
+        return false;
+    }
+
+    return true;
+}
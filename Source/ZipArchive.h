@@ -0,0 +1,159 @@
+#ifndef VZKR_ZIP_ARCHIVE_H // ======================================================
+#define VZKR_ZIP_ARCHIVE_H
+#include "__Prelude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Zip Archive Declaration ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * A cross-platform opaque handle to an opened zip archive.
+ * The archive is mapped into memory, and its central directory indexed up front, so
+ * entries can be looked up by name and read in any order.
+ * Once opened, an archive can be read from several threads at once.
+ */
+typedef struct VZKR_ZipArchive
+{
+    rawptr handle;
+} VZKR_ZipArchive;
+
+/**
+ * How an entry's data is stored in the archive.
+ * Entries using anything else (or encryption) are listed, but can't be read.
+ */
+typedef u8 VZKR_ZipCompression /* use as value */;
+#define VZKR_ZipCompression_Stored ((VZKR_ZipCompression) 0)
+#define VZKR_ZipCompression_Deflated ((VZKR_ZipCompression) 1)
+#define VZKR_ZipCompression_Unsupported ((VZKR_ZipCompression) 2)
+
+/**
+ * An entry in a zip archive, as listed in its central directory.
+ * 'name' points into the archive's mapping, and uses forward slashes; directories end
+ * with one.
+ * 'headerOffset' is where its local header is in the archive.
+ */
+typedef struct VZKR_ZipEntry
+{
+    utf8str name;
+    VZKR_ZipCompression compression;
+    u32 crc32;
+    i64 compressedSize;
+    i64 uncompressedSize;
+    i64 headerOffset;
+} VZKR_ZipEntry;
+
+PNSLR_DECLARE_ARRAY_SLICE(VZKR_ZipEntry);
+
+/**
+ * Opens a zip archive (including zip64 ones).
+ * The allocator is used for the index, and must stay valid until the archive is closed.
+ * If opening failed, the returned handle will be zeroed.
+ */
+VZKR_ZipArchive VZKR_OpenZipArchive(
+    PNSLR_Path path,
+    PNSLR_Allocator allocator
+);
+
+/**
+ * Closes a zip archive. Views of its entries, their names and any streams reading from
+ * it can't be used afterwards.
+ */
+void VZKR_CloseZipArchive(
+    VZKR_ZipArchive* archive
+);
+
+// Zip Entries ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * Returns every entry in the archive, in the order of its central directory.
+ * Valid until the archive is closed.
+ */
+PNSLR_ArraySlice(VZKR_ZipEntry) VZKR_GetZipEntries(
+    VZKR_ZipArchive archive
+);
+
+/**
+ * Looks up an entry by its full name (case-sensitive).
+ * Returns its index, or -1 if there's no such entry.
+ */
+i64 VZKR_FindZipEntry(
+    VZKR_ZipArchive archive,
+    utf8str name
+);
+
+/**
+ * Gets a stored (uncompressed) entry's data, straight from the archive's mapping without
+ * copying it. Its checksum isn't verified.
+ * Returns true on success, false if the entry is compressed, or the archive is malformed.
+ */
+b8 VZKR_GetZipEntryView(
+    VZKR_ZipArchive archive,
+    i64 index,
+    PNSLR_ArraySlice(u8)* output
+);
+
+/**
+ * Reads an entry, decompressing it if needed, while it's read. Reading the entry to the
+ * end verifies its checksum, and fails if it doesn't match.
+ * Seeking backwards only works for stored entries, and stops the checksum from being
+ * verified.
+ * Closing the stream frees it. Streams of different entries (or the same one) can be
+ * read from different threads at once.
+ */
+typedef struct VZKR_ZipEntryStream
+{
+    PNSLR_Allocator allocator;
+    rawptr reader;
+} VZKR_ZipEntryStream;
+
+/**
+ * Opens a stream over an entry.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_OpenZipEntryStream(
+    VZKR_ZipArchive archive,
+    i64 index,
+    PNSLR_Allocator allocator,
+    VZKR_ZipEntryStream* output
+);
+
+/**
+ * Creates a stream that reads through a zip entry stream.
+ * The zip entry stream must outlive the returned stream.
+ */
+PNSLR_Stream VZKR_StreamFromZipEntryStream(
+    VZKR_ZipEntryStream* stream
+);
+
+/**
+ * Reads an entry's contents into memory in one go, verifying its checksum.
+ * Returns true on success, false on failure.
+ */
+b8 VZKR_ReadZipEntry(
+    VZKR_ZipArchive archive,
+    i64 index,
+    PNSLR_Allocator allocator,
+    PNSLR_ArraySlice(u8)* output
+);
+
+/**
+ * Reads several entries into memory on several threads at once (4 if 'numThreads'
+ * isn't positive), storing each one's contents at the same index in 'outputs' (which
+ * must have as many slots as there are indices). The allocator must be thread-safe.
+ * Returns true if every entry was read; on failure, nothing is kept.
+ */
+b8 VZKR_ReadZipEntriesParallel(
+    VZKR_ZipArchive archive,
+    PNSLR_ArraySlice(i64) indices,
+    i32 numThreads,
+    PNSLR_Allocator allocator,
+    PNSLR_ArraySlice(utf8str) outputs
+);
+
+#ifdef __cplusplus
+} // extern c
+#endif
+
+#endif // VZKR_ZIP_ARCHIVE_H =======================================================
@@ -6,6 +6,45 @@
 #include "Dependencies/Muzent/Source/__PrivateIncludes.h"
 
 PNSLR_SUPPRESS_WARN
+#include <assert.h>
+#if PNSLR_X64
+    #include <emmintrin.h>
+#elif PNSLR_ARM64
+    #include <arm_neon.h>
+#endif
+#if PNSLR_UNIX
+    #include <dirent.h>
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <pthread.h>
+    #include <sched.h>
+    #include <stdio.h>
+    #include <time.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/uio.h>
+#endif
+#if PNSLR_LINUX
+    #include <sys/inotify.h>
+    #include <sys/ioctl.h>
+    #include <sys/sendfile.h>
+    #include <sys/syscall.h>
+    #include <linux/futex.h>
+    #include <linux/io_uring.h>
+#endif
+#if PNSLR_OSX || PNSLR_IOS
+    #include <copyfile.h>
+    #include <sys/event.h>
+#endif
 PNSLR_UNSUPPRESS_WARN
 
+// for the implementation files that keep per-thread state
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define VZKR_INTERNAL_THREAD_LOCAL __declspec(thread)
+#else
+    #define VZKR_INTERNAL_THREAD_LOCAL __thread
+#endif
+
 #endif//VZKR_PRIVATE_INCLUDES_H
@@ -21,7 +21,7 @@ i32 VzkrMain(DVRPL_App app, PNSLR_ArraySlice(utf8str) args)
         )
     );
 
-    // i64 prevTime = PNSLR_NanosecondsSinceUnixEpoch();
+    i64 prevTime = VZKR_GetMonotonicTime();
 
     PNSLR_AllocatorError err = PNSLR_AllocatorError_None;
     PNSLR_Allocator tempAllocator = PNSLR_NewAllocator_Arena(PNSLR_GetAllocator_DefaultHeap(), 16 * 1024 * 1024 /* 16 MiB */, PNSLR_GET_LOC(), &err);
@@ -55,12 +55,19 @@ i32 VzkrMain(DVRPL_App app, PNSLR_ArraySlice(utf8str) args)
 
     PNSLR_FreeAll(tempAllocator, PNSLR_GET_LOC(), nil);
 
+    // per-frame work goes in as tasks, with dependencies between them, and runs on the
+    // job system between beginning and ending the frame (serially if the job system
+    // couldn't be created)
+    VZKR_JobSystem jobs = VZKR_CreateJobSystem((VZKR_JobSystemOptions) {0}, PNSLR_GetAllocator_DefaultHeap());
+    VZKR_TaskGraph frameGraph = VZKR_CreateTaskGraph(PNSLR_GetAllocator_DefaultHeap());
+
     b8 running = true, fullscreen = false;
     while (running)
     {
-        // i64 newTime = PNSLR_NanosecondsSinceUnixEpoch();
-        // f32 dt = (f32) ((f64) (newTime - prevTime) / 1000000000.0);
-        // prevTime = newTime;
+        i64 newTime = VZKR_GetMonotonicTime();
+        f32 dt = (f32) VZKR_NanosecondsToSeconds(newTime - prevTime);
+        prevTime = newTime;
+        (void) dt; // nothing's animated yet
 
         DVRPL_GatherEvents(tempAllocator);
         i64 iterator = 0; DVRPL_Event evt;
@@ -115,12 +122,17 @@ i32 VzkrMain(DVRPL_App app, PNSLR_ArraySlice(utf8str) args)
             }
 
             /*MZNT_RendererCommandBuffer* cmdBuf = */ MZNT_BeginFrame(wndSrf, 0.15f, 0.15f, 0.3f, 1.0f, tempAllocator);
+            VZKR_RunTaskGraph(frameGraph, jobs);
             MZNT_EndFrame(wndSrf, tempAllocator);
         }
 
         PNSLR_FreeAll(tempAllocator, PNSLR_GET_LOC(), nil);
     }
 
+    VZKR_DestroyTaskGraph(&frameGraph);
+
+    VZKR_DestroyJobSystem(&jobs);
+
     MZNT_DestroyRendererSurface(wndSrf, tempAllocator);
 
     DVRPL_DestroyWindow(&wnd);
@@ -131,6 +143,25 @@ i32 VzkrMain(DVRPL_App app, PNSLR_ArraySlice(utf8str) args)
 }
 
 // unity build
+#include "TextSearch.c"
+#include "PatternMatch.c"
+#include "Atomics.c"
+#include "Clock.c"
+#include "Threading.c"
+#include "Synchronization.c"
+#include "LockProfiling.c"
+#include "Queues.c"
+#include "Parallel.c"
+#include "TaskGraph.c"
+#include "TimerWheel.c"
+#include "FileIO.c"
+#include "AsyncIO.c"
+#include "Fibers.c"
+#include "Streams.c"
+#include "DirectoryWalk.c"
+#include "FileWatcher.c"
+#include "Compression.c"
+#include "ZipArchive.c"
 #include "Dependencies/Panshilar/Source/zzzz_Unity.c"
 #include "Dependencies/Dvaarpaal/Source/zzzz_Unity.c"
 #include "Dependencies/Muzent/Source/zzzz_Unity.c"